@@ -3,9 +3,11 @@ package cvc
 import (
 	"crypto/ecdsa"
 	"crypto/elliptic"
+	"errors"
 	"math/big"
 	"testing"
 
+	"github.com/MyNextID/cvc-go/internal"
 	"github.com/lestrrat-go/jwx/v2/jwk"
 )
 
@@ -323,3 +325,111 @@ func TestAddSecretKeys(t *testing.T) {
 		t.Logf("Large number handling test passed after 10 iterations")
 	})
 }
+
+func TestAddSecretKeysWithPublic(t *testing.T) {
+	key1, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate first test key: %v", err)
+	}
+
+	key2, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate second test key: %v", err)
+	}
+
+	t.Run("MatchesAddSecretKeys", func(t *testing.T) {
+		expected, err := AddSecretKeys(key1, key2)
+		if err != nil {
+			t.Fatalf("AddSecretKeys failed: %v", err)
+		}
+
+		for _, verify := range []bool{false, true} {
+			result, err := AddSecretKeysWithPublic(key1, key2, verify)
+			if err != nil {
+				t.Fatalf("AddSecretKeysWithPublic(verify=%v) failed: %v", verify, err)
+			}
+
+			var expectedKey, resultKey ecdsa.PrivateKey
+			if err := expected.Raw(&expectedKey); err != nil {
+				t.Fatalf("Failed to extract expected key: %v", err)
+			}
+			if err := result.Raw(&resultKey); err != nil {
+				t.Fatalf("Failed to extract result key: %v", err)
+			}
+
+			if expectedKey.D.Cmp(resultKey.D) != 0 {
+				t.Errorf("Private key mismatch (verify=%v)", verify)
+			}
+			if expectedKey.X.Cmp(resultKey.X) != 0 || expectedKey.Y.Cmp(resultKey.Y) != 0 {
+				t.Errorf("Public key mismatch (verify=%v)", verify)
+			}
+		}
+	})
+
+	t.Run("Doubling", func(t *testing.T) {
+		expected, err := AddSecretKeys(key1, key1)
+		if err != nil {
+			t.Fatalf("AddSecretKeys failed: %v", err)
+		}
+
+		result, err := AddSecretKeysWithPublic(key1, key1, true)
+		if err != nil {
+			t.Fatalf("AddSecretKeysWithPublic failed: %v", err)
+		}
+
+		var expectedKey, resultKey ecdsa.PrivateKey
+		expected.Raw(&expectedKey)
+		result.Raw(&resultKey)
+		if expectedKey.X.Cmp(resultKey.X) != 0 || expectedKey.Y.Cmp(resultKey.Y) != 0 {
+			t.Errorf("Public key mismatch when adding a key to itself")
+		}
+	})
+
+	t.Run("InconsistentPublicKey", func(t *testing.T) {
+		// Pair the secret scalar of key1 with the public key of key2
+		var privateKey1, privateKey2 ecdsa.PrivateKey
+		key1.Raw(&privateKey1)
+		key2.Raw(&privateKey2)
+		mismatched := privateKey1
+		mismatched.PublicKey = privateKey2.PublicKey
+
+		mismatchedKey, err := jwk.FromRaw(&mismatched)
+		if err != nil {
+			t.Fatalf("Failed to create mismatched key: %v", err)
+		}
+
+		if _, err := AddSecretKeysWithPublic(mismatchedKey, key2, true); !errors.Is(err, internal.ErrKeyMismatch) {
+			t.Errorf("Expected key mismatch error, got %v", err)
+		}
+	})
+
+	t.Run("ErrorCases", func(t *testing.T) {
+		if _, err := AddSecretKeysWithPublic(nil, key2, false); err == nil {
+			t.Errorf("Expected error for nil first key")
+		}
+		if _, err := AddSecretKeysWithPublic(key1, nil, false); err == nil {
+			t.Errorf("Expected error for nil second key")
+		}
+	})
+}
+
+func BenchmarkAddSecretKeys(b *testing.B) {
+	key1, _ := GenerateSecretKey()
+	key2, _ := GenerateSecretKey()
+
+	b.Run("GeneratorMultiplication", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			if _, err := AddSecretKeys(key1, key2); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("PointAddition", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			if _, err := AddSecretKeysWithPublic(key1, key2, false); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+}
@@ -0,0 +1,317 @@
+package cvc
+
+import (
+	"crypto/rand"
+	"encoding/json"
+	"fmt"
+	"strings"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/MyNextID/cvc-go/pkg"
+	"github.com/lestrrat-go/jwx/v2/jwk"
+)
+
+// Additive derivation lets an issuer compute wallet provider public keys locally, without a round trip
+// to /generate/pub-key. For every issuer it serves in this mode, the wallet provider derives a dedicated
+// issuer master key m_I from its MasterSecretKey and an issuer chain code c_I from its ChainCode, and
+// hands M_I = m_I*G and c_I to that issuer once. For a key context ctx both sides compute the tweak
+//
+//	t = hash_to_field(c_I || M_I, ctx, dst) mod n
+//
+// The issuer derives the child public key as M_I + t*G and the wallet provider later recovers the
+// matching child secret key as m_I + t.
+//
+// Security properties:
+//   - Child public keys are unlinkable to M_I for anyone who does not know the chain code.
+//   - Anyone who knows c_I, M_I and the context of a single child secret key can compute
+//     m_I = child - t and therefore every other child secret key of that issuer. An issuer that receives
+//     one of its own child secret keys, for example by issuing to its own mailbox, learns m_I.
+//   - m_I is derived one-way from the MasterSecretKey, so learning it reveals neither the MasterSecretKey
+//     nor the keys of other issuers or of non-additive key IDs. The damage is limited to the recipients
+//     of the issuer that already holds c_I; only enable additive derivation for issuers trusted with them.
+//   - Key IDs of keys derived in this mode carry the AdditiveKeyIDPrefix and the issuer ID, so the wallet
+//     provider derives them with the master of that issuer only, and rejects issuers it has not enabled.
+
+const (
+	// AdditiveDerivationV1 identifies version 1 of the additive derivation scheme
+	AdditiveDerivationV1 = "cvc-additive-v1"
+	// AdditiveKeyIDPrefix marks key IDs of keys derived with AdditiveDerivationV1
+	AdditiveKeyIDPrefix = "add1."
+	// ChainCodeSize is the size of a generated chain code in bytes
+	ChainCodeSize = 32
+
+	// issuer masters are derived under their own domain separation tag, so no key context passed to
+	// GenerateSecretKey can select one
+	additiveMasterDSTSuffix = "-" + AdditiveDerivationV1 + "-issuer-master"
+	additiveChainCodeInfo   = AdditiveDerivationV1 + " issuer chain code "
+)
+
+// AdditiveMasterKey is the material a wallet provider hands to an issuer to enable additive derivation
+type AdditiveMasterKey struct {
+	Version   string  // derivation scheme version, AdditiveDerivationV1
+	IssuerID  string  // issuer the master key was derived for; it is part of every additive key ID
+	PublicKey jwk.Key // issuer master public key M_I
+	ChainCode []byte  // confidential chain code shared between wallet provider and issuer
+	Dst       string  // domain separation tag used for the tweak
+}
+
+type additiveMasterKeyJSON struct {
+	Version   string          `json:"version"`
+	IssuerID  string          `json:"issuer_id"`
+	PublicKey json.RawMessage `json:"public_key"`
+	ChainCode []byte          `json:"chain_code"`
+	Dst       string          `json:"dst"`
+}
+
+// MarshalJSON encodes the additive master key for transport to the issuer
+func (k *AdditiveMasterKey) MarshalJSON() ([]byte, error) {
+	pubKeyBytes, err := pkg.KeyJWKToJson(k.PublicKey)
+	if err != nil {
+		return nil, err
+	}
+	return json.Marshal(additiveMasterKeyJSON{
+		Version:   k.Version,
+		IssuerID:  k.IssuerID,
+		PublicKey: pubKeyBytes,
+		ChainCode: k.ChainCode,
+		Dst:       k.Dst,
+	})
+}
+
+// UnmarshalJSON decodes an additive master key produced by MarshalJSON
+func (k *AdditiveMasterKey) UnmarshalJSON(data []byte) error {
+	var temp additiveMasterKeyJSON
+	if err := json.Unmarshal(data, &temp); err != nil {
+		return err
+	}
+	pubKey, err := pkg.KeyJsonToJWK(temp.PublicKey)
+	if err != nil {
+		return err
+	}
+	k.Version = temp.Version
+	k.IssuerID = temp.IssuerID
+	k.PublicKey = pubKey
+	k.ChainCode = temp.ChainCode
+	k.Dst = temp.Dst
+	return nil
+}
+
+// validate checks that the additive master key can be used for derivation
+func (k *AdditiveMasterKey) validate() error {
+	if k.Version != AdditiveDerivationV1 {
+		return internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("unsupported additive derivation version %q", k.Version))
+	}
+	if err := validateAdditiveIssuerID(k.IssuerID); err != nil {
+		return err
+	}
+	if k.PublicKey == nil {
+		return internal.WrapError(internal.ErrInvalidKey, "master public key cannot be nil")
+	}
+	if len(k.ChainCode) < ChainCodeSize {
+		return internal.WrapError(internal.ErrInvalidParameters, "chain code is too short")
+	}
+	if k.Dst == "" {
+		return internal.WrapError(internal.ErrInvalidParameters, "domain separation tag cannot be empty")
+	}
+	return nil
+}
+
+// GenerateChainCode generates a random chain code for additive derivation
+func GenerateChainCode() ([]byte, error) {
+	chainCode := make([]byte, ChainCodeSize)
+	if _, err := rand.Read(chainCode); err != nil {
+		return nil, internal.WrapError(internal.ErrKeyGeneration, "failed to generate chain code")
+	}
+	return chainCode, nil
+}
+
+// IsAdditiveKeyID reports whether a key ID belongs to a key derived with additive derivation
+func IsAdditiveKeyID(keyID string) bool {
+	return strings.HasPrefix(keyID, AdditiveKeyIDPrefix)
+}
+
+// NewAdditiveKeyID generates a key ID for a key derived with additive derivation for an issuer
+func NewAdditiveKeyID(issuerID string) string {
+	return AdditiveKeyIDPrefix + issuerID + "." + pkg.GenerateUUID()
+}
+
+// additiveKeyIssuer returns the issuer ID an additive key ID is bound to
+func additiveKeyIssuer(keyID string) (string, error) {
+	rest := strings.TrimPrefix(keyID, AdditiveKeyIDPrefix)
+	dot := strings.IndexByte(rest, '.')
+	if !IsAdditiveKeyID(keyID) || dot <= 0 || dot == len(rest)-1 {
+		return "", internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("malformed additive key ID %q", keyID))
+	}
+	return rest[:dot], nil
+}
+
+// validateAdditiveIssuerID checks that an issuer ID can be embedded in additive key IDs
+func validateAdditiveIssuerID(issuerID string) error {
+	if issuerID == "" {
+		return internal.WrapError(internal.ErrInvalidParameters, "issuer ID cannot be empty")
+	}
+	if strings.IndexByte(issuerID, '.') >= 0 {
+		return internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("issuer ID %q cannot contain '.'", issuerID))
+	}
+	return nil
+}
+
+// deriveAdditiveTweak computes the tweak t and t*G for the given master public key and context
+func deriveAdditiveTweak(masterPub *AdditiveMasterKey, context []byte) (jwk.Key, error) {
+	if err := masterPub.validate(); err != nil {
+		return nil, err
+	}
+	if err := internal.ValidateNonEmpty(context, "context"); err != nil {
+		return nil, err
+	}
+
+	pubKey, err := extractPublicKey(masterPub.PublicKey, "master public key")
+	if err != nil {
+		return nil, err
+	}
+
+	// bind the tweak to both the chain code and the master public key
+	tweakMaterial, err := internal.DeriveSecretKeySegments([]byte(masterPub.Dst), masterPub.ChainCode, pkg.PublicECDSAToBytes(pubKey), context)
+	if err != nil {
+		return nil, internal.WrapError(err, "tweak derivation failed")
+	}
+
+	tweak, err := keyMaterialToJWK(tweakMaterial)
+	if err != nil {
+		return nil, internal.WrapError(err, "failed to convert tweak to JWK")
+	}
+
+	return tweak, nil
+}
+
+// DeriveAdditivePublicKey derives the child public key M + t*G for the given context. It only needs the
+// master public key and chain code, so issuers can compute wallet provider keys locally.
+func DeriveAdditivePublicKey(masterPub *AdditiveMasterKey, context []byte) (jwk.Key, error) {
+	if masterPub == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "additive master key cannot be nil")
+	}
+
+	tweak, err := deriveAdditiveTweak(masterPub, context)
+	if err != nil {
+		return nil, err
+	}
+
+	childPubKey, err := AddPublicKeys(masterPub.PublicKey, tweak)
+	if err != nil {
+		return nil, internal.WrapError(err, "child public key derivation failed")
+	}
+
+	return childPubKey, nil
+}
+
+// DeriveAdditiveSecretKey derives the child secret key m_I + t matching DeriveAdditivePublicKey for the
+// given context. The master key must be the issuer master secret key whose public part was published in
+// masterPub; wallet providers use ProviderConfig.DeriveAdditiveSecretKey, which derives it.
+func DeriveAdditiveSecretKey(master jwk.Key, masterPub *AdditiveMasterKey, context []byte) (jwk.Key, error) {
+	if master == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "master key cannot be nil")
+	}
+	if masterPub == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "additive master key cannot be nil")
+	}
+
+	tweak, err := deriveAdditiveTweak(masterPub, context)
+	if err != nil {
+		return nil, err
+	}
+
+	// both public parts are known, so the child key pair only costs a point addition
+	childSecretKey, err := AddSecretKeysWithPublic(master, tweak, false)
+	if err != nil {
+		return nil, internal.WrapError(err, "child secret key derivation failed")
+	}
+
+	return childSecretKey, nil
+}
+
+// AdditiveMasterKey returns the additive master key to hand to an issuer. The provider's ChainCode must
+// be set and the issuer must be listed in AdditiveIssuers. The returned chain code is shared with the
+// issuer and must be kept confidential.
+func (c *ProviderConfig) AdditiveMasterKey(issuerID string) (*AdditiveMasterKey, error) {
+	_, masterKey, err := c.additiveIssuerMaster(issuerID, c.Dst)
+	if err != nil {
+		return nil, err
+	}
+	return masterKey, nil
+}
+
+// DeriveAdditiveSecretKey recovers the child secret key of an additive key ID. The issuer is taken from
+// the key ID and must be listed in AdditiveIssuers.
+func (c *ProviderConfig) DeriveAdditiveSecretKey(keyID string, context []byte, dst string) (jwk.Key, error) {
+	issuerID, err := additiveKeyIssuer(keyID)
+	if err != nil {
+		return nil, err
+	}
+	if dst == "" {
+		dst = c.Dst
+	}
+	issuerMaster, masterPub, err := c.additiveIssuerMaster(issuerID, dst)
+	if err != nil {
+		return nil, err
+	}
+	return DeriveAdditiveSecretKey(issuerMaster, masterPub, context)
+}
+
+// additiveIssuerMaster derives the issuer master secret key m_I and the additive master key published
+// for it. m_I comes from DeriveSecretKey, so it cannot be traced back to the MasterSecretKey.
+func (c *ProviderConfig) additiveIssuerMaster(issuerID, dst string) (jwk.Key, *AdditiveMasterKey, error) {
+	if c.MasterSecretKey == nil {
+		return nil, nil, internal.ErrMasterKeyNotSet
+	}
+	if len(c.ChainCode) == 0 {
+		return nil, nil, internal.WrapError(internal.ErrInvalidParameters, "chain code not set")
+	}
+	if c.HybridKEM {
+		return nil, nil, internal.WrapError(internal.ErrInvalidParameters, "additive derivation cannot be combined with HybridKEM")
+	}
+	if err := validateAdditiveIssuerID(issuerID); err != nil {
+		return nil, nil, err
+	}
+	enabled := false
+	for _, id := range c.AdditiveIssuers {
+		if id == issuerID {
+			enabled = true
+			break
+		}
+	}
+	if !enabled {
+		return nil, nil, internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("additive derivation is not enabled for issuer %q", issuerID))
+	}
+
+	issuerMaster, err := DeriveSecretKey(c.MasterSecretKey, []byte(issuerID), []byte(dst+additiveMasterDSTSuffix))
+	if err != nil {
+		return nil, nil, internal.WrapError(err, "issuer master key derivation failed")
+	}
+	masterPub, err := issuerMaster.PublicKey()
+	if err != nil {
+		return nil, nil, internal.WrapError(internal.ErrJWKExtraction, "failed to get issuer master public key")
+	}
+
+	chainKey, err := pkg.NewHMACKey(c.ChainCode)
+	if err != nil {
+		return nil, nil, err
+	}
+	defer chainKey.Wipe()
+	chainCode, err := chainKey.Sum([]byte(additiveChainCodeInfo + issuerID))
+	if err != nil {
+		return nil, nil, err
+	}
+
+	masterKey := &AdditiveMasterKey{
+		Version:   AdditiveDerivationV1,
+		IssuerID:  issuerID,
+		PublicKey: masterPub,
+		ChainCode: chainCode,
+		Dst:       dst,
+	}
+	if err := masterKey.validate(); err != nil {
+		return nil, nil, err
+	}
+
+	return issuerMaster, masterKey, nil
+}
@@ -0,0 +1,213 @@
+package cvc
+
+import (
+	"crypto/ecdsa"
+	"crypto/elliptic"
+	"encoding/base64"
+	"encoding/json"
+	"math/big"
+	"testing"
+
+	"github.com/MyNextID/cvc-go/pkg"
+)
+
+func newAdditiveProvider(t *testing.T) *ProviderConfig {
+	t.Helper()
+
+	masterKey, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate master key: %v", err)
+	}
+	chainCode, err := GenerateChainCode()
+	if err != nil {
+		t.Fatalf("Failed to generate chain code: %v", err)
+	}
+	return &ProviderConfig{MasterSecretKey: masterKey, Dst: "CVC-TEST-DST-v1.0", ChainCode: chainCode, AdditiveIssuers: []string{"issuer-a", "issuer-b"}}
+}
+
+func TestAdditiveDerivation(t *testing.T) {
+	provider := newAdditiveProvider(t)
+	masterPub, err := provider.AdditiveMasterKey("issuer-a")
+	if err != nil {
+		t.Fatalf("AdditiveMasterKey failed: %v", err)
+	}
+
+	t.Run("PublicMatchesSecret", func(t *testing.T) {
+		keyID := NewAdditiveKeyID("issuer-a")
+		context := []byte(keyID + "hash")
+
+		childPub, err := DeriveAdditivePublicKey(masterPub, context)
+		if err != nil {
+			t.Fatalf("DeriveAdditivePublicKey failed: %v", err)
+		}
+		childSec, err := provider.DeriveAdditiveSecretKey(keyID, context, "")
+		if err != nil {
+			t.Fatalf("DeriveAdditiveSecretKey failed: %v", err)
+		}
+
+		var pub ecdsa.PublicKey
+		var sec ecdsa.PrivateKey
+		if err := childPub.Raw(&pub); err != nil {
+			t.Fatalf("Failed to extract child public key: %v", err)
+		}
+		if err := childSec.Raw(&sec); err != nil {
+			t.Fatalf("Failed to extract child secret key: %v", err)
+		}
+		if pub.X.Cmp(sec.X) != 0 || pub.Y.Cmp(sec.Y) != 0 {
+			t.Errorf("Child public key does not match child secret key")
+		}
+
+		// the child secret must not be the master secret
+		var master ecdsa.PrivateKey
+		provider.MasterSecretKey.Raw(&master)
+		if sec.D.Cmp(master.D) == 0 {
+			t.Errorf("Child secret key equals master secret key")
+		}
+	})
+
+	t.Run("IssuerMastersAreIsolated", func(t *testing.T) {
+		other, err := provider.AdditiveMasterKey("issuer-b")
+		if err != nil {
+			t.Fatalf("AdditiveMasterKey failed: %v", err)
+		}
+		var providerPub, pubA, pubB ecdsa.PublicKey
+		var master ecdsa.PrivateKey
+		provider.MasterSecretKey.Raw(&master)
+		providerPub = master.PublicKey
+		masterPub.PublicKey.Raw(&pubA)
+		other.PublicKey.Raw(&pubB)
+		if pubA.Equal(&providerPub) || pubB.Equal(&providerPub) {
+			t.Errorf("Issuer master key is the provider master key")
+		}
+		if pubA.Equal(&pubB) || string(masterPub.ChainCode) == string(other.ChainCode) {
+			t.Errorf("Issuers share additive master material")
+		}
+
+		// a child secret of issuer-a reveals m_a = child - t, which must not open keys of issuer-b
+		keyID := NewAdditiveKeyID("issuer-a")
+		context := []byte(keyID + "hash")
+		childSec, err := provider.DeriveAdditiveSecretKey(keyID, context, "")
+		if err != nil {
+			t.Fatalf("DeriveAdditiveSecretKey failed: %v", err)
+		}
+		tweak, err := deriveAdditiveTweak(masterPub, context)
+		if err != nil {
+			t.Fatalf("deriveAdditiveTweak failed: %v", err)
+		}
+		var child, tw ecdsa.PrivateKey
+		childSec.Raw(&child)
+		tweak.Raw(&tw)
+		recovered := new(big.Int).Sub(child.D, tw.D)
+		recovered.Mod(recovered, elliptic.P256().Params().N)
+		if recovered.Cmp(master.D) == 0 {
+			t.Errorf("Child secret key reveals the provider master secret key")
+		}
+		if x, _ := elliptic.P256().ScalarBaseMult(recovered.FillBytes(make([]byte, 32))); x.Cmp(pubA.X) != 0 {
+			t.Errorf("Recovered scalar is not the issuer master key")
+		}
+	})
+
+	t.Run("RejectsUnboundKeyIDs", func(t *testing.T) {
+		if _, err := provider.AdditiveMasterKey("issuer-c"); err == nil {
+			t.Errorf("Expected error for an issuer without additive derivation")
+		}
+		if _, err := provider.AdditiveMasterKey("issuer.a"); err == nil {
+			t.Errorf("Expected error for an issuer ID containing '.'")
+		}
+		for _, keyID := range []string{NewAdditiveKeyID("issuer-c"), AdditiveKeyIDPrefix + pkg.GenerateUUID(), AdditiveKeyIDPrefix + "issuer-a."} {
+			request, _ := json.Marshal(SecretKeyData{KeyId: keyID, Salt: []byte("salt"), Email: "alice@example.com"})
+			if _, err := provider.GenerateSecretKey(request, ""); err == nil {
+				t.Errorf("GenerateSecretKey accepted key ID %q", keyID)
+			}
+		}
+	})
+
+	t.Run("ChainCodeChangesKeys", func(t *testing.T) {
+		context := []byte("context")
+		other := *masterPub
+		other.ChainCode = make([]byte, ChainCodeSize)
+
+		key1, err := DeriveAdditivePublicKey(masterPub, context)
+		if err != nil {
+			t.Fatalf("DeriveAdditivePublicKey failed: %v", err)
+		}
+		key2, err := DeriveAdditivePublicKey(&other, context)
+		if err != nil {
+			t.Fatalf("DeriveAdditivePublicKey failed: %v", err)
+		}
+
+		var pub1, pub2 ecdsa.PublicKey
+		key1.Raw(&pub1)
+		key2.Raw(&pub2)
+		if pub1.X.Cmp(pub2.X) == 0 {
+			t.Errorf("Different chain codes produced the same child key")
+		}
+	})
+
+	t.Run("RejectsUnknownVersion", func(t *testing.T) {
+		other := *masterPub
+		other.Version = "cvc-additive-v0"
+		if _, err := DeriveAdditivePublicKey(&other, []byte("context")); err == nil {
+			t.Errorf("Expected error for unsupported version")
+		}
+	})
+
+	t.Run("JSONRoundTrip", func(t *testing.T) {
+		data, err := json.Marshal(masterPub)
+		if err != nil {
+			t.Fatalf("Failed to marshal additive master key: %v", err)
+		}
+		var decoded AdditiveMasterKey
+		if err := json.Unmarshal(data, &decoded); err != nil {
+			t.Fatalf("Failed to unmarshal additive master key: %v", err)
+		}
+		if decoded.Version != masterPub.Version || decoded.IssuerID != masterPub.IssuerID || decoded.Dst != masterPub.Dst || string(decoded.ChainCode) != string(masterPub.ChainCode) {
+			t.Errorf("Decoded additive master key does not match")
+		}
+	})
+
+	t.Run("ProviderFreeIssuance", func(t *testing.T) {
+		// no wallet provider is reachable at this URL
+		issuer := &IssuerConfig{ProviderURL: "http://127.0.0.1:1", AdditiveMasterKey: masterPub}
+
+		userMap, err := issuer.GetPublicKeysFromWalletProvider(map[string]string{"u1": "alice@example.com"})
+		if err != nil {
+			t.Fatalf("GetPublicKeysFromWalletProvider failed: %v", err)
+		}
+		userData := userMap["u1"]
+		if !IsAdditiveKeyID(userData.KeyID) {
+			t.Fatalf("Key ID %q is not marked as additive", userData.KeyID)
+		}
+
+		// the wallet provider recovers the matching secret key later
+		request, _ := json.Marshal(SecretKeyData{KeyId: userData.KeyID, Salt: userData.Salt, Email: userData.Email})
+		secKeyBytes, err := provider.GenerateSecretKey(request, "")
+		if err != nil {
+			t.Fatalf("GenerateSecretKey failed: %v", err)
+		}
+		secKey, err := pkg.KeyJsonToJWK(secKeyBytes)
+		if err != nil {
+			t.Fatalf("Failed to parse secret key: %v", err)
+		}
+
+		var pub ecdsa.PublicKey
+		var sec ecdsa.PrivateKey
+		userData.WpPubKey.Raw(&pub)
+		secKey.Raw(&sec)
+		if pub.X.Cmp(sec.X) != 0 || pub.Y.Cmp(sec.Y) != 0 {
+			t.Errorf("Recovered secret key does not match locally derived public key")
+		}
+
+		// the same context derived the non-additive way gives a different key
+		hash := base64.StdEncoding.EncodeToString(pkg.Hash(append([]byte(userData.Email), userData.Salt...)))
+		legacy, err := DeriveSecretKey(provider.MasterSecretKey, append([]byte(userData.KeyID), hash...), []byte(provider.Dst))
+		if err != nil {
+			t.Fatalf("DeriveSecretKey failed: %v", err)
+		}
+		var legacyKey ecdsa.PrivateKey
+		legacy.Raw(&legacyKey)
+		if legacyKey.D.Cmp(sec.D) == 0 {
+			t.Errorf("Additive and legacy derivation produced the same key")
+		}
+	})
+}
@@ -0,0 +1,194 @@
+package cvc
+
+import (
+	"bytes"
+	"encoding/json"
+	"testing"
+
+	"github.com/MyNextID/cvc-go/pkg"
+	"github.com/lestrrat-go/jwx/v2/jwa"
+	"github.com/lestrrat-go/jwx/v2/jwe"
+	"github.com/shamaton/msgpack/v2"
+)
+
+func TestBinaryJWE(t *testing.T) {
+	secretKey, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate key: %v", err)
+	}
+	publicKey, _ := secretKey.PublicKey()
+	payload := bytes.Repeat([]byte("credential "), 100)
+
+	t.Run("NativeRoundTrip", func(t *testing.T) {
+		binJWE, err := pkg.EncryptBinaryJWE(payload, publicKey)
+		if err != nil {
+			t.Fatalf("EncryptBinaryJWE failed: %v", err)
+		}
+		if len(binJWE.Ciphertext) != len(payload) || len(binJWE.Tag) != 16 || len(binJWE.IV) != 12 {
+			t.Errorf("Unexpected part sizes")
+		}
+		var header map[string]interface{}
+		if err := json.Unmarshal(binJWE.Protected, &header); err != nil || header["alg"] != "ECDH-ES" || header["enc"] != "A256GCM" {
+			t.Errorf("Unexpected protected header %s", binJWE.Protected)
+		}
+
+		decrypted, err := pkg.DecryptBinaryJWE(binJWE, secretKey)
+		if err != nil {
+			t.Fatalf("DecryptBinaryJWE failed: %v", err)
+		}
+		if !bytes.Equal(decrypted, payload) {
+			t.Errorf("Decrypted payload does not match")
+		}
+	})
+
+	t.Run("CompactInterop", func(t *testing.T) {
+		// binary JWE must be readable by the JWE library
+		binJWE, err := pkg.EncryptBinaryJWE(payload, publicKey)
+		if err != nil {
+			t.Fatalf("EncryptBinaryJWE failed: %v", err)
+		}
+		decrypted, err := pkg.DecryptWithSecretKey(binJWE.Compact(), secretKey)
+		if err != nil {
+			t.Fatalf("DecryptWithSecretKey failed on converted JWE: %v", err)
+		}
+		if !bytes.Equal(decrypted, payload) {
+			t.Errorf("Decrypted payload does not match")
+		}
+
+		// and JWE library output must convert to binary without loss
+		compact, err := pkg.EncryptWithPublicKey(payload, publicKey)
+		if err != nil {
+			t.Fatalf("EncryptWithPublicKey failed: %v", err)
+		}
+		parsed, err := pkg.ParseCompactJWE(compact)
+		if err != nil {
+			t.Fatalf("ParseCompactJWE failed: %v", err)
+		}
+		if !bytes.Equal(parsed.Compact(), compact) {
+			t.Errorf("Compact JWE did not survive round trip")
+		}
+		decrypted, err = pkg.DecryptBinaryJWE(parsed, secretKey)
+		if err != nil {
+			t.Fatalf("DecryptBinaryJWE failed on parsed JWE: %v", err)
+		}
+		if !bytes.Equal(decrypted, payload) {
+			t.Errorf("Decrypted payload does not match")
+		}
+	})
+
+	t.Run("NonNativeAlgorithm", func(t *testing.T) {
+		// envelopes that are not ECDH-ES, A256GCM are still opened, through the JWE library
+		compact, err := jwe.Encrypt(payload, jwe.WithKey(jwa.ECDH_ES, publicKey), jwe.WithContentEncryption(jwa.A128GCM))
+		if err != nil {
+			t.Fatalf("Encrypt failed: %v", err)
+		}
+		binJWE, err := pkg.ParseCompactJWE(compact)
+		if err != nil {
+			t.Fatalf("ParseCompactJWE failed: %v", err)
+		}
+		decrypted, err := DecryptVC(&MessagePack{EncVCBinary: binJWE}, secretKey)
+		if err != nil {
+			t.Fatalf("DecryptVC failed: %v", err)
+		}
+		if !bytes.Equal(decrypted, payload) {
+			t.Errorf("Decrypted payload does not match")
+		}
+	})
+
+	t.Run("Tampered", func(t *testing.T) {
+		binJWE, _ := pkg.EncryptBinaryJWE(payload, publicKey)
+		binJWE.Protected = append([]byte{}, binJWE.Protected...)
+		binJWE.Protected = bytes.Replace(binJWE.Protected, []byte(`"enc":"A256GCM"`), []byte(`"enc":"A256GCM" `), 1)
+		if _, err := pkg.DecryptBinaryJWE(binJWE, secretKey); err == nil {
+			t.Errorf("Expected error for modified protected header")
+		}
+	})
+
+	t.Run("InvalidCompact", func(t *testing.T) {
+		if _, err := pkg.ParseCompactJWE([]byte("a.b.c")); err == nil {
+			t.Errorf("Expected error for JWE with three parts")
+		}
+		if _, err := pkg.ParseCompactJWE([]byte("a!.b.c.d.e")); err == nil {
+			t.Errorf("Expected error for invalid base64url")
+		}
+	})
+}
+
+func TestBinaryEncVCMessagePack(t *testing.T) {
+	wpSecKey, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate key: %v", err)
+	}
+	wpPubKey, _ := wpSecKey.PublicKey()
+	credential := bytes.Repeat([]byte("eyJhbGciOiJFUzI1NiJ9"), 200)
+
+	userMap := map[string]*UserData{"user": {Email: "user@example.com", KeyID: "key", WpPubKey: wpPubKey}}
+	issuer := &IssuerConfig{BinaryEncVC: true}
+	if _, _, err := issuer.AddCnfToPayload("user", map[string]interface{}{}, userMap); err != nil {
+		t.Fatalf("AddCnfToPayload failed: %v", err)
+	}
+	packBytes, err := issuer.PrepareMessagePack(credential, "user", userMap, nil, nil)
+	if err != nil {
+		t.Fatalf("PrepareMessagePack failed: %v", err)
+	}
+	var pack MessagePack
+	if err := msgpack.Unmarshal(packBytes, &pack); err != nil {
+		t.Fatalf("Failed to unmarshal message pack: %v", err)
+	}
+	if pack.EncVCBinary == nil || len(pack.EncVC) != 0 {
+		t.Fatalf("Expected binary EncVC only")
+	}
+
+	vcSecKey, err := DecryptVCSecretKey(&pack, wpSecKey)
+	if err != nil {
+		t.Fatalf("DecryptVCSecretKey failed: %v", err)
+	}
+	decrypted, err := DecryptVC(&pack, vcSecKey)
+	if err != nil {
+		t.Fatalf("DecryptVC failed: %v", err)
+	}
+	if !bytes.Equal(decrypted, credential) {
+		t.Errorf("Decrypted credential does not match")
+	}
+
+	compact, err := pack.CompactEncVC()
+	if err != nil {
+		t.Fatalf("CompactEncVC failed: %v", err)
+	}
+	decrypted, err = pkg.DecryptWithSecretKey(compact, vcSecKey)
+	if err != nil {
+		t.Fatalf("DecryptWithSecretKey failed on compact EncVC: %v", err)
+	}
+	if !bytes.Equal(decrypted, credential) {
+		t.Errorf("Decrypted credential does not match")
+	}
+
+	binarySize := len(pack.EncVCBinary.Protected) + len(pack.EncVCBinary.IV) + len(pack.EncVCBinary.Ciphertext) + len(pack.EncVCBinary.Tag)
+	if binarySize >= len(compact)*4/5 {
+		t.Errorf("Binary EncVC (%d bytes) is not smaller than compact JWE (%d bytes)", binarySize, len(compact))
+	}
+}
+
+func BenchmarkEncVCEnvelope(b *testing.B) {
+	secretKey, _ := GenerateSecretKey()
+	publicKey, _ := secretKey.PublicKey()
+	payload := bytes.Repeat([]byte("a"), 64*1024)
+
+	b.Run("CompactJWE", func(b *testing.B) {
+		b.SetBytes(int64(len(payload)))
+		for i := 0; i < b.N; i++ {
+			if _, err := pkg.EncryptWithPublicKey(payload, publicKey); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("BinaryJWE", func(b *testing.B) {
+		b.SetBytes(int64(len(payload)))
+		for i := 0; i < b.N; i++ {
+			if _, err := pkg.EncryptBinaryJWE(payload, publicKey); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+}
@@ -0,0 +1,501 @@
+package cvc
+
+import (
+	"bytes"
+	"encoding/json"
+	"fmt"
+	"strconv"
+	"strings"
+
+	"github.com/MyNextID/cvc-go/internal"
+)
+
+// maxClaimDepth bounds the nesting of claim values, as encoding/json does
+const maxClaimDepth = 10000
+
+// Claims is a lazily indexed view of a JSON object, usually a verified JWT payload. Top-level claims
+// are indexed by a forward scan that stops at the requested claim, so verifiers that only read a few
+// claims of a large credential do not pay for decoding the rest of it. Values are returned as
+// sub-slices of the payload without copying and must not be modified.
+//
+// Lookups stop at the first claim with the requested name. Duplicate names, which RFC 7519 allows
+// parsers to reject, are reported as malformed once the scan reaches the second one, and syntax errors
+// are reported by the lookup whose scan runs into them, so a lookup can succeed before either is seen.
+// Validate indexes the whole top level up front; VerifyJWSClaims does so before returning. A Claims is
+// not safe for concurrent use.
+type Claims struct {
+	payload []byte
+	index   map[string]claimSpan
+	scan    objectScanner
+}
+
+// claimSpan is the offset range of a value in the payload
+type claimSpan struct {
+	start, end int
+}
+
+// ParseClaims prepares payload for claim lookups. Only the opening brace is checked here; the
+// members are indexed as lookups need them.
+func ParseClaims(payload []byte) (*Claims, error) {
+	start := skipSpace(payload, 0)
+	if start >= len(payload) || payload[start] != '{' {
+		return nil, internal.WrapError(internal.ErrClaimFormat, "claims must be a JSON object")
+	}
+	return &Claims{
+		payload: payload,
+		scan:    objectScanner{data: payload, pos: start + 1, top: true},
+	}, nil
+}
+
+// parseVerifiedClaims parses a verified JWT payload and indexes its top level, so that no claim can be
+// read from a payload with duplicate claims or trailing garbage
+func parseVerifiedClaims(payload []byte) (*Claims, error) {
+	claims, err := ParseClaims(payload)
+	if err != nil {
+		return nil, err
+	}
+	if err := claims.Validate(); err != nil {
+		return nil, err
+	}
+	return claims, nil
+}
+
+// Validate indexes the remaining top-level claims and reports duplicate names and syntax errors
+// anywhere in the payload. Nested values are checked for syntax as they are skipped.
+func (c *Claims) Validate() error {
+	for {
+		_, _, ok, err := c.indexNext()
+		if err != nil || !ok {
+			return err
+		}
+	}
+}
+
+// Raw returns the JSON encoding of the named top-level claim
+func (c *Claims) Raw(name string) ([]byte, error) {
+	span, err := c.lookup(name)
+	if err != nil {
+		return nil, err
+	}
+	return c.payload[span.start:span.end:span.end], nil
+}
+
+// Pointer returns the JSON encoding of the value an RFC 6901 JSON Pointer refers to. The top-level
+// claim is found through the index; nested objects and arrays are scanned only up to the member or
+// element the pointer names.
+func (c *Claims) Pointer(pointer string) ([]byte, error) {
+	if pointer == "" {
+		return c.payload, nil
+	}
+	if pointer[0] != '/' {
+		return nil, internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("invalid JSON Pointer %q", pointer))
+	}
+	tokens := strings.Split(pointer[1:], "/")
+	for i, token := range tokens {
+		tokens[i] = strings.ReplaceAll(strings.ReplaceAll(token, "~1", "/"), "~0", "~")
+	}
+
+	span, err := c.lookup(tokens[0])
+	if err != nil {
+		return nil, err
+	}
+	for _, token := range tokens[1:] {
+		switch c.payload[span.start] {
+		case '{':
+			span, err = c.member(span, token)
+		case '[':
+			span, err = c.element(span, token)
+		default:
+			err = internal.WrapError(internal.ErrClaimNotFound, fmt.Sprintf("%s does not reach into an object or array", pointer))
+		}
+		if err != nil {
+			return nil, err
+		}
+	}
+	return c.payload[span.start:span.end:span.end], nil
+}
+
+// String returns the named claim, which must be a JSON string
+func (c *Claims) String(name string) (string, error) {
+	raw, err := c.Raw(name)
+	if err != nil {
+		return "", err
+	}
+	if raw[0] != '"' {
+		return "", internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("claim %s is not a string", name))
+	}
+	body := raw[1 : len(raw)-1]
+	if bytes.IndexByte(body, '\\') < 0 {
+		return string(body), nil
+	}
+	var s string
+	if err := json.Unmarshal(raw, &s); err != nil {
+		return "", internal.WrapError(internal.ErrClaimFormat, fmt.Sprintf("claim %s is not a valid string", name))
+	}
+	return s, nil
+}
+
+// Int64 returns the named claim, which must be a JSON number. Fractional NumericDate values such as
+// exp, nbf and iat are truncated to whole seconds.
+func (c *Claims) Int64(name string) (int64, error) {
+	raw, err := c.Raw(name)
+	if err != nil {
+		return 0, err
+	}
+	if raw[0] != '-' && (raw[0] < '0' || raw[0] > '9') {
+		return 0, internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("claim %s is not a number", name))
+	}
+	if n, err := strconv.ParseInt(string(raw), 10, 64); err == nil {
+		return n, nil
+	}
+	f, err := strconv.ParseFloat(string(raw), 64)
+	if err != nil || f < -(1<<63) || f >= 1<<63 {
+		return 0, internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("claim %s is out of range", name))
+	}
+	return int64(f), nil
+}
+
+// Unmarshal decodes the named claim into v with encoding/json
+func (c *Claims) Unmarshal(name string, v interface{}) error {
+	raw, err := c.Raw(name)
+	if err != nil {
+		return err
+	}
+	return json.Unmarshal(raw, v)
+}
+
+// lookup finds a top-level claim, extending the index until it is found or the object ends
+func (c *Claims) lookup(name string) (claimSpan, error) {
+	if span, ok := c.index[name]; ok {
+		return span, nil
+	}
+	for {
+		k, span, ok, err := c.indexNext()
+		if err != nil {
+			return claimSpan{}, err
+		}
+		if !ok {
+			return claimSpan{}, internal.WrapError(internal.ErrClaimNotFound, fmt.Sprintf("claim %s not found", name))
+		}
+		if k == name {
+			return span, nil
+		}
+	}
+}
+
+// indexNext adds the next top-level claim to the index, or returns ok == false at the end of the object
+func (c *Claims) indexNext() (string, claimSpan, bool, error) {
+	key, escaped, span, ok, err := c.scan.next()
+	if err != nil || !ok {
+		return "", claimSpan{}, false, err
+	}
+	k, err := claimName(c.payload, key, escaped)
+	if err != nil {
+		return "", claimSpan{}, false, err
+	}
+	if _, dup := c.index[k]; dup {
+		c.scan.err = internal.WrapError(internal.ErrClaimFormat, fmt.Sprintf("duplicate claim %s", k))
+		return "", claimSpan{}, false, c.scan.err
+	}
+	if c.index == nil {
+		c.index = make(map[string]claimSpan, 8)
+	}
+	c.index[k] = span
+	return k, span, true, nil
+}
+
+// member finds a member of the object at span without indexing it
+func (c *Claims) member(span claimSpan, name string) (claimSpan, error) {
+	scan := objectScanner{data: c.payload[:span.end], pos: span.start + 1}
+	for {
+		key, escaped, value, ok, err := scan.next()
+		if err != nil {
+			return claimSpan{}, err
+		}
+		if !ok {
+			return claimSpan{}, internal.WrapError(internal.ErrClaimNotFound, fmt.Sprintf("member %s not found", name))
+		}
+		if !escaped {
+			if string(c.payload[key.start+1:key.end-1]) == name {
+				return value, nil
+			}
+			continue
+		}
+		if k, err := claimName(c.payload, key, true); err != nil {
+			return claimSpan{}, err
+		} else if k == name {
+			return value, nil
+		}
+	}
+}
+
+// element finds the element of the array at span that an array index token names
+func (c *Claims) element(span claimSpan, token string) (claimSpan, error) {
+	index, err := strconv.Atoi(token)
+	if err != nil || index < 0 || (len(token) > 1 && token[0] == '0') {
+		return claimSpan{}, internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("invalid array index %q", token))
+	}
+
+	b := c.payload[:span.end]
+	i := skipSpace(b, span.start+1)
+	if i < len(b) && b[i] == ']' {
+		return claimSpan{}, internal.WrapError(internal.ErrClaimNotFound, fmt.Sprintf("array index %d out of range", index))
+	}
+	for n := 0; ; n++ {
+		end, err := skipValue(b, i, 1)
+		if err != nil {
+			return claimSpan{}, err
+		}
+		if n == index {
+			return claimSpan{i, end}, nil
+		}
+		i = skipSpace(b, end)
+		if i < len(b) && b[i] == ',' {
+			i = skipSpace(b, i+1)
+			continue
+		}
+		return claimSpan{}, internal.WrapError(internal.ErrClaimNotFound, fmt.Sprintf("array index %d out of range", index))
+	}
+}
+
+// objectScanner walks the members of a JSON object one at a time, validating each value it skips.
+// pos starts just after the opening brace.
+type objectScanner struct {
+	data  []byte
+	pos   int
+	top   bool // the object is the whole document, so only whitespace may follow it
+	count int
+	done  bool
+	err   error
+}
+
+// next returns the span of the quoted key and of the value of the next member, or ok == false at the
+// end of the object. Errors are sticky.
+func (s *objectScanner) next() (key claimSpan, escaped bool, value claimSpan, ok bool, err error) {
+	if s.err != nil || s.done {
+		return claimSpan{}, false, claimSpan{}, false, s.err
+	}
+	b := s.data
+	i := skipSpace(b, s.pos)
+	if i < len(b) && b[i] == '}' {
+		s.done = true
+		if s.top && skipSpace(b, i+1) != len(b) {
+			s.err = claimSyntaxError(b, skipSpace(b, i+1))
+		}
+		return claimSpan{}, false, claimSpan{}, false, s.err
+	}
+	if s.count > 0 {
+		if i >= len(b) || b[i] != ',' {
+			s.err = claimSyntaxError(b, i)
+			return claimSpan{}, false, claimSpan{}, false, s.err
+		}
+		i = skipSpace(b, i+1)
+	}
+
+	if i >= len(b) || b[i] != '"' {
+		s.err = claimSyntaxError(b, i)
+		return claimSpan{}, false, claimSpan{}, false, s.err
+	}
+	keyEnd, escaped, err := scanString(b, i)
+	if err != nil {
+		s.err = err
+		return claimSpan{}, false, claimSpan{}, false, err
+	}
+	key = claimSpan{i, keyEnd}
+
+	i = skipSpace(b, keyEnd)
+	if i >= len(b) || b[i] != ':' {
+		s.err = claimSyntaxError(b, i)
+		return claimSpan{}, false, claimSpan{}, false, s.err
+	}
+	i = skipSpace(b, i+1)
+	end, err := skipValue(b, i, 1)
+	if err != nil {
+		s.err = err
+		return claimSpan{}, false, claimSpan{}, false, err
+	}
+
+	s.pos = end
+	s.count++
+	return key, escaped, claimSpan{i, end}, true, nil
+}
+
+// claimName returns the unquoted member name at key
+func claimName(b []byte, key claimSpan, escaped bool) (string, error) {
+	if !escaped {
+		return string(b[key.start+1 : key.end-1]), nil
+	}
+	var name string
+	if err := json.Unmarshal(b[key.start:key.end], &name); err != nil {
+		return "", internal.WrapError(internal.ErrClaimFormat, fmt.Sprintf("invalid member name at offset %d", key.start))
+	}
+	return name, nil
+}
+
+func skipSpace(b []byte, i int) int {
+	for i < len(b) && (b[i] == ' ' || b[i] == '\t' || b[i] == '\n' || b[i] == '\r') {
+		i++
+	}
+	return i
+}
+
+// skipValue returns the offset just after the JSON value starting at i
+func skipValue(b []byte, i, depth int) (int, error) {
+	if i >= len(b) {
+		return 0, claimSyntaxError(b, i)
+	}
+	switch b[i] {
+	case '"':
+		end, _, err := scanString(b, i)
+		return end, err
+	case '{', '[':
+		if depth > maxClaimDepth {
+			return 0, internal.WrapError(internal.ErrClaimFormat, fmt.Sprintf("claims nested too deeply at offset %d", i))
+		}
+		return skipContainer(b, i, depth)
+	case 't':
+		return skipLiteral(b, i, "true")
+	case 'f':
+		return skipLiteral(b, i, "false")
+	case 'n':
+		return skipLiteral(b, i, "null")
+	default:
+		return scanNumber(b, i)
+	}
+}
+
+// skipContainer skips the object or array starting at i
+func skipContainer(b []byte, i, depth int) (int, error) {
+	closing := byte(']')
+	if b[i] == '{' {
+		closing = '}'
+	}
+	i = skipSpace(b, i+1)
+	if i < len(b) && b[i] == closing {
+		return i + 1, nil
+	}
+	for {
+		if closing == '}' {
+			if i >= len(b) || b[i] != '"' {
+				return 0, claimSyntaxError(b, i)
+			}
+			end, _, err := scanString(b, i)
+			if err != nil {
+				return 0, err
+			}
+			i = skipSpace(b, end)
+			if i >= len(b) || b[i] != ':' {
+				return 0, claimSyntaxError(b, i)
+			}
+			i = skipSpace(b, i+1)
+		}
+		end, err := skipValue(b, i, depth+1)
+		if err != nil {
+			return 0, err
+		}
+		i = skipSpace(b, end)
+		if i >= len(b) {
+			return 0, claimSyntaxError(b, i)
+		}
+		switch b[i] {
+		case ',':
+			i = skipSpace(b, i+1)
+		case closing:
+			return i + 1, nil
+		default:
+			return 0, claimSyntaxError(b, i)
+		}
+	}
+}
+
+// scanString returns the offset just after the string starting at i and whether it contains escapes
+func scanString(b []byte, i int) (int, bool, error) {
+	escaped := false
+	for j := i + 1; j < len(b); j++ {
+		switch c := b[j]; {
+		case c == '"':
+			return j + 1, escaped, nil
+		case c == '\\':
+			escaped = true
+			j++
+			if j >= len(b) {
+				return 0, false, claimSyntaxError(b, j)
+			}
+			switch b[j] {
+			case '"', '\\', '/', 'b', 'f', 'n', 'r', 't':
+			case 'u':
+				if j+4 >= len(b) || !isHex(b[j+1]) || !isHex(b[j+2]) || !isHex(b[j+3]) || !isHex(b[j+4]) {
+					return 0, false, claimSyntaxError(b, j)
+				}
+				j += 4
+			default:
+				return 0, false, claimSyntaxError(b, j)
+			}
+		case c < 0x20:
+			return 0, false, claimSyntaxError(b, j)
+		}
+	}
+	return 0, false, claimSyntaxError(b, len(b))
+}
+
+// scanNumber returns the offset just after the number starting at i
+func scanNumber(b []byte, i int) (int, error) {
+	start := i
+	if i < len(b) && b[i] == '-' {
+		i++
+	}
+	switch {
+	case i < len(b) && b[i] == '0':
+		i++
+	case i < len(b) && b[i] >= '1' && b[i] <= '9':
+		i = skipDigits(b, i)
+	default:
+		return 0, claimSyntaxError(b, start)
+	}
+	if i < len(b) && b[i] == '.' {
+		if i+1 >= len(b) || !isDigit(b[i+1]) {
+			return 0, claimSyntaxError(b, i)
+		}
+		i = skipDigits(b, i+1)
+	}
+	if i < len(b) && (b[i] == 'e' || b[i] == 'E') {
+		i++
+		if i < len(b) && (b[i] == '+' || b[i] == '-') {
+			i++
+		}
+		if i >= len(b) || !isDigit(b[i]) {
+			return 0, claimSyntaxError(b, i)
+		}
+		i = skipDigits(b, i)
+	}
+	return i, nil
+}
+
+func skipLiteral(b []byte, i int, literal string) (int, error) {
+	if len(b)-i < len(literal) || string(b[i:i+len(literal)]) != literal {
+		return 0, claimSyntaxError(b, i)
+	}
+	return i + len(literal), nil
+}
+
+func skipDigits(b []byte, i int) int {
+	for i < len(b) && isDigit(b[i]) {
+		i++
+	}
+	return i
+}
+
+func isDigit(c byte) bool {
+	return c >= '0' && c <= '9'
+}
+
+func isHex(c byte) bool {
+	return isDigit(c) || (c|0x20 >= 'a' && c|0x20 <= 'f')
+}
+
+func claimSyntaxError(b []byte, i int) error {
+	if i >= len(b) {
+		return internal.WrapError(internal.ErrClaimFormat, "unexpected end of claims")
+	}
+	return internal.WrapError(internal.ErrClaimFormat, fmt.Sprintf("unexpected %q at offset %d", b[i], i))
+}
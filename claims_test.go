@@ -0,0 +1,306 @@
+package cvc
+
+import (
+	"bytes"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"strings"
+	"testing"
+
+	"github.com/MyNextID/cvc-go/internal"
+)
+
+// testCredentialPayload returns a VC-shaped JWT payload whose large vc claim, with evidence entries,
+// sits between the claims verifiers usually read
+func testCredentialPayload(evidence int) []byte {
+	items := make([]string, evidence)
+	for i := range items {
+		items[i] = fmt.Sprintf(`{"id":"urn:evidence:%d","type":["DocumentVerification"],"verifier":"did:example:verifier","evidenceDocument":"Passport","subjectPresence":"Physical","documentPresence":"Physical","licenseNumber":"%08d"}`, i, i)
+	}
+	return []byte(`{"iss":"did:example:issuer","nbf":1700000000,"exp":1900000000.5,` +
+		`"vc":{"@context":["https://www.w3.org/2018/credentials/v1"],"type":["VerifiableCredential","IdentityCredential"],` +
+		`"credentialSubject":{"id":"did:example:holder","given_name":"Jane","family_name":"Doe","email":"jane.doe@example.com"},` +
+		`"evidence":[` + strings.Join(items, ",") + `]},` +
+		`"cnf":{"jwk":{"kty":"EC","crv":"P-256","x":"f83OJ3D2xF1Bg8vub9tLe1gHMzV76e8Tus9uPHvRVEU","y":"x_FEzRu9m36HLN_tue659LNpXW6pCyStikYjKIWI5a0"}},` +
+		`"sub":"did:example:holder","a~b/c":"escaped \"name\""}`)
+}
+
+func TestClaims(t *testing.T) {
+	payload := testCredentialPayload(16)
+
+	t.Run("TopLevelClaimsMatchEncodingJSON", func(t *testing.T) {
+		var want map[string]json.RawMessage
+		if err := json.Unmarshal(payload, &want); err != nil {
+			t.Fatalf("json.Unmarshal failed: %v", err)
+		}
+		claims, err := ParseClaims(payload)
+		if err != nil {
+			t.Fatalf("ParseClaims failed: %v", err)
+		}
+		// read in reverse payload order, so the first lookup indexes the whole object
+		for _, name := range []string{"a~b/c", "sub", "cnf", "vc", "exp", "nbf", "iss"} {
+			raw, err := claims.Raw(name)
+			if err != nil {
+				t.Fatalf("Raw(%q) failed: %v", name, err)
+			}
+			if !bytes.Equal(raw, want[name]) {
+				t.Errorf("Raw(%q) = %s, want %s", name, raw, want[name])
+			}
+		}
+	})
+
+	t.Run("ValuesAliasPayload", func(t *testing.T) {
+		claims, err := ParseClaims(payload)
+		if err != nil {
+			t.Fatalf("ParseClaims failed: %v", err)
+		}
+		raw, err := claims.Raw("iss")
+		if err != nil {
+			t.Fatalf("Raw failed: %v", err)
+		}
+		if &raw[0] != &payload[7] {
+			t.Error("Raw copied the claim instead of returning a slice of the payload")
+		}
+		if cap(raw) != len(raw) {
+			t.Error("Raw result can be appended into the rest of the payload")
+		}
+	})
+
+	t.Run("TypedAccessors", func(t *testing.T) {
+		claims, err := ParseClaims(payload)
+		if err != nil {
+			t.Fatalf("ParseClaims failed: %v", err)
+		}
+		if iss, err := claims.String("iss"); err != nil || iss != "did:example:issuer" {
+			t.Errorf("String(iss) = %q, %v", iss, err)
+		}
+		if name, err := claims.String("a~b/c"); err != nil || name != `escaped "name"` {
+			t.Errorf("String(a~b/c) = %q, %v", name, err)
+		}
+		if exp, err := claims.Int64("exp"); err != nil || exp != 1900000000 {
+			t.Errorf("Int64(exp) = %d, %v", exp, err)
+		}
+		if nbf, err := claims.Int64("nbf"); err != nil || nbf != 1700000000 {
+			t.Errorf("Int64(nbf) = %d, %v", nbf, err)
+		}
+		var cnf struct {
+			JWK map[string]string `json:"jwk"`
+		}
+		if err := claims.Unmarshal("cnf", &cnf); err != nil || cnf.JWK["crv"] != "P-256" {
+			t.Errorf("Unmarshal(cnf) = %v, %v", cnf, err)
+		}
+		if _, err := claims.String("nbf"); !errors.Is(err, internal.ErrInvalidParameters) {
+			t.Errorf("String of a number: got %v, want ErrInvalidParameters", err)
+		}
+		if _, err := claims.Int64("iss"); !errors.Is(err, internal.ErrInvalidParameters) {
+			t.Errorf("Int64 of a string: got %v, want ErrInvalidParameters", err)
+		}
+	})
+
+	t.Run("Pointer", func(t *testing.T) {
+		claims, err := ParseClaims(payload)
+		if err != nil {
+			t.Fatalf("ParseClaims failed: %v", err)
+		}
+		tests := []struct {
+			pointer string
+			want    string
+		}{
+			{"/vc/credentialSubject/id", `"did:example:holder"`},
+			{"/vc/type/1", `"IdentityCredential"`},
+			{"/vc/evidence/15/licenseNumber", `"00000015"`},
+			{"/cnf/jwk/crv", `"P-256"`},
+			{"/a~0b~1c", `"escaped \"name\""`},
+			{"", string(payload)},
+		}
+		for _, tt := range tests {
+			raw, err := claims.Pointer(tt.pointer)
+			if err != nil {
+				t.Errorf("Pointer(%q) failed: %v", tt.pointer, err)
+				continue
+			}
+			if string(raw) != tt.want {
+				t.Errorf("Pointer(%q) = %s, want %s", tt.pointer, raw, tt.want)
+			}
+		}
+
+		for _, pointer := range []string{"/missing", "/vc/missing", "/vc/evidence/16", "/iss/x"} {
+			if _, err := claims.Pointer(pointer); !errors.Is(err, internal.ErrClaimNotFound) {
+				t.Errorf("Pointer(%q): got %v, want ErrClaimNotFound", pointer, err)
+			}
+		}
+		for _, pointer := range []string{"vc", "/vc/type/01", "/vc/type/-1"} {
+			if _, err := claims.Pointer(pointer); !errors.Is(err, internal.ErrInvalidParameters) {
+				t.Errorf("Pointer(%q): got %v, want ErrInvalidParameters", pointer, err)
+			}
+		}
+	})
+
+	t.Run("LookupsOnlyScanWhatTheyNeed", func(t *testing.T) {
+		claims, err := ParseClaims([]byte(`{"iss":"a","exp":1, "broken": tru}`))
+		if err != nil {
+			t.Fatalf("ParseClaims failed: %v", err)
+		}
+		if _, err := claims.Raw("exp"); err != nil {
+			t.Fatalf("Raw(exp) failed before reaching the malformed claim: %v", err)
+		}
+		if _, err := claims.Raw("sub"); !errors.Is(err, internal.ErrClaimFormat) {
+			t.Errorf("Raw(sub): got %v, want ErrClaimFormat", err)
+		}
+		// the error is sticky, but indexed claims stay readable
+		if _, err := claims.Raw("sub"); !errors.Is(err, internal.ErrClaimFormat) {
+			t.Errorf("second Raw(sub): got %v, want ErrClaimFormat", err)
+		}
+		if _, err := claims.Raw("iss"); err != nil {
+			t.Errorf("Raw(iss) after the scan error: %v", err)
+		}
+	})
+
+	t.Run("MalformedPayload", func(t *testing.T) {
+		for _, payload := range []string{
+			``, `[]`, `"iss"`,
+			`{"iss"}`, `{"iss":}`, `{"iss":"a",}`, `{"iss":"a" "exp":1}`, `{iss:"a"}`,
+			`{"iss":"a`, `{"iss":"a\q"}`, `{"iss":"a\u12"}`, "{\"iss\":\"a\x01\"}",
+			`{"exp":01}`, `{"exp":1.}`, `{"exp":-}`, `{"exp":1e}`, `{"exp":nul}`,
+			`{"vc":{"a":1,}}`, `{"vc":[1,2}`, `{"vc":{"a" 1}}`,
+			`{"iss":"a"} x`, `{"iss":"a","iss":"b"}`,
+			strings.Repeat(`{"a":`, maxClaimDepth+2),
+		} {
+			claims, err := ParseClaims([]byte(payload))
+			if err == nil {
+				_, err = claims.Raw("missing")
+			}
+			if !errors.Is(err, internal.ErrClaimFormat) {
+				t.Errorf("payload %.40q: got %v, want ErrClaimFormat", payload, err)
+			}
+		}
+	})
+
+	t.Run("Validate", func(t *testing.T) {
+		claims, err := ParseClaims(payload)
+		if err != nil {
+			t.Fatalf("ParseClaims failed: %v", err)
+		}
+		if err := claims.Validate(); err != nil {
+			t.Fatalf("Validate failed: %v", err)
+		}
+		if iss, err := claims.String("iss"); err != nil || iss != "did:example:issuer" {
+			t.Errorf("String(iss) after Validate = %q, %v", iss, err)
+		}
+
+		for _, payload := range []string{`{"exp":1,"exp":9999999999}`, `{"exp":1} x`, `{"exp":1,"vc":{"a":}}`} {
+			claims, err := ParseClaims([]byte(payload))
+			if err != nil {
+				t.Fatalf("ParseClaims failed: %v", err)
+			}
+			if err := claims.Validate(); !errors.Is(err, internal.ErrClaimFormat) {
+				t.Errorf("Validate(%s): got %v, want ErrClaimFormat", payload, err)
+			}
+		}
+	})
+
+	t.Run("MissingClaim", func(t *testing.T) {
+		claims, err := ParseClaims([]byte(` { } `))
+		if err != nil {
+			t.Fatalf("ParseClaims failed: %v", err)
+		}
+		if _, err := claims.Raw("iss"); !errors.Is(err, internal.ErrClaimNotFound) {
+			t.Errorf("got %v, want ErrClaimNotFound", err)
+		}
+	})
+
+	t.Run("VerifyJWSClaims", func(t *testing.T) {
+		key, err := GenerateCurveSecretKey(CurveEd25519)
+		if err != nil {
+			t.Fatalf("GenerateCurveSecretKey failed: %v", err)
+		}
+		signer, err := NewEdDSASigner(key, "issuer-key-1")
+		if err != nil {
+			t.Fatalf("NewEdDSASigner failed: %v", err)
+		}
+		publicKey, err := signer.PublicKey()
+		if err != nil {
+			t.Fatalf("PublicKey failed: %v", err)
+		}
+		verifier, err := NewEdDSAVerifier(publicKey)
+		if err != nil {
+			t.Fatalf("NewEdDSAVerifier failed: %v", err)
+		}
+
+		token, err := signer.SignJWS(payload)
+		if err != nil {
+			t.Fatalf("SignJWS failed: %v", err)
+		}
+		claims, err := verifier.VerifyJWSClaims(token)
+		if err != nil {
+			t.Fatalf("VerifyJWSClaims failed: %v", err)
+		}
+		if sub, err := claims.String("sub"); err != nil || sub != "did:example:holder" {
+			t.Errorf("String(sub) = %q, %v", sub, err)
+		}
+
+		token[len(token)-2] ^= 1
+		if _, err := verifier.VerifyJWSClaims(token); err == nil {
+			t.Error("VerifyJWSClaims accepted a tampered token")
+		}
+
+		// a signed payload with a repeated claim must not yield its first value
+		for _, malformed := range []string{`{"exp":1,"exp":9999999999}`, `{"exp":1}}`} {
+			token, err := signer.SignJWS([]byte(malformed))
+			if err != nil {
+				t.Fatalf("SignJWS failed: %v", err)
+			}
+			if _, err := verifier.VerifyJWSClaims(token); !errors.Is(err, internal.ErrClaimFormat) {
+				t.Errorf("VerifyJWSClaims(%s): got %v, want ErrClaimFormat", malformed, err)
+			}
+		}
+	})
+}
+
+// BenchmarkClaims compares reading the claims a verifier needs through the lazy index against
+// decoding the whole payload with encoding/json
+func BenchmarkClaims(b *testing.B) {
+	payload := testCredentialPayload(64)
+
+	b.Run("Index", func(b *testing.B) {
+		b.SetBytes(int64(len(payload)))
+		b.ReportAllocs()
+		for i := 0; i < b.N; i++ {
+			claims, err := ParseClaims(payload)
+			if err != nil {
+				b.Fatal(err)
+			}
+			if _, err := claims.String("iss"); err != nil {
+				b.Fatal(err)
+			}
+			if _, err := claims.Int64("exp"); err != nil {
+				b.Fatal(err)
+			}
+			if _, err := claims.Pointer("/vc/credentialSubject/id"); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("Unmarshal", func(b *testing.B) {
+		b.SetBytes(int64(len(payload)))
+		b.ReportAllocs()
+		for i := 0; i < b.N; i++ {
+			var claims map[string]interface{}
+			if err := json.Unmarshal(payload, &claims); err != nil {
+				b.Fatal(err)
+			}
+			if _, ok := claims["iss"].(string); !ok {
+				b.Fatal("iss missing")
+			}
+			if _, ok := claims["exp"].(float64); !ok {
+				b.Fatal("exp missing")
+			}
+			subject := claims["vc"].(map[string]interface{})["credentialSubject"].(map[string]interface{})
+			if _, ok := subject["id"].(string); !ok {
+				b.Fatal("subject id missing")
+			}
+		}
+	})
+}
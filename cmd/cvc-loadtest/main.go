@@ -0,0 +1,384 @@
+// Command cvc-loadtest drives the issuance flow (F0 → F1 → F2) against an in-process wallet provider and
+// reports throughput, per-stage latency percentiles, allocations and resident memory.
+//
+// The wallet provider runs on an httptest server backed by ProviderConfig.GeneratePublicKeys. Network latency
+// and provider failures can be injected to see how retries, hedging and batching behave under load:
+//
+//	go run ./cmd/cvc-loadtest -users 2000 -concurrency 8 -batch 50 -latency 20ms -error-rate 0.05
+package main
+
+import (
+	"bytes"
+	"crypto/rand"
+	"encoding/hex"
+	"flag"
+	"fmt"
+	"io"
+	mrand "math/rand"
+	"net/http"
+	"net/http/httptest"
+	"os"
+	"runtime"
+	"sort"
+	"strconv"
+	"strings"
+	"sync"
+	"sync/atomic"
+	"time"
+
+	"github.com/MyNextID/cvc-go"
+)
+
+type options struct {
+	users          int
+	concurrency    int
+	batch          int
+	credentialSize int
+	latency        time.Duration
+	jitter         time.Duration
+	errorRate      float64
+	attempts       int
+	hedges         int
+
+	hybrid    bool
+	compact   bool
+	binary    bool
+	compress  int
+	cacheKeys bool
+}
+
+func main() {
+	var opts options
+	flag.IntVar(&opts.users, "users", 1000, "number of synthetic users to issue credentials to")
+	flag.IntVar(&opts.concurrency, "concurrency", runtime.GOMAXPROCS(0), "number of concurrent issuance workers")
+	flag.IntVar(&opts.batch, "batch", 50, "users per F0 wallet provider request")
+	flag.IntVar(&opts.credentialSize, "credential-size", 2048, "size of the synthetic signed credential in bytes")
+	flag.DurationVar(&opts.latency, "latency", 0, "latency injected into every wallet provider response")
+	flag.DurationVar(&opts.jitter, "jitter", 0, "uniform random latency added on top of -latency")
+	flag.Float64Var(&opts.errorRate, "error-rate", 0, "fraction of wallet provider requests answered with 503")
+	flag.IntVar(&opts.attempts, "attempts", 3, "maximum attempts per wallet provider request")
+	flag.IntVar(&opts.hedges, "hedges", 0, "maximum hedged wallet provider requests")
+	flag.BoolVar(&opts.hybrid, "hybrid", false, "use hybrid P-256 + ML-KEM-768 envelopes")
+	flag.BoolVar(&opts.compact, "compact", false, "encode VC secret keys as compact scalars")
+	flag.BoolVar(&opts.binary, "binary", false, "use binary JWE envelopes for EncVC")
+	flag.IntVar(&opts.compress, "compress", 0, "deflate credentials of at least this many bytes (0 disables)")
+	flag.BoolVar(&opts.cacheKeys, "cache", false, "cache wallet provider public keys in memory")
+	flag.Parse()
+
+	if opts.users < 1 || opts.concurrency < 1 || opts.batch < 1 {
+		fmt.Fprintln(os.Stderr, "users, concurrency and batch must be positive")
+		os.Exit(2)
+	}
+	if err := run(opts); err != nil {
+		fmt.Fprintln(os.Stderr, "cvc-loadtest:", err)
+		os.Exit(1)
+	}
+}
+
+// stage collects the latencies of one step of the issuance flow
+type stage struct {
+	name    string
+	mu      sync.Mutex
+	samples []time.Duration
+}
+
+func (s *stage) record(d time.Duration) {
+	s.mu.Lock()
+	s.samples = append(s.samples, d)
+	s.mu.Unlock()
+}
+
+func (s *stage) time(fn func() error) error {
+	start := time.Now()
+	err := fn()
+	s.record(time.Since(start))
+	return err
+}
+
+// percentile returns the q quantile of sorted samples using the nearest-rank method
+func percentile(sorted []time.Duration, q float64) time.Duration {
+	if len(sorted) == 0 {
+		return 0
+	}
+	rank := int(q*float64(len(sorted))+0.5) - 1
+	if rank < 0 {
+		rank = 0
+	}
+	if rank >= len(sorted) {
+		rank = len(sorted) - 1
+	}
+	return sorted[rank]
+}
+
+func (s *stage) report(w io.Writer) {
+	sort.Slice(s.samples, func(i, j int) bool { return s.samples[i] < s.samples[j] })
+	var total time.Duration
+	for _, d := range s.samples {
+		total += d
+	}
+	mean := time.Duration(0)
+	if len(s.samples) > 0 {
+		mean = total / time.Duration(len(s.samples))
+	}
+	fmt.Fprintf(w, "  %-4s %8d %12v %12v %12v %12v %12v\n", s.name, len(s.samples),
+		mean.Round(time.Microsecond),
+		percentile(s.samples, 0.50).Round(time.Microsecond),
+		percentile(s.samples, 0.90).Round(time.Microsecond),
+		percentile(s.samples, 0.99).Round(time.Microsecond),
+		percentile(s.samples, 1).Round(time.Microsecond))
+}
+
+// newProvider starts a wallet provider answering /generate/pub-key with injected latency and failures
+func newProvider(opts options, requests, failures *atomic.Int64) (*httptest.Server, error) {
+	masterKey, err := cvc.GenerateSecretKey()
+	if err != nil {
+		return nil, err
+	}
+	kemMasterSeed, err := cvc.GenerateKEMMasterSeed()
+	if err != nil {
+		return nil, err
+	}
+	provider := &cvc.ProviderConfig{MasterSecretKey: masterKey, Dst: "CVC-LOADTEST-DST-v1.0", HybridKEM: opts.hybrid, KEMMasterSeed: kemMasterSeed}
+
+	var rngMu sync.Mutex
+	rng := mrand.New(mrand.NewSource(time.Now().UnixNano()))
+
+	return httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+		requests.Add(1)
+		if r.URL.Path != "/generate/pub-key" {
+			http.NotFound(w, r)
+			return
+		}
+		body, err := io.ReadAll(r.Body)
+		if err != nil {
+			http.Error(w, err.Error(), http.StatusBadRequest)
+			return
+		}
+
+		rngMu.Lock()
+		delay := opts.latency
+		if opts.jitter > 0 {
+			delay += time.Duration(rng.Int63n(int64(opts.jitter)))
+		}
+		fail := opts.errorRate > 0 && rng.Float64() < opts.errorRate
+		rngMu.Unlock()
+
+		if delay > 0 {
+			select {
+			case <-time.After(delay):
+			case <-r.Context().Done():
+				return
+			}
+		}
+		if fail {
+			failures.Add(1)
+			http.Error(w, "injected failure", http.StatusServiceUnavailable)
+			return
+		}
+
+		keys, err := provider.GeneratePublicKeysContext(r.Context(), body)
+		if err != nil {
+			http.Error(w, err.Error(), http.StatusBadRequest)
+			return
+		}
+		w.Header().Set("Content-Type", "application/json")
+		w.Write(keys)
+	})), nil
+}
+
+// syntheticCredential returns a credential-like payload of the given size
+func syntheticCredential(size int) []byte {
+	credential := bytes.Repeat([]byte(`{"type":"VerifiableCredential","claim":"value"},`), size/48+1)[:size]
+	// make the second half random hex, like signatures and digests, so deflate results stay realistic
+	raw := make([]byte, size/4+1)
+	rand.Read(raw)
+	copy(credential[size/2:], hex.EncodeToString(raw))
+	return credential
+}
+
+// rssBytes returns the resident set size of the process, or 0 if it cannot be read
+func rssBytes() uint64 {
+	data, err := os.ReadFile("/proc/self/status")
+	if err != nil {
+		return 0
+	}
+	for _, line := range strings.Split(string(data), "\n") {
+		if !strings.HasPrefix(line, "VmRSS:") {
+			continue
+		}
+		fields := strings.Fields(line)
+		if len(fields) < 2 {
+			return 0
+		}
+		kb, err := strconv.ParseUint(fields[1], 10, 64)
+		if err != nil {
+			return 0
+		}
+		return kb * 1024
+	}
+	return 0
+}
+
+func run(opts options) error {
+	var requests, injected atomic.Int64
+	server, err := newProvider(opts, &requests, &injected)
+	if err != nil {
+		return fmt.Errorf("failed to start wallet provider: %w", err)
+	}
+	defer server.Close()
+
+	policy := cvc.NewRequestPolicy()
+	policy.MaxAttempts = opts.attempts
+	policy.MaxHedges = opts.hedges
+	policy.BaseBackoff = 10 * time.Millisecond
+	policy.MaxBackoff = 200 * time.Millisecond
+
+	issuer := &cvc.IssuerConfig{
+		ProviderURL:          server.URL,
+		HTTPClient:           server.Client(),
+		RequestPolicy:        policy,
+		HybridKEM:            opts.hybrid,
+		CompactSecretKey:     opts.compact,
+		BinaryEncVC:          opts.binary,
+		CompressionThreshold: opts.compress,
+	}
+	if opts.cacheKeys {
+		issuer.PublicKeyCache = cvc.NewMemoryPublicKeyCache()
+	}
+
+	credential := syntheticCredential(opts.credentialSize)
+
+	batches := make(chan map[string]string)
+	go func() {
+		defer close(batches)
+		batch := make(map[string]string, opts.batch)
+		for i := 0; i < opts.users; i++ {
+			batch[fmt.Sprintf("user-%d", i)] = fmt.Sprintf("user-%d@loadtest.example", i)
+			if len(batch) == opts.batch {
+				batches <- batch
+				batch = make(map[string]string, opts.batch)
+			}
+		}
+		if len(batch) > 0 {
+			batches <- batch
+		}
+	}()
+
+	f0 := &stage{name: "F0"}
+	f1 := &stage{name: "F1"}
+	f2 := &stage{name: "F2"}
+	var issued, failed, packBytes atomic.Int64
+	var errMu sync.Mutex
+	var firstErr error
+
+	fail := func(n int, err error) {
+		failed.Add(int64(n))
+		errMu.Lock()
+		if firstErr == nil {
+			firstErr = err
+		}
+		errMu.Unlock()
+	}
+
+	var statsBefore cvc.Stats
+	if cvc.StatsEnabled() {
+		statsBefore = cvc.StatsSnapshot()
+	}
+	runtime.GC()
+	var memBefore runtime.MemStats
+	runtime.ReadMemStats(&memBefore)
+	start := time.Now()
+
+	var wg sync.WaitGroup
+	for w := 0; w < opts.concurrency; w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for batch := range batches {
+				var userMap map[string]*cvc.UserData
+				if err := f0.time(func() (err error) {
+					userMap, err = issuer.GetPublicKeysFromWalletProvider(batch)
+					return err
+				}); err != nil {
+					fail(len(batch), err)
+					continue
+				}
+
+				for uuid := range batch {
+					payload := map[string]interface{}{"credentialSubject": map[string]interface{}{"id": uuid}}
+					if err := f1.time(func() error {
+						_, _, err := issuer.AddCnfToPayload(uuid, payload, userMap)
+						return err
+					}); err != nil {
+						fail(1, err)
+						continue
+					}
+
+					var pack []byte
+					if err := f2.time(func() (err error) {
+						pack, err = issuer.PrepareMessagePack(credential, uuid, userMap, nil, nil)
+						return err
+					}); err != nil {
+						fail(1, err)
+						continue
+					}
+					packBytes.Add(int64(len(pack)))
+					issued.Add(1)
+				}
+			}
+		}()
+	}
+	wg.Wait()
+
+	elapsed := time.Since(start)
+	var memAfter runtime.MemStats
+	runtime.ReadMemStats(&memAfter)
+
+	out := os.Stdout
+	fmt.Fprintf(out, "users %d, concurrency %d, batch %d, credential %d bytes, GOMAXPROCS %d\n",
+		opts.users, opts.concurrency, opts.batch, opts.credentialSize, runtime.GOMAXPROCS(0))
+	fmt.Fprintf(out, "issued %d, failed %d in %v (%.1f credentials/s)\n",
+		issued.Load(), failed.Load(), elapsed.Round(time.Millisecond), float64(issued.Load())/elapsed.Seconds())
+	fmt.Fprintf(out, "wallet provider requests %d, injected failures %d\n", requests.Load(), injected.Load())
+	if firstErr != nil {
+		fmt.Fprintf(out, "first error: %v\n", firstErr)
+	}
+	if n := issued.Load(); n > 0 {
+		fmt.Fprintf(out, "mean message pack size %d bytes\n", packBytes.Load()/n)
+	}
+
+	fmt.Fprintln(out, "\nlatency")
+	fmt.Fprintf(out, "  %-4s %8s %12s %12s %12s %12s %12s\n", "", "n", "mean", "p50", "p90", "p99", "max")
+	for _, s := range []*stage{f0, f1, f2} {
+		s.report(out)
+	}
+
+	mallocs := memAfter.Mallocs - memBefore.Mallocs
+	allocated := memAfter.TotalAlloc - memBefore.TotalAlloc
+	fmt.Fprintln(out, "\nmemory")
+	fmt.Fprintf(out, "  allocations %d (%d bytes)", mallocs, allocated)
+	if n := issued.Load(); n > 0 {
+		fmt.Fprintf(out, ", %d allocs/credential, %d bytes/credential", mallocs/uint64(n), allocated/uint64(n))
+	}
+	fmt.Fprintf(out, "\n  GC cycles %d, heap in use %d bytes, runtime sys %d bytes\n",
+		memAfter.NumGC-memBefore.NumGC, memAfter.HeapInuse, memAfter.Sys)
+	if rss := rssBytes(); rss > 0 {
+		fmt.Fprintf(out, "  RSS %d bytes\n", rss)
+	}
+
+	if cvc.StatsEnabled() {
+		diff := cvc.StatsSnapshot().Sub(statsBefore)
+		fmt.Fprintln(out, "\nlibrary operations")
+		for op := cvc.StatOp(0); int(op) < cvc.NumStatOps; op++ {
+			if diff[op].Count == 0 {
+				continue
+			}
+			fmt.Fprintf(out, "  %-20s %10d %12.0f ticks/op\n", op, diff[op].Count, diff[op].TicksPerOp())
+		}
+	}
+
+	if issued.Load() == 0 {
+		return fmt.Errorf("no credentials issued")
+	}
+	return nil
+}
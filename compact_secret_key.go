@@ -0,0 +1,88 @@
+package cvc
+
+import (
+	"crypto/ecdh"
+	"crypto/ecdsa"
+	"crypto/elliptic"
+	"math/big"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/MyNextID/cvc-go/pkg"
+	"github.com/lestrrat-go/jwx/v2/jwk"
+)
+
+// KeyFormatScalarV1 marks a VC secret key encoded as its raw 32-byte big-endian scalar instead of JWK JSON.
+// The public key is recomputed from the scalar by SecretKeyFromScalar.
+const KeyFormatScalarV1 = "scalar-v1"
+
+// KeyFormatScalarKEMV1 marks a hybrid VC secret key encoded as its 32-byte scalar followed by the seed of its
+// Kyber768 key (pkg.KEMSeedParam).
+const KeyFormatScalarKEMV1 = "scalar-kem-v1"
+
+// SecretKeyScalar returns the 32-byte big-endian scalar of a P-256 secret key
+func SecretKeyScalar(key jwk.Key) ([]byte, error) {
+	if key == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "secret key cannot be nil")
+	}
+
+	privateKey, err := extractPrivateKey(key, "secret key")
+	if err != nil {
+		return nil, err
+	}
+
+	return privateKeyToBytes(privateKey.D), nil
+}
+
+// SecretKeyScalarKEM returns the 32-byte scalar of a hybrid P-256 secret key followed by its Kyber768 seed
+func SecretKeyScalarKEM(key jwk.Key) ([]byte, error) {
+	scalar, err := SecretKeyScalar(key)
+	if err != nil {
+		return nil, err
+	}
+	seed, err := pkg.KEMSeed(key)
+	if err != nil {
+		return nil, err
+	}
+	return append(scalar, seed...), nil
+}
+
+// SecretKeyFromScalarKEM rebuilds a hybrid P-256 secret key JWK from its scalar and Kyber768 seed
+func SecretKeyFromScalarKEM(b []byte) (jwk.Key, error) {
+	if err := internal.ValidateKeyLength(b, internal.KeySize+internal.KEMSeedSize, "secret key scalar and KEM seed"); err != nil {
+		return nil, err
+	}
+	key, err := SecretKeyFromScalar(b[:internal.KeySize])
+	if err != nil {
+		return nil, err
+	}
+	return pkg.WithKEMSeed(key, b[internal.KeySize:])
+}
+
+// SecretKeyFromScalar rebuilds a P-256 secret key JWK from its 32-byte big-endian scalar
+func SecretKeyFromScalar(scalar []byte) (jwk.Key, error) {
+	if err := internal.ValidateKeyLength(scalar, internal.KeySize, "secret key scalar"); err != nil {
+		return nil, err
+	}
+
+	// NewPrivateKey rejects zero and out of range scalars
+	ecdhKey, err := ecdh.P256().NewPrivateKey(scalar)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrKeyOutOfRange, "secret key scalar is not in valid range")
+	}
+
+	pubBytes := ecdhKey.PublicKey().Bytes()
+	privateKey := &ecdsa.PrivateKey{
+		PublicKey: ecdsa.PublicKey{
+			Curve: elliptic.P256(),
+			X:     new(big.Int).SetBytes(pubBytes[1:33]),
+			Y:     new(big.Int).SetBytes(pubBytes[33:]),
+		},
+		D: new(big.Int).SetBytes(scalar),
+	}
+
+	jwkKey, err := jwk.FromRaw(privateKey)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrJWKCreation, "failed to create JWK from ECDSA private key")
+	}
+	return jwkKey, nil
+}
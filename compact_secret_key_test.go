@@ -0,0 +1,194 @@
+package cvc
+
+import (
+	"bytes"
+	"encoding/json"
+	"errors"
+	"testing"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/MyNextID/cvc-go/pkg"
+	"github.com/shamaton/msgpack/v2"
+)
+
+func TestSecretKeyScalar(t *testing.T) {
+	secretKey, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate key: %v", err)
+	}
+
+	scalar, err := SecretKeyScalar(secretKey)
+	if err != nil {
+		t.Fatalf("SecretKeyScalar failed: %v", err)
+	}
+	if len(scalar) != internal.KeySize {
+		t.Fatalf("Expected %d byte scalar, got %d", internal.KeySize, len(scalar))
+	}
+
+	restored, err := SecretKeyFromScalar(scalar)
+	if err != nil {
+		t.Fatalf("SecretKeyFromScalar failed: %v", err)
+	}
+	originalJSON, _ := json.Marshal(secretKey)
+	restoredJSON, _ := json.Marshal(restored)
+	if !bytes.Equal(originalJSON, restoredJSON) {
+		t.Errorf("Restored key does not match original")
+	}
+
+	if _, err := SecretKeyFromScalar(make([]byte, internal.KeySize)); !errors.Is(err, internal.ErrKeyOutOfRange) {
+		t.Errorf("Expected out of range error for zero scalar, got %v", err)
+	}
+	if _, err := SecretKeyFromScalar(bytes.Repeat([]byte{0xff}, internal.KeySize)); !errors.Is(err, internal.ErrKeyOutOfRange) {
+		t.Errorf("Expected out of range error for scalar above curve order, got %v", err)
+	}
+}
+
+func TestCompactEnvelope(t *testing.T) {
+	secretKey, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate key: %v", err)
+	}
+	publicKey, _ := secretKey.PublicKey()
+	payload := bytes.Repeat([]byte{0x42}, internal.KeySize)
+
+	envelope, err := pkg.EncryptCompact(payload, publicKey)
+	if err != nil {
+		t.Fatalf("EncryptCompact failed: %v", err)
+	}
+	if len(envelope) != 82 {
+		t.Errorf("Expected 82 byte envelope, got %d", len(envelope))
+	}
+	if !pkg.IsCompactEnvelope(envelope) {
+		t.Errorf("Envelope not recognized as compact")
+	}
+
+	decrypted, err := pkg.DecryptCompact(envelope, secretKey)
+	if err != nil {
+		t.Fatalf("DecryptCompact failed: %v", err)
+	}
+	if !bytes.Equal(decrypted, payload) {
+		t.Errorf("Decrypted payload does not match")
+	}
+
+	for _, pos := range []int{5, len(envelope) - 1} {
+		tampered := append([]byte{}, envelope...)
+		tampered[pos] ^= 0x01
+		if _, err := pkg.DecryptCompact(tampered, secretKey); err == nil {
+			t.Errorf("Expected error for tampered byte %d", pos)
+		}
+	}
+}
+
+func TestCompactMessagePack(t *testing.T) {
+	wpSecKey, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate key: %v", err)
+	}
+	wpPubKey, _ := wpSecKey.PublicKey()
+	credential := []byte("signed-credential")
+
+	prepare := func(t *testing.T, issuer *IssuerConfig) (*MessagePack, *UserData) {
+		t.Helper()
+		userMap := map[string]*UserData{"user": {Email: "user@example.com", KeyID: "key", WpPubKey: wpPubKey}}
+		if _, _, err := issuer.AddCnfToPayload("user", map[string]interface{}{}, userMap); err != nil {
+			t.Fatalf("AddCnfToPayload failed: %v", err)
+		}
+		packBytes, err := issuer.PrepareMessagePack(credential, "user", userMap, nil, nil)
+		if err != nil {
+			t.Fatalf("PrepareMessagePack failed: %v", err)
+		}
+		var pack MessagePack
+		if err := msgpack.Unmarshal(packBytes, &pack); err != nil {
+			t.Fatalf("Failed to unmarshal message pack: %v", err)
+		}
+		return &pack, userMap["user"]
+	}
+
+	t.Run("CompactSecretKey", func(t *testing.T) {
+		pack, userData := prepare(t, &IssuerConfig{CompactSecretKey: true})
+		if pack.Format != "" || pack.EncVCSecKeyFormat != pkg.CompactFormatV1 || pack.KeyFormat != KeyFormatScalarV1 {
+			t.Fatalf("Unexpected formats %q / %q / %q", pack.Format, pack.EncVCSecKeyFormat, pack.KeyFormat)
+		}
+
+		legacy, _ := prepare(t, &IssuerConfig{})
+		if len(pack.EncVCSecKey) >= len(legacy.EncVCSecKey)/4 {
+			t.Errorf("Compact secret key (%d bytes) is not much smaller than JWE (%d bytes)", len(pack.EncVCSecKey), len(legacy.EncVCSecKey))
+		}
+
+		vcSecKey, err := DecryptVCSecretKey(pack, wpSecKey)
+		if err != nil {
+			t.Fatalf("DecryptVCSecretKey failed: %v", err)
+		}
+		expected, _ := SecretKeyScalar(userData.VcSecKey)
+		got, _ := SecretKeyScalar(vcSecKey)
+		if !bytes.Equal(expected, got) {
+			t.Errorf("Recovered VC secret key does not match")
+		}
+
+		decrypted, err := pkg.DecryptWithSecretKey(pack.EncVC, vcSecKey)
+		if err != nil {
+			t.Fatalf("Failed to decrypt credential: %v", err)
+		}
+		if !bytes.Equal(decrypted, credential) {
+			t.Errorf("Decrypted credential does not match")
+		}
+	})
+
+	t.Run("FormatNamingBothEnvelopes", func(t *testing.T) {
+		// packs written before EncVCSecKeyFormat carried the compact envelope format in Format
+		pack, _ := prepare(t, &IssuerConfig{CompactSecretKey: true})
+		pack.Format, pack.EncVCSecKeyFormat = pack.EncVCSecKeyFormat, ""
+		vcSecKey, err := DecryptVCSecretKey(pack, wpSecKey)
+		if err != nil {
+			t.Fatalf("DecryptVCSecretKey failed: %v", err)
+		}
+		if decrypted, err := DecryptVC(pack, vcSecKey); err != nil || !bytes.Equal(decrypted, credential) {
+			t.Errorf("DecryptVC failed: %v", err)
+		}
+	})
+
+	t.Run("LegacyFormat", func(t *testing.T) {
+		pack, _ := prepare(t, &IssuerConfig{})
+		if pack.Format != "" || pack.KeyFormat != "" {
+			t.Fatalf("Unexpected formats %q / %q", pack.Format, pack.KeyFormat)
+		}
+		if _, err := DecryptVCSecretKey(pack, wpSecKey); err != nil {
+			t.Fatalf("DecryptVCSecretKey failed: %v", err)
+		}
+	})
+
+	t.Run("UnknownFormat", func(t *testing.T) {
+		pack, _ := prepare(t, &IssuerConfig{})
+		pack.Format = "future-v9"
+		if _, err := DecryptVCSecretKey(pack, wpSecKey); !errors.Is(err, internal.ErrEnvelopeFormat) {
+			t.Errorf("Expected envelope format error, got %v", err)
+		}
+	})
+}
+
+func BenchmarkPrepareMessagePack(b *testing.B) {
+	wpSecKey, _ := GenerateSecretKey()
+	wpPubKey, _ := wpSecKey.PublicKey()
+	credential := bytes.Repeat([]byte("a"), 2048)
+
+	for _, bc := range []struct {
+		name   string
+		issuer *IssuerConfig
+	}{
+		{"JWE", &IssuerConfig{}},
+		{"CompactSecretKey", &IssuerConfig{CompactSecretKey: true}},
+	} {
+		b.Run(bc.name, func(b *testing.B) {
+			userMap := map[string]*UserData{"user": {Email: "user@example.com", KeyID: "key", WpPubKey: wpPubKey}}
+			if _, _, err := bc.issuer.AddCnfToPayload("user", map[string]interface{}{}, userMap); err != nil {
+				b.Fatal(err)
+			}
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				if _, err := bc.issuer.PrepareMessagePack(credential, "user", userMap, nil, nil); err != nil {
+					b.Fatal(err)
+				}
+			}
+		})
+	}
+}
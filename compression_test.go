@@ -0,0 +1,212 @@
+package cvc
+
+import (
+	"bytes"
+	"compress/flate"
+	"errors"
+	"fmt"
+	"strings"
+	"testing"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/MyNextID/cvc-go/pkg"
+	"github.com/shamaton/msgpack/v2"
+)
+
+// testCredential returns a JSON credential of roughly the given size with the redundancy of real claims
+func testCredential(size int) []byte {
+	var sb strings.Builder
+	sb.WriteString(`{"vc":{"credentialSubject":{"claims":[`)
+	for i := 0; sb.Len() < size; i++ {
+		if i > 0 {
+			sb.WriteString(",")
+		}
+		fmt.Fprintf(&sb, `{"name":"claim-%d","value":"value of claim number %d","type":"string"}`, i, i)
+	}
+	sb.WriteString(`]}}}`)
+	return []byte(sb.String())
+}
+
+func TestCompressedEnvelopes(t *testing.T) {
+	secretKey, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate key: %v", err)
+	}
+	publicKey, _ := secretKey.PublicKey()
+	secretKey, kemPubKey := attachKEMSeed(t, secretKey)
+	credential := testCredential(32 * 1024)
+
+	t.Run("JWE", func(t *testing.T) {
+		plain, _ := pkg.EncryptWithPublicKey(credential, publicKey)
+		compressed, err := pkg.EncryptWithPublicKeyDeflate(credential, publicKey)
+		if err != nil {
+			t.Fatalf("EncryptWithPublicKeyDeflate failed: %v", err)
+		}
+		if len(compressed)*3 > len(plain) {
+			t.Errorf("Compressed JWE (%d bytes) is not much smaller than uncompressed (%d bytes)", len(compressed), len(plain))
+		}
+		decrypted, err := pkg.DecryptWithSecretKey(compressed, secretKey)
+		if err != nil {
+			t.Fatalf("DecryptWithSecretKey failed: %v", err)
+		}
+		if !bytes.Equal(decrypted, credential) {
+			t.Errorf("Decrypted credential does not match")
+		}
+	})
+
+	t.Run("BinaryJWE", func(t *testing.T) {
+		binJWE, err := pkg.EncryptBinaryJWEDeflate(credential, publicKey)
+		if err != nil {
+			t.Fatalf("EncryptBinaryJWEDeflate failed: %v", err)
+		}
+		decrypted, err := pkg.DecryptBinaryJWE(binJWE, secretKey)
+		if err != nil {
+			t.Fatalf("DecryptBinaryJWE failed: %v", err)
+		}
+		if !bytes.Equal(decrypted, credential) {
+			t.Errorf("Decrypted credential does not match")
+		}
+		// the compact form must carry the zip header for other JOSE libraries
+		decrypted, err = pkg.DecryptWithSecretKey(binJWE.Compact(), secretKey)
+		if err != nil || !bytes.Equal(decrypted, credential) {
+			t.Errorf("Compact form of compressed binary JWE did not decrypt: %v", err)
+		}
+	})
+
+	t.Run("Hybrid", func(t *testing.T) {
+		envelope, err := pkg.EncryptHybridDeflate(credential, publicKey, kemPubKey)
+		if err != nil {
+			t.Fatalf("EncryptHybridDeflate failed: %v", err)
+		}
+		if envelope[0]&pkg.EnvelopeFlagDeflate == 0 || !pkg.IsHybridEnvelope(envelope) {
+			t.Errorf("Envelope is not flagged as compressed hybrid envelope")
+		}
+		decrypted, err := pkg.DecryptHybrid(envelope, secretKey)
+		if err != nil {
+			t.Fatalf("DecryptHybrid failed: %v", err)
+		}
+		if !bytes.Equal(decrypted, credential) {
+			t.Errorf("Decrypted credential does not match")
+		}
+
+		// the flag is authenticated
+		envelope[0] &^= pkg.EnvelopeFlagDeflate
+		if _, err := pkg.DecryptHybrid(envelope, secretKey); !errors.Is(err, internal.ErrDecryption) {
+			t.Errorf("Expected decryption error after clearing the flag, got %v", err)
+		}
+	})
+
+	t.Run("DecompressionLimit", func(t *testing.T) {
+		bomb := make([]byte, pkg.MaxDecompressedSize+1)
+		binJWE, err := pkg.EncryptBinaryJWEDeflate(bomb, publicKey)
+		if err != nil {
+			t.Fatalf("EncryptBinaryJWEDeflate failed: %v", err)
+		}
+		if _, err := pkg.DecryptBinaryJWE(binJWE, secretKey); !errors.Is(err, internal.ErrInputTooLarge) {
+			t.Errorf("Expected size limit error, got %v", err)
+		}
+		if _, err := pkg.DecryptWithSecretKey(binJWE.Compact(), secretKey); err == nil {
+			t.Errorf("Expected size limit error for compact JWE")
+		}
+		if _, err := pkg.DecryptWithSecretKeyLimit(binJWE.Compact(), secretKey, pkg.MaxDecompressedSize+1); err != nil {
+			t.Errorf("DecryptWithSecretKeyLimit failed with raised limit: %v", err)
+		}
+	})
+
+	t.Run("InvalidDeflateData", func(t *testing.T) {
+		if _, err := pkg.Inflate([]byte{0xff, 0xff, 0xff}, 1024); err == nil {
+			t.Errorf("Expected error for invalid DEFLATE data")
+		}
+		var buf bytes.Buffer
+		w, _ := flate.NewWriter(&buf, flate.BestSpeed)
+		w.Write(credential)
+		w.Close()
+		if out, err := pkg.Inflate(buf.Bytes(), int64(len(credential))); err != nil || !bytes.Equal(out, credential) {
+			t.Errorf("Inflate failed at exact limit: %v", err)
+		}
+
+		prefixed, err := pkg.DeflateTo([]byte("header"), credential)
+		if err != nil || !bytes.HasPrefix(prefixed, []byte("header")) {
+			t.Fatalf("DeflateTo did not append to dst: %v", err)
+		}
+		if out, err := pkg.Inflate(prefixed[len("header"):], int64(len(credential))); err != nil || !bytes.Equal(out, credential) {
+			t.Errorf("DeflateTo output did not inflate: %v", err)
+		}
+	})
+}
+
+func TestCompressionThreshold(t *testing.T) {
+	wpSecKey, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate key: %v", err)
+	}
+	wpPubKey, _ := wpSecKey.PublicKey()
+
+	for _, bc := range []struct {
+		name   string
+		issuer *IssuerConfig
+	}{
+		{"JWE", &IssuerConfig{CompressionThreshold: 1024}},
+		{"BinaryJWE", &IssuerConfig{CompressionThreshold: 1024, BinaryEncVC: true}},
+	} {
+		t.Run(bc.name, func(t *testing.T) {
+			for _, size := range []int{100, 16 * 1024} {
+				credential := testCredential(size)
+				userMap := map[string]*UserData{"user": {Email: "user@example.com", KeyID: "key", WpPubKey: wpPubKey}}
+				if _, _, err := bc.issuer.AddCnfToPayload("user", map[string]interface{}{}, userMap); err != nil {
+					t.Fatalf("AddCnfToPayload failed: %v", err)
+				}
+				packBytes, err := bc.issuer.PrepareMessagePack(credential, "user", userMap, nil, nil)
+				if err != nil {
+					t.Fatalf("PrepareMessagePack failed: %v", err)
+				}
+				var pack MessagePack
+				if err := msgpack.Unmarshal(packBytes, &pack); err != nil {
+					t.Fatalf("Failed to unmarshal message pack: %v", err)
+				}
+
+				compact, _ := pack.CompactEncVC()
+				binJWE, err := pkg.ParseCompactJWE(compact)
+				if err != nil {
+					t.Fatalf("ParseCompactJWE failed: %v", err)
+				}
+				zipped := bytes.Contains(binJWE.Protected, []byte(`"zip":"DEF"`))
+				if zipped != (len(credential) >= bc.issuer.CompressionThreshold) {
+					t.Errorf("Credential of %d bytes: compressed=%v", len(credential), zipped)
+				}
+
+				decrypted, err := DecryptVC(&pack, userMap["user"].VcSecKey)
+				if err != nil {
+					t.Fatalf("DecryptVC failed: %v", err)
+				}
+				if !bytes.Equal(decrypted, credential) {
+					t.Errorf("Decrypted credential does not match")
+				}
+			}
+		})
+	}
+}
+
+func BenchmarkCompressedEncryption(b *testing.B) {
+	secretKey, _ := GenerateSecretKey()
+	publicKey, _ := secretKey.PublicKey()
+	credential := testCredential(64 * 1024)
+
+	b.Run("BinaryJWE", func(b *testing.B) {
+		b.SetBytes(int64(len(credential)))
+		for i := 0; i < b.N; i++ {
+			if _, err := pkg.EncryptBinaryJWE(credential, publicKey); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("BinaryJWEDeflate", func(b *testing.B) {
+		b.SetBytes(int64(len(credential)))
+		for i := 0; i < b.N; i++ {
+			if _, err := pkg.EncryptBinaryJWEDeflate(credential, publicKey); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+}
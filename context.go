@@ -0,0 +1,60 @@
+package cvc
+
+import (
+	"context"
+	"runtime"
+	"sync"
+)
+
+// Context variants (the ...Context methods) stop long running work when their context is cancelled or
+// its deadline passes. Network calls carry the context in their request. Batches of C calls cannot be
+// interrupted while a call is running, so they are split into chunks and the context is checked
+// between chunks; each chunk is small enough to finish within a few milliseconds.
+
+const (
+	// deriveChunkSize is the number of key derivations between two context checks
+	deriveChunkSize = 8
+	// validateChunkSize is the number of public keys validated per C call by the context variants
+	validateChunkSize = 256
+)
+
+// forEachParallel calls fn for every index below n, spreading the calls over all available CPUs. It
+// stops handing out indices once ctx is done and returns ctx.Err(); calls already in progress finish.
+// Otherwise the first error returned by fn is returned.
+func forEachParallel(ctx context.Context, n int, fn func(i int) error) error {
+	workers := runtime.GOMAXPROCS(0)
+	if workers > n {
+		workers = n
+	}
+
+	jobs := make(chan int)
+	var wg sync.WaitGroup
+	var errOnce sync.Once
+	var firstErr error
+	for w := 0; w < workers; w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i := range jobs {
+				if err := fn(i); err != nil {
+					errOnce.Do(func() { firstErr = err })
+				}
+			}
+		}()
+	}
+	cancelled := false
+	for i := 0; i < n && !cancelled; i++ {
+		select {
+		case jobs <- i:
+		case <-ctx.Done():
+			cancelled = true
+		}
+	}
+	close(jobs)
+	wg.Wait()
+
+	if cancelled {
+		return ctx.Err()
+	}
+	return firstErr
+}
@@ -0,0 +1,228 @@
+package cvc
+
+import (
+	"context"
+	"crypto/ecdsa"
+	"crypto/elliptic"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"net/http"
+	"net/http/httptest"
+	"strings"
+	"sync/atomic"
+	"testing"
+	"time"
+
+	"github.com/lestrrat-go/jwx/v2/jwk"
+)
+
+// maxCancelLatency bounds how long cancelled work may keep running. It leaves room for a slow,
+// shared test machine; a single chunk takes a few milliseconds.
+const maxCancelLatency = 250 * time.Millisecond
+
+func testHashRequest(t testing.TB, n int) []byte {
+	t.Helper()
+	hashes := make([]string, n)
+	for i := range hashes {
+		hashes[i] = fmt.Sprintf("hash-%d", i)
+	}
+	request, err := json.Marshal(hashes)
+	if err != nil {
+		t.Fatalf("Failed to marshal request: %v", err)
+	}
+	return request
+}
+
+// cancelAfter runs fn with a context that is cancelled after delay and returns the time fn kept
+// running after the cancellation together with fn's error
+func cancelAfter(delay time.Duration, fn func(ctx context.Context) error) (time.Duration, error) {
+	ctx, cancel := context.WithCancel(context.Background())
+	defer cancel()
+
+	var cancelled atomic.Int64
+	timer := time.AfterFunc(delay, func() {
+		cancelled.Store(time.Now().UnixNano())
+		cancel()
+	})
+	defer timer.Stop()
+
+	err := fn(ctx)
+	if at := cancelled.Load(); at != 0 {
+		return time.Since(time.Unix(0, at)), err
+	}
+	return 0, err
+}
+
+func TestContextCancellation(t *testing.T) {
+	masterKey, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate master key: %v", err)
+	}
+	provider := &ProviderConfig{MasterSecretKey: masterKey, Dst: "CVC-TEST-DST-v1.0"}
+
+	t.Run("ProviderAlreadyCancelled", func(t *testing.T) {
+		ctx, cancel := context.WithCancel(context.Background())
+		cancel()
+		if _, err := provider.GeneratePublicKeysContext(ctx, testHashRequest(t, 4)); !errors.Is(err, context.Canceled) {
+			t.Fatalf("Expected context.Canceled, got %v", err)
+		}
+	})
+
+	t.Run("ProviderStopsPromptly", func(t *testing.T) {
+		request := testHashRequest(t, 5000)
+		latency, err := cancelAfter(20*time.Millisecond, func(ctx context.Context) error {
+			_, err := provider.GeneratePublicKeysContext(ctx, request)
+			return err
+		})
+		if !errors.Is(err, context.Canceled) {
+			t.Fatalf("Expected context.Canceled, got %v", err)
+		}
+		if latency > maxCancelLatency {
+			t.Errorf("Derivation kept running for %v after cancellation", latency)
+		}
+	})
+
+	t.Run("ProviderUncancelled", func(t *testing.T) {
+		keysJSON, err := provider.GeneratePublicKeysContext(context.Background(), testHashRequest(t, 20))
+		if err != nil {
+			t.Fatalf("GeneratePublicKeysContext failed: %v", err)
+		}
+		var keyMap map[string]KeyData
+		if err := json.Unmarshal(keysJSON, &keyMap); err != nil {
+			t.Fatalf("Failed to unmarshal keys: %v", err)
+		}
+		if len(keyMap) != 20 {
+			t.Errorf("Expected 20 keys, got %d", len(keyMap))
+		}
+	})
+
+	t.Run("KeyArenaKeepsDerivedKeys", func(t *testing.T) {
+		contexts := make([][]byte, 5000)
+		for i := range contexts {
+			contexts[i] = []byte(fmt.Sprintf("context-%d", i))
+		}
+		arena, err := NewKeyArena(len(contexts))
+		if err != nil {
+			t.Fatalf("NewKeyArena failed: %v", err)
+		}
+		defer arena.Close()
+
+		latency, err := cancelAfter(20*time.Millisecond, func(ctx context.Context) error {
+			return arena.DeriveSecretKeysContext(ctx, masterKey, contexts, []byte(provider.Dst))
+		})
+		if !errors.Is(err, context.Canceled) {
+			t.Fatalf("Expected context.Canceled, got %v", err)
+		}
+		if latency > maxCancelLatency {
+			t.Errorf("Derivation kept running for %v after cancellation", latency)
+		}
+		if arena.Len() == 0 || arena.Len()%deriveChunkSize != 0 {
+			t.Errorf("Expected whole chunks of derived keys, got %d", arena.Len())
+		}
+	})
+
+	t.Run("ValidateBatch", func(t *testing.T) {
+		keys := testPublicKeys(t, validateChunkSize+8)
+		ctx, cancel := context.WithCancel(context.Background())
+		cancel()
+		if err := ValidatePublicKeysBatchContext(ctx, keys); !errors.Is(err, context.Canceled) {
+			t.Fatalf("Expected context.Canceled, got %v", err)
+		}
+
+		// an invalid key in a later chunk is still named by its index in the whole batch
+		x, y := offCurvePoint()
+		invalid, err := jwk.FromRaw(&ecdsa.PublicKey{Curve: elliptic.P256(), X: x, Y: y})
+		if err != nil {
+			t.Fatalf("Failed to create JWK: %v", err)
+		}
+		batch := append(append([]jwk.Key{}, keys...), invalid)
+		err = ValidatePublicKeysBatchContext(context.Background(), batch)
+		if err == nil || !strings.Contains(err.Error(), fmt.Sprintf("public key %d ", len(keys))) {
+			t.Errorf("Expected error naming public key %d, got %v", len(keys), err)
+		}
+	})
+
+	t.Run("SignBatch", func(t *testing.T) {
+		secretKey, err := GenerateCurveSecretKey(CurveEd25519)
+		if err != nil {
+			t.Fatalf("Failed to generate Ed25519 key: %v", err)
+		}
+		signer, err := NewEdDSASigner(secretKey, "kid")
+		if err != nil {
+			t.Fatalf("NewEdDSASigner failed: %v", err)
+		}
+		payloads := make([][]byte, 20000)
+		for i := range payloads {
+			payloads[i] = []byte(fmt.Sprintf(`{"n":%d}`, i))
+		}
+
+		latency, err := cancelAfter(20*time.Millisecond, func(ctx context.Context) error {
+			_, err := signer.SignBatchContext(ctx, payloads)
+			return err
+		})
+		if !errors.Is(err, context.Canceled) {
+			t.Fatalf("Expected context.Canceled, got %v", err)
+		}
+		if latency > maxCancelLatency {
+			t.Errorf("Signing kept running for %v after cancellation", latency)
+		}
+	})
+
+	t.Run("WalletProviderRequest", func(t *testing.T) {
+		// the wallet provider never answers; only the cancellation ends the request
+		release := make(chan struct{})
+		server := httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+			select {
+			case <-r.Context().Done():
+			case <-release:
+			}
+		}))
+		defer server.Close()
+		defer close(release)
+
+		policy := NewRequestPolicy()
+		policy.MaxHedges = 0
+		issuer := &IssuerConfig{ProviderURL: server.URL, RequestPolicy: policy}
+
+		latency, err := cancelAfter(20*time.Millisecond, func(ctx context.Context) error {
+			_, err := issuer.GetPublicKeysFromWalletProviderContext(ctx, testEmailMap(3))
+			return err
+		})
+		if !errors.Is(err, context.Canceled) {
+			t.Fatalf("Expected context.Canceled, got %v", err)
+		}
+		if latency > maxCancelLatency {
+			t.Errorf("Request kept running for %v after cancellation", latency)
+		}
+	})
+}
+
+// BenchmarkContextChecks compares key generation with and without a cancellable context, which shows
+// the cost of the checks between chunks
+func BenchmarkContextChecks(b *testing.B) {
+	masterKey, err := GenerateSecretKey()
+	if err != nil {
+		b.Fatalf("Failed to generate master key: %v", err)
+	}
+	provider := &ProviderConfig{MasterSecretKey: masterKey, Dst: "CVC-TEST-DST-v1.0"}
+	request := testHashRequest(b, 64)
+
+	b.Run("GeneratePublicKeys", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			if _, err := provider.GeneratePublicKeys(request); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("GeneratePublicKeysContext", func(b *testing.B) {
+		ctx, cancel := context.WithCancel(context.Background())
+		defer cancel()
+		for i := 0; i < b.N; i++ {
+			if _, err := provider.GeneratePublicKeysContext(ctx, request); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+}
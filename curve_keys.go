@@ -0,0 +1,288 @@
+package cvc
+
+import (
+	"crypto/ed25519"
+	"crypto/rand"
+	"fmt"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/MyNextID/cvc-go/pkg"
+	"github.com/lestrrat-go/jwx/v2/jwk"
+)
+
+// Curve selects the elliptic curve of composable keys. The JWK based functions (DeriveSecretKey,
+// AddSecretKeys, AddPublicKeys) work on P-256 only; the Curve functions below accept either curve.
+//
+// Ed25519 keys compose the same way as P-256 keys: secret scalars add modulo the group order and the
+// matching public keys add as points. A composed Ed25519 secret key is a bare scalar and has no RFC 8032
+// seed, so it cannot be written as a private OKP JWK; its public key is a regular OKP JWK.
+type Curve int
+
+const (
+	// CurveP256 is NIST P-256 with keys encoded as EC JWKs
+	CurveP256 Curve = iota
+	// CurveEd25519 is edwards25519 with public keys encoded as OKP JWKs (RFC 8037)
+	CurveEd25519
+)
+
+// String returns the JWK curve name
+func (c Curve) String() string {
+	switch c {
+	case CurveP256:
+		return "P-256"
+	case CurveEd25519:
+		return "Ed25519"
+	default:
+		return fmt.Sprintf("Curve(%d)", int(c))
+	}
+}
+
+// CurveSecretKey is a secret key reduced to its scalar, the form in which keys on every supported
+// curve can be composed
+type CurveSecretKey struct {
+	curve     Curve
+	scalar    []byte // big-endian for P-256 (as JWK "d"), little-endian for Ed25519 (RFC 8032)
+	publicKey []byte // SEC 1 uncompressed point for P-256, RFC 8032 encoding for Ed25519
+
+	// seed and prefix are only known for Ed25519 keys created from an RFC 8032 private key
+	seed   []byte
+	prefix []byte
+}
+
+// Curve returns the curve of the key
+func (k *CurveSecretKey) Curve() Curve {
+	return k.curve
+}
+
+// Scalar returns a copy of the secret scalar
+func (k *CurveSecretKey) Scalar() []byte {
+	return append([]byte{}, k.scalar...)
+}
+
+// PublicKeyBytes returns the encoded public key: an uncompressed point for P-256, the RFC 8032
+// encoding for Ed25519
+func (k *CurveSecretKey) PublicKeyBytes() []byte {
+	return append([]byte{}, k.publicKey...)
+}
+
+// PublicKey returns the public key as an EC (P-256) or OKP (Ed25519) JWK
+func (k *CurveSecretKey) PublicKey() (jwk.Key, error) {
+	switch k.curve {
+	case CurveP256:
+		pubKey, err := pkg.PublicBytesToECDSA(k.publicKey)
+		if err != nil {
+			return nil, internal.WrapError(internal.ErrResultConversion, "failed to convert public key")
+		}
+		return jwkFromRaw(pubKey)
+	case CurveEd25519:
+		return jwkFromRaw(ed25519.PublicKey(append([]byte{}, k.publicKey...)))
+	default:
+		return nil, unsupportedCurve(k.curve)
+	}
+}
+
+// JWK returns the secret key as a private JWK. Ed25519 keys can only be converted if they were
+// created from an RFC 8032 private key; derived and composed Ed25519 keys have no seed.
+func (k *CurveSecretKey) JWK() (jwk.Key, error) {
+	switch k.curve {
+	case CurveP256:
+		var keyMaterial internal.KeyMaterial
+		copy(keyMaterial.PrivateKeyBytes[:], k.scalar)
+		copy(keyMaterial.PublicKeyXBytes[:], k.publicKey[1:1+internal.KeySize])
+		copy(keyMaterial.PublicKeyYBytes[:], k.publicKey[1+internal.KeySize:])
+		return keyMaterialToJWK(keyMaterial)
+	case CurveEd25519:
+		if k.seed == nil {
+			return nil, internal.WrapError(internal.ErrKeyTypeUnsupported, "composed Ed25519 key has no seed and cannot be encoded as a private JWK")
+		}
+		return jwkFromRaw(ed25519.NewKeyFromSeed(k.seed))
+	default:
+		return nil, unsupportedCurve(k.curve)
+	}
+}
+
+// GenerateCurveSecretKey generates a random secret key on the given curve
+func GenerateCurveSecretKey(curve Curve) (*CurveSecretKey, error) {
+	switch curve {
+	case CurveP256:
+		key, err := GenerateSecretKey()
+		if err != nil {
+			return nil, err
+		}
+		return CurveSecretKeyFromJWK(key)
+	case CurveEd25519:
+		seed := make([]byte, internal.Ed25519SeedSize)
+		if _, err := rand.Read(seed); err != nil {
+			return nil, internal.WrapError(internal.ErrKeyGeneration, "failed to generate random seed")
+		}
+		return ed25519KeyFromSeed(seed)
+	default:
+		return nil, unsupportedCurve(curve)
+	}
+}
+
+// CurveSecretKeyFromJWK converts a private EC P-256 or OKP Ed25519 JWK into a composable secret key.
+// Ed25519 seeds are expanded as in RFC 8032 and the clamped scalar is reduced modulo the group order,
+// which leaves the public key unchanged.
+func CurveSecretKeyFromJWK(key jwk.Key) (*CurveSecretKey, error) {
+	if key == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "key cannot be nil")
+	}
+
+	var edKey ed25519.PrivateKey
+	if err := key.Raw(&edKey); err == nil {
+		return ed25519KeyFromSeed(edKey.Seed())
+	}
+
+	privateKey, err := extractPrivateKey(key, "key")
+	if err != nil {
+		return nil, err
+	}
+	return &CurveSecretKey{
+		curve:     CurveP256,
+		scalar:    privateKeyToBytes(privateKey.D),
+		publicKey: pkg.PublicECDSAToBytes(&privateKey.PublicKey),
+	}, nil
+}
+
+// DeriveCurveSecretKey derives a secret key on the given curve from master key material, like
+// DeriveSecretKey does for P-256. Use a different DST per curve.
+func DeriveCurveSecretKey(curve Curve, master jwk.Key, context, dst []byte) (*CurveSecretKey, error) {
+	switch curve {
+	case CurveP256:
+		key, err := DeriveSecretKey(master, context, dst)
+		if err != nil {
+			return nil, err
+		}
+		return CurveSecretKeyFromJWK(key)
+	case CurveEd25519:
+	default:
+		return nil, unsupportedCurve(curve)
+	}
+
+	if master == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "master key cannot be nil")
+	}
+	if err := internal.ValidateNonEmpty(context, "context"); err != nil {
+		return nil, err
+	}
+
+	masterBytes, err := pkg.KeyJWKToJson(master)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrJWKExtraction, "failed to convert master key to JSON")
+	}
+	defer clear(masterBytes)
+
+	keyMaterial, err := internal.DeriveEd25519SecretKeySegments(dst, masterBytes, context)
+	if err != nil {
+		return nil, internal.WrapError(err, "key derivation failed")
+	}
+	return ed25519KeyFromMaterial(keyMaterial), nil
+}
+
+// AddCurveSecretKeys adds two secret keys on the same curve using scalar addition modulo the group order
+func AddCurveSecretKeys(key1, key2 *CurveSecretKey) (*CurveSecretKey, error) {
+	if key1 == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "first key cannot be nil")
+	}
+	if key2 == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "second key cannot be nil")
+	}
+	if key1.curve != key2.curve {
+		return nil, internal.WrapError(internal.ErrCurveUnsupported, fmt.Sprintf("cannot add %s and %s keys", key1.curve, key2.curve))
+	}
+
+	switch key1.curve {
+	case CurveP256:
+		keyMaterial, err := internal.AddSecretKeys(key1.scalar, key2.scalar)
+		if err != nil {
+			return nil, internal.WrapError(err, "secret key addition failed")
+		}
+		publicKey := make([]byte, 0, internal.UncompressedPublicKeySize)
+		publicKey = append(append(append(publicKey, 0x04), keyMaterial.PublicKeyXBytes[:]...), keyMaterial.PublicKeyYBytes[:]...)
+		return &CurveSecretKey{curve: CurveP256, scalar: keyMaterial.PrivateKeyBytes[:], publicKey: publicKey}, nil
+	case CurveEd25519:
+		keyMaterial, err := internal.AddEd25519SecretKeys(key1.scalar, key2.scalar)
+		if err != nil {
+			return nil, internal.WrapError(err, "secret key addition failed")
+		}
+		return ed25519KeyFromMaterial(keyMaterial), nil
+	default:
+		return nil, unsupportedCurve(key1.curve)
+	}
+}
+
+// AddCurvePublicKeys adds two public keys on the given curve. Private JWKs are accepted and their
+// public part is used.
+func AddCurvePublicKeys(curve Curve, key1, key2 jwk.Key) (jwk.Key, error) {
+	switch curve {
+	case CurveP256:
+		return AddPublicKeys(key1, key2)
+	case CurveEd25519:
+	default:
+		return nil, unsupportedCurve(curve)
+	}
+
+	publicKey1, err := ed25519PublicKeyBytes(key1, "first key")
+	if err != nil {
+		return nil, err
+	}
+	publicKey2, err := ed25519PublicKeyBytes(key2, "second key")
+	if err != nil {
+		return nil, err
+	}
+
+	sum, err := internal.AddEd25519PublicKeys(publicKey1, publicKey2)
+	if err != nil {
+		return nil, internal.WrapError(err, "public key addition failed")
+	}
+	return jwkFromRaw(ed25519.PublicKey(sum))
+}
+
+// ed25519PublicKeyBytes extracts the encoded public key from a public or private OKP Ed25519 JWK
+func ed25519PublicKeyBytes(key jwk.Key, keyName string) ([]byte, error) {
+	if key == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, fmt.Sprintf("%s cannot be nil", keyName))
+	}
+
+	var publicKey ed25519.PublicKey
+	if err := key.Raw(&publicKey); err != nil {
+		var privateKey ed25519.PrivateKey
+		if err := key.Raw(&privateKey); err != nil {
+			return nil, internal.WrapError(internal.ErrJWKExtraction, fmt.Sprintf("failed to extract %s as Ed25519 key", keyName))
+		}
+		publicKey = privateKey.Public().(ed25519.PublicKey)
+	}
+	return publicKey, nil
+}
+
+func ed25519KeyFromSeed(seed []byte) (*CurveSecretKey, error) {
+	keyMaterial, prefix, err := internal.Ed25519ExpandSeed(seed)
+	if err != nil {
+		return nil, internal.WrapError(err, "failed to expand Ed25519 seed")
+	}
+	key := ed25519KeyFromMaterial(keyMaterial)
+	key.seed = append([]byte{}, seed...)
+	key.prefix = prefix
+	return key, nil
+}
+
+func ed25519KeyFromMaterial(keyMaterial internal.Ed25519KeyMaterial) *CurveSecretKey {
+	return &CurveSecretKey{
+		curve:     CurveEd25519,
+		scalar:    keyMaterial.Scalar[:],
+		publicKey: keyMaterial.PublicKey[:],
+	}
+}
+
+func jwkFromRaw(raw interface{}) (jwk.Key, error) {
+	key, err := jwk.FromRaw(raw)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrJWKCreation, "failed to create JWK")
+	}
+	return key, nil
+}
+
+func unsupportedCurve(curve Curve) error {
+	return internal.WrapError(internal.ErrCurveUnsupported, fmt.Sprintf("unsupported curve %s", curve))
+}
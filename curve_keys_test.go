@@ -0,0 +1,193 @@
+package cvc
+
+import (
+	"bytes"
+	"crypto/ed25519"
+	"crypto/rand"
+	"errors"
+	"testing"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/MyNextID/cvc-go/pkg"
+	"github.com/lestrrat-go/jwx/v2/jwk"
+)
+
+func TestCurveKeys(t *testing.T) {
+	t.Run("Ed25519FromJWK", func(t *testing.T) {
+		_, edKey, err := ed25519.GenerateKey(rand.Reader)
+		if err != nil {
+			t.Fatalf("Failed to generate Ed25519 key: %v", err)
+		}
+		key, err := jwk.FromRaw(edKey)
+		if err != nil {
+			t.Fatalf("Failed to create JWK: %v", err)
+		}
+		secretKey, err := CurveSecretKeyFromJWK(key)
+		if err != nil {
+			t.Fatalf("CurveSecretKeyFromJWK failed: %v", err)
+		}
+		if secretKey.Curve() != CurveEd25519 {
+			t.Fatalf("Expected Ed25519 key, got %s", secretKey.Curve())
+		}
+		if !bytes.Equal(secretKey.PublicKeyBytes(), edKey.Public().(ed25519.PublicKey)) {
+			t.Errorf("Public key does not match crypto/ed25519")
+		}
+
+		roundTrip, err := secretKey.JWK()
+		if err != nil {
+			t.Fatalf("JWK failed: %v", err)
+		}
+		var raw ed25519.PrivateKey
+		if err := roundTrip.Raw(&raw); err != nil || !bytes.Equal(raw.Seed(), edKey.Seed()) {
+			t.Errorf("Private JWK does not round trip: %v", err)
+		}
+	})
+
+	for _, curve := range []Curve{CurveP256, CurveEd25519} {
+		t.Run(curve.String(), func(t *testing.T) {
+			key1, err := GenerateCurveSecretKey(curve)
+			if err != nil {
+				t.Fatalf("GenerateCurveSecretKey failed: %v", err)
+			}
+			key2, err := GenerateCurveSecretKey(curve)
+			if err != nil {
+				t.Fatalf("GenerateCurveSecretKey failed: %v", err)
+			}
+
+			// the public key of the summed scalars equals the sum of the public keys
+			sum, err := AddCurveSecretKeys(key1, key2)
+			if err != nil {
+				t.Fatalf("AddCurveSecretKeys failed: %v", err)
+			}
+			pub1, _ := key1.PublicKey()
+			pub2, _ := key2.PublicKey()
+			pubSum, err := AddCurvePublicKeys(curve, pub1, pub2)
+			if err != nil {
+				t.Fatalf("AddCurvePublicKeys failed: %v", err)
+			}
+			expected, _ := sum.PublicKey()
+			if !jwkEqual(t, pubSum, expected) {
+				t.Errorf("Sum of public keys does not match public key of summed secret keys")
+			}
+
+			master, err := GenerateSecretKey()
+			if err != nil {
+				t.Fatalf("Failed to generate master key: %v", err)
+			}
+			derived, err := DeriveCurveSecretKey(curve, master, []byte("context"), []byte("CVC-TEST-DST-v1.0"))
+			if err != nil {
+				t.Fatalf("DeriveCurveSecretKey failed: %v", err)
+			}
+			again, _ := DeriveCurveSecretKey(curve, master, []byte("context"), []byte("CVC-TEST-DST-v1.0"))
+			other, _ := DeriveCurveSecretKey(curve, master, []byte("context"), []byte("CVC-OTHER-DST-v1.0"))
+			if !bytes.Equal(derived.Scalar(), again.Scalar()) {
+				t.Errorf("Derivation is not deterministic")
+			}
+			if bytes.Equal(derived.Scalar(), other.Scalar()) {
+				t.Errorf("Different DSTs derived the same key")
+			}
+		})
+	}
+
+	t.Run("P256MatchesJWKFunctions", func(t *testing.T) {
+		master, _ := GenerateSecretKey()
+		context, dst := []byte("context"), []byte("CVC-TEST-DST-v1.0")
+		derivedJWK, err := DeriveSecretKey(master, context, dst)
+		if err != nil {
+			t.Fatalf("DeriveSecretKey failed: %v", err)
+		}
+		derived, err := DeriveCurveSecretKey(CurveP256, master, context, dst)
+		if err != nil {
+			t.Fatalf("DeriveCurveSecretKey failed: %v", err)
+		}
+		asJWK, err := derived.JWK()
+		if err != nil {
+			t.Fatalf("JWK failed: %v", err)
+		}
+		if !jwkEqual(t, asJWK, derivedJWK) {
+			t.Errorf("P-256 derivation differs from DeriveSecretKey")
+		}
+	})
+
+	t.Run("ComposedEd25519HasNoPrivateJWK", func(t *testing.T) {
+		key1, _ := GenerateCurveSecretKey(CurveEd25519)
+		key2, _ := GenerateCurveSecretKey(CurveEd25519)
+		sum, err := AddCurveSecretKeys(key1, key2)
+		if err != nil {
+			t.Fatalf("AddCurveSecretKeys failed: %v", err)
+		}
+		if _, err := sum.JWK(); !errors.Is(err, internal.ErrKeyTypeUnsupported) {
+			t.Errorf("Expected ErrKeyTypeUnsupported, got %v", err)
+		}
+	})
+
+	t.Run("InvalidInput", func(t *testing.T) {
+		p256Key, _ := GenerateCurveSecretKey(CurveP256)
+		edKey, _ := GenerateCurveSecretKey(CurveEd25519)
+		if _, err := AddCurveSecretKeys(p256Key, edKey); !errors.Is(err, internal.ErrCurveUnsupported) {
+			t.Errorf("Expected ErrCurveUnsupported for mixed curves, got %v", err)
+		}
+
+		// the identity point encodes as y = 1
+		identity := make([]byte, ed25519.PublicKeySize)
+		identity[0] = 1
+		identityJWK, _ := jwk.FromRaw(ed25519.PublicKey(identity))
+		edPub, _ := edKey.PublicKey()
+		if _, err := AddCurvePublicKeys(CurveEd25519, edPub, identityJWK); !errors.Is(err, internal.ErrInvalidKey) {
+			t.Errorf("Expected ErrInvalidKey for small order point, got %v", err)
+		}
+		if _, err := GenerateCurveSecretKey(Curve(7)); !errors.Is(err, internal.ErrCurveUnsupported) {
+			t.Errorf("Expected ErrCurveUnsupported, got %v", err)
+		}
+	})
+}
+
+func jwkEqual(t testing.TB, a, b jwk.Key) bool {
+	t.Helper()
+	aJSON, err := pkg.KeyJWKToJson(a)
+	if err != nil {
+		t.Fatalf("Failed to marshal JWK: %v", err)
+	}
+	bJSON, err := pkg.KeyJWKToJson(b)
+	if err != nil {
+		t.Fatalf("Failed to marshal JWK: %v", err)
+	}
+	return bytes.Equal(aJSON, bJSON)
+}
+
+func BenchmarkCurveKeys(b *testing.B) {
+	master, err := GenerateSecretKey()
+	if err != nil {
+		b.Fatalf("Failed to generate master key: %v", err)
+	}
+	context, dst := []byte("context"), []byte("CVC-BENCH-DST-v1.0")
+
+	for _, curve := range []Curve{CurveP256, CurveEd25519} {
+		key1, _ := GenerateCurveSecretKey(curve)
+		key2, _ := GenerateCurveSecretKey(curve)
+		pub1, _ := key1.PublicKey()
+		pub2, _ := key2.PublicKey()
+
+		b.Run(curve.String()+"/Derive", func(b *testing.B) {
+			for i := 0; i < b.N; i++ {
+				if _, err := DeriveCurveSecretKey(curve, master, context, dst); err != nil {
+					b.Fatal(err)
+				}
+			}
+		})
+		b.Run(curve.String()+"/AddSecretKeys", func(b *testing.B) {
+			for i := 0; i < b.N; i++ {
+				if _, err := AddCurveSecretKeys(key1, key2); err != nil {
+					b.Fatal(err)
+				}
+			}
+		})
+		b.Run(curve.String()+"/AddPublicKeys", func(b *testing.B) {
+			for i := 0; i < b.N; i++ {
+				if _, err := AddCurvePublicKeys(curve, pub1, pub2); err != nil {
+					b.Fatal(err)
+				}
+			}
+		})
+	}
+}
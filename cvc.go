@@ -1,6 +1,7 @@
 package cvc
 
 import (
+	"context"
 	"crypto/ecdsa"
 	"crypto/elliptic"
 	"crypto/rand"
@@ -77,6 +78,59 @@ func AddSecretKeys(key1, key2 jwk.Key) (jwk.Key, error) {
 	return resultJWK, nil
 }
 
+// AddSecretKeysWithPublic adds two ECDSA private keys like AddSecretKeys, but derives the resulting
+// public key by adding the public keys embedded in key1 and key2 instead of multiplying the generator.
+// This is much cheaper when recombining keys whose public parts are already known, such as the VC and
+// wallet provider secret keys. The embedded public keys are checked to lie on the curve; if verify is
+// set, the result is also checked against the summed private key at the cost of a full multiplication.
+func AddSecretKeysWithPublic(key1, key2 jwk.Key, verify bool) (jwk.Key, error) {
+	// Input validation
+	if key1 == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "first key cannot be nil")
+	}
+	if key2 == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "second key cannot be nil")
+	}
+
+	// Extract private keys from JWKs
+	privateKey1, err := extractPrivateKey(key1, "first key")
+	if err != nil {
+		return nil, err
+	}
+
+	privateKey2, err := extractPrivateKey(key2, "second key")
+	if err != nil {
+		return nil, err
+	}
+
+	if privateKey1.X == nil || privateKey1.Y == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "first key has no public coordinates")
+	}
+	if privateKey2.X == nil || privateKey2.Y == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "second key has no public coordinates")
+	}
+
+	// Perform scalar and point addition using internal C bindings
+	resultKeyMaterial, err := internal.AddSecretKeysWithPublic(
+		privateKeyToBytes(privateKey1.D),
+		pkg.PublicECDSAToBytes(&privateKey1.PublicKey),
+		privateKeyToBytes(privateKey2.D),
+		pkg.PublicECDSAToBytes(&privateKey2.PublicKey),
+		verify,
+	)
+	if err != nil {
+		return nil, internal.WrapError(err, "secret key addition failed")
+	}
+
+	// Convert result to JWK
+	resultJWK, err := keyMaterialToJWK(resultKeyMaterial)
+	if err != nil {
+		return nil, internal.WrapError(err, "failed to convert result to JWK")
+	}
+
+	return resultJWK, nil
+}
+
 // AddPublicKeys adds two ECDSA public keys using elliptic curve point addition
 func AddPublicKeys(key1, key2 jwk.Key) (jwk.Key, error) {
 	// Input validation
@@ -98,6 +152,27 @@ func AddPublicKeys(key1, key2 jwk.Key) (jwk.Key, error) {
 		return nil, err
 	}
 
+	return addValidatedPublicKeys(pubKey1, pubKey2)
+}
+
+// addTrustedPublicKeys is AddPublicKeys for keys that have already passed point validation, such as wallet
+// provider keys checked with ValidatePublicKeysBatch at F0
+func addTrustedPublicKeys(key1, key2 jwk.Key) (jwk.Key, error) {
+	pubKey1, err := rawPublicKey(key1, "first key")
+	if err != nil {
+		return nil, err
+	}
+
+	pubKey2, err := rawPublicKey(key2, "second key")
+	if err != nil {
+		return nil, err
+	}
+
+	return addValidatedPublicKeys(pubKey1, pubKey2)
+}
+
+// addValidatedPublicKeys adds two public keys that are known to be valid curve points
+func addValidatedPublicKeys(pubKey1, pubKey2 *ecdsa.PublicKey) (jwk.Key, error) {
 	// Convert to uncompressed point format
 	pubKey1Bytes := pkg.PublicECDSAToBytes(pubKey1)
 	pubKey2Bytes := pkg.PublicECDSAToBytes(pubKey2)
@@ -149,15 +224,7 @@ func DeriveSecretKey(master jwk.Key, context, dst []byte) (jwk.Key, error) {
 		return nil, internal.WrapError(internal.ErrJWKExtraction, "failed to convert master key to JSON")
 	}
 
-	// Perform additional size validations
-	if err := internal.ValidateInputSize(masterBytes, 2048, "master key JSON"); err != nil {
-		return nil, err
-	}
-
-	if err := internal.ValidateInputSize(context, 2048, "context"); err != nil {
-		return nil, err
-	}
-
+	// Master key and context are absorbed in place and may have any size; only the DST is bounded
 	if err := internal.ValidateInputSize(dst, 256, "domain separation tag"); err != nil {
 		return nil, err
 	}
@@ -261,6 +328,21 @@ func extractPrivateKey(key jwk.Key, keyName string) (*ecdsa.PrivateKey, error) {
 
 // extractPublicKey extracts an ECDSA public key from a JWK
 func extractPublicKey(key jwk.Key, keyName string) (*ecdsa.PublicKey, error) {
+	pubKey, err := rawPublicKey(key, keyName)
+	if err != nil {
+		return nil, err
+	}
+
+	// Validate public key
+	if err := validatePublicKey(pubKey); err != nil {
+		return nil, internal.WrapError(err, fmt.Sprintf("%s validation failed", keyName))
+	}
+
+	return pubKey, nil
+}
+
+// rawPublicKey extracts a P-256 public key from a JWK without checking that it is a valid curve point
+func rawPublicKey(key jwk.Key, keyName string) (*ecdsa.PublicKey, error) {
 	// Try to extract as public key first
 	var pubKey ecdsa.PublicKey
 	if err := key.Raw(&pubKey); err != nil {
@@ -277,11 +359,6 @@ func extractPublicKey(key jwk.Key, keyName string) (*ecdsa.PublicKey, error) {
 		return nil, internal.WrapError(internal.ErrCurveUnsupported, fmt.Sprintf("%s is not on P-256 curve", keyName))
 	}
 
-	// Validate public key
-	if err := validatePublicKey(&pubKey); err != nil {
-		return nil, internal.WrapError(err, fmt.Sprintf("%s validation failed", keyName))
-	}
-
 	return &pubKey, nil
 }
 
@@ -303,6 +380,69 @@ func validatePublicKey(pubKey *ecdsa.PublicKey) error {
 	return nil
 }
 
+// ValidatePublicKeysBatch validates many P-256 public keys at once. It accepts exactly the keys that
+// pass the per-key validation of AddPublicKeys, but checks all curve equations in a single C call
+// instead of one key at a time. The error names the index of the first invalid key.
+func ValidatePublicKeysBatch(keys []jwk.Key) error {
+	return ValidatePublicKeysBatchContext(context.Background(), keys)
+}
+
+// ValidatePublicKeysBatchContext is ValidatePublicKeysBatch that checks the keys in chunks and returns
+// ctx.Err() once ctx is done
+func ValidatePublicKeysBatchContext(ctx context.Context, keys []jwk.Key) error {
+	points := make([]byte, len(keys)*internal.UncompressedPublicKeySize)
+	for i, key := range keys {
+		keyName := fmt.Sprintf("public key %d", i)
+		if key == nil {
+			return internal.WrapError(internal.ErrInvalidKey, fmt.Sprintf("%s cannot be nil", keyName))
+		}
+		pubKey, err := rawPublicKey(key, keyName)
+		if err != nil {
+			return err
+		}
+		if !putUncompressedPoint(points[i*internal.UncompressedPublicKeySize:], pubKey) {
+			return internal.WrapError(internal.ErrKeyNotOnCurve, fmt.Sprintf("%s coordinates are out of range", keyName))
+		}
+	}
+
+	chunkBytes := validateChunkSize * internal.UncompressedPublicKeySize
+	for start := 0; start < len(points); start += chunkBytes {
+		end := start + chunkBytes
+		if end > len(points) {
+			end = len(points)
+		}
+		var valid []bool
+		err := runBulk(ctx, len(keys), func() (err error) {
+			valid, err = internal.ValidatePublicKeysBatch(points[start:end])
+			return err
+		})
+		if err != nil {
+			// name the first invalid key by its position in keys rather than in the chunk
+			for i, ok := range valid {
+				if !ok {
+					index := start/internal.UncompressedPublicKeySize + i
+					return fmt.Errorf("%w: public key %d is not a valid curve point", internal.ErrKeyNotOnCurve, index)
+				}
+			}
+			return err
+		}
+	}
+	return nil
+}
+
+// putUncompressedPoint encodes a public key as 0x04 || x || y into dst without the on-curve check of
+// elliptic.Marshal. It reports false if a coordinate does not fit.
+func putUncompressedPoint(dst []byte, pubKey *ecdsa.PublicKey) bool {
+	if pubKey.X == nil || pubKey.Y == nil || pubKey.X.Sign() < 0 || pubKey.Y.Sign() < 0 ||
+		pubKey.X.BitLen() > 256 || pubKey.Y.BitLen() > 256 {
+		return false
+	}
+	dst[0] = 0x04
+	pubKey.X.FillBytes(dst[1:33])
+	pubKey.Y.FillBytes(dst[33:internal.UncompressedPublicKeySize])
+	return true
+}
+
 // validateDerivedKey performs additional validation on a derived key
 func validateDerivedKey(key jwk.Key) error {
 	// Extract and validate the derived private key
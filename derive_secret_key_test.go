@@ -1,11 +1,15 @@
 package cvc
 
 import (
+	"bytes"
 	"crypto/ecdsa"
 	"crypto/elliptic"
+	"encoding/hex"
 	"fmt"
+	"strings"
 	"testing"
 
+	"github.com/MyNextID/cvc-go/internal"
 	"github.com/MyNextID/cvc-go/pkg"
 )
 
@@ -212,17 +216,6 @@ func TestDeriveSecretKey(t *testing.T) {
 		}
 		t.Logf("Correctly rejected empty DST: %v", err)
 
-		// Test oversized context (>2048 bytes)
-		oversizedContext := make([]byte, 2049)
-		for i := range oversizedContext {
-			oversizedContext[i] = byte(i % 256)
-		}
-		_, err = DeriveSecretKey(masterKey, oversizedContext, validDST)
-		if err == nil {
-			t.Errorf("Expected error for oversized context, but got none")
-		}
-		t.Logf("Correctly rejected oversized context: %v", err)
-
 		// Test oversized DST (>256 bytes)
 		oversizedDST := make([]byte, 257)
 		for i := range oversizedDST {
@@ -312,4 +305,85 @@ func TestDeriveSecretKey(t *testing.T) {
 
 		t.Logf("Multiple derivations test passed - generated %d unique keys", numDerivations)
 	})
+
+	t.Run("KnownAnswers", func(t *testing.T) {
+		// outputs of the original staging-buffer implementation, which derivation must reproduce exactly
+		dst := []byte("CVC-KAT-DST-v1.0")
+		longContext := make([]byte, 2999)
+		for i := range longContext {
+			longContext[i] = byte('a' + i%26)
+		}
+
+		for _, tc := range []struct {
+			master, context []byte
+			expected        string
+		}{
+			{[]byte("master-key-material"), []byte("credential-context"), "76daf391df3c655eff9d38f9735e200ca665840ced2e506958d6cfa7135f7a77"},
+			{[]byte("m"), longContext, "99089b8e42bf01c5a7d9f9071cbe91bc27d5f9ac1cb2ab8775ac9d245fd7c4f0"},
+		} {
+			keyMaterial, err := internal.DeriveSecretKey(tc.master, tc.context, dst)
+			if err != nil {
+				t.Fatalf("DeriveSecretKey failed: %v", err)
+			}
+			if got := hex.EncodeToString(keyMaterial.PrivateKeyBytes[:]); got != tc.expected {
+				t.Errorf("Derived key %s, expected %s", got, tc.expected)
+			}
+		}
+	})
+
+	t.Run("UnboundedInput", func(t *testing.T) {
+		masterKey, err := GenerateSecretKey()
+		if err != nil {
+			t.Fatalf("Failed to generate master key: %v", err)
+		}
+		dst := []byte("CVC-UNBOUNDED-TEST-DST-v1.0")
+
+		// e.g. a full credential used as context, well beyond the former 2048 byte limit
+		context := []byte(strings.Repeat("credential-digest-input|", 1<<16))
+		derivedKey, err := DeriveSecretKey(masterKey, context, dst)
+		if err != nil {
+			t.Fatalf("DeriveSecretKey failed with %d byte context: %v", len(context), err)
+		}
+		var privateKey ecdsa.PrivateKey
+		if err := derivedKey.Raw(&privateKey); err != nil {
+			t.Fatalf("Failed to extract derived private key: %v", err)
+		}
+		if !privateKey.Curve.IsOnCurve(privateKey.X, privateKey.Y) {
+			t.Errorf("Derived public key point is not on the curve")
+		}
+
+		// only the concatenation of the segments matters, not how it is split
+		whole, err := internal.DeriveSecretKeySegments(dst, context)
+		if err != nil {
+			t.Fatalf("DeriveSecretKeySegments failed: %v", err)
+		}
+		split, err := internal.DeriveSecretKeySegments(dst, context[:1], nil, context[1:777], context[777:])
+		if err != nil {
+			t.Fatalf("DeriveSecretKeySegments failed: %v", err)
+		}
+		if !bytes.Equal(whole.PrivateKeyBytes[:], split.PrivateKeyBytes[:]) {
+			t.Errorf("Derivation depends on segmentation")
+		}
+
+		if _, err := internal.DeriveSecretKeySegments(dst, nil, []byte{}); err == nil {
+			t.Errorf("Expected error for empty derivation input")
+		}
+	})
+}
+
+func BenchmarkDeriveSecretKey(b *testing.B) {
+	dst := []byte("CVC-BENCH-DST-v1.0")
+	master := bytes.Repeat([]byte{0x42}, 32)
+
+	for _, size := range []int{64, 2048, 64 * 1024} {
+		context := bytes.Repeat([]byte("c"), size)
+		b.Run(fmt.Sprintf("Context%d", size), func(b *testing.B) {
+			b.SetBytes(int64(size))
+			for i := 0; i < b.N; i++ {
+				if _, err := internal.DeriveSecretKey(master, context, dst); err != nil {
+					b.Fatal(err)
+				}
+			}
+		})
+	}
 }
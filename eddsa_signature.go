@@ -0,0 +1,134 @@
+package cvc
+
+import (
+	"context"
+	"crypto/ed25519"
+	"crypto/sha512"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/lestrrat-go/jwx/v2/jwk"
+)
+
+// EdDSA is the JWS algorithm name of Ed25519 signatures (RFC 8037)
+const EdDSA = "EdDSA"
+
+// eddsaPrefixLabel domain-separates the nonce prefix of Ed25519 keys that have no RFC 8032 seed
+const eddsaPrefixLabel = "cvc-eddsa-v1 nonce prefix"
+
+// EdDSASigner is a prepared Ed25519 signing handle. It holds the expanded secret key (scalar, nonce
+// prefix and public key) and the encoded JWS protected header, so a signature costs one fixed-base
+// scalar multiplication and two SHA-512 passes. A signer is safe for concurrent use.
+//
+// Signatures are deterministic. For keys created from an RFC 8032 private key they are identical to
+// ed25519.Sign; derived and composed keys have no seed, so their nonce prefix is derived from the scalar.
+type EdDSASigner struct {
+	keyMaterial internal.Ed25519KeyMaterial
+	prefix      []byte
+	header      []byte // base64url encoded protected header followed by '.'
+}
+
+// NewEdDSASigner prepares a signer for an Ed25519 secret key. keyID is placed in the "kid" header of
+// JWS signatures and may be empty.
+func NewEdDSASigner(key *CurveSecretKey, keyID string) (*EdDSASigner, error) {
+	if key == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "signing key cannot be nil")
+	}
+	if key.curve != CurveEd25519 {
+		return nil, internal.WrapError(internal.ErrCurveUnsupported, "EdDSA signing requires an Ed25519 key")
+	}
+
+	signer := &EdDSASigner{prefix: key.prefix}
+	copy(signer.keyMaterial.Scalar[:], key.scalar)
+	copy(signer.keyMaterial.PublicKey[:], key.publicKey)
+
+	if signer.prefix == nil {
+		digest := sha512.Sum512(append([]byte(eddsaPrefixLabel), key.scalar...))
+		signer.prefix = digest[:internal.Ed25519PrefixSize]
+	}
+
+	var err error
+	if signer.header, err = encodeJWSHeader(EdDSA, keyID); err != nil {
+		return nil, err
+	}
+	return signer, nil
+}
+
+// PublicKey returns the signer's public key as an OKP JWK
+func (s *EdDSASigner) PublicKey() (jwk.Key, error) {
+	return jwkFromRaw(ed25519.PublicKey(append([]byte{}, s.keyMaterial.PublicKey[:]...)))
+}
+
+// Sign returns an Ed25519 signature over message
+func (s *EdDSASigner) Sign(message []byte) ([]byte, error) {
+	signature := make([]byte, internal.Ed25519SignatureSize)
+	if err := s.signInto(message, signature); err != nil {
+		return nil, err
+	}
+	return signature, nil
+}
+
+func (s *EdDSASigner) signInto(message, signature []byte) error {
+	return internal.Ed25519Sign(&s.keyMaterial, s.prefix, message, signature)
+}
+
+// SignJWS signs payload and returns a compact JWS serialization (header.payload.signature)
+func (s *EdDSASigner) SignJWS(payload []byte) ([]byte, error) {
+	return signJWS(s.header, payload, internal.Ed25519SignatureSize, s.signInto)
+}
+
+// SignBatch signs every payload as compact JWS, spreading the work over all available CPUs. The
+// result has the same order as payloads. If any signature fails, the first error is returned.
+func (s *EdDSASigner) SignBatch(payloads [][]byte) ([][]byte, error) {
+	return signBatch(context.Background(), payloads, s.SignJWS)
+}
+
+// SignBatchContext is SignBatch that stops starting new signatures once ctx is done and returns ctx.Err()
+func (s *EdDSASigner) SignBatchContext(ctx context.Context, payloads [][]byte) ([][]byte, error) {
+	return signBatch(ctx, payloads, s.SignJWS)
+}
+
+// EdDSAVerifier is a prepared Ed25519 verification handle, safe for concurrent use
+type EdDSAVerifier struct {
+	publicKey []byte
+}
+
+// NewEdDSAVerifier prepares a verifier for a public or private OKP Ed25519 JWK. Keys that are not
+// points of large order are rejected here rather than on every verification.
+func NewEdDSAVerifier(key jwk.Key) (*EdDSAVerifier, error) {
+	publicKey, err := ed25519PublicKeyBytes(key, "verification key")
+	if err != nil {
+		return nil, err
+	}
+	if err := internal.ValidateEd25519PublicKey(publicKey); err != nil {
+		return nil, err
+	}
+	return &EdDSAVerifier{publicKey: append([]byte{}, publicKey...)}, nil
+}
+
+// Verify checks an Ed25519 signature over message
+func (v *EdDSAVerifier) Verify(message, signature []byte) error {
+	return internal.Ed25519VerifyPrepared(v.publicKey, message, signature)
+}
+
+// VerifyJWS verifies a compact JWS with algorithm EdDSA and returns its decoded payload
+func (v *EdDSAVerifier) VerifyJWS(token []byte) ([]byte, error) {
+	signingInput, signature, encPayload, err := parseJWS(token, EdDSA)
+	if err != nil {
+		return nil, err
+	}
+	if err := v.Verify(signingInput, signature); err != nil {
+		return nil, err
+	}
+	return decodeJWSPayload(encPayload)
+}
+
+// VerifyJWSClaims verifies a compact JWS with algorithm EdDSA and returns its claims. The top level
+// is indexed and checked for duplicate claims and syntax errors first; nested values are only decoded
+// when they are read.
+func (v *EdDSAVerifier) VerifyJWSClaims(token []byte) (*Claims, error) {
+	payload, err := v.VerifyJWS(token)
+	if err != nil {
+		return nil, err
+	}
+	return parseVerifiedClaims(payload)
+}
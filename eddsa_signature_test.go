@@ -0,0 +1,223 @@
+package cvc
+
+import (
+	"bytes"
+	"crypto/ed25519"
+	"errors"
+	"fmt"
+	"math/big"
+	"testing"
+
+	"github.com/MyNextID/cvc-go/internal"
+)
+
+func TestEdDSASignature(t *testing.T) {
+	key, err := GenerateCurveSecretKey(CurveEd25519)
+	if err != nil {
+		t.Fatalf("GenerateCurveSecretKey failed: %v", err)
+	}
+	signer, err := NewEdDSASigner(key, "issuer-key-1")
+	if err != nil {
+		t.Fatalf("NewEdDSASigner failed: %v", err)
+	}
+	publicKey, err := signer.PublicKey()
+	if err != nil {
+		t.Fatalf("PublicKey failed: %v", err)
+	}
+	verifier, err := NewEdDSAVerifier(publicKey)
+	if err != nil {
+		t.Fatalf("NewEdDSAVerifier failed: %v", err)
+	}
+	payload := []byte(`{"iss":"https://issuer.example.com","vc":{"type":["VerifiableCredential"]}}`)
+
+	t.Run("SignVerify", func(t *testing.T) {
+		signature, err := signer.Sign(payload)
+		if err != nil {
+			t.Fatalf("Sign failed: %v", err)
+		}
+		if err := verifier.Verify(payload, signature); err != nil {
+			t.Errorf("Verify failed: %v", err)
+		}
+		if err := verifier.Verify([]byte("other"), signature); !errors.Is(err, internal.ErrInvalidSignature) {
+			t.Errorf("Expected invalid signature for other message, got %v", err)
+		}
+		if err := verifier.Verify(payload, signature[:10]); !errors.Is(err, internal.ErrInvalidSignature) {
+			t.Errorf("Expected invalid signature for short signature, got %v", err)
+		}
+	})
+
+	t.Run("MatchesCryptoEd25519", func(t *testing.T) {
+		// RFC 8032 section 7.1, test 2
+		seed, _ := new(big.Int).SetString("4ccd089b28ff96da9db6c346ec114e0f5b8a319f35aba624da8cf6ed4fb8a6fb", 16)
+		privateKey := ed25519.NewKeyFromSeed(seed.FillBytes(make([]byte, ed25519.SeedSize)))
+		privateJWK, err := jwkFromRaw(privateKey)
+		if err != nil {
+			t.Fatalf("Failed to create JWK: %v", err)
+		}
+		key, err := CurveSecretKeyFromJWK(privateJWK)
+		if err != nil {
+			t.Fatalf("CurveSecretKeyFromJWK failed: %v", err)
+		}
+		signer, err := NewEdDSASigner(key, "")
+		if err != nil {
+			t.Fatalf("NewEdDSASigner failed: %v", err)
+		}
+		for _, message := range [][]byte{{}, {0x72}, payload} {
+			signature, err := signer.Sign(message)
+			if err != nil {
+				t.Fatalf("Sign failed: %v", err)
+			}
+			if !bytes.Equal(signature, ed25519.Sign(privateKey, message)) {
+				t.Errorf("Signature over %d bytes differs from crypto/ed25519", len(message))
+			}
+		}
+	})
+
+	t.Run("ComposedKey", func(t *testing.T) {
+		other, err := GenerateCurveSecretKey(CurveEd25519)
+		if err != nil {
+			t.Fatalf("GenerateCurveSecretKey failed: %v", err)
+		}
+		composed, err := AddCurveSecretKeys(key, other)
+		if err != nil {
+			t.Fatalf("AddCurveSecretKeys failed: %v", err)
+		}
+		signer, err := NewEdDSASigner(composed, "")
+		if err != nil {
+			t.Fatalf("NewEdDSASigner failed: %v", err)
+		}
+		signature, err := signer.Sign(payload)
+		if err != nil {
+			t.Fatalf("Sign failed: %v", err)
+		}
+		if !ed25519.Verify(composed.PublicKeyBytes(), payload, signature) {
+			t.Errorf("crypto/ed25519 rejects signature of composed key")
+		}
+	})
+
+	t.Run("JWS", func(t *testing.T) {
+		token, err := signer.SignJWS(payload)
+		if err != nil {
+			t.Fatalf("SignJWS failed: %v", err)
+		}
+		decoded, err := verifier.VerifyJWS(token)
+		if err != nil {
+			t.Fatalf("VerifyJWS failed: %v", err)
+		}
+		if !bytes.Equal(decoded, payload) {
+			t.Errorf("Decoded payload does not match")
+		}
+
+		tampered := append([]byte{}, token...)
+		tampered[bytes.IndexByte(token, '.')+2] ^= 0x01
+		if _, err := verifier.VerifyJWS(tampered); err == nil {
+			t.Errorf("Expected error for tampered payload")
+		}
+
+		// a token for another algorithm is rejected before the signature is checked
+		es256Token := append([]byte("eyJhbGciOiJFUzI1NiJ9"), token[bytes.IndexByte(token, '.'):]...)
+		if _, err := verifier.VerifyJWS(es256Token); !errors.Is(err, internal.ErrInvalidParameters) {
+			t.Errorf("Expected error for ES256 header, got %v", err)
+		}
+	})
+
+	t.Run("BatchSign", func(t *testing.T) {
+		payloads := make([][]byte, 16)
+		for i := range payloads {
+			payloads[i] = []byte(fmt.Sprintf(`{"sub":"user-%d"}`, i))
+		}
+		tokens, err := signer.SignBatch(payloads)
+		if err != nil {
+			t.Fatalf("SignBatch failed: %v", err)
+		}
+		for i, token := range tokens {
+			decoded, err := verifier.VerifyJWS(token)
+			if err != nil {
+				t.Fatalf("VerifyJWS failed for token %d: %v", i, err)
+			}
+			if !bytes.Equal(decoded, payloads[i]) {
+				t.Errorf("Token %d carries the wrong payload", i)
+			}
+		}
+	})
+
+	t.Run("InvalidKeys", func(t *testing.T) {
+		p256Key, err := GenerateCurveSecretKey(CurveP256)
+		if err != nil {
+			t.Fatalf("GenerateCurveSecretKey failed: %v", err)
+		}
+		if _, err := NewEdDSASigner(p256Key, ""); !errors.Is(err, internal.ErrCurveUnsupported) {
+			t.Errorf("Expected unsupported curve error for P-256 key, got %v", err)
+		}
+
+		// the identity point has small order
+		identity := make([]byte, ed25519.PublicKeySize)
+		identity[0] = 1
+		identityJWK, err := jwkFromRaw(ed25519.PublicKey(identity))
+		if err != nil {
+			t.Fatalf("Failed to create JWK: %v", err)
+		}
+		if _, err := NewEdDSAVerifier(identityJWK); !internal.IsKeyError(err) {
+			t.Errorf("Expected key error for small order public key, got %v", err)
+		}
+	})
+}
+
+func BenchmarkEdDSASignature(b *testing.B) {
+	key, err := GenerateCurveSecretKey(CurveEd25519)
+	if err != nil {
+		b.Fatalf("GenerateCurveSecretKey failed: %v", err)
+	}
+	signer, err := NewEdDSASigner(key, "")
+	if err != nil {
+		b.Fatalf("NewEdDSASigner failed: %v", err)
+	}
+	publicKey, _ := signer.PublicKey()
+	verifier, _ := NewEdDSAVerifier(publicKey)
+
+	// ES256 with crypto/ecdsa, for comparison
+	ecKey, _ := GenerateSecretKey()
+	es256Signer, err := NewES256Signer(ecKey, "")
+	if err != nil {
+		b.Fatalf("NewES256Signer failed: %v", err)
+	}
+	es256Verifier, _ := NewES256Verifier(ecKey)
+
+	payload := bytes.Repeat([]byte("a"), 1024)
+
+	b.Run("EdDSA/SignJWS", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			if _, err := signer.SignJWS(payload); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("EdDSA/VerifyJWS", func(b *testing.B) {
+		token, _ := signer.SignJWS(payload)
+		b.ResetTimer()
+		for i := 0; i < b.N; i++ {
+			if _, err := verifier.VerifyJWS(token); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("ES256/SignJWS", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			if _, err := es256Signer.SignJWS(payload); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("ES256/VerifyJWS", func(b *testing.B) {
+		token, _ := es256Signer.SignJWS(payload)
+		b.ResetTimer()
+		for i := 0; i < b.N; i++ {
+			if _, err := es256Verifier.VerifyJWS(token); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+}
@@ -0,0 +1,57 @@
+package cvc
+
+import (
+	"context"
+
+	"github.com/MyNextID/cvc-go/internal"
+)
+
+// Bulk operations (batch derivation and batch public key validation) run their C calls on a shared
+// executor: a fixed set of worker goroutines locked to OS threads. However many bulk requests are in
+// flight, they occupy at most ExecutorWorkers threads, so a provider that serves bulk derivation and
+// interactive endpoints from one binary keeps cores free for the interactive calls, which run inline.
+
+// executorMinBatch is the smallest batch that is handed to the executor; smaller batches are
+// interactive and run on the calling goroutine
+const executorMinBatch = 32
+
+// ExecutorStats is a snapshot of the bulk executor queue
+type ExecutorStats struct {
+	Workers   int    // number of locked worker threads
+	Queued    int64  // chunks waiting for a worker
+	Running   int64  // chunks currently running
+	PeakQueue int64  // largest number of waiting chunks seen since the executor started
+	Completed uint64 // chunks that ran to completion
+	Cancelled uint64 // chunks dropped from the queue because their context was done
+}
+
+// SetExecutorWorkers sets the number of threads used for bulk operations. By default it is one less
+// than GOMAXPROCS, and at least one. It must be called before the first bulk operation, typically at
+// program start, and returns an error afterwards.
+func SetExecutorWorkers(workers int) error {
+	return internal.SetDefaultExecutorWorkers(workers)
+}
+
+// ExecutorStatsSnapshot returns the current queue depth and job counts of the bulk executor. A queue
+// that stays deep means bulk work arrives faster than the configured workers can derive.
+func ExecutorStatsSnapshot() ExecutorStats {
+	return ExecutorStats(internal.DefaultExecutor().Stats())
+}
+
+// runBulk runs one chunk of a batch of batchSize items. Chunks of large batches run on the executor,
+// chunks of small batches inline; either way the chunk is skipped and ctx.Err() returned once ctx is done.
+// A chunk that panics on the executor is reported as an error, as it could not be recovered by the caller.
+func runBulk(ctx context.Context, batchSize int, fn func() error) error {
+	if batchSize < executorMinBatch {
+		if err := ctx.Err(); err != nil {
+			return err
+		}
+		return fn()
+	}
+
+	var err error
+	if runErr := internal.DefaultExecutor().Run(ctx, func() { err = fn() }); runErr != nil {
+		return runErr
+	}
+	return err
+}
@@ -0,0 +1,183 @@
+package cvc
+
+import (
+	"context"
+	"errors"
+	"sync"
+	"sync/atomic"
+	"testing"
+	"time"
+
+	"github.com/MyNextID/cvc-go/internal"
+)
+
+// waitFor polls cond until it holds or a second has passed
+func waitFor(t *testing.T, cond func() bool) {
+	t.Helper()
+	deadline := time.Now().Add(time.Second)
+	for !cond() {
+		if time.Now().After(deadline) {
+			t.Fatal("Condition not reached within a second")
+		}
+		time.Sleep(time.Millisecond)
+	}
+}
+
+func TestExecutor(t *testing.T) {
+	t.Run("BoundsConcurrency", func(t *testing.T) {
+		executor := internal.NewExecutor(2, 8)
+		var running, peak atomic.Int64
+		var wg sync.WaitGroup
+		for i := 0; i < 16; i++ {
+			wg.Add(1)
+			go func() {
+				defer wg.Done()
+				err := executor.Run(context.Background(), func() {
+					n := running.Add(1)
+					for p := peak.Load(); n > p && !peak.CompareAndSwap(p, n); p = peak.Load() {
+					}
+					time.Sleep(time.Millisecond)
+					running.Add(-1)
+				})
+				if err != nil {
+					t.Errorf("Run failed: %v", err)
+				}
+			}()
+		}
+		wg.Wait()
+
+		if peak.Load() > 2 {
+			t.Errorf("Expected at most 2 concurrent jobs, got %d", peak.Load())
+		}
+		if stats := executor.Stats(); stats.Completed != 16 || stats.Queued != 0 || stats.Running != 0 {
+			t.Errorf("Unexpected stats after all jobs: %+v", stats)
+		}
+	})
+
+	t.Run("QueueDepth", func(t *testing.T) {
+		executor := internal.NewExecutor(1, 4)
+		release := make(chan struct{})
+		var wg sync.WaitGroup
+		for i := 0; i < 3; i++ {
+			wg.Add(1)
+			go func() {
+				defer wg.Done()
+				executor.Run(context.Background(), func() { <-release })
+			}()
+		}
+
+		waitFor(t, func() bool {
+			stats := executor.Stats()
+			return stats.Running == 1 && stats.Queued == 2
+		})
+		close(release)
+		wg.Wait()
+
+		if stats := executor.Stats(); stats.PeakQueue < 2 || stats.Queued != 0 {
+			t.Errorf("Unexpected stats after draining: %+v", stats)
+		}
+	})
+
+	t.Run("CancelWhileQueued", func(t *testing.T) {
+		executor := internal.NewExecutor(1, 4)
+		release := make(chan struct{})
+		done := make(chan struct{})
+		go func() {
+			executor.Run(context.Background(), func() { <-release })
+			close(done)
+		}()
+		waitFor(t, func() bool { return executor.Stats().Running == 1 })
+
+		ctx, cancel := context.WithCancel(context.Background())
+		time.AfterFunc(10*time.Millisecond, cancel)
+		ran := false
+		if err := executor.Run(ctx, func() { ran = true }); !errors.Is(err, context.Canceled) {
+			t.Errorf("Expected context.Canceled, got %v", err)
+		}
+
+		close(release)
+		<-done
+		// the dropped job is dequeued and skipped; a later job must still run
+		if err := executor.Run(context.Background(), func() {}); err != nil {
+			t.Fatalf("Run failed: %v", err)
+		}
+		if ran {
+			t.Error("Cancelled job was run")
+		}
+		if stats := executor.Stats(); stats.Cancelled != 1 || stats.Completed != 2 {
+			t.Errorf("Unexpected stats: %+v", stats)
+		}
+	})
+
+	t.Run("PanicIsReturned", func(t *testing.T) {
+		executor := internal.NewExecutor(1, 1)
+		err := executor.Run(context.Background(), func() { panic("chunk failed") })
+		if !errors.Is(err, internal.ErrInternalError) {
+			t.Fatalf("Expected the panic as an internal error, got %v", err)
+		}
+		// the worker survives the panic
+		ran := false
+		if err := executor.Run(context.Background(), func() { ran = true }); err != nil || !ran {
+			t.Errorf("Worker did not run the next job: %v", err)
+		}
+
+		if err := runBulk(context.Background(), executorMinBatch, func() error { panic("chunk failed") }); !errors.Is(err, internal.ErrInternalError) {
+			t.Errorf("Expected runBulk to return the panic, got %v", err)
+		}
+	})
+
+	t.Run("BulkOperationsUseExecutor", func(t *testing.T) {
+		masterKey, err := GenerateSecretKey()
+		if err != nil {
+			t.Fatalf("Failed to generate master key: %v", err)
+		}
+		provider := &ProviderConfig{MasterSecretKey: masterKey, Dst: "CVC-TEST-DST-v1.0"}
+
+		before := ExecutorStatsSnapshot()
+		if _, err := provider.GeneratePublicKeys(testHashRequest(t, executorMinBatch)); err != nil {
+			t.Fatalf("GeneratePublicKeys failed: %v", err)
+		}
+		after := ExecutorStatsSnapshot()
+		if chunks := after.Completed - before.Completed; chunks < executorMinBatch/deriveChunkSize {
+			t.Errorf("Expected at least %d chunks on the executor, got %d", executorMinBatch/deriveChunkSize, chunks)
+		}
+		if after.Workers < 1 {
+			t.Errorf("Expected at least one worker, got %d", after.Workers)
+		}
+
+		// small requests run inline
+		if _, err := provider.GeneratePublicKeys(testHashRequest(t, 2)); err != nil {
+			t.Fatalf("GeneratePublicKeys failed: %v", err)
+		}
+		if ExecutorStatsSnapshot().Completed != after.Completed {
+			t.Error("Expected a small request to run inline")
+		}
+
+		if err := SetExecutorWorkers(2); err == nil {
+			t.Error("Expected SetExecutorWorkers to fail once the executor has started")
+		}
+	})
+}
+
+func BenchmarkExecutor(b *testing.B) {
+	executor := internal.NewExecutor(1, 4)
+	ctx := context.Background()
+
+	b.Run("RunEmpty", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			if err := executor.Run(ctx, func() {}); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("RunParallel", func(b *testing.B) {
+		b.RunParallel(func(pb *testing.PB) {
+			for pb.Next() {
+				if err := executor.Run(ctx, func() {}); err != nil {
+					b.Fatal(err)
+				}
+			}
+		})
+	})
+}
@@ -0,0 +1,193 @@
+package cvc
+
+import (
+	"bytes"
+	"crypto/hmac"
+	"crypto/sha256"
+	"encoding/binary"
+	"fmt"
+	"testing"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/MyNextID/cvc-go/pkg"
+)
+
+// referenceHKDF is RFC 5869 HKDF-SHA256 built on crypto/hmac
+func referenceHKDF(salt, ikm, info []byte, outLen int) []byte {
+	if len(salt) == 0 {
+		salt = make([]byte, sha256.Size)
+	}
+	extract := hmac.New(sha256.New, salt)
+	extract.Write(ikm)
+	prk := extract.Sum(nil)
+
+	var out, t []byte
+	for i := byte(1); len(out) < outLen; i++ {
+		expand := hmac.New(sha256.New, prk)
+		expand.Write(t)
+		expand.Write(info)
+		expand.Write([]byte{i})
+		t = expand.Sum(nil)
+		out = append(out, t...)
+	}
+	return out[:outLen]
+}
+
+// referenceKDF2 is IEEE 1363 KDF2 with SHA-256
+func referenceKDF2(z, param []byte, outLen int) []byte {
+	var out []byte
+	for counter := uint32(1); len(out) < outLen; counter++ {
+		h := sha256.New()
+		h.Write(z)
+		binary.Write(h, binary.BigEndian, counter)
+		h.Write(param)
+		out = h.Sum(out)
+	}
+	return out[:outLen]
+}
+
+func testBytes(n int, seed byte) []byte {
+	b := make([]byte, n)
+	for i := range b {
+		b[i] = byte(i)*31 + seed
+	}
+	return b
+}
+
+func TestPreparedHMAC(t *testing.T) {
+	keyLens := []int{0, 1, 32, 64, 65, 200}
+	messageLens := []int{0, 1, 55, 56, 64, 119, 300}
+
+	t.Run("MatchesCryptoHMAC", func(t *testing.T) {
+		for _, keyLen := range keyLens {
+			key := testBytes(keyLen, 1)
+			prepared, err := pkg.NewHMACKey(key)
+			if err != nil {
+				t.Fatalf("NewHMACKey failed: %v", err)
+			}
+			for _, messageLen := range messageLens {
+				message := testBytes(messageLen, 2)
+				tag, err := prepared.Sum(message)
+				if err != nil {
+					t.Fatalf("Sum failed: %v", err)
+				}
+				mac := hmac.New(sha256.New, key)
+				mac.Write(message)
+				if !bytes.Equal(tag, mac.Sum(nil)) {
+					t.Errorf("Tag mismatch for key length %d, message length %d", keyLen, messageLen)
+				}
+				if !prepared.Verify(message, tag) {
+					t.Errorf("Verify rejected a valid tag for key length %d, message length %d", keyLen, messageLen)
+				}
+				tag[0] ^= 1
+				if prepared.Verify(message, tag) || prepared.Verify(message, tag[:16]) {
+					t.Errorf("Verify accepted an invalid tag for key length %d, message length %d", keyLen, messageLen)
+				}
+			}
+		}
+	})
+
+	t.Run("HKDF", func(t *testing.T) {
+		for _, saltLen := range keyLens {
+			salt := testBytes(saltLen, 3)
+			prepared, err := pkg.NewHMACKey(salt)
+			if err != nil {
+				t.Fatalf("NewHMACKey failed: %v", err)
+			}
+			for _, outLen := range []int{1, 32, 44, 100} {
+				ikm, info := testBytes(64, 4), testBytes(outLen+10, 5)
+				want := referenceHKDF(salt, ikm, info, outLen)
+
+				got, err := prepared.HKDF(ikm, info, outLen)
+				if err != nil {
+					t.Fatalf("HKDF failed: %v", err)
+				}
+				if !bytes.Equal(got, want) {
+					t.Errorf("HKDF mismatch for salt length %d, output length %d", saltLen, outLen)
+				}
+
+				// the one-shot internal HKDF used by the envelopes must agree as well
+				got, err = internal.HKDF(salt, ikm, info, outLen)
+				if err != nil {
+					t.Fatalf("internal.HKDF failed: %v", err)
+				}
+				if !bytes.Equal(got, want) {
+					t.Errorf("internal.HKDF mismatch for salt length %d, output length %d", saltLen, outLen)
+				}
+			}
+		}
+
+		prepared, _ := pkg.NewHMACKey(nil)
+		if _, err := prepared.HKDF([]byte("ikm"), nil, 255*sha256.Size+1); err == nil {
+			t.Error("Expected an error for an output longer than 255 blocks")
+		}
+	})
+
+	t.Run("KDF2", func(t *testing.T) {
+		for _, zLen := range []int{0, 32, 65, 130} {
+			z := testBytes(zLen, 6)
+			secret, err := pkg.NewKDF2Secret(z)
+			if err != nil {
+				t.Fatalf("NewKDF2Secret failed: %v", err)
+			}
+			for _, outLen := range []int{1, 32, 48, 100} {
+				param := testBytes(outLen%17, 7)
+				got, err := secret.Derive(param, outLen)
+				if err != nil {
+					t.Fatalf("Derive failed: %v", err)
+				}
+				if !bytes.Equal(got, referenceKDF2(z, param, outLen)) {
+					t.Errorf("KDF2 mismatch for secret length %d, output length %d", zLen, outLen)
+				}
+			}
+		}
+	})
+
+	t.Run("Wipe", func(t *testing.T) {
+		prepared, err := pkg.NewHMACKey([]byte("request authentication key"))
+		if err != nil {
+			t.Fatalf("NewHMACKey failed: %v", err)
+		}
+		tag, _ := prepared.Sum([]byte("message"))
+		prepared.Wipe()
+		if prepared.Verify([]byte("message"), tag) {
+			t.Error("Expected a wiped key to produce different tags")
+		}
+	})
+}
+
+func BenchmarkPreparedHMAC(b *testing.B) {
+	key := testBytes(32, 1)
+	for _, size := range []int{32, 1024} {
+		message := testBytes(size, 2)
+
+		b.Run(fmt.Sprintf("Prepared/%d", size), func(b *testing.B) {
+			prepared, _ := pkg.NewHMACKey(key)
+			b.SetBytes(int64(size))
+			for i := 0; i < b.N; i++ {
+				if _, err := prepared.Sum(message); err != nil {
+					b.Fatal(err)
+				}
+			}
+		})
+
+		b.Run(fmt.Sprintf("PrepareEachCall/%d", size), func(b *testing.B) {
+			b.SetBytes(int64(size))
+			for i := 0; i < b.N; i++ {
+				prepared, _ := pkg.NewHMACKey(key)
+				if _, err := prepared.Sum(message); err != nil {
+					b.Fatal(err)
+				}
+			}
+		})
+	}
+
+	b.Run("HKDF/NoSalt", func(b *testing.B) {
+		ikm, info := testBytes(64, 3), testBytes(1219, 4)
+		for i := 0; i < b.N; i++ {
+			if _, err := internal.HKDF(nil, ikm, info, 44); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+}
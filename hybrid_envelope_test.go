@@ -0,0 +1,350 @@
+package cvc
+
+import (
+	"bytes"
+	"context"
+	"encoding/base64"
+	"encoding/json"
+	"errors"
+	"testing"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/MyNextID/cvc-go/pkg"
+	"github.com/lestrrat-go/jwx/v2/jwk"
+	"github.com/shamaton/msgpack/v2"
+)
+
+func TestHybridEnvelope(t *testing.T) {
+	secretKey, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate key: %v", err)
+	}
+	publicKey, err := secretKey.PublicKey()
+	if err != nil {
+		t.Fatalf("Failed to get public key: %v", err)
+	}
+	secretKey, kemPubKey := attachKEMSeed(t, secretKey)
+	payload := []byte("eyJhbGciOiJFUzI1NiJ9.eyJzdWIiOiJ0ZXN0In0.signature")
+
+	t.Run("RoundTrip", func(t *testing.T) {
+		envelope, err := pkg.EncryptHybrid(payload, publicKey, kemPubKey)
+		if err != nil {
+			t.Fatalf("EncryptHybrid failed: %v", err)
+		}
+		if !pkg.IsHybridEnvelope(envelope) {
+			t.Errorf("Envelope not recognized as hybrid")
+		}
+		decrypted, err := pkg.DecryptHybrid(envelope, secretKey)
+		if err != nil {
+			t.Fatalf("DecryptHybrid failed: %v", err)
+		}
+		if !bytes.Equal(decrypted, payload) {
+			t.Errorf("Decrypted payload does not match")
+		}
+	})
+
+	t.Run("KEMKeyPairFollowsSeed", func(t *testing.T) {
+		_, again, err := pkg.KEMKeyPair(secretKey)
+		if err != nil {
+			t.Fatalf("KEMKeyPair failed: %v", err)
+		}
+		if !bytes.Equal(again, kemPubKey) {
+			t.Errorf("KEM key pair is not reproduced from the seed")
+		}
+
+		// the same P-256 key with another seed has an unrelated KEM key
+		other, err := pkg.KeyJsonToJWK(mustJSON(t, secretKey))
+		if err != nil {
+			t.Fatalf("Failed to copy secret key: %v", err)
+		}
+		if _, otherPubKey := attachKEMSeed(t, other); bytes.Equal(otherPubKey, kemPubKey) {
+			t.Errorf("KEM key pair depends on the P-256 key instead of the seed")
+		}
+
+		plain, err := GenerateSecretKey()
+		if err != nil {
+			t.Fatalf("Failed to generate key: %v", err)
+		}
+		if _, _, err := pkg.KEMKeyPair(plain); !errors.Is(err, internal.ErrInvalidKey) {
+			t.Errorf("Expected error for a key without KEM seed, got %v", err)
+		}
+	})
+
+	t.Run("PublicJWKDropsSeed", func(t *testing.T) {
+		seededPub, err := pkg.PublicJWK(secretKey)
+		if err != nil {
+			t.Fatalf("PublicJWK failed: %v", err)
+		}
+		if _, ok := seededPub.Get(pkg.KEMSeedParam); ok {
+			t.Errorf("Public key carries the KEM seed")
+		}
+		if got, want := mustJSON(t, seededPub), mustJSON(t, publicKey); !bytes.Equal(got, want) {
+			t.Errorf("PublicJWK = %s, want %s", got, want)
+		}
+	})
+
+	t.Run("PreparedRecipient", func(t *testing.T) {
+		recipient, err := pkg.NewHybridRecipient(publicKey, kemPubKey)
+		if err != nil {
+			t.Fatalf("NewHybridRecipient failed: %v", err)
+		}
+		first, err := recipient.Encrypt(payload)
+		if err != nil {
+			t.Fatalf("Encrypt failed: %v", err)
+		}
+		second, err := recipient.Encrypt(payload)
+		if err != nil {
+			t.Fatalf("Encrypt failed: %v", err)
+		}
+		if bytes.Equal(first, second) {
+			t.Errorf("Envelopes for the same payload must differ")
+		}
+		for _, envelope := range [][]byte{first, second} {
+			if _, err := pkg.DecryptHybrid(envelope, secretKey); err != nil {
+				t.Errorf("DecryptHybrid failed: %v", err)
+			}
+		}
+	})
+
+	t.Run("TamperedEnvelope", func(t *testing.T) {
+		envelope, err := pkg.EncryptHybrid(payload, publicKey, kemPubKey)
+		if err != nil {
+			t.Fatalf("EncryptHybrid failed: %v", err)
+		}
+		// flip a bit in the KEM ciphertext, the AES ciphertext and the tag
+		for _, pos := range []int{100, len(envelope) - 20, len(envelope) - 1} {
+			tampered := append([]byte{}, envelope...)
+			tampered[pos] ^= 0x01
+			if _, err := pkg.DecryptHybrid(tampered, secretKey); !errors.Is(err, internal.ErrDecryption) {
+				t.Errorf("Expected decryption error for tampered byte %d, got %v", pos, err)
+			}
+		}
+	})
+
+	t.Run("WrongKey", func(t *testing.T) {
+		envelope, err := pkg.EncryptHybrid(payload, publicKey, kemPubKey)
+		if err != nil {
+			t.Fatalf("EncryptHybrid failed: %v", err)
+		}
+		otherKey, _ := GenerateSecretKey()
+		if _, err := pkg.DecryptHybrid(envelope, otherKey); err == nil {
+			t.Errorf("Expected error when decrypting with another key")
+		}
+	})
+
+	t.Run("InvalidInput", func(t *testing.T) {
+		if _, err := pkg.EncryptHybrid(payload, publicKey, kemPubKey[:100]); err == nil {
+			t.Errorf("Expected error for short KEM public key")
+		}
+		if _, err := pkg.DecryptHybrid([]byte{pkg.HybridEnvelopeV1, 1, 2, 3}, secretKey); !errors.Is(err, internal.ErrEnvelopeFormat) {
+			t.Errorf("Expected envelope format error, got %v", err)
+		}
+	})
+}
+
+// attachKEMSeed gives a secret key a random Kyber768 seed and returns it with the matching KEM public key
+func attachKEMSeed(t testing.TB, secretKey jwk.Key) (jwk.Key, []byte) {
+	t.Helper()
+	seed, err := pkg.GenerateKEMSeed()
+	if err != nil {
+		t.Fatalf("GenerateKEMSeed failed: %v", err)
+	}
+	if secretKey, err = pkg.WithKEMSeed(secretKey, seed); err != nil {
+		t.Fatalf("WithKEMSeed failed: %v", err)
+	}
+	_, kemPubKey, err := pkg.KEMKeyPair(secretKey)
+	if err != nil {
+		t.Fatalf("KEMKeyPair failed: %v", err)
+	}
+	return secretKey, kemPubKey
+}
+
+func mustJSON(t testing.TB, key jwk.Key) []byte {
+	t.Helper()
+	b, err := pkg.KeyJWKToJson(key)
+	if err != nil {
+		t.Fatalf("Failed to marshal key: %v", err)
+	}
+	return b
+}
+
+func TestHybridMessagePack(t *testing.T) {
+	masterKey, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate master key: %v", err)
+	}
+	kemMasterSeed, err := GenerateKEMMasterSeed()
+	if err != nil {
+		t.Fatalf("Failed to generate KEM master seed: %v", err)
+	}
+	provider := &ProviderConfig{MasterSecretKey: masterKey, Dst: "CVC-TEST-DST-v1.0", HybridKEM: true, KEMMasterSeed: kemMasterSeed}
+
+	// hash the way the issuer does, so the provider can resolve the key from the pack
+	salt := []byte("salt")
+	hash := base64.StdEncoding.EncodeToString(pkg.Hash(append([]byte("user@example.com"), salt...)))
+	keys, err := provider.GeneratePublicKeys([]byte(`["` + hash + `"]`))
+	if err != nil {
+		t.Fatalf("GeneratePublicKeys failed: %v", err)
+	}
+	var keyMap map[string]KeyData
+	if err := json.Unmarshal(keys, &keyMap); err != nil {
+		t.Fatalf("Failed to decode keys: %v", err)
+	}
+	if len(keyMap[hash].WpKemPubkey) != internal.KEMPublicKeySize {
+		t.Fatalf("Expected KEM public key in provider response")
+	}
+
+	wpPubKey, err := pkg.KeyJsonToJWK(keyMap[hash].WpPubkey)
+	if err != nil {
+		t.Fatalf("Failed to parse public key: %v", err)
+	}
+	userMap := map[string]*UserData{"user": {
+		Email:       "user@example.com",
+		Salt:        salt,
+		KeyID:       keyMap[hash].KeyID,
+		WpPubKey:    wpPubKey,
+		WpKemPubKey: keyMap[hash].WpKemPubkey,
+	}}
+
+	issuer := &IssuerConfig{ProviderURL: "https://wp.example.com", HybridKEM: true}
+	if _, _, err := issuer.AddCnfToPayload("user", map[string]interface{}{}, userMap); err != nil {
+		t.Fatalf("AddCnfToPayload failed: %v", err)
+	}
+
+	credential := []byte("signed-credential")
+	packBytes, err := issuer.PrepareMessagePack(credential, "user", userMap, nil, nil)
+	if err != nil {
+		t.Fatalf("PrepareMessagePack failed: %v", err)
+	}
+	var pack MessagePack
+	if err := msgpack.Unmarshal(packBytes, &pack); err != nil {
+		t.Fatalf("Failed to unmarshal message pack: %v", err)
+	}
+	if pack.Format != pkg.HybridFormatV1 {
+		t.Fatalf("Expected format %q, got %q", pkg.HybridFormatV1, pack.Format)
+	}
+
+	// the wallet recovers the VC secret key with the wallet provider secret key, which carries its KEM seed
+	wpSecKey, err := provider.ResolveSecretKey(context.Background(), &pack)
+	if err != nil {
+		t.Fatalf("ResolveSecretKey failed: %v", err)
+	}
+	vcSecKey, err := DecryptVCSecretKey(&pack, wpSecKey)
+	if err != nil {
+		t.Fatalf("Failed to decrypt VC secret key: %v", err)
+	}
+	decrypted, err := DecryptVC(&pack, vcSecKey)
+	if err != nil {
+		t.Fatalf("Failed to decrypt credential: %v", err)
+	}
+	if !bytes.Equal(decrypted, credential) {
+		t.Errorf("Decrypted credential does not match")
+	}
+
+	t.Run("KEMKeyIndependentOfMasterSecretKey", func(t *testing.T) {
+		keyContext := append([]byte(keyMap[hash].KeyID), hash...)
+		other := *provider
+		if other.KEMMasterSeed, err = GenerateKEMMasterSeed(); err != nil {
+			t.Fatalf("Failed to generate KEM master seed: %v", err)
+		}
+		kemPubKey, err := other.kemPublicKey(keyContext)
+		if err != nil {
+			t.Fatalf("kemPublicKey failed: %v", err)
+		}
+		if bytes.Equal(kemPubKey, keyMap[hash].WpKemPubkey) {
+			t.Errorf("KEM key does not depend on KEMMasterSeed")
+		}
+
+		other.KEMMasterSeed = nil
+		if _, err := other.kemPublicKey(keyContext); !errors.Is(err, internal.ErrInvalidParameters) {
+			t.Errorf("Expected error without KEM master seed, got %v", err)
+		}
+	})
+
+	t.Run("CompactSecretKey", func(t *testing.T) {
+		compact := &IssuerConfig{ProviderURL: "https://wp.example.com", HybridKEM: true, CompactSecretKey: true}
+		if _, _, err := compact.AddCnfToPayload("user", map[string]interface{}{}, userMap); err != nil {
+			t.Fatalf("AddCnfToPayload failed: %v", err)
+		}
+		packBytes, err := compact.PrepareMessagePack(credential, "user", userMap, nil, nil)
+		if err != nil {
+			t.Fatalf("PrepareMessagePack failed: %v", err)
+		}
+		opened, err := OpenMessagePack(packBytes, provider.ResolveSecretKey)
+		if err != nil {
+			t.Fatalf("OpenMessagePack failed: %v", err)
+		}
+		if opened.MessagePack.KeyFormat != KeyFormatScalarKEMV1 || !bytes.Equal(opened.Credential, credential) {
+			t.Errorf("Compact hybrid pack did not round trip")
+		}
+	})
+
+	t.Run("AdditiveRejected", func(t *testing.T) {
+		chainCode, err := GenerateChainCode()
+		if err != nil {
+			t.Fatalf("GenerateChainCode failed: %v", err)
+		}
+		additive := *provider
+		additive.ChainCode = chainCode
+		additive.AdditiveIssuers = []string{"issuer-a"}
+		if _, err := additive.AdditiveMasterKey("issuer-a"); !errors.Is(err, internal.ErrInvalidParameters) {
+			t.Errorf("Expected AdditiveMasterKey to reject HybridKEM, got %v", err)
+		}
+
+		additive.HybridKEM = false
+		masterPub, err := additive.AdditiveMasterKey("issuer-a")
+		if err != nil {
+			t.Fatalf("AdditiveMasterKey failed: %v", err)
+		}
+		hybrid := &IssuerConfig{ProviderURL: "https://wp.example.com", HybridKEM: true, AdditiveMasterKey: masterPub}
+		if _, err := hybrid.GetPublicKeysFromWalletProvider(testEmailMap(1)); err == nil {
+			t.Errorf("Expected issuer to reject HybridKEM with AdditiveMasterKey")
+		}
+	})
+
+	t.Run("MissingKEMKey", func(t *testing.T) {
+		userMap["user"].WpKemPubKey = nil
+		if _, err := issuer.PrepareMessagePack(credential, "user", userMap, nil, nil); err == nil {
+			t.Errorf("Expected error without wallet provider KEM public key")
+		}
+	})
+}
+
+func BenchmarkEnvelopeEncryption(b *testing.B) {
+	secretKey, err := GenerateSecretKey()
+	if err != nil {
+		b.Fatalf("Failed to generate key: %v", err)
+	}
+	publicKey, _ := secretKey.PublicKey()
+	secretKey, kemPubKey := attachKEMSeed(b, secretKey)
+	payload := bytes.Repeat([]byte("a"), 2048)
+
+	b.Run("JWE", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			if _, err := pkg.EncryptWithPublicKey(payload, publicKey); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("Hybrid", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			if _, err := pkg.EncryptHybrid(payload, publicKey, kemPubKey); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("HybridPreparedRecipient", func(b *testing.B) {
+		recipient, err := pkg.NewHybridRecipient(publicKey, kemPubKey)
+		if err != nil {
+			b.Fatal(err)
+		}
+		b.ResetTimer()
+		for i := 0; i < b.N; i++ {
+			if _, err := recipient.Encrypt(payload); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+}
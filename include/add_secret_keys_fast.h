@@ -0,0 +1,52 @@
+#ifndef ADD_SECRET_KEYS_FAST_H
+#define ADD_SECRET_KEYS_FAST_H
+
+#include "add_secret_keys.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Additional result codes for secret key addition with known public keys
+ *
+ * These extend cvc_add_secret_keys_result_t; codes -1 to -5 keep their meaning.
+ */
+typedef enum
+{
+    CVC_ADD_SECRET_KEYS_ERROR_INVALID_PUBLIC_KEY1 = -6, /**< First public key is not a valid uncompressed P-256 point */
+    CVC_ADD_SECRET_KEYS_ERROR_INVALID_PUBLIC_KEY2 = -7, /**< Second public key is not a valid uncompressed P-256 point */
+    CVC_ADD_SECRET_KEYS_ERROR_RESULT_AT_INFINITY = -8,  /**< Sum of the public keys is the point at infinity */
+    CVC_ADD_SECRET_KEYS_ERROR_INCONSISTENT = -9,        /**< Sum of the public keys does not match the sum of the secret keys */
+} cvc_add_secret_keys_fast_result_t;
+
+/**
+ * @brief Add two NIST P-256 key pairs whose public keys are already known
+ *
+ * Computes (d1 + d2) mod n and P1 + P2 using a single point addition instead of
+ * recomputing the public key with a generator multiplication. Both public keys must be
+ * in uncompressed format (65 bytes: 0x04 || X || Y) and are checked to lie on the curve.
+ *
+ * The caller is responsible for P1 = d1*G and P2 = d2*G. When verify is non-zero, the
+ * result is additionally checked by recomputing (d1 + d2)*G, which costs as much as
+ * cvc_add_nist256_secret_keys and is intended for testing and auditing.
+ *
+ * @param key1_bytes First private key as 32-byte big-endian scalar
+ * @param key1_len Length of first key bytes (must be 32)
+ * @param pub1_bytes First public key in uncompressed format (65 bytes)
+ * @param pub1_len Length of first public key bytes (must be 65)
+ * @param key2_bytes Second private key as 32-byte big-endian scalar
+ * @param key2_len Length of second key bytes (must be 32)
+ * @param pub2_bytes Second public key in uncompressed format (65 bytes)
+ * @param pub2_len Length of second public key bytes (must be 65)
+ * @param verify Non-zero to verify the result against a full generator multiplication
+ * @param result_key_material Output structure to store the complete key material
+ * @return CVC_ADD_SECRET_KEYS_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_add_nist256_secret_keys_with_public(const unsigned char* key1_bytes, int key1_len, const unsigned char* pub1_bytes, int pub1_len, const unsigned char* key2_bytes, int key2_len, const unsigned char* pub2_bytes, int pub2_len, int verify, nist256_key_material_t* result_key_material);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ADD_SECRET_KEYS_FAST_H
@@ -0,0 +1,97 @@
+#ifndef CVC_STATS_H
+#define CVC_STATS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Operations tracked by the statistics counters
+ */
+typedef enum
+{
+    CVC_STAT_KEY_DERIVATION = 0,   /**< Secret key derivations (hash-to-field and key extraction) */
+    CVC_STAT_SCALAR_MUL = 1,       /**< P-256 scalar multiplications */
+    CVC_STAT_POINT_ADD = 2,        /**< P-256 point additions */
+    CVC_STAT_HASH_COMPRESSION = 3, /**< SHA-256 compression function calls */
+    CVC_STAT_KEM_KEYPAIR = 4,      /**< Kyber768 key pair generations */
+    CVC_STAT_KEM_ENCAPSULATE = 5,  /**< Kyber768 encapsulations */
+    CVC_STAT_KEM_DECAPSULATE = 6,  /**< Kyber768 decapsulations */
+    CVC_STAT_SIGN = 7,             /**< ML-DSA-65 signatures */
+    CVC_STAT_VERIFY = 8,           /**< ML-DSA-65 verifications */
+    CVC_STAT_GCM_BLOCK = 9,        /**< AES-GCM blocks sealed or opened, recorded by the Go bindings */
+    CVC_STAT_COUNT = 10,           /**< Number of tracked operations */
+} cvc_stat_op_t;
+
+/**
+ * @brief Counts and elapsed ticks per operation
+ *
+ * Ticks are TSC cycles on x86-64, generic timer ticks on arm64 and nanoseconds elsewhere.
+ * Operations that are only counted report zero ticks.
+ */
+typedef struct
+{
+    uint64_t count[CVC_STAT_COUNT];
+    uint64_t ticks[CVC_STAT_COUNT];
+} cvc_stats_t;
+
+/**
+ * @brief Report whether statistics were compiled in (CVC_STATS defined)
+ *
+ * @return 1 if statistics are collected, 0 otherwise
+ */
+int cvc_stats_enabled(void);
+
+/**
+ * @brief Sum the counters of all threads into stats
+ *
+ * Counters are kept per thread and read without stopping writers, so a snapshot taken while
+ * operations are running may miss the most recent ones.
+ *
+ * @param stats Output structure, zeroed when statistics are disabled
+ */
+void cvc_stats_snapshot(cvc_stats_t* stats);
+
+/**
+ * @brief Zero the counters of all threads
+ *
+ * Updates racing with the reset may survive it.
+ */
+void cvc_stats_reset(void);
+
+/**
+ * @brief Add count operations taking ticks to the calling thread's counters
+ *
+ * @param op Operation to record
+ * @param count Number of operations
+ * @param ticks Elapsed ticks, or 0 if not timed
+ */
+void cvc_stats_record(cvc_stat_op_t op, uint64_t count, uint64_t ticks);
+
+/**
+ * @brief Read the tick counter used by the timers
+ *
+ * @return Current tick count
+ */
+uint64_t cvc_stats_ticks(void);
+
+/** Number of SHA-256 compressions needed to hash len bytes, including padding */
+#define CVC_SHA256_BLOCKS(len) (((uint64_t)(len) + 9 + 63) / 64)
+
+#ifdef CVC_STATS
+#define CVC_STATS_TIMER(var) uint64_t var = cvc_stats_ticks()
+#define CVC_STATS_TIMED(op, var) cvc_stats_record((op), 1, cvc_stats_ticks() - (var))
+#define CVC_STATS_COUNT(op, n) cvc_stats_record((op), (n), 0)
+#else
+#define CVC_STATS_TIMER(var) ((void)0)
+#define CVC_STATS_TIMED(op, var) ((void)0)
+#define CVC_STATS_COUNT(op, n) ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CVC_STATS_H
@@ -0,0 +1,60 @@
+#ifndef DERIVE_IOV_H
+#define DERIVE_IOV_H
+
+#include <stddef.h>
+
+#include "ed25519_keys.h"
+#include "hash_to_field.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief One segment of a scatter-gather input
+ */
+typedef struct
+{
+    const unsigned char* data; /**< Segment bytes, may be NULL when len is 0 */
+    size_t len;                /**< Segment length in bytes */
+} cvc_iovec_t;
+
+/**
+ * @brief Derive a secret key from a message given as a list of segments
+ *
+ * Produces the same key as cvc_derive_secret_key_nist256 called with the concatenation of
+ * all segments as master_key_bytes || context, but absorbs every segment directly into the
+ * SHA-256 state of expand_message_xmd (RFC 9380) instead of copying it into a staging buffer.
+ * Neither the message nor the DST is limited in size; a DST longer than 255 bytes is reduced
+ * to H("H2C-OVERSIZE-DST-" || DST) as the RFC requires.
+ *
+ * @param segments Message segments, absorbed in order
+ * @param segment_count Number of segments (must be > 0)
+ * @param dst Domain Separation Tag as byte array
+ * @param dst_len Length of the DST (must be > 0)
+ * @param derived_key_material Output structure to store the derived key material
+ * @return CVC_DERIVE_KEY_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_derive_secret_key_nist256_iov(const cvc_iovec_t* segments, int segment_count, const unsigned char* dst, size_t dst_len, nist256_key_material_t* derived_key_material);
+
+/**
+ * @brief Derive an Ed25519 secret scalar from a message given as a list of segments
+ *
+ * Uses the same expand_message_xmd construction as cvc_derive_secret_key_nist256_iov, but
+ * reduces the expanded bytes modulo the Ed25519 group order q. Callers should use a DST that
+ * differs from the one used for P-256 keys.
+ *
+ * @param segments Message segments, absorbed in order
+ * @param segment_count Number of segments (must be > 0)
+ * @param dst Domain Separation Tag as byte array
+ * @param dst_len Length of the DST (must be > 0)
+ * @param derived_key_material Output structure to store the derived scalar and public key
+ * @return CVC_DERIVE_KEY_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_derive_secret_key_ed25519_iov(const cvc_iovec_t* segments, int segment_count, const unsigned char* dst, size_t dst_len, ed25519_key_material_t* derived_key_material);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DERIVE_IOV_H
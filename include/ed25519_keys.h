@@ -0,0 +1,94 @@
+#ifndef ED25519_KEYS_H
+#define ED25519_KEYS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CVC_ED25519_SCALAR_SIZE 32     /**< Secret scalar, little-endian and reduced modulo the group order */
+#define CVC_ED25519_PUBLIC_KEY_SIZE 32 /**< Public key in RFC 8032 encoding */
+#define CVC_ED25519_SEED_SIZE 32       /**< RFC 8032 private key (seed) */
+#define CVC_ED25519_PREFIX_SIZE 32     /**< Nonce prefix of an expanded secret key */
+
+/**
+ * @brief Result codes for Ed25519 key operations
+ */
+typedef enum
+{
+    CVC_ED25519_SUCCESS = 0,                  /**< Operation completed successfully */
+    CVC_ED25519_ERROR_INVALID_PARAMS = -1,    /**< Invalid input parameters */
+    CVC_ED25519_ERROR_INVALID_SCALAR = -2,    /**< Scalar is not reduced modulo the group order */
+    CVC_ED25519_ERROR_INVALID_POINT = -3,     /**< Public key does not decode to a curve point */
+    CVC_ED25519_ERROR_SMALL_ORDER_POINT = -4, /**< Public key is the identity or has small order */
+    CVC_ED25519_ERROR_ZERO_SCALAR = -5,       /**< Resulting scalar is zero */
+    CVC_ED25519_ERROR_INFINITY = -6           /**< Resulting public key is the identity */
+} cvc_ed25519_result_t;
+
+/**
+ * @brief Ed25519 secret scalar together with its public key
+ */
+typedef struct
+{
+    unsigned char secret_scalar[CVC_ED25519_SCALAR_SIZE]; /**< Little-endian scalar s, 0 < s < q */
+    unsigned char public_key[CVC_ED25519_PUBLIC_KEY_SIZE]; /**< RFC 8032 encoding of [s]B */
+} ed25519_key_material_t;
+
+/**
+ * @brief Compute the key material of a secret scalar
+ *
+ * @param scalar Little-endian scalar (CVC_ED25519_SCALAR_SIZE), must be reduced modulo q
+ * @param key_material Output key material
+ * @return CVC_ED25519_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_ed25519_key_material_from_scalar(const unsigned char* scalar, ed25519_key_material_t* key_material);
+
+/**
+ * @brief Expand an RFC 8032 private key (seed) into a composable scalar
+ *
+ * Hashes the seed with SHA-512 and clamps the lower half as RFC 8032 section 5.1.5 does. The
+ * clamped value is reduced modulo q, which leaves the public key unchanged but makes the scalar
+ * usable with cvc_add_ed25519_secret_keys. The upper half is returned as nonce prefix.
+ *
+ * @param seed Private key seed (CVC_ED25519_SEED_SIZE)
+ * @param seed_len Length of the seed
+ * @param key_material Output key material
+ * @param prefix Output buffer for the nonce prefix (CVC_ED25519_PREFIX_SIZE), may be NULL
+ * @return CVC_ED25519_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_ed25519_expand_seed(const unsigned char* seed, int seed_len, ed25519_key_material_t* key_material, unsigned char* prefix);
+
+/**
+ * @brief Add two Ed25519 secret scalars modulo the group order
+ *
+ * @param scalar1 First little-endian scalar, reduced modulo q
+ * @param scalar2 Second little-endian scalar, reduced modulo q
+ * @param key_material Output key material of scalar1 + scalar2
+ * @return CVC_ED25519_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_add_ed25519_secret_keys(const unsigned char* scalar1, const unsigned char* scalar2, ed25519_key_material_t* key_material);
+
+/**
+ * @brief Add two Ed25519 public keys
+ *
+ * Both keys must decode to points that are neither the identity nor of small order.
+ *
+ * @param public_key1 First public key in RFC 8032 encoding
+ * @param public_key2 Second public key in RFC 8032 encoding
+ * @param result Output buffer for the encoded sum (CVC_ED25519_PUBLIC_KEY_SIZE)
+ * @return CVC_ED25519_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_add_ed25519_public_keys(const unsigned char* public_key1, const unsigned char* public_key2, unsigned char* result);
+
+/**
+ * @brief Check that a public key decodes to a point of large order
+ *
+ * @param public_key Public key in RFC 8032 encoding
+ * @return CVC_ED25519_SUCCESS if the key is valid, or a negative error code
+ */
+int cvc_ed25519_validate_public_key(const unsigned char* public_key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ED25519_KEYS_H
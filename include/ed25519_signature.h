@@ -0,0 +1,122 @@
+#ifndef ED25519_SIGNATURE_H
+#define ED25519_SIGNATURE_H
+
+#include "fp_F25519.h"
+#include "ed25519_keys.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CVC_ED25519_SIGNATURE_SIZE 64 /**< RFC 8032 signature: encoded R followed by little-endian S */
+#define CVC_ED25519_BASE_WINDOWS 64    /**< 4-bit windows of a 256-bit scalar */
+#define CVC_ED25519_BASE_ENTRIES 15    /**< Non-zero multiples per window */
+
+/**
+ * @brief Result codes for Ed25519 signature operations
+ */
+typedef enum
+{
+    CVC_ED25519_SIGNATURE_SUCCESS = 0,                /**< Operation completed successfully */
+    CVC_ED25519_SIGNATURE_ERROR_INVALID_PARAMS = -1,  /**< Invalid input parameters */
+    CVC_ED25519_SIGNATURE_ERROR_INVALID_SCALAR = -2,  /**< Secret scalar is not reduced modulo the group order */
+    CVC_ED25519_SIGNATURE_ERROR_INVALID_KEY = -3,     /**< Public key is not a valid point of large order */
+    CVC_ED25519_SIGNATURE_ERROR_INVALID_SIGNATURE = -4, /**< Signature does not verify */
+    CVC_ED25519_SIGNATURE_ERROR_INVALID_TABLE = -5      /**< Fixed-base table does not hold the multiples of B */
+} cvc_ed25519_signature_result_t;
+
+/**
+ * @brief Affine point of a fixed-base table
+ */
+typedef struct
+{
+    FP_F25519 x; /**< Affine x coordinate */
+    FP_F25519 y; /**< Affine y coordinate */
+} ed25519_affine_point_t;
+
+/**
+ * @brief Fixed-base table of the Ed25519 generator B
+ *
+ * Entry [i][j] holds (j + 1) * 16^i * B, so [k]B for a 256-bit k costs one constant-time table scan
+ * and one point addition per 4-bit window of k, with no doublings.
+ */
+typedef struct
+{
+    ed25519_affine_point_t points[CVC_ED25519_BASE_WINDOWS][CVC_ED25519_BASE_ENTRIES]; /**< Window multiples of B */
+} ed25519_base_table_t;
+
+/**
+ * @brief Fill a fixed-base table of the generator
+ *
+ * The table only depends on the curve, so it is built once per process and shared read-only by
+ * all signers.
+ *
+ * @param table Output table
+ * @return CVC_ED25519_SIGNATURE_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_ed25519_base_table_init(ed25519_base_table_t* table);
+
+/**
+ * @brief Check a fixed-base table that was not built by this process
+ *
+ * Recomputes every entry from B and compares it with the stored point, and requires every
+ * coordinate to be fully reduced as cvc_ed25519_base_table_init leaves it. A table loaded from a
+ * file must pass this check before it is passed to cvc_ed25519_sign. The check is several times
+ * cheaper than building the table, because no point is converted to affine coordinates.
+ *
+ * @param table Table to check
+ * @return CVC_ED25519_SIGNATURE_SUCCESS if the table is valid, or a negative error code otherwise
+ */
+int cvc_ed25519_base_table_check(const ed25519_base_table_t* table);
+
+/**
+ * @brief Sign a message with an expanded Ed25519 secret key (pure Ed25519, RFC 8032 section 5.1.6)
+ *
+ * The key is given in expanded form, so no SHA-512 of the seed and no public key multiplication
+ * is repeated per signature; the only scalar multiplication is the nonce commitment R, which uses
+ * the fixed-base table when one is given. For keys expanded with cvc_ed25519_expand_seed the
+ * signature is identical to the RFC 8032 signature of the seed. The caller is responsible for
+ * key_material->public_key matching the scalar.
+ *
+ * @param table Fixed-base table from cvc_ed25519_base_table_init, or NULL for a generic multiplication
+ * @param key_material Secret scalar and its public key
+ * @param prefix Nonce prefix of the expanded key (CVC_ED25519_PREFIX_SIZE)
+ * @param message Message to sign (may be NULL when message_len is 0)
+ * @param message_len Length of the message
+ * @param signature Output buffer for the signature (CVC_ED25519_SIGNATURE_SIZE)
+ * @return CVC_ED25519_SIGNATURE_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_ed25519_sign(const ed25519_base_table_t* table, const ed25519_key_material_t* key_material, const unsigned char* prefix, const unsigned char* message, int message_len, unsigned char* signature);
+
+/**
+ * @brief Verify a pure Ed25519 signature with EDDSA_Ed25519_VERIFY
+ *
+ * @param public_key Signer public key in RFC 8032 encoding (CVC_ED25519_PUBLIC_KEY_SIZE)
+ * @param message Signed message (may be NULL when message_len is 0)
+ * @param message_len Length of the message
+ * @param signature Signature to verify (CVC_ED25519_SIGNATURE_SIZE)
+ * @return CVC_ED25519_SIGNATURE_SUCCESS if the signature is valid,
+ *         CVC_ED25519_SIGNATURE_ERROR_INVALID_SIGNATURE if not, or another negative error code on invalid input
+ */
+int cvc_ed25519_verify(const unsigned char* public_key, const unsigned char* message, int message_len, const unsigned char* signature);
+
+/**
+ * @brief Verify a pure Ed25519 signature with a public key that was already validated
+ *
+ * Same as cvc_ed25519_verify without the cvc_ed25519_validate_public_key call, for callers that
+ * validate the key once and verify many signatures with it.
+ *
+ * @param public_key Signer public key accepted by cvc_ed25519_validate_public_key (CVC_ED25519_PUBLIC_KEY_SIZE)
+ * @param message Signed message (may be NULL when message_len is 0)
+ * @param message_len Length of the message
+ * @param signature Signature to verify (CVC_ED25519_SIGNATURE_SIZE)
+ * @return CVC_ED25519_SIGNATURE_SUCCESS if the signature is valid,
+ *         CVC_ED25519_SIGNATURE_ERROR_INVALID_SIGNATURE if not, or another negative error code on invalid input
+ */
+int cvc_ed25519_verify_prepared(const unsigned char* public_key, const unsigned char* message, int message_len, const unsigned char* signature);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ED25519_SIGNATURE_H
@@ -0,0 +1,122 @@
+#ifndef HMAC_PREPARED_H
+#define HMAC_PREPARED_H
+
+#include <stddef.h>
+
+#include "core.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CVC_HMAC_SHA256_SIZE 32 /**< HMAC-SHA256 tag and HKDF-SHA256 PRK size */
+
+/**
+ * @brief Result codes for prepared HMAC, HKDF and KDF2 operations
+ */
+typedef enum
+{
+    CVC_HMAC_SUCCESS = 0,              /**< Operation completed successfully */
+    CVC_HMAC_ERROR_INVALID_PARAMS = -1 /**< Invalid input parameters */
+} cvc_hmac_result_t;
+
+/**
+ * @brief HMAC-SHA256 key schedule
+ *
+ * Holds the SHA-256 states after absorbing the key XOR ipad and the key XOR opad blocks, so every
+ * HMAC with the key starts from these midstates and saves two compressions. The states are as
+ * secret as the key.
+ */
+typedef struct
+{
+    hash256 inner; /**< State after the key XOR ipad block */
+    hash256 outer; /**< State after the key XOR opad block */
+} cvc_hmac_prepared_t;
+
+/**
+ * @brief IEEE 1363 KDF2-SHA256 schedule of a shared secret
+ */
+typedef struct
+{
+    hash256 state; /**< State after absorbing the shared secret Z */
+    size_t z_len;  /**< Length of Z, for the compression statistics */
+} cvc_kdf2_prepared_t;
+
+/**
+ * @brief Prepare the HMAC-SHA256 key schedule of a key
+ *
+ * Keys longer than a SHA-256 block are hashed first, as RFC 2104 requires.
+ *
+ * @param prepared Output key schedule
+ * @param key HMAC key (may be NULL when key_len is 0)
+ * @param key_len Length of the key
+ * @return CVC_HMAC_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_hmac_prepare(cvc_hmac_prepared_t* prepared, const unsigned char* key, size_t key_len);
+
+/**
+ * @brief Compute HMAC-SHA256 with a prepared key
+ *
+ * @param prepared Key schedule from cvc_hmac_prepare
+ * @param message Message (may be NULL when message_len is 0)
+ * @param message_len Length of the message
+ * @param tag Output buffer for the tag (CVC_HMAC_SHA256_SIZE)
+ * @return CVC_HMAC_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_hmac_prepared(const cvc_hmac_prepared_t* prepared, const unsigned char* message, size_t message_len, unsigned char* tag);
+
+/**
+ * @brief HKDF-SHA256 extract (RFC 5869) with a prepared salt
+ *
+ * The PRK is returned as a key schedule ready for cvc_hkdf_expand_prepared, so it never leaves
+ * the library as bytes.
+ *
+ * @param salt Key schedule of the salt; an absent salt is a key of CVC_HMAC_SHA256_SIZE zero bytes
+ * @param ikm Input keying material (may be NULL when ikm_len is 0)
+ * @param ikm_len Length of the input keying material
+ * @param prk Output key schedule of the PRK
+ * @return CVC_HMAC_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_hkdf_extract_prepared(const cvc_hmac_prepared_t* salt, const unsigned char* ikm, size_t ikm_len, cvc_hmac_prepared_t* prk);
+
+/**
+ * @brief HKDF-SHA256 expand (RFC 5869) with a prepared PRK
+ *
+ * @param prk Key schedule of the PRK
+ * @param info Context information (may be NULL when info_len is 0)
+ * @param info_len Length of the context information
+ * @param out Output buffer for the derived key
+ * @param out_len Desired output length (at most 255 * CVC_HMAC_SHA256_SIZE bytes)
+ * @return CVC_HMAC_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_hkdf_expand_prepared(const cvc_hmac_prepared_t* prk, const unsigned char* info, size_t info_len, unsigned char* out, size_t out_len);
+
+/**
+ * @brief Prepare KDF2-SHA256 for a shared secret
+ *
+ * @param prepared Output schedule
+ * @param z Shared secret Z (may be NULL when z_len is 0)
+ * @param z_len Length of the shared secret
+ * @return CVC_HMAC_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_kdf2_prepare(cvc_kdf2_prepared_t* prepared, const unsigned char* z, size_t z_len);
+
+/**
+ * @brief Derive key material with KDF2-SHA256, Hash(Z || counter || P) for counter = 1, 2, ...
+ *
+ * Produces the same output as MIRACL KDF2 with SHA-256 for the prepared Z.
+ *
+ * @param prepared Schedule from cvc_kdf2_prepare
+ * @param param Key derivation parameter P (may be NULL when param_len is 0)
+ * @param param_len Length of the parameter
+ * @param out Output buffer for the derived key
+ * @param out_len Desired output length
+ * @return CVC_HMAC_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_kdf2_prepared(const cvc_kdf2_prepared_t* prepared, const unsigned char* param, size_t param_len, unsigned char* out, size_t out_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HMAC_PREPARED_H
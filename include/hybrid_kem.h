@@ -0,0 +1,80 @@
+#ifndef HYBRID_KEM_H
+#define HYBRID_KEM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CVC_KYBER768_SEED_SIZE 64          /**< Seed size for deterministic key pair generation */
+#define CVC_KYBER768_SECRET_KEY_SIZE 2400  /**< ML-KEM-768 decapsulation key size */
+#define CVC_KYBER768_PUBLIC_KEY_SIZE 1184  /**< ML-KEM-768 encapsulation key size */
+#define CVC_KYBER768_CIPHERTEXT_SIZE 1088  /**< ML-KEM-768 ciphertext size */
+#define CVC_KYBER768_SHARED_SECRET_SIZE 32 /**< ML-KEM-768 shared secret size */
+#define CVC_KYBER768_RANDOM_SIZE 32        /**< Randomness consumed by encapsulation */
+
+/**
+ * @brief Result codes for KEM and KDF operations
+ */
+typedef enum
+{
+    CVC_KEM_SUCCESS = 0,                   /**< Operation completed successfully */
+    CVC_KEM_ERROR_INVALID_PARAMS = -1,     /**< Invalid input parameters */
+    CVC_KEM_ERROR_INVALID_SEED = -2,       /**< Seed or randomness has invalid length */
+    CVC_KEM_ERROR_INVALID_PUBLIC_KEY = -3, /**< Public key has invalid length */
+    CVC_KEM_ERROR_INVALID_SECRET_KEY = -4, /**< Secret key has invalid length */
+    CVC_KEM_ERROR_INVALID_CIPHERTEXT = -5, /**< Ciphertext has invalid length */
+    CVC_KEM_ERROR_INSUFFICIENT_BUFFER = -6 /**< Output buffer is too small */
+} cvc_kem_result_t;
+
+/**
+ * @brief Generate an ML-KEM-768 (Kyber768) key pair from a seed
+ *
+ * The key pair is a deterministic function of the seed, so the same seed always yields
+ * the same key pair.
+ *
+ * @param seed Seed bytes (CVC_KYBER768_SEED_SIZE)
+ * @param seed_len Length of the seed
+ * @param secret_key Output buffer for the secret key (CVC_KYBER768_SECRET_KEY_SIZE)
+ * @param secret_key_len Size of the secret key buffer
+ * @param public_key Output buffer for the public key (CVC_KYBER768_PUBLIC_KEY_SIZE)
+ * @param public_key_len Size of the public key buffer
+ * @return CVC_KEM_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_kyber768_keypair(const unsigned char* seed, int seed_len, unsigned char* secret_key, int secret_key_len, unsigned char* public_key, int public_key_len);
+
+/**
+ * @brief Encapsulate a fresh shared secret to an ML-KEM-768 public key
+ *
+ * @param random Random bytes (CVC_KYBER768_RANDOM_SIZE)
+ * @param random_len Length of the random bytes
+ * @param public_key Recipient public key (CVC_KYBER768_PUBLIC_KEY_SIZE)
+ * @param public_key_len Length of the public key
+ * @param shared_secret Output buffer for the shared secret (CVC_KYBER768_SHARED_SECRET_SIZE)
+ * @param shared_secret_len Size of the shared secret buffer
+ * @param ciphertext Output buffer for the ciphertext (CVC_KYBER768_CIPHERTEXT_SIZE)
+ * @param ciphertext_len Size of the ciphertext buffer
+ * @return CVC_KEM_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_kyber768_encapsulate(const unsigned char* random, int random_len, const unsigned char* public_key, int public_key_len, unsigned char* shared_secret, int shared_secret_len, unsigned char* ciphertext, int ciphertext_len);
+
+/**
+ * @brief Decapsulate an ML-KEM-768 ciphertext
+ *
+ * Invalid ciphertexts are implicitly rejected: a pseudo-random shared secret is returned, so
+ * failures surface when the derived key is used for authenticated decryption.
+ *
+ * @param secret_key Recipient secret key (CVC_KYBER768_SECRET_KEY_SIZE)
+ * @param secret_key_len Length of the secret key
+ * @param ciphertext Ciphertext (CVC_KYBER768_CIPHERTEXT_SIZE)
+ * @param ciphertext_len Length of the ciphertext
+ * @param shared_secret Output buffer for the shared secret (CVC_KYBER768_SHARED_SECRET_SIZE)
+ * @param shared_secret_len Size of the shared secret buffer
+ * @return CVC_KEM_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_kyber768_decapsulate(const unsigned char* secret_key, int secret_key_len, const unsigned char* ciphertext, int ciphertext_len, unsigned char* shared_secret, int shared_secret_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HYBRID_KEM_H
@@ -0,0 +1,146 @@
+#ifndef KEY_ARENA_H
+#define KEY_ARENA_H
+
+#include <stddef.h>
+
+#include "nist256_key_material.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Result codes for key arena operations
+ *
+ * Derivation into an arena slot returns cvc_derive_key_result_t codes (-1 to -5) on failure.
+ */
+typedef enum
+{
+    CVC_KEY_ARENA_SUCCESS = 0,                    /**< Operation completed successfully */
+    CVC_KEY_ARENA_ERROR_INVALID_PARAMS = -1,      /**< Invalid input parameters */
+    CVC_KEY_ARENA_ERROR_ALLOCATION_FAILED = -10,  /**< Pages for the arena could not be mapped */
+    CVC_KEY_ARENA_ERROR_INDEX_OUT_OF_RANGE = -11, /**< Slot index is not below the arena capacity */
+    CVC_KEY_ARENA_ERROR_NO_MASTER = -12,          /**< No master key was set with cvc_key_arena_set_master */
+} cvc_key_arena_result_t;
+
+/**
+ * @brief Off-heap storage for a batch of NIST P-256 key material
+ *
+ * The slots live in dedicated pages mapped outside of any garbage collected heap. The pages are
+ * locked into RAM when the process is allowed to (mlock / VirtualLock), excluded from core dumps
+ * where supported, and wiped before they are released.
+ *
+ * The fields are only exposed so that bindings can hold the arena as a complete type; they must
+ * not be modified.
+ */
+typedef struct cvc_key_arena
+{
+    nist256_key_material_t* slots; /**< First of capacity contiguous slots */
+    size_t capacity;               /**< Number of slots */
+    size_t mapped_len;             /**< Length of the mapping in bytes, a multiple of the page size */
+    int locked;                    /**< Non-zero if the mapping is locked into RAM */
+    unsigned char* master;         /**< Master key material set with cvc_key_arena_set_master, or NULL */
+    size_t master_len;             /**< Length of the master key material */
+    size_t master_mapped_len;      /**< Length of the master mapping in bytes */
+    int master_locked;             /**< Non-zero if the master mapping is locked into RAM */
+} cvc_key_arena_t;
+
+/**
+ * @brief Map a new arena with room for capacity key material slots
+ *
+ * Failing to lock the pages is not an error; use cvc_key_arena_is_locked to check.
+ *
+ * @param capacity Number of slots (must be > 0)
+ * @param arena Output parameter receiving the arena
+ * @return CVC_KEY_ARENA_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_key_arena_create(size_t capacity, cvc_key_arena_t** arena);
+
+/**
+ * @brief Report whether the arena pages are locked into RAM
+ *
+ * @param arena Arena to query
+ * @return 1 if the pages are locked, 0 otherwise
+ */
+int cvc_key_arena_is_locked(const cvc_key_arena_t* arena);
+
+/**
+ * @brief Return the first slot of the arena; slots are contiguous
+ *
+ * @param arena Arena to query
+ * @return Pointer to slot 0, or NULL if arena is NULL
+ */
+nist256_key_material_t* cvc_key_arena_slots(cvc_key_arena_t* arena);
+
+/**
+ * @brief Derive a secret key as cvc_derive_secret_key_nist256 does, directly into an arena slot
+ *
+ * master_key_bytes and context are absorbed in place, so no copy of the input or the result is
+ * made outside of the arena.
+ *
+ * @param arena Destination arena
+ * @param index Slot to write
+ * @param master_key_bytes Master key material as byte array
+ * @param master_key_len Length of the master key material
+ * @param context Context bytes for key derivation
+ * @param context_len Length of the context
+ * @param dst Domain Separation Tag as byte array
+ * @param dst_len Length of the DST
+ * @return CVC_KEY_ARENA_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_key_arena_derive(cvc_key_arena_t* arena, size_t index, const unsigned char* master_key_bytes, size_t master_key_len, const unsigned char* context, size_t context_len, const unsigned char* dst, size_t dst_len);
+
+/**
+ * @brief Copy master key material into pages of the arena, replacing any master set before
+ *
+ * The master pages are mapped, locked and wiped like the slots, so callers can wipe their copy right
+ * away and derive with cvc_key_arena_derive_from_master.
+ *
+ * @param arena Arena to hold the master key
+ * @param master_key_bytes Master key material as byte array
+ * @param master_key_len Length of the master key material
+ * @return CVC_KEY_ARENA_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_key_arena_set_master(cvc_key_arena_t* arena, const unsigned char* master_key_bytes, size_t master_key_len);
+
+/**
+ * @brief Wipe and unmap the master key material of the arena, if any
+ *
+ * @param arena Arena to clear, may be NULL
+ */
+void cvc_key_arena_clear_master(cvc_key_arena_t* arena);
+
+/**
+ * @brief Derive a secret key as cvc_key_arena_derive does, with the master set by cvc_key_arena_set_master
+ *
+ * @param arena Destination arena
+ * @param index Slot to write
+ * @param context Context bytes for key derivation
+ * @param context_len Length of the context
+ * @param dst Domain Separation Tag as byte array
+ * @param dst_len Length of the DST
+ * @return CVC_KEY_ARENA_SUCCESS on success, CVC_KEY_ARENA_ERROR_NO_MASTER if no master is set, or another
+ *         negative error code on failure
+ */
+int cvc_key_arena_derive_from_master(cvc_key_arena_t* arena, size_t index, const unsigned char* context, size_t context_len, const unsigned char* dst, size_t dst_len);
+
+/**
+ * @brief Zero the first count slots of the arena
+ *
+ * @param arena Arena to wipe
+ * @param count Number of slots to wipe, clamped to the capacity
+ */
+void cvc_key_arena_wipe(cvc_key_arena_t* arena, size_t count);
+
+/**
+ * @brief Wipe, unlock and unmap all arena pages, including the master, and free the arena
+ *
+ * @param arena Arena to destroy, may be NULL
+ */
+void cvc_key_arena_destroy(cvc_key_arena_t* arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // KEY_ARENA_H
@@ -0,0 +1,83 @@
+#ifndef MLDSA_H
+#define MLDSA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CVC_MLDSA65_SEED_SIZE 32          /**< Seed size for deterministic key pair generation */
+#define CVC_MLDSA65_SECRET_KEY_SIZE 4032  /**< ML-DSA-65 secret key size */
+#define CVC_MLDSA65_PUBLIC_KEY_SIZE 1952  /**< ML-DSA-65 public key size */
+#define CVC_MLDSA65_SIGNATURE_SIZE 3309   /**< ML-DSA-65 signature size */
+#define CVC_MLDSA65_RANDOM_SIZE 32        /**< Randomness consumed by a hedged signature */
+#define CVC_MLDSA65_MAX_CONTEXT_SIZE 255  /**< Maximum length of the domain separation context */
+
+/**
+ * @brief Result codes for ML-DSA operations
+ */
+typedef enum
+{
+    CVC_MLDSA_SUCCESS = 0,                   /**< Operation completed successfully */
+    CVC_MLDSA_ERROR_INVALID_PARAMS = -1,     /**< Invalid input parameters */
+    CVC_MLDSA_ERROR_INVALID_SEED = -2,       /**< Seed or randomness has invalid length */
+    CVC_MLDSA_ERROR_INVALID_SECRET_KEY = -3, /**< Secret key has invalid length */
+    CVC_MLDSA_ERROR_INVALID_PUBLIC_KEY = -4, /**< Public key has invalid length */
+    CVC_MLDSA_ERROR_CONTEXT_TOO_LARGE = -5,  /**< Context exceeds CVC_MLDSA65_MAX_CONTEXT_SIZE */
+    CVC_MLDSA_ERROR_INSUFFICIENT_BUFFER = -6,/**< Output buffer is too small */
+    CVC_MLDSA_ERROR_INVALID_SIGNATURE = -7   /**< Signature does not verify */
+} cvc_mldsa_result_t;
+
+/**
+ * @brief Generate an ML-DSA-65 (Dilithium3) key pair from a seed
+ *
+ * @param seed Seed bytes (CVC_MLDSA65_SEED_SIZE)
+ * @param seed_len Length of the seed
+ * @param secret_key Output buffer for the secret key (CVC_MLDSA65_SECRET_KEY_SIZE)
+ * @param secret_key_len Size of the secret key buffer
+ * @param public_key Output buffer for the public key (CVC_MLDSA65_PUBLIC_KEY_SIZE)
+ * @param public_key_len Size of the public key buffer
+ * @return CVC_MLDSA_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_mldsa65_keypair(const unsigned char* seed, int seed_len, unsigned char* secret_key, int secret_key_len, unsigned char* public_key, int public_key_len);
+
+/**
+ * @brief Sign a message with ML-DSA-65
+ *
+ * With random set to NULL the signature is deterministic; otherwise CVC_MLDSA65_RANDOM_SIZE
+ * fresh random bytes give the recommended hedged variant.
+ *
+ * @param secret_key Signer secret key (CVC_MLDSA65_SECRET_KEY_SIZE)
+ * @param secret_key_len Length of the secret key
+ * @param context Domain separation context (may be NULL when context_len is 0)
+ * @param context_len Length of the context
+ * @param message Message to sign
+ * @param message_len Length of the message
+ * @param random Random bytes for hedged signing, or NULL
+ * @param random_len Length of the random bytes
+ * @param signature Output buffer for the signature (CVC_MLDSA65_SIGNATURE_SIZE)
+ * @param signature_len Size of the signature buffer
+ * @return CVC_MLDSA_SUCCESS on success, or a negative error code on failure
+ */
+int cvc_mldsa65_sign(const unsigned char* secret_key, int secret_key_len, const unsigned char* context, int context_len, const unsigned char* message, int message_len, const unsigned char* random, int random_len, unsigned char* signature, int signature_len);
+
+/**
+ * @brief Verify an ML-DSA-65 signature
+ *
+ * @param public_key Signer public key (CVC_MLDSA65_PUBLIC_KEY_SIZE)
+ * @param public_key_len Length of the public key
+ * @param context Domain separation context used when signing (may be NULL when context_len is 0)
+ * @param context_len Length of the context
+ * @param message Signed message
+ * @param message_len Length of the message
+ * @param signature Signature to verify
+ * @param signature_len Length of the signature
+ * @return CVC_MLDSA_SUCCESS if the signature is valid, CVC_MLDSA_ERROR_INVALID_SIGNATURE if not,
+ *         or another negative error code on invalid input
+ */
+int cvc_mldsa65_verify(const unsigned char* public_key, int public_key_len, const unsigned char* context, int context_len, const unsigned char* message, int message_len, const unsigned char* signature, int signature_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MLDSA_H
@@ -0,0 +1,39 @@
+#ifndef VALIDATE_POINTS_H
+#define VALIDATE_POINTS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CVC_NIST256_POINT_SIZE 65 /**< Uncompressed P-256 point: 0x04 || x || y */
+
+/**
+ * @brief Result codes for batch point validation
+ */
+typedef enum
+{
+    CVC_VALIDATE_SUCCESS = 0,               /**< All points are valid */
+    CVC_VALIDATE_ERROR_INVALID_PARAMS = -1, /**< Invalid input parameters */
+    CVC_VALIDATE_ERROR_INVALID_POINTS = -2  /**< At least one point is invalid, see the valid array */
+} cvc_validate_result_t;
+
+/**
+ * @brief Check that a batch of uncompressed P-256 points lie on the curve
+ *
+ * Each point must have the 0x04 prefix, coordinates in [0, p) and satisfy
+ * y^2 = x^3 - 3x + b. The check runs directly on field elements, without building
+ * ECP objects, so validating many keys costs one square, one cube and a comparison
+ * per key. The point at infinity has no uncompressed encoding and is always rejected.
+ *
+ * @param points Concatenated points, count * CVC_NIST256_POINT_SIZE bytes
+ * @param count Number of points (must be > 0)
+ * @param valid Output array of count entries, set to 1 for valid and 0 for invalid points
+ * @return CVC_VALIDATE_SUCCESS if every point is valid, or a negative error code
+ */
+int cvc_validate_nist256_public_keys(const unsigned char* points, int count, unsigned char* valid);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VALIDATE_POINTS_H
@@ -0,0 +1,109 @@
+#include "add_secret_keys_fast.h"
+#include "cvc_stats.h"
+
+#define NIST256_UNCOMPRESSED_POINT_LEN (2 * MODBYTES_256_56 + 1)
+
+// Load a private key scalar and check that it is in [1, n-1]
+static int load_scalar(BIG_256_56 d, const unsigned char* bytes, int len)
+{
+    BIG_256_56 order;
+
+    if (bytes == NULL || len != MODBYTES_256_56)
+    {
+        return 0;
+    }
+
+    BIG_256_56_rcopy(order, CURVE_Order_NIST256);
+    BIG_256_56_fromBytesLen(d, (char*)bytes, len);
+
+    return !BIG_256_56_iszilch(d) && BIG_256_56_comp(d, order) < 0;
+}
+
+// Load an uncompressed public key and check that it is a finite point on the curve
+static int load_point(ECP_NIST256* P, const unsigned char* bytes, int len)
+{
+    octet point;
+
+    if (bytes == NULL || len != NIST256_UNCOMPRESSED_POINT_LEN || bytes[0] != 0x04)
+    {
+        return 0;
+    }
+
+    point.len = len;
+    point.max = len;
+    point.val = (char*)bytes;
+
+    return ECP_NIST256_fromOctet(P, &point) && !ECP_NIST256_isinf(P);
+}
+
+int cvc_add_nist256_secret_keys_with_public(const unsigned char* key1_bytes, int key1_len, const unsigned char* pub1_bytes, int pub1_len, const unsigned char* key2_bytes, int key2_len, const unsigned char* pub2_bytes, int pub2_len, int verify, nist256_key_material_t* result_key_material)
+{
+    BIG_256_56 d1, d2, d, order, x, y;
+    ECP_NIST256 P, Q;
+
+    if (result_key_material == NULL)
+    {
+        return CVC_ADD_SECRET_KEYS_ERROR_INVALID_PARAMS;
+    }
+
+    if (!load_scalar(d1, key1_bytes, key1_len))
+    {
+        return CVC_ADD_SECRET_KEYS_ERROR_INVALID_KEY1;
+    }
+
+    if (!load_scalar(d2, key2_bytes, key2_len))
+    {
+        return CVC_ADD_SECRET_KEYS_ERROR_INVALID_KEY2;
+    }
+
+    if (!load_point(&P, pub1_bytes, pub1_len))
+    {
+        return CVC_ADD_SECRET_KEYS_ERROR_INVALID_PUBLIC_KEY1;
+    }
+
+    if (!load_point(&Q, pub2_bytes, pub2_len))
+    {
+        return CVC_ADD_SECRET_KEYS_ERROR_INVALID_PUBLIC_KEY2;
+    }
+
+    // d = (d1 + d2) mod n
+    BIG_256_56_rcopy(order, CURVE_Order_NIST256);
+    BIG_256_56_modadd(d, d1, d2, order);
+    if (BIG_256_56_iszilch(d))
+    {
+        return CVC_ADD_SECRET_KEYS_ERROR_RESULT_ZERO;
+    }
+
+    // P = P1 + P2
+    CVC_STATS_TIMER(add_start);
+    ECP_NIST256_add(&P, &Q);
+    CVC_STATS_TIMED(CVC_STAT_POINT_ADD, add_start);
+    if (ECP_NIST256_isinf(&P))
+    {
+        return CVC_ADD_SECRET_KEYS_ERROR_RESULT_AT_INFINITY;
+    }
+
+    if (verify)
+    {
+        ECP_NIST256 G;
+        ECP_NIST256_generator(&G);
+        CVC_STATS_TIMER(mul_start);
+        ECP_NIST256_mul(&G, d);
+        CVC_STATS_TIMED(CVC_STAT_SCALAR_MUL, mul_start);
+        if (!ECP_NIST256_equals(&G, &P))
+        {
+            return CVC_ADD_SECRET_KEYS_ERROR_INCONSISTENT;
+        }
+    }
+
+    if (ECP_NIST256_get(x, y, &P) < 0)
+    {
+        return CVC_ADD_SECRET_KEYS_ERROR_KEY_EXTRACTION_FAILED;
+    }
+
+    BIG_256_56_toBytes((char*)result_key_material->private_key_bytes, d);
+    BIG_256_56_toBytes((char*)result_key_material->public_key_x_bytes, x);
+    BIG_256_56_toBytes((char*)result_key_material->public_key_y_bytes, y);
+
+    return CVC_ADD_SECRET_KEYS_SUCCESS;
+}
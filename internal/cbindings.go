@@ -12,9 +12,12 @@ package internal
 #include "ecp_operations.h"
 #include "hash_to_field.h"
 #include "add_secret_keys.h"
+#include "add_secret_keys_fast.h"
+#include "derive_iov.h"
 */
 import "C"
 import (
+	"runtime"
 	"unsafe"
 )
 
@@ -109,6 +112,59 @@ func AddSecretKeys(key1Bytes, key2Bytes []byte) (KeyMaterial, error) {
 	return keyMaterial, nil
 }
 
+// AddSecretKeysWithPublic adds two NIST P-256 key pairs whose public keys are known, using a single
+// point addition for the public key instead of a generator multiplication. If verify is set, the
+// resulting public key is checked against a full generator multiplication.
+func AddSecretKeysWithPublic(key1Bytes, pub1Bytes, key2Bytes, pub2Bytes []byte, verify bool) (KeyMaterial, error) {
+	var keyMaterial KeyMaterial
+
+	// Validate input key lengths
+	if err := ValidateKeyLength(key1Bytes, KeySize, "first private key"); err != nil {
+		return keyMaterial, err
+	}
+
+	if err := ValidateKeyLength(pub1Bytes, UncompressedPublicKeySize, "first public key"); err != nil {
+		return keyMaterial, err
+	}
+
+	if err := ValidateKeyLength(key2Bytes, KeySize, "second private key"); err != nil {
+		return keyMaterial, err
+	}
+
+	if err := ValidateKeyLength(pub2Bytes, UncompressedPublicKeySize, "second public key"); err != nil {
+		return keyMaterial, err
+	}
+
+	cVerify := C.int(0)
+	if verify {
+		cVerify = 1
+	}
+
+	// Call C function to add the key pairs
+	var cKeyMaterial C.nist256_key_material_t
+	result := C.cvc_add_nist256_secret_keys_with_public(
+		(*C.uchar)(unsafe.Pointer(&key1Bytes[0])),
+		C.int(len(key1Bytes)),
+		(*C.uchar)(unsafe.Pointer(&pub1Bytes[0])),
+		C.int(len(pub1Bytes)),
+		(*C.uchar)(unsafe.Pointer(&key2Bytes[0])),
+		C.int(len(key2Bytes)),
+		(*C.uchar)(unsafe.Pointer(&pub2Bytes[0])),
+		C.int(len(pub2Bytes)),
+		cVerify,
+		&cKeyMaterial,
+	)
+
+	if result != 0 {
+		return keyMaterial, MapSecretKeyError(CErrorCode(result))
+	}
+
+	// Convert C key material to Go
+	keyMaterial = convertCKeyMaterial(cKeyMaterial)
+
+	return keyMaterial, nil
+}
+
 // AddPublicKeys adds two NIST P-256 public keys using elliptic curve point addition
 func AddPublicKeys(key1Bytes, key2Bytes []byte) ([]byte, error) {
 	// Validate input key lengths (uncompressed format: 65 bytes)
@@ -163,16 +219,16 @@ func DeriveSecretKey(masterKeyBytes, context, dst []byte) (KeyMaterial, error) {
 		return keyMaterial, err
 	}
 
-	if err := ValidateNonEmpty(dst, "domain separation tag"); err != nil {
-		return keyMaterial, err
-	}
+	return DeriveSecretKeySegments(dst, masterKeyBytes, context)
+}
 
-	// Validate input sizes to prevent C buffer overflows
-	if err := ValidateInputSize(masterKeyBytes, 2048, "master key"); err != nil {
-		return keyMaterial, err
-	}
+// DeriveSecretKeySegments derives a secret key from the concatenation of segments using hash-to-field.
+// The segments are absorbed in place, so the result equals DeriveSecretKey on the joined input without
+// the input ever being copied, and there is no limit on the segment sizes.
+func DeriveSecretKeySegments(dst []byte, segments ...[]byte) (KeyMaterial, error) {
+	var keyMaterial KeyMaterial
 
-	if err := ValidateInputSize(context, 2048, "context"); err != nil {
+	if err := ValidateNonEmpty(dst, "domain separation tag"); err != nil {
 		return keyMaterial, err
 	}
 
@@ -180,26 +236,24 @@ func DeriveSecretKey(masterKeyBytes, context, dst []byte) (KeyMaterial, error) {
 		return keyMaterial, err
 	}
 
-	// Check combined input size
-	combinedSize := len(masterKeyBytes) + len(context)
-	if combinedSize > 4096 {
-		return keyMaterial, WrapError(
-			ErrInputTooLarge,
-			"combined master key and context exceed maximum size",
-		)
+	// The segment list holds Go pointers, which cgo only allows when they are pinned
+	var pinner runtime.Pinner
+	defer pinner.Unpin()
+
+	iov := pinSegments(&pinner, segments)
+	if len(iov) == 0 {
+		return keyMaterial, WrapError(ErrInvalidParameters, "derivation input cannot be empty")
 	}
 
 	// Prepare output structure for key material
 	var cKeyMaterial C.nist256_key_material_t
 
 	// Call C function to derive the secret key
-	result := C.cvc_derive_secret_key_nist256(
-		(*C.uchar)(unsafe.Pointer(&masterKeyBytes[0])),
-		C.int(len(masterKeyBytes)),
-		(*C.uchar)(unsafe.Pointer(&context[0])),
-		C.int(len(context)),
+	result := C.cvc_derive_secret_key_nist256_iov(
+		&iov[0],
+		C.int(len(iov)),
 		(*C.uchar)(unsafe.Pointer(&dst[0])),
-		C.int(len(dst)),
+		C.size_t(len(dst)),
 		&cKeyMaterial,
 	)
 
@@ -218,6 +272,22 @@ func DeriveSecretKey(masterKeyBytes, context, dst []byte) (KeyMaterial, error) {
 	return keyMaterial, nil
 }
 
+// pinSegments pins the non-empty segments and returns them as a C scatter-gather list
+func pinSegments(pinner *runtime.Pinner, segments [][]byte) []C.cvc_iovec_t {
+	iov := make([]C.cvc_iovec_t, 0, len(segments))
+	for _, segment := range segments {
+		if len(segment) == 0 {
+			continue
+		}
+		pinner.Pin(&segment[0])
+		iov = append(iov, C.cvc_iovec_t{
+			data: (*C.uchar)(unsafe.Pointer(&segment[0])),
+			len:  C.size_t(len(segment)),
+		})
+	}
+	return iov
+}
+
 // HashToField performs hash-to-field operation for the given input
 func HashToField(hash, hashLen int, dst, message []byte, count int) error {
 	// Validate input parameters
@@ -0,0 +1,154 @@
+#include <string.h>
+
+#include "cvc_stats.h"
+
+#ifdef CVC_STATS
+
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <x86intrin.h>
+#elif !defined(__aarch64__)
+#include <time.h>
+#endif
+
+// Counters of one thread. Only the owning thread writes them, so relaxed loads and stores suffice
+// and the hot path needs no locked instructions. Blocks are never freed, so snapshots keep the
+// counts of threads that have exited.
+typedef struct cvc_stats_block
+{
+    _Atomic uint64_t count[CVC_STAT_COUNT];
+    _Atomic uint64_t ticks[CVC_STAT_COUNT];
+    struct cvc_stats_block* next;
+} cvc_stats_block_t;
+
+static _Thread_local cvc_stats_block_t* local_block;
+static _Atomic(cvc_stats_block_t*) blocks;
+
+static cvc_stats_block_t* thread_block(void)
+{
+    cvc_stats_block_t* b = local_block;
+    if (b != NULL)
+    {
+        return b;
+    }
+
+    b = (cvc_stats_block_t*)calloc(1, sizeof(*b));
+    if (b == NULL)
+    {
+        return NULL;
+    }
+    b->next = atomic_load(&blocks);
+    while (!atomic_compare_exchange_weak(&blocks, &b->next, b))
+    {
+    }
+
+    local_block = b;
+    return b;
+}
+
+static void add_relaxed(_Atomic uint64_t* v, uint64_t n)
+{
+    atomic_store_explicit(v, atomic_load_explicit(v, memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+int cvc_stats_enabled(void)
+{
+    return 1;
+}
+
+void cvc_stats_record(cvc_stat_op_t op, uint64_t count, uint64_t ticks)
+{
+    cvc_stats_block_t* b;
+
+    if ((unsigned)op >= CVC_STAT_COUNT || (b = thread_block()) == NULL)
+    {
+        return;
+    }
+    add_relaxed(&b->count[op], count);
+    add_relaxed(&b->ticks[op], ticks);
+}
+
+void cvc_stats_snapshot(cvc_stats_t* stats)
+{
+    cvc_stats_block_t* b;
+    int i;
+
+    if (stats == NULL)
+    {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+    for (b = atomic_load(&blocks); b != NULL; b = b->next)
+    {
+        for (i = 0; i < CVC_STAT_COUNT; i++)
+        {
+            stats->count[i] += atomic_load_explicit(&b->count[i], memory_order_relaxed);
+            stats->ticks[i] += atomic_load_explicit(&b->ticks[i], memory_order_relaxed);
+        }
+    }
+}
+
+void cvc_stats_reset(void)
+{
+    cvc_stats_block_t* b;
+    int i;
+
+    for (b = atomic_load(&blocks); b != NULL; b = b->next)
+    {
+        for (i = 0; i < CVC_STAT_COUNT; i++)
+        {
+            atomic_store_explicit(&b->count[i], 0, memory_order_relaxed);
+            atomic_store_explicit(&b->ticks[i], 0, memory_order_relaxed);
+        }
+    }
+}
+
+uint64_t cvc_stats_ticks(void)
+{
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t v;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+#else
+
+int cvc_stats_enabled(void)
+{
+    return 0;
+}
+
+void cvc_stats_record(cvc_stat_op_t op, uint64_t count, uint64_t ticks)
+{
+    (void)op;
+    (void)count;
+    (void)ticks;
+}
+
+void cvc_stats_snapshot(cvc_stats_t* stats)
+{
+    if (stats != NULL)
+    {
+        memset(stats, 0, sizeof(*stats));
+    }
+}
+
+void cvc_stats_reset(void)
+{
+}
+
+uint64_t cvc_stats_ticks(void)
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,226 @@
+#include <string.h>
+
+#include "core.h"
+#include "big_256_56.h"
+#include "ecp_NIST256.h"
+#include "ecp_Ed25519.h"
+
+#include "cvc_stats.h"
+#include "derive_iov.h"
+#include "ed25519_keys.h"
+
+#define XMD_HASH_LEN 32
+#define XMD_BLOCK_LEN 64
+#define XMD_MAX_DST_LEN 255
+#define XMD_OVERSIZE_PREFIX "H2C-OVERSIZE-DST-"
+
+// L = ceil((ceil(log2(p)) + k) / 8) with k = 128 for P-256, as computed by cvc_hash_to_field_nist256
+#define DERIVE_EXPAND_LEN 48
+
+static void absorb(hash256* h, const unsigned char* data, size_t len)
+{
+    size_t i;
+    for (i = 0; i < len; i++)
+    {
+        HASH256_process(h, data[i]);
+    }
+}
+
+static void absorb_dst_prime(hash256* h, const unsigned char* dst, size_t dst_len)
+{
+    absorb(h, dst, dst_len);
+    HASH256_process(h, (int)dst_len);
+}
+
+// expand_message_xmd with SHA-256, absorbing the message segment by segment
+static void xmd_expand_iov(unsigned char* out, int out_len, const unsigned char* dst, size_t dst_len, const cvc_iovec_t* segments, int segment_count)
+{
+    unsigned char short_dst[XMD_HASH_LEN];
+    unsigned char b0[XMD_HASH_LEN], bi[XMD_HASH_LEN];
+    hash256 h;
+    int i, j, ell, n;
+
+    if (dst_len > XMD_MAX_DST_LEN)
+    {
+        HASH256_init(&h);
+        absorb(&h, (const unsigned char*)XMD_OVERSIZE_PREFIX, sizeof(XMD_OVERSIZE_PREFIX) - 1);
+        absorb(&h, dst, dst_len);
+        HASH256_hash(&h, (char*)short_dst);
+        dst = short_dst;
+        dst_len = sizeof(short_dst);
+    }
+
+    // b_0 = H(Z_pad || msg || I2OSP(len_in_bytes, 2) || I2OSP(0, 1) || DST_prime)
+    HASH256_init(&h);
+    for (i = 0; i < XMD_BLOCK_LEN; i++)
+    {
+        HASH256_process(&h, 0);
+    }
+    for (i = 0; i < segment_count; i++)
+    {
+        absorb(&h, segments[i].data, segments[i].len);
+    }
+    HASH256_process(&h, (out_len >> 8) & 0xff);
+    HASH256_process(&h, out_len & 0xff);
+    HASH256_process(&h, 0);
+    absorb_dst_prime(&h, dst, dst_len);
+    HASH256_hash(&h, (char*)b0);
+
+    // b_i = H((b_0 xor b_(i-1)) || I2OSP(i, 1) || DST_prime), with b_0 xor b_0 = 0 skipped for i = 1
+    memset(bi, 0, sizeof(bi));
+    ell = (out_len + XMD_HASH_LEN - 1) / XMD_HASH_LEN;
+    for (i = 1; i <= ell; i++)
+    {
+        HASH256_init(&h);
+        for (j = 0; j < XMD_HASH_LEN; j++)
+        {
+            HASH256_process(&h, b0[j] ^ bi[j]);
+        }
+        HASH256_process(&h, i);
+        absorb_dst_prime(&h, dst, dst_len);
+        HASH256_hash(&h, (char*)bi);
+
+        n = out_len - (i - 1) * XMD_HASH_LEN;
+        memcpy(out + (i - 1) * XMD_HASH_LEN, bi, n < XMD_HASH_LEN ? n : XMD_HASH_LEN);
+    }
+
+    memset(b0, 0, sizeof(b0));
+    memset(bi, 0, sizeof(bi));
+}
+
+// Number of SHA-256 compressions spent by xmd_expand_iov
+static inline uint64_t xmd_compressions(size_t msg_len, size_t dst_len, int out_len)
+{
+    uint64_t ell = (out_len + XMD_HASH_LEN - 1) / XMD_HASH_LEN, blocks = 0;
+
+    if (dst_len > XMD_MAX_DST_LEN)
+    {
+        blocks += CVC_SHA256_BLOCKS(sizeof(XMD_OVERSIZE_PREFIX) - 1 + dst_len);
+        dst_len = XMD_HASH_LEN;
+    }
+    blocks += CVC_SHA256_BLOCKS(XMD_BLOCK_LEN + msg_len + 3 + dst_len + 1);
+    blocks += ell * CVC_SHA256_BLOCKS(XMD_HASH_LEN + 1 + dst_len + 1);
+    return blocks;
+}
+
+int cvc_derive_secret_key_nist256_iov(const cvc_iovec_t* segments, int segment_count, const unsigned char* dst, size_t dst_len, nist256_key_material_t* derived_key_material)
+{
+    unsigned char uniform[DERIVE_EXPAND_LEN];
+    BIG_256_56 modulus, order, d;
+    DBIG_256_56 dd;
+    size_t total = 0;
+    int i;
+
+    if (segments == NULL || segment_count <= 0 || dst == NULL || dst_len == 0 || derived_key_material == NULL)
+    {
+        return CVC_DERIVE_KEY_ERROR_INVALID_PARAMS;
+    }
+    for (i = 0; i < segment_count; i++)
+    {
+        if (segments[i].data == NULL && segments[i].len != 0)
+        {
+            return CVC_DERIVE_KEY_ERROR_INVALID_PARAMS;
+        }
+        total += segments[i].len;
+    }
+    if (total == 0)
+    {
+        return CVC_DERIVE_KEY_ERROR_INVALID_PARAMS;
+    }
+
+    CVC_STATS_TIMER(derive_start);
+    xmd_expand_iov(uniform, DERIVE_EXPAND_LEN, dst, dst_len, segments, segment_count);
+    CVC_STATS_COUNT(CVC_STAT_HASH_COMPRESSION, xmd_compressions(total, dst_len, DERIVE_EXPAND_LEN));
+
+    // hash_to_field reduces modulo p; the key is then reduced modulo the curve order
+    BIG_256_56_rcopy(modulus, Modulus_NIST256);
+    BIG_256_56_rcopy(order, CURVE_Order_NIST256);
+    BIG_256_56_dfromBytesLen(dd, (char*)uniform, DERIVE_EXPAND_LEN);
+    BIG_256_56_dmod(d, dd, modulus);
+    BIG_256_56_mod(d, order);
+    memset(uniform, 0, sizeof(uniform));
+    BIG_256_56_dzero(dd);
+
+    if (BIG_256_56_iszilch(d))
+    {
+        return CVC_DERIVE_KEY_ERROR_ZERO_SCALAR;
+    }
+
+    // key material extraction computes the public key with one generator multiplication
+    CVC_STATS_TIMER(mul_start);
+    if (nist256_big_to_key_material(d, derived_key_material) != 0)
+    {
+        BIG_256_56_zero(d);
+        return CVC_DERIVE_KEY_ERROR_KEY_EXTRACTION_FAILED;
+    }
+    CVC_STATS_TIMED(CVC_STAT_SCALAR_MUL, mul_start);
+    BIG_256_56_zero(d);
+
+    CVC_STATS_TIMED(CVC_STAT_KEY_DERIVATION, derive_start);
+
+    return CVC_DERIVE_KEY_SUCCESS;
+}
+
+int cvc_derive_secret_key_ed25519_iov(const cvc_iovec_t* segments, int segment_count, const unsigned char* dst, size_t dst_len, ed25519_key_material_t* derived_key_material)
+{
+    unsigned char uniform[DERIVE_EXPAND_LEN];
+    unsigned char scalar[CVC_ED25519_SCALAR_SIZE];
+    char be[MODBYTES_256_56];
+    BIG_256_56 order, d;
+    DBIG_256_56 dd;
+    size_t total = 0;
+    int i, result;
+
+    if (segments == NULL || segment_count <= 0 || dst == NULL || dst_len == 0 || derived_key_material == NULL)
+    {
+        return CVC_DERIVE_KEY_ERROR_INVALID_PARAMS;
+    }
+    for (i = 0; i < segment_count; i++)
+    {
+        if (segments[i].data == NULL && segments[i].len != 0)
+        {
+            return CVC_DERIVE_KEY_ERROR_INVALID_PARAMS;
+        }
+        total += segments[i].len;
+    }
+    if (total == 0)
+    {
+        return CVC_DERIVE_KEY_ERROR_INVALID_PARAMS;
+    }
+
+    CVC_STATS_TIMER(derive_start);
+    xmd_expand_iov(uniform, DERIVE_EXPAND_LEN, dst, dst_len, segments, segment_count);
+    CVC_STATS_COUNT(CVC_STAT_HASH_COMPRESSION, xmd_compressions(total, dst_len, DERIVE_EXPAND_LEN));
+
+    // the 48 uniform bytes are reduced straight into the scalar field; q is 253 bits, so the bias is
+    // below 2^-130
+    BIG_256_56_rcopy(order, CURVE_Order_Ed25519);
+    BIG_256_56_dfromBytesLen(dd, (char*)uniform, DERIVE_EXPAND_LEN);
+    BIG_256_56_dmod(d, dd, order);
+    memset(uniform, 0, sizeof(uniform));
+    BIG_256_56_dzero(dd);
+
+    if (BIG_256_56_iszilch(d))
+    {
+        return CVC_DERIVE_KEY_ERROR_ZERO_SCALAR;
+    }
+
+    BIG_256_56_toBytes(be, d);
+    for (i = 0; i < CVC_ED25519_SCALAR_SIZE; i++)
+    {
+        scalar[i] = (unsigned char)be[CVC_ED25519_SCALAR_SIZE - 1 - i];
+    }
+    BIG_256_56_zero(d);
+    memset(be, 0, sizeof(be));
+
+    result = cvc_ed25519_key_material_from_scalar(scalar, derived_key_material);
+    memset(scalar, 0, sizeof(scalar));
+    if (result != CVC_ED25519_SUCCESS)
+    {
+        return CVC_DERIVE_KEY_ERROR_KEY_EXTRACTION_FAILED;
+    }
+
+    CVC_STATS_TIMED(CVC_STAT_KEY_DERIVATION, derive_start);
+
+    return CVC_DERIVE_KEY_SUCCESS;
+}
@@ -0,0 +1,177 @@
+package internal
+
+/*
+#include "ed25519_keys.h"
+#include "derive_iov.h"
+*/
+import "C"
+import (
+	"runtime"
+	"unsafe"
+)
+
+const (
+	// Ed25519ScalarSize size of a little-endian Ed25519 secret scalar in bytes
+	Ed25519ScalarSize = C.CVC_ED25519_SCALAR_SIZE
+	// Ed25519PublicKeySize size of an RFC 8032 encoded Ed25519 public key in bytes
+	Ed25519PublicKeySize = C.CVC_ED25519_PUBLIC_KEY_SIZE
+	// Ed25519SeedSize size of an RFC 8032 private key (seed) in bytes
+	Ed25519SeedSize = C.CVC_ED25519_SEED_SIZE
+	// Ed25519PrefixSize size of the nonce prefix of an expanded secret key in bytes
+	Ed25519PrefixSize = C.CVC_ED25519_PREFIX_SIZE
+)
+
+// Ed25519KeyMaterial holds an Ed25519 secret scalar and its encoded public key
+type Ed25519KeyMaterial struct {
+	Scalar    [Ed25519ScalarSize]byte
+	PublicKey [Ed25519PublicKeySize]byte
+}
+
+func convertEd25519KeyMaterial(cKeyMaterial *C.ed25519_key_material_t) Ed25519KeyMaterial {
+	var keyMaterial Ed25519KeyMaterial
+	for i := 0; i < Ed25519ScalarSize; i++ {
+		keyMaterial.Scalar[i] = byte(cKeyMaterial.secret_scalar[i])
+		keyMaterial.PublicKey[i] = byte(cKeyMaterial.public_key[i])
+	}
+	return keyMaterial
+}
+
+// wipeEd25519KeyMaterial clears the secret scalar left in a C key material structure
+func wipeEd25519KeyMaterial(cKeyMaterial *C.ed25519_key_material_t) {
+	for i := range cKeyMaterial.secret_scalar {
+		cKeyMaterial.secret_scalar[i] = 0
+	}
+}
+
+// Ed25519KeyMaterialFromScalar computes the public key of a reduced little-endian scalar
+func Ed25519KeyMaterialFromScalar(scalar []byte) (Ed25519KeyMaterial, error) {
+	var keyMaterial Ed25519KeyMaterial
+	if err := ValidateKeyLength(scalar, Ed25519ScalarSize, "Ed25519 scalar"); err != nil {
+		return keyMaterial, err
+	}
+
+	var cKeyMaterial C.ed25519_key_material_t
+	defer wipeEd25519KeyMaterial(&cKeyMaterial)
+	result := C.cvc_ed25519_key_material_from_scalar((*C.uchar)(unsafe.Pointer(&scalar[0])), &cKeyMaterial)
+	if result != 0 {
+		return keyMaterial, MapEd25519Error(CErrorCode(result))
+	}
+
+	return convertEd25519KeyMaterial(&cKeyMaterial), nil
+}
+
+// Ed25519ExpandSeed expands an RFC 8032 private key into its reduced secret scalar and nonce prefix
+func Ed25519ExpandSeed(seed []byte) (Ed25519KeyMaterial, []byte, error) {
+	var keyMaterial Ed25519KeyMaterial
+	if err := ValidateKeyLength(seed, Ed25519SeedSize, "Ed25519 seed"); err != nil {
+		return keyMaterial, nil, err
+	}
+
+	var cKeyMaterial C.ed25519_key_material_t
+	defer wipeEd25519KeyMaterial(&cKeyMaterial)
+	prefix := make([]byte, Ed25519PrefixSize)
+	result := C.cvc_ed25519_expand_seed(
+		(*C.uchar)(unsafe.Pointer(&seed[0])),
+		C.int(len(seed)),
+		&cKeyMaterial,
+		(*C.uchar)(unsafe.Pointer(&prefix[0])),
+	)
+	if result != 0 {
+		return keyMaterial, nil, MapEd25519Error(CErrorCode(result))
+	}
+
+	return convertEd25519KeyMaterial(&cKeyMaterial), prefix, nil
+}
+
+// AddEd25519SecretKeys adds two reduced Ed25519 scalars modulo the group order
+func AddEd25519SecretKeys(scalar1, scalar2 []byte) (Ed25519KeyMaterial, error) {
+	var keyMaterial Ed25519KeyMaterial
+	if err := ValidateKeyLength(scalar1, Ed25519ScalarSize, "first Ed25519 scalar"); err != nil {
+		return keyMaterial, err
+	}
+	if err := ValidateKeyLength(scalar2, Ed25519ScalarSize, "second Ed25519 scalar"); err != nil {
+		return keyMaterial, err
+	}
+
+	var cKeyMaterial C.ed25519_key_material_t
+	defer wipeEd25519KeyMaterial(&cKeyMaterial)
+	result := C.cvc_add_ed25519_secret_keys(
+		(*C.uchar)(unsafe.Pointer(&scalar1[0])),
+		(*C.uchar)(unsafe.Pointer(&scalar2[0])),
+		&cKeyMaterial,
+	)
+	if result != 0 {
+		return keyMaterial, MapEd25519Error(CErrorCode(result))
+	}
+
+	return convertEd25519KeyMaterial(&cKeyMaterial), nil
+}
+
+// AddEd25519PublicKeys adds two RFC 8032 encoded Ed25519 public keys
+func AddEd25519PublicKeys(publicKey1, publicKey2 []byte) ([]byte, error) {
+	if err := ValidateKeyLength(publicKey1, Ed25519PublicKeySize, "first Ed25519 public key"); err != nil {
+		return nil, err
+	}
+	if err := ValidateKeyLength(publicKey2, Ed25519PublicKeySize, "second Ed25519 public key"); err != nil {
+		return nil, err
+	}
+
+	sum := make([]byte, Ed25519PublicKeySize)
+	result := C.cvc_add_ed25519_public_keys(
+		(*C.uchar)(unsafe.Pointer(&publicKey1[0])),
+		(*C.uchar)(unsafe.Pointer(&publicKey2[0])),
+		(*C.uchar)(unsafe.Pointer(&sum[0])),
+	)
+	if result != 0 {
+		return nil, MapEd25519Error(CErrorCode(result))
+	}
+
+	return sum, nil
+}
+
+// ValidateEd25519PublicKey checks that an encoded public key is a curve point of large order
+func ValidateEd25519PublicKey(publicKey []byte) error {
+	if err := ValidateKeyLength(publicKey, Ed25519PublicKeySize, "Ed25519 public key"); err != nil {
+		return err
+	}
+	if result := C.cvc_ed25519_validate_public_key((*C.uchar)(unsafe.Pointer(&publicKey[0]))); result != 0 {
+		return MapEd25519Error(CErrorCode(result))
+	}
+	return nil
+}
+
+// DeriveEd25519SecretKeySegments derives an Ed25519 secret scalar from the concatenation of segments, with
+// the same expand_message_xmd construction as DeriveSecretKeySegments
+func DeriveEd25519SecretKeySegments(dst []byte, segments ...[]byte) (Ed25519KeyMaterial, error) {
+	var keyMaterial Ed25519KeyMaterial
+
+	if err := ValidateNonEmpty(dst, "domain separation tag"); err != nil {
+		return keyMaterial, err
+	}
+	if err := ValidateInputSize(dst, 256, "domain separation tag"); err != nil {
+		return keyMaterial, err
+	}
+
+	var pinner runtime.Pinner
+	defer pinner.Unpin()
+
+	iov := pinSegments(&pinner, segments)
+	if len(iov) == 0 {
+		return keyMaterial, WrapError(ErrInvalidParameters, "derivation input cannot be empty")
+	}
+
+	var cKeyMaterial C.ed25519_key_material_t
+	defer wipeEd25519KeyMaterial(&cKeyMaterial)
+	result := C.cvc_derive_secret_key_ed25519_iov(
+		&iov[0],
+		C.int(len(iov)),
+		(*C.uchar)(unsafe.Pointer(&dst[0])),
+		C.size_t(len(dst)),
+		&cKeyMaterial,
+	)
+	if result != 0 {
+		return keyMaterial, MapDeriveKeyError(CErrorCode(result))
+	}
+
+	return convertEd25519KeyMaterial(&cKeyMaterial), nil
+}
@@ -0,0 +1,293 @@
+#include <string.h>
+
+#include "core.h"
+#include "big_256_56.h"
+#include "fp_F25519.h"
+#include "ecp_Ed25519.h"
+
+#include "ed25519_keys.h"
+
+#define ED25519_SIGN_BIT 0x80
+#define ED25519_COFACTOR_DOUBLINGS 3
+
+// scalar_from_bytes reads a little-endian scalar
+static void scalar_from_bytes(BIG_256_56 s, const unsigned char* bytes, int len)
+{
+    char be[2 * CVC_ED25519_SCALAR_SIZE];
+    int i;
+
+    for (i = 0; i < len; i++)
+    {
+        be[i] = (char)bytes[len - 1 - i];
+    }
+    BIG_256_56_fromBytesLen(s, be, len);
+    memset(be, 0, sizeof(be));
+}
+
+// scalar_to_bytes writes a scalar in little-endian order
+static void scalar_to_bytes(unsigned char* bytes, BIG_256_56 s)
+{
+    char be[MODBYTES_256_56];
+    int i;
+
+    BIG_256_56_toBytes(be, s);
+    for (i = 0; i < CVC_ED25519_SCALAR_SIZE; i++)
+    {
+        bytes[i] = (unsigned char)be[CVC_ED25519_SCALAR_SIZE - 1 - i];
+    }
+    memset(be, 0, sizeof(be));
+}
+
+// encode_point writes the RFC 8032 encoding: y in little-endian with the parity of x in the top bit
+static void encode_point(unsigned char* out, ECP_Ed25519* P)
+{
+    BIG_256_56 x, y;
+
+    ECP_Ed25519_get(x, y, P);
+    scalar_to_bytes(out, y);
+    if (BIG_256_56_parity(x))
+    {
+        out[CVC_ED25519_PUBLIC_KEY_SIZE - 1] |= ED25519_SIGN_BIT;
+    }
+}
+
+// decode_point parses an RFC 8032 encoding and rejects the identity and points of small order
+static int decode_point(ECP_Ed25519* P, const unsigned char* in)
+{
+    unsigned char buf[CVC_ED25519_PUBLIC_KEY_SIZE];
+    BIG_256_56 x, y, p;
+    FP_F25519 fy, u, v, uv, fx, inv, one;
+    ECP_Ed25519 T;
+    int sign, i;
+
+    memcpy(buf, in, sizeof(buf));
+    sign = (buf[CVC_ED25519_PUBLIC_KEY_SIZE - 1] & ED25519_SIGN_BIT) != 0;
+    buf[CVC_ED25519_PUBLIC_KEY_SIZE - 1] &= ~ED25519_SIGN_BIT;
+    scalar_from_bytes(y, buf, CVC_ED25519_PUBLIC_KEY_SIZE);
+
+    BIG_256_56_rcopy(p, Modulus_F25519);
+    if (BIG_256_56_comp(y, p) >= 0)
+    {
+        return CVC_ED25519_ERROR_INVALID_POINT;
+    }
+
+    // x^2 = u / v with u = y^2 - 1 and v = d y^2 + 1
+    FP_F25519_nres(&fy, y);
+    FP_F25519_sqr(&u, &fy);
+    BIG_256_56_rcopy(x, CURVE_B_Ed25519);
+    FP_F25519_nres(&v, x);
+    FP_F25519_mul(&v, &v, &u);
+    FP_F25519_one(&one);
+    FP_F25519_sub(&u, &u, &one);
+    FP_F25519_add(&v, &v, &one);
+
+    if (FP_F25519_iszilch(&u))
+    {
+        // x = 0 has no negative encoding
+        if (sign)
+        {
+            return CVC_ED25519_ERROR_INVALID_POINT;
+        }
+        FP_F25519_zero(&fx);
+    }
+    else
+    {
+        // sqrt(u / v) = sqrt(u v) * u / (u v), which needs a single exponentiation
+        FP_F25519_mul(&uv, &u, &v);
+        if (!FP_F25519_invsqrt(&inv, &fx, &uv))
+        {
+            return CVC_ED25519_ERROR_INVALID_POINT;
+        }
+        FP_F25519_mul(&fx, &fx, &u);
+        FP_F25519_mul(&fx, &fx, &inv);
+        FP_F25519_redc(x, &fx);
+        if (BIG_256_56_parity(x) != sign)
+        {
+            FP_F25519_neg(&fx, &fx);
+            FP_F25519_norm(&fx);
+        }
+    }
+
+    // (x, y) satisfies the curve equation by construction, so the affine point is set directly instead of
+    // through ECP_Ed25519_set, which would solve for x a second time
+    FP_F25519_copy(&P->x, &fx);
+    FP_F25519_copy(&P->y, &fy);
+    FP_F25519_one(&P->z);
+
+    // the cofactor is 8; points whose multiple by 8 is the identity carry no key
+    ECP_Ed25519_copy(&T, P);
+    for (i = 0; i < ED25519_COFACTOR_DOUBLINGS; i++)
+    {
+        ECP_Ed25519_dbl(&T);
+    }
+    if (ECP_Ed25519_isinf(&T))
+    {
+        return CVC_ED25519_ERROR_SMALL_ORDER_POINT;
+    }
+
+    return CVC_ED25519_SUCCESS;
+}
+
+// key_material_from_big fills key material from a reduced, non-zero scalar
+static int key_material_from_big(BIG_256_56 s, ed25519_key_material_t* key_material)
+{
+    ECP_Ed25519 P;
+
+    if (BIG_256_56_iszilch(s))
+    {
+        return CVC_ED25519_ERROR_ZERO_SCALAR;
+    }
+
+    ECP_Ed25519_generator(&P);
+    ECP_Ed25519_mul(&P, s);
+
+    scalar_to_bytes(key_material->secret_scalar, s);
+    encode_point(key_material->public_key, &P);
+    return CVC_ED25519_SUCCESS;
+}
+
+// read_scalar reads a little-endian scalar and checks that it is reduced modulo q
+static int read_scalar(BIG_256_56 s, const unsigned char* bytes)
+{
+    BIG_256_56 q;
+
+    scalar_from_bytes(s, bytes, CVC_ED25519_SCALAR_SIZE);
+    BIG_256_56_rcopy(q, CURVE_Order_Ed25519);
+    if (BIG_256_56_comp(s, q) >= 0)
+    {
+        BIG_256_56_zero(s);
+        return CVC_ED25519_ERROR_INVALID_SCALAR;
+    }
+    return CVC_ED25519_SUCCESS;
+}
+
+int cvc_ed25519_key_material_from_scalar(const unsigned char* scalar, ed25519_key_material_t* key_material)
+{
+    BIG_256_56 s;
+    int result;
+
+    if (scalar == NULL || key_material == NULL)
+    {
+        return CVC_ED25519_ERROR_INVALID_PARAMS;
+    }
+
+    if ((result = read_scalar(s, scalar)) != CVC_ED25519_SUCCESS)
+    {
+        return result;
+    }
+    result = key_material_from_big(s, key_material);
+    BIG_256_56_zero(s);
+    return result;
+}
+
+int cvc_ed25519_expand_seed(const unsigned char* seed, int seed_len, ed25519_key_material_t* key_material, unsigned char* prefix)
+{
+    unsigned char h[64];
+    BIG_256_56 s, q;
+    DBIG_256_56 ds;
+    hash512 sha;
+    int i, result;
+
+    if (seed == NULL || seed_len != CVC_ED25519_SEED_SIZE || key_material == NULL)
+    {
+        return CVC_ED25519_ERROR_INVALID_PARAMS;
+    }
+
+    HASH512_init(&sha);
+    for (i = 0; i < seed_len; i++)
+    {
+        HASH512_process(&sha, seed[i]);
+    }
+    HASH512_hash(&sha, (char*)h);
+
+    // RFC 8032 clamping: clear the cofactor bits, clear bit 255 and set bit 254
+    h[0] &= 248;
+    h[31] &= 127;
+    h[31] |= 64;
+
+    scalar_from_bytes(s, h, CVC_ED25519_SCALAR_SIZE);
+    BIG_256_56_rcopy(q, CURVE_Order_Ed25519);
+    BIG_256_56_dscopy(ds, s);
+    BIG_256_56_dmod(s, ds, q);
+    BIG_256_56_dzero(ds);
+
+    result = key_material_from_big(s, key_material);
+    if (result == CVC_ED25519_SUCCESS && prefix != NULL)
+    {
+        memcpy(prefix, h + CVC_ED25519_SCALAR_SIZE, CVC_ED25519_PREFIX_SIZE);
+    }
+
+    BIG_256_56_zero(s);
+    memset(h, 0, sizeof(h));
+    return result;
+}
+
+int cvc_add_ed25519_secret_keys(const unsigned char* scalar1, const unsigned char* scalar2, ed25519_key_material_t* key_material)
+{
+    BIG_256_56 s1, s2, q;
+    int result;
+
+    if (scalar1 == NULL || scalar2 == NULL || key_material == NULL)
+    {
+        return CVC_ED25519_ERROR_INVALID_PARAMS;
+    }
+
+    if ((result = read_scalar(s1, scalar1)) != CVC_ED25519_SUCCESS)
+    {
+        return result;
+    }
+    if ((result = read_scalar(s2, scalar2)) != CVC_ED25519_SUCCESS)
+    {
+        BIG_256_56_zero(s1);
+        return result;
+    }
+
+    BIG_256_56_rcopy(q, CURVE_Order_Ed25519);
+    BIG_256_56_modadd(s1, s1, s2, q);
+    result = key_material_from_big(s1, key_material);
+
+    BIG_256_56_zero(s1);
+    BIG_256_56_zero(s2);
+    return result;
+}
+
+int cvc_add_ed25519_public_keys(const unsigned char* public_key1, const unsigned char* public_key2, unsigned char* result)
+{
+    ECP_Ed25519 P, Q;
+    int code;
+
+    if (public_key1 == NULL || public_key2 == NULL || result == NULL)
+    {
+        return CVC_ED25519_ERROR_INVALID_PARAMS;
+    }
+
+    // each decode takes one inverse square root, so the sum costs two exponentiations in the field
+    if ((code = decode_point(&P, public_key1)) != CVC_ED25519_SUCCESS)
+    {
+        return code;
+    }
+    if ((code = decode_point(&Q, public_key2)) != CVC_ED25519_SUCCESS)
+    {
+        return code;
+    }
+
+    ECP_Ed25519_add(&P, &Q);
+    if (ECP_Ed25519_isinf(&P))
+    {
+        return CVC_ED25519_ERROR_INFINITY;
+    }
+
+    encode_point(result, &P);
+    return CVC_ED25519_SUCCESS;
+}
+
+int cvc_ed25519_validate_public_key(const unsigned char* public_key)
+{
+    ECP_Ed25519 P;
+
+    if (public_key == NULL)
+    {
+        return CVC_ED25519_ERROR_INVALID_PARAMS;
+    }
+    return decode_point(&P, public_key);
+}
@@ -0,0 +1,308 @@
+#include <string.h>
+
+#include "core.h"
+#include "big_256_56.h"
+#include "fp_F25519.h"
+#include "ecp_Ed25519.h"
+#include "eddsa_Ed25519.h"
+
+#include "ed25519_signature.h"
+
+#define ED25519_SIGN_BIT 0x80
+#define ED25519_HASH_SIZE 64
+
+// Wrap a caller buffer in a MIRACL octet without copying
+static octet ed25519_octet(const unsigned char* bytes, int len)
+{
+    octet o;
+    o.len = len;
+    o.max = len;
+    o.val = (char*)bytes;
+    return o;
+}
+
+static void hash_bytes(hash512* sha, const unsigned char* bytes, int len)
+{
+    int i;
+
+    for (i = 0; i < len; i++)
+    {
+        HASH512_process(sha, bytes[i]);
+    }
+}
+
+// hash_to_scalar reduces a little-endian SHA-512 digest modulo the group order
+static void hash_to_scalar(BIG_256_56 s, hash512* sha)
+{
+    unsigned char h[ED25519_HASH_SIZE];
+    char be[ED25519_HASH_SIZE];
+    BIG_256_56 q;
+    DBIG_256_56 d;
+    int i;
+
+    HASH512_hash(sha, (char*)h);
+    for (i = 0; i < ED25519_HASH_SIZE; i++)
+    {
+        be[i] = (char)h[ED25519_HASH_SIZE - 1 - i];
+    }
+    BIG_256_56_dfromBytesLen(d, be, ED25519_HASH_SIZE);
+    BIG_256_56_rcopy(q, CURVE_Order_Ed25519);
+    BIG_256_56_dmod(s, d, q);
+
+    BIG_256_56_dzero(d);
+    memset(h, 0, sizeof(h));
+    memset(be, 0, sizeof(be));
+}
+
+// scalar_from_bytes reads a little-endian 32 byte scalar
+static void scalar_from_bytes(BIG_256_56 s, const unsigned char* bytes)
+{
+    char be[CVC_ED25519_SCALAR_SIZE];
+    int i;
+
+    for (i = 0; i < CVC_ED25519_SCALAR_SIZE; i++)
+    {
+        be[i] = (char)bytes[CVC_ED25519_SCALAR_SIZE - 1 - i];
+    }
+    BIG_256_56_fromBytesLen(s, be, CVC_ED25519_SCALAR_SIZE);
+    memset(be, 0, sizeof(be));
+}
+
+// scalar_to_bytes writes a scalar in little-endian order
+static void scalar_to_bytes(unsigned char* bytes, BIG_256_56 s)
+{
+    char be[MODBYTES_256_56];
+    int i;
+
+    BIG_256_56_toBytes(be, s);
+    for (i = 0; i < CVC_ED25519_SCALAR_SIZE; i++)
+    {
+        bytes[i] = (unsigned char)be[CVC_ED25519_SCALAR_SIZE - 1 - i];
+    }
+    memset(be, 0, sizeof(be));
+}
+
+int cvc_ed25519_base_table_init(ed25519_base_table_t* table)
+{
+    ECP_Ed25519 base, P;
+    int i, j, k;
+
+    if (table == NULL)
+    {
+        return CVC_ED25519_SIGNATURE_ERROR_INVALID_PARAMS;
+    }
+
+    ECP_Ed25519_generator(&base);
+    for (i = 0; i < CVC_ED25519_BASE_WINDOWS; i++)
+    {
+        ECP_Ed25519_copy(&P, &base);
+        for (j = 0; j < CVC_ED25519_BASE_ENTRIES; j++)
+        {
+            if (j > 0)
+            {
+                ECP_Ed25519_add(&P, &base);
+            }
+            ECP_Ed25519_affine(&P);
+            FP_F25519_copy(&table->points[i][j].x, &P.x);
+            FP_F25519_copy(&table->points[i][j].y, &P.y);
+        }
+
+        // next window base: 16 * base
+        for (k = 0; k < 4; k++)
+        {
+            ECP_Ed25519_dbl(&base);
+        }
+    }
+
+    return CVC_ED25519_SIGNATURE_SUCCESS;
+}
+
+// canonical reports whether a table coordinate is fully reduced, as cvc_ed25519_base_table_init leaves it
+static int canonical(const FP_F25519* x)
+{
+    FP_F25519 r;
+    int i;
+
+    // reject excess and unnormalized limbs before any arithmetic touches them
+    if (x->XES != 1)
+    {
+        return 0;
+    }
+    for (i = 0; i < NLEN_256_56; i++)
+    {
+        if (x->g[i] < 0 || x->g[i] > BMASK_256_56)
+        {
+            return 0;
+        }
+    }
+
+    FP_F25519_copy(&r, (FP_F25519*)x);
+    FP_F25519_reduce(&r);
+    return BIG_256_56_comp(r.g, (chunk*)x->g) == 0;
+}
+
+int cvc_ed25519_base_table_check(const ed25519_base_table_t* table)
+{
+    ECP_Ed25519 base, P, T;
+    int i, j, k;
+
+    if (table == NULL)
+    {
+        return CVC_ED25519_SIGNATURE_ERROR_INVALID_PARAMS;
+    }
+
+    ECP_Ed25519_generator(&base);
+    for (i = 0; i < CVC_ED25519_BASE_WINDOWS; i++)
+    {
+        ECP_Ed25519_copy(&P, &base);
+        for (j = 0; j < CVC_ED25519_BASE_ENTRIES; j++)
+        {
+            if (j > 0)
+            {
+                ECP_Ed25519_add(&P, &base);
+            }
+            if (!canonical(&table->points[i][j].x) || !canonical(&table->points[i][j].y))
+            {
+                return CVC_ED25519_SIGNATURE_ERROR_INVALID_TABLE;
+            }
+
+            // base_mul treats table points as (x, y, 1)
+            FP_F25519_copy(&T.x, (FP_F25519*)&table->points[i][j].x);
+            FP_F25519_copy(&T.y, (FP_F25519*)&table->points[i][j].y);
+            FP_F25519_one(&T.z);
+            if (!ECP_Ed25519_equals(&P, &T))
+            {
+                return CVC_ED25519_SIGNATURE_ERROR_INVALID_TABLE;
+            }
+        }
+
+        for (k = 0; k < 4; k++)
+        {
+            ECP_Ed25519_dbl(&base);
+        }
+    }
+
+    return CVC_ED25519_SIGNATURE_SUCCESS;
+}
+
+// ct_equal returns 1 if a == b and 0 otherwise, without branching on the values
+static int ct_equal(int a, int b)
+{
+    unsigned int d = (unsigned int)(a ^ b);
+    return (int)(((d - 1) >> 31) & 1);
+}
+
+// base_mul computes [k]B for a little-endian scalar k from the fixed-base table. Every window scans
+// all entries, so neither the memory access pattern nor the number of additions depends on k.
+static void base_mul(ECP_Ed25519* R, const ed25519_base_table_t* table, const unsigned char* k)
+{
+    ECP_Ed25519 T;
+    int i, j, digit;
+
+    ECP_Ed25519_inf(R);
+    for (i = 0; i < CVC_ED25519_BASE_WINDOWS; i++)
+    {
+        digit = (k[i >> 1] >> ((i & 1) << 2)) & 0x0f;
+
+        // the identity (0, 1, 1) stays selected for a zero digit; table points are affine, so z is 1
+        ECP_Ed25519_inf(&T);
+        for (j = 0; j < CVC_ED25519_BASE_ENTRIES; j++)
+        {
+            FP_F25519_cmove(&T.x, (FP_F25519*)&table->points[i][j].x, ct_equal(digit, j + 1));
+            FP_F25519_cmove(&T.y, (FP_F25519*)&table->points[i][j].y, ct_equal(digit, j + 1));
+        }
+        ECP_Ed25519_add(R, &T);
+    }
+}
+
+int cvc_ed25519_sign(const ed25519_base_table_t* table, const ed25519_key_material_t* key_material, const unsigned char* prefix, const unsigned char* message, int message_len, unsigned char* signature)
+{
+    BIG_256_56 s, r, k, q, x, y;
+    ECP_Ed25519 R;
+    hash512 sha;
+
+    if (key_material == NULL || prefix == NULL || signature == NULL || (message == NULL && message_len != 0) || message_len < 0)
+    {
+        return CVC_ED25519_SIGNATURE_ERROR_INVALID_PARAMS;
+    }
+
+    BIG_256_56_rcopy(q, CURVE_Order_Ed25519);
+    scalar_from_bytes(s, key_material->secret_scalar);
+    if (BIG_256_56_iszilch(s) || BIG_256_56_comp(s, q) >= 0)
+    {
+        BIG_256_56_zero(s);
+        return CVC_ED25519_SIGNATURE_ERROR_INVALID_SCALAR;
+    }
+
+    // r = SHA-512(prefix || M) mod q, R = [r]B
+    HASH512_init(&sha);
+    hash_bytes(&sha, prefix, CVC_ED25519_PREFIX_SIZE);
+    hash_bytes(&sha, message, message_len);
+    hash_to_scalar(r, &sha);
+
+    if (table != NULL)
+    {
+        scalar_to_bytes(signature, r);
+        base_mul(&R, table, signature);
+    }
+    else
+    {
+        ECP_Ed25519_generator(&R);
+        ECP_Ed25519_mul(&R, r);
+    }
+    ECP_Ed25519_get(x, y, &R);
+    scalar_to_bytes(signature, y);
+    if (BIG_256_56_parity(x))
+    {
+        signature[CVC_ED25519_PUBLIC_KEY_SIZE - 1] |= ED25519_SIGN_BIT;
+    }
+
+    // k = SHA-512(R || A || M) mod q, S = r + k s mod q
+    HASH512_init(&sha);
+    hash_bytes(&sha, signature, CVC_ED25519_PUBLIC_KEY_SIZE);
+    hash_bytes(&sha, key_material->public_key, CVC_ED25519_PUBLIC_KEY_SIZE);
+    hash_bytes(&sha, message, message_len);
+    hash_to_scalar(k, &sha);
+
+    BIG_256_56_modmul(k, k, s, q);
+    BIG_256_56_modadd(r, r, k, q);
+    scalar_to_bytes(signature + CVC_ED25519_PUBLIC_KEY_SIZE, r);
+
+    BIG_256_56_zero(s);
+    BIG_256_56_zero(r);
+    BIG_256_56_zero(k);
+    return CVC_ED25519_SIGNATURE_SUCCESS;
+}
+
+int cvc_ed25519_verify(const unsigned char* public_key, const unsigned char* message, int message_len, const unsigned char* signature)
+{
+    if (public_key == NULL || signature == NULL || (message == NULL && message_len != 0) || message_len < 0)
+    {
+        return CVC_ED25519_SIGNATURE_ERROR_INVALID_PARAMS;
+    }
+    if (cvc_ed25519_validate_public_key(public_key) != CVC_ED25519_SUCCESS)
+    {
+        return CVC_ED25519_SIGNATURE_ERROR_INVALID_KEY;
+    }
+    return cvc_ed25519_verify_prepared(public_key, message, message_len, signature);
+}
+
+int cvc_ed25519_verify_prepared(const unsigned char* public_key, const unsigned char* message, int message_len, const unsigned char* signature)
+{
+    octet pk, msg, sig;
+
+    if (public_key == NULL || signature == NULL || (message == NULL && message_len != 0) || message_len < 0)
+    {
+        return CVC_ED25519_SIGNATURE_ERROR_INVALID_PARAMS;
+    }
+
+    pk = ed25519_octet(public_key, CVC_ED25519_PUBLIC_KEY_SIZE);
+    msg = ed25519_octet(message, message_len);
+    sig = ed25519_octet(signature, CVC_ED25519_SIGNATURE_SIZE);
+
+    if (!EDDSA_Ed25519_VERIFY(false, &pk, NULL, &msg, &sig))
+    {
+        return CVC_ED25519_SIGNATURE_ERROR_INVALID_SIGNATURE;
+    }
+    return CVC_ED25519_SIGNATURE_SUCCESS;
+}
@@ -0,0 +1,131 @@
+package internal
+
+/*
+#include "ed25519_signature.h"
+*/
+import "C"
+import (
+	"fmt"
+	"sync"
+	"unsafe"
+)
+
+// Ed25519SignatureSize size of an RFC 8032 Ed25519 signature in bytes
+const Ed25519SignatureSize = C.CVC_ED25519_SIGNATURE_SIZE
+
+var (
+	ed25519BaseTable     *C.ed25519_base_table_t
+	ed25519BaseTableOnce sync.Once
+)
+
+// ed25519Base returns the fixed-base table of the generator, building it on first use. The table
+// only depends on the curve and is shared read-only by all signers.
+func ed25519Base() *C.ed25519_base_table_t {
+	ed25519BaseTableOnce.Do(func() {
+		table := new(C.ed25519_base_table_t)
+		if C.cvc_ed25519_base_table_init(table) == 0 {
+			ed25519BaseTable = table
+		}
+	})
+	return ed25519BaseTable
+}
+
+// Ed25519BaseTableSize is the size in bytes of the fixed-base table in the memory layout of
+// ed25519_base_table_t, which depends on the platform
+const Ed25519BaseTableSize = C.sizeof_ed25519_base_table_t
+
+// Ed25519BaseTableBytes returns the fixed-base table as bytes, building it if needed. The slice is a
+// read-only view of the table in use and must not be modified.
+func Ed25519BaseTableBytes() ([]byte, error) {
+	table := ed25519Base()
+	if table == nil {
+		return nil, WrapError(ErrInternalError, "failed to build Ed25519 fixed-base table")
+	}
+	return unsafe.Slice((*byte)(unsafe.Pointer(table)), Ed25519BaseTableSize), nil
+}
+
+// UseEd25519BaseTable makes signing use a fixed-base table loaded from outside of this process, such
+// as a snapshot file. The table is copied into memory of this process and the copy is checked, so later
+// changes to the source cannot reach signing. It must be installed before the first signature.
+func UseEd25519BaseTable(table []byte) error {
+	if len(table) != Ed25519BaseTableSize {
+		return fmt.Errorf("%w: Ed25519 fixed-base table has %d bytes, expected %d", ErrSnapshotFormat, len(table), Ed25519BaseTableSize)
+	}
+
+	cTable := new(C.ed25519_base_table_t)
+	copy(unsafe.Slice((*byte)(unsafe.Pointer(cTable)), Ed25519BaseTableSize), table)
+	if result := C.cvc_ed25519_base_table_check(cTable); result != 0 {
+		return MapEd25519SignatureError(CErrorCode(result))
+	}
+
+	installed := false
+	ed25519BaseTableOnce.Do(func() {
+		ed25519BaseTable = cTable
+		installed = true
+	})
+	if !installed {
+		return WrapError(ErrInvalidParameters, "Ed25519 fixed-base table is already in use")
+	}
+	return nil
+}
+
+// Ed25519Sign signs message with an expanded Ed25519 secret key into signature, which must hold
+// Ed25519SignatureSize bytes. The public key in keyMaterial must belong to its scalar.
+func Ed25519Sign(keyMaterial *Ed25519KeyMaterial, prefix, message, signature []byte) error {
+	if keyMaterial == nil {
+		return WrapError(ErrInvalidKey, "Ed25519 key material cannot be nil")
+	}
+	if err := ValidateKeyLength(prefix, Ed25519PrefixSize, "Ed25519 nonce prefix"); err != nil {
+		return err
+	}
+	if err := ValidateBufferSize(signature, Ed25519SignatureSize, "signature"); err != nil {
+		return err
+	}
+
+	// Ed25519KeyMaterial has the layout of ed25519_key_material_t, so it is passed without a copy
+	result := C.cvc_ed25519_sign(
+		ed25519Base(),
+		(*C.ed25519_key_material_t)(unsafe.Pointer(keyMaterial)),
+		bytePtr(prefix),
+		bytePtr(message),
+		C.int(len(message)),
+		bytePtr(signature),
+	)
+	if result != 0 {
+		return MapEd25519SignatureError(CErrorCode(result))
+	}
+
+	return nil
+}
+
+// Ed25519Verify verifies an Ed25519 signature over message
+func Ed25519Verify(publicKey, message, signature []byte) error {
+	return ed25519Verify(publicKey, message, signature, false)
+}
+
+// Ed25519VerifyPrepared verifies an Ed25519 signature over message with a public key that already
+// passed ValidateEd25519PublicKey, skipping the per-call key validation
+func Ed25519VerifyPrepared(publicKey, message, signature []byte) error {
+	return ed25519Verify(publicKey, message, signature, true)
+}
+
+func ed25519Verify(publicKey, message, signature []byte, prepared bool) error {
+	if err := ValidateKeyLength(publicKey, Ed25519PublicKeySize, "Ed25519 public key"); err != nil {
+		return err
+	}
+	if len(signature) != Ed25519SignatureSize {
+		return ErrInvalidSignature
+	}
+
+	var result C.int
+	if prepared {
+		result = C.cvc_ed25519_verify_prepared(bytePtr(publicKey), bytePtr(message), C.int(len(message)), bytePtr(signature))
+	} else {
+		result = C.cvc_ed25519_verify(bytePtr(publicKey), bytePtr(message), C.int(len(message)), bytePtr(signature))
+	}
+	if result != 0 {
+		return MapEd25519SignatureError(CErrorCode(result))
+	}
+
+	return nil
+}
@@ -25,6 +25,7 @@ var (
 	ErrKeyAtInfinity    = errors.New("key point is at infinity (invalid)")
 	ErrZeroScalar       = errors.New("private key scalar is zero (invalid)")
 	ErrKeyOutOfRange    = errors.New("private key is not in valid range")
+	ErrKeyMismatch      = errors.New("public key does not match private key")
 
 	// Cryptographic operation errors
 	ErrPointAddition      = errors.New("elliptic curve point addition failed")
@@ -43,6 +44,22 @@ var (
 	ErrContextTooLarge = errors.New("context data too large")
 	ErrDSTTooLarge     = errors.New("domain separation tag too large")
 
+	// Key encapsulation errors
+	ErrKEM            = errors.New("key encapsulation failed")
+	ErrEnvelopeFormat = errors.New("invalid envelope format")
+	ErrDecryption     = errors.New("decryption failed")
+
+	// Signature errors
+	ErrSignature        = errors.New("signature operation failed")
+	ErrInvalidSignature = errors.New("signature verification failed")
+
+	// Precomputation snapshot errors
+	ErrSnapshotFormat = errors.New("invalid precomputation snapshot")
+
+	// Claim access errors
+	ErrClaimNotFound = errors.New("claim not found")
+	ErrClaimFormat   = errors.New("malformed claims JSON")
+
 	// JWK and encoding errors
 	ErrJWKCreation        = errors.New("failed to create JWK")
 	ErrJWKExtraction      = errors.New("failed to extract key from JWK")
@@ -77,6 +94,14 @@ func MapSecretKeyError(code CErrorCode) error {
 		return fmt.Errorf("%w: result scalar is zero (invalid private key)", ErrZeroScalar)
 	case -5: // CVC_ADD_SECRET_KEYS_ERROR_KEY_EXTRACTION_FAILED
 		return fmt.Errorf("%w: failed to extract complete key material", ErrKeyMaterialExtraction)
+	case -6: // CVC_ADD_SECRET_KEYS_ERROR_INVALID_PUBLIC_KEY1
+		return fmt.Errorf("%w: first public key is not a valid curve point", ErrKeyNotOnCurve)
+	case -7: // CVC_ADD_SECRET_KEYS_ERROR_INVALID_PUBLIC_KEY2
+		return fmt.Errorf("%w: second public key is not a valid curve point", ErrKeyNotOnCurve)
+	case -8: // CVC_ADD_SECRET_KEYS_ERROR_RESULT_AT_INFINITY
+		return fmt.Errorf("%w: sum of public keys is at infinity (invalid)", ErrKeyAtInfinity)
+	case -9: // CVC_ADD_SECRET_KEYS_ERROR_INCONSISTENT
+		return fmt.Errorf("%w: public keys do not match the secret keys", ErrKeyMismatch)
 	default:
 		return fmt.Errorf("%w: secret key addition failed with error code %d", ErrInternalError, int(code))
 	}
@@ -146,6 +171,121 @@ func MapDeriveKeyError(code CErrorCode) error {
 	}
 }
 
+// MapHMACError maps C prepared HMAC, HKDF and KDF2 error codes to Go errors
+func MapHMACError(code CErrorCode) error {
+	switch code {
+	case 0: // CVC_HMAC_SUCCESS
+		return nil
+	case -1: // CVC_HMAC_ERROR_INVALID_PARAMS
+		return fmt.Errorf("%w: invalid parameters for HMAC or KDF operation", ErrInvalidParameters)
+	default:
+		return fmt.Errorf("%w: HMAC or KDF operation failed with error code %d", ErrInternalError, int(code))
+	}
+}
+
+// MapKEMError maps C KEM and KDF error codes to Go errors
+func MapKEMError(code CErrorCode) error {
+	switch code {
+	case 0: // CVC_KEM_SUCCESS
+		return nil
+	case -1: // CVC_KEM_ERROR_INVALID_PARAMS
+		return fmt.Errorf("%w: invalid parameters for KEM operation", ErrInvalidParameters)
+	case -2: // CVC_KEM_ERROR_INVALID_SEED
+		return fmt.Errorf("%w: seed or randomness has invalid length", ErrInvalidParameters)
+	case -3: // CVC_KEM_ERROR_INVALID_PUBLIC_KEY
+		return fmt.Errorf("%w: KEM public key has invalid length", ErrInvalidKeyLength)
+	case -4: // CVC_KEM_ERROR_INVALID_SECRET_KEY
+		return fmt.Errorf("%w: KEM secret key has invalid length", ErrInvalidKeyLength)
+	case -5: // CVC_KEM_ERROR_INVALID_CIPHERTEXT
+		return fmt.Errorf("%w: KEM ciphertext has invalid length", ErrEnvelopeFormat)
+	case -6: // CVC_KEM_ERROR_INSUFFICIENT_BUFFER
+		return fmt.Errorf("%w: KEM output buffer is too small", ErrInsufficientBuffer)
+	default:
+		return fmt.Errorf("%w: KEM operation failed with error code %d", ErrKEM, int(code))
+	}
+}
+
+// MapSignatureError maps C ML-DSA error codes to Go errors
+func MapSignatureError(code CErrorCode) error {
+	switch code {
+	case 0: // CVC_MLDSA_SUCCESS
+		return nil
+	case -1: // CVC_MLDSA_ERROR_INVALID_PARAMS
+		return fmt.Errorf("%w: invalid parameters for signature operation", ErrInvalidParameters)
+	case -2: // CVC_MLDSA_ERROR_INVALID_SEED
+		return fmt.Errorf("%w: seed or randomness has invalid length", ErrInvalidParameters)
+	case -3: // CVC_MLDSA_ERROR_INVALID_SECRET_KEY
+		return fmt.Errorf("%w: signing key has invalid length", ErrInvalidKeyLength)
+	case -4: // CVC_MLDSA_ERROR_INVALID_PUBLIC_KEY
+		return fmt.Errorf("%w: verification key has invalid length", ErrInvalidKeyLength)
+	case -5: // CVC_MLDSA_ERROR_CONTEXT_TOO_LARGE
+		return fmt.Errorf("%w: signature context exceeds maximum size", ErrContextTooLarge)
+	case -6: // CVC_MLDSA_ERROR_INSUFFICIENT_BUFFER
+		return fmt.Errorf("%w: signature buffer is too small", ErrInsufficientBuffer)
+	case -7: // CVC_MLDSA_ERROR_INVALID_SIGNATURE
+		return ErrInvalidSignature
+	default:
+		return fmt.Errorf("%w: signature operation failed with error code %d", ErrSignature, int(code))
+	}
+}
+
+// MapKeyArenaError maps C key arena error codes to Go errors. Derivation failures inside an arena use the
+// key derivation codes.
+func MapKeyArenaError(code CErrorCode) error {
+	switch code {
+	case -10: // CVC_KEY_ARENA_ERROR_ALLOCATION_FAILED
+		return fmt.Errorf("%w: key arena pages could not be mapped", ErrMemoryAllocation)
+	case -11: // CVC_KEY_ARENA_ERROR_INDEX_OUT_OF_RANGE
+		return fmt.Errorf("%w: key arena slot index out of range", ErrInvalidParameters)
+	case -12: // CVC_KEY_ARENA_ERROR_NO_MASTER
+		return fmt.Errorf("%w: key arena has no master key", ErrInvalidParameters)
+	default:
+		return MapDeriveKeyError(code)
+	}
+}
+
+// MapEd25519Error maps C Ed25519 key operation error codes to Go errors
+func MapEd25519Error(code CErrorCode) error {
+	switch code {
+	case 0: // CVC_ED25519_SUCCESS
+		return nil
+	case -1: // CVC_ED25519_ERROR_INVALID_PARAMS
+		return fmt.Errorf("%w: invalid parameters for Ed25519 key operation", ErrInvalidParameters)
+	case -2: // CVC_ED25519_ERROR_INVALID_SCALAR
+		return fmt.Errorf("%w: Ed25519 scalar is not reduced modulo the group order", ErrKeyOutOfRange)
+	case -3: // CVC_ED25519_ERROR_INVALID_POINT
+		return fmt.Errorf("%w: Ed25519 public key does not decode to a curve point", ErrKeyNotOnCurve)
+	case -4: // CVC_ED25519_ERROR_SMALL_ORDER_POINT
+		return fmt.Errorf("%w: Ed25519 public key has small order", ErrInvalidKey)
+	case -5: // CVC_ED25519_ERROR_ZERO_SCALAR
+		return fmt.Errorf("%w: Ed25519 scalar is zero", ErrZeroScalar)
+	case -6: // CVC_ED25519_ERROR_INFINITY
+		return fmt.Errorf("%w: sum of Ed25519 public keys is the identity", ErrKeyAtInfinity)
+	default:
+		return fmt.Errorf("%w: Ed25519 key operation failed with error code %d", ErrInternalError, int(code))
+	}
+}
+
+// MapEd25519SignatureError maps C Ed25519 signature error codes to Go errors
+func MapEd25519SignatureError(code CErrorCode) error {
+	switch code {
+	case 0: // CVC_ED25519_SIGNATURE_SUCCESS
+		return nil
+	case -1: // CVC_ED25519_SIGNATURE_ERROR_INVALID_PARAMS
+		return fmt.Errorf("%w: invalid parameters for Ed25519 signature operation", ErrInvalidParameters)
+	case -2: // CVC_ED25519_SIGNATURE_ERROR_INVALID_SCALAR
+		return fmt.Errorf("%w: Ed25519 signing scalar is zero or not reduced", ErrKeyOutOfRange)
+	case -3: // CVC_ED25519_SIGNATURE_ERROR_INVALID_KEY
+		return fmt.Errorf("%w: Ed25519 verification key is not a point of large order", ErrInvalidKey)
+	case -4: // CVC_ED25519_SIGNATURE_ERROR_INVALID_SIGNATURE
+		return ErrInvalidSignature
+	case -5: // CVC_ED25519_SIGNATURE_ERROR_INVALID_TABLE
+		return fmt.Errorf("%w: Ed25519 fixed-base table does not hold the multiples of the generator", ErrSnapshotFormat)
+	default:
+		return fmt.Errorf("%w: Ed25519 signature operation failed with error code %d", ErrSignature, int(code))
+	}
+}
+
 // ValidateKeyLength validates that a key byte slice has the expected length
 func ValidateKeyLength(keyBytes []byte, expectedLength int, keyName string) error {
 	if len(keyBytes) != expectedLength {
@@ -197,7 +337,8 @@ func IsKeyError(err error) bool {
 		errors.Is(err, ErrKeyNotOnCurve) ||
 		errors.Is(err, ErrKeyAtInfinity) ||
 		errors.Is(err, ErrZeroScalar) ||
-		errors.Is(err, ErrKeyOutOfRange)
+		errors.Is(err, ErrKeyOutOfRange) ||
+		errors.Is(err, ErrKeyMismatch)
 }
 
 // IsCryptoError checks if an error is related to cryptographic operations
@@ -205,7 +346,9 @@ func IsCryptoError(err error) bool {
 	return errors.Is(err, ErrPointAddition) ||
 		errors.Is(err, ErrScalarAddition) ||
 		errors.Is(err, ErrHashToField) ||
-		errors.Is(err, ErrKeyDerivation)
+		errors.Is(err, ErrKeyDerivation) ||
+		errors.Is(err, ErrSignature) ||
+		errors.Is(err, ErrInvalidSignature)
 }
 
 // IsValidationError checks if an error is related to input validation
@@ -0,0 +1,190 @@
+package internal
+
+import (
+	"context"
+	"fmt"
+	"runtime"
+	"sync"
+	"sync/atomic"
+)
+
+// Executor runs long C jobs on a fixed set of worker goroutines that are locked to their OS threads.
+// Bulk work submitted through an executor can occupy at most Workers threads, however many goroutines
+// submit it, so C batches leave the remaining cores to the Go scheduler and to short, interactive C
+// calls, which keep running inline on the calling goroutine. Per-thread C state such as the statistics
+// counters stays on the same few threads.
+type Executor struct {
+	jobs    chan *executorJob
+	workers int
+
+	queued    atomic.Int64
+	running   atomic.Int64
+	peak      atomic.Int64
+	completed atomic.Uint64
+	cancelled atomic.Uint64
+}
+
+// ExecutorStats is a snapshot of the queue of an executor
+type ExecutorStats struct {
+	Workers   int    // number of locked worker threads
+	Queued    int64  // jobs waiting for a worker
+	Running   int64  // jobs currently running
+	PeakQueue int64  // largest number of waiting jobs seen since the executor started
+	Completed uint64 // jobs that ran to completion
+	Cancelled uint64 // jobs dropped from the queue because their context was done
+}
+
+// job states; a job is claimed by exactly one of the worker (running) and the submitter (cancelled)
+const (
+	jobQueued int32 = iota
+	jobRunning
+	jobCancelled
+)
+
+type executorJob struct {
+	fn    func()
+	err   error // set if fn panicked
+	state atomic.Int32
+	done  chan struct{}
+}
+
+var executorJobPool = sync.Pool{
+	New: func() any { return &executorJob{done: make(chan struct{}, 1)} },
+}
+
+// NewExecutor starts workers locked OS threads fed from a queue of queueSize jobs. Submitters block
+// while the queue is full. Executors are meant to live as long as the process.
+func NewExecutor(workers, queueSize int) *Executor {
+	if workers < 1 {
+		workers = 1
+	}
+	if queueSize < 0 {
+		queueSize = 0
+	}
+	e := &Executor{jobs: make(chan *executorJob, queueSize), workers: workers}
+	for i := 0; i < workers; i++ {
+		go e.work()
+	}
+	return e
+}
+
+func (e *Executor) work() {
+	runtime.LockOSThread()
+	for job := range e.jobs {
+		e.queued.Add(-1)
+		if !job.state.CompareAndSwap(jobQueued, jobRunning) {
+			// the submitter has given up on the job and will not wait for it
+			job.fn, job.err = nil, nil
+			executorJobPool.Put(job)
+			continue
+		}
+		e.running.Add(1)
+		job.err = runJob(job.fn)
+		e.running.Add(-1)
+		e.completed.Add(1)
+		job.done <- struct{}{}
+	}
+}
+
+// runJob calls fn and turns a panic into an error, so that a failing job neither kills the process
+// from a worker goroutine nor takes its worker thread down
+func runJob(fn func()) (err error) {
+	defer func() {
+		if r := recover(); r != nil {
+			err = WrapError(ErrInternalError, fmt.Sprintf("executor job panicked: %v", r))
+		}
+	}()
+	fn()
+	return nil
+}
+
+// Run runs fn on a worker thread and waits for it to finish. If ctx is done before a worker picks fn
+// up, fn is not run and ctx.Err() is returned. Once fn has started, Run waits for it, because fn
+// usually works on memory owned by the caller. If fn panics, the panic is returned as an error
+// wrapping ErrInternalError.
+func (e *Executor) Run(ctx context.Context, fn func()) error {
+	if err := ctx.Err(); err != nil {
+		return err
+	}
+
+	job := executorJobPool.Get().(*executorJob)
+	job.fn = fn
+	job.state.Store(jobQueued)
+
+	depth := e.queued.Add(1)
+	for peak := e.peak.Load(); depth > peak && !e.peak.CompareAndSwap(peak, depth); peak = e.peak.Load() {
+	}
+
+	select {
+	case e.jobs <- job:
+	case <-ctx.Done():
+		e.queued.Add(-1)
+		e.cancelled.Add(1)
+		job.fn = nil
+		executorJobPool.Put(job)
+		return ctx.Err()
+	}
+
+	select {
+	case <-job.done:
+	case <-ctx.Done():
+		if job.state.CompareAndSwap(jobQueued, jobCancelled) {
+			// the worker recycles the job when it dequeues it
+			e.cancelled.Add(1)
+			return ctx.Err()
+		}
+		<-job.done
+	}
+	err := job.err
+	job.fn, job.err = nil, nil
+	executorJobPool.Put(job)
+	return err
+}
+
+// Stats returns a snapshot of the executor queue
+func (e *Executor) Stats() ExecutorStats {
+	return ExecutorStats{
+		Workers:   e.workers,
+		Queued:    e.queued.Load(),
+		Running:   e.running.Load(),
+		PeakQueue: e.peak.Load(),
+		Completed: e.completed.Load(),
+		Cancelled: e.cancelled.Load(),
+	}
+}
+
+var (
+	defaultExecutor     *Executor
+	defaultExecutorOnce sync.Once
+)
+
+// DefaultExecutor returns the executor used for bulk C work, starting it on first use. Unless set
+// with SetDefaultExecutorWorkers, it has one worker less than GOMAXPROCS, and at least one, so a core
+// stays available for interactive calls.
+func DefaultExecutor() *Executor {
+	defaultExecutorOnce.Do(func() {
+		workers := runtime.GOMAXPROCS(0) - 1
+		if workers < 1 {
+			workers = 1
+		}
+		defaultExecutor = NewExecutor(workers, 4*workers)
+	})
+	return defaultExecutor
+}
+
+// SetDefaultExecutorWorkers sets the number of worker threads of the default executor. It must be
+// called before the first bulk operation and fails afterwards.
+func SetDefaultExecutorWorkers(workers int) error {
+	if workers < 1 {
+		return WrapError(ErrInvalidParameters, "executor needs at least one worker")
+	}
+	started := true
+	defaultExecutorOnce.Do(func() {
+		started = false
+		defaultExecutor = NewExecutor(workers, 4*workers)
+	})
+	if started {
+		return WrapError(ErrInvalidParameters, "executor already started")
+	}
+	return nil
+}
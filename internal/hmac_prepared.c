@@ -0,0 +1,202 @@
+#include <string.h>
+
+#include "core.h"
+
+#include "cvc_stats.h"
+#include "hmac_prepared.h"
+
+#define HMAC_BLOCK_SIZE 64
+#define HMAC_IPAD 0x36
+#define HMAC_OPAD 0x5c
+#define HKDF_MAX_BLOCKS 255
+
+static void absorb(hash256* h, const unsigned char* data, size_t len)
+{
+    size_t i;
+    for (i = 0; i < len; i++)
+    {
+        HASH256_process(h, data[i]);
+    }
+}
+
+// Number of SHA-256 compressions of an HMAC of len bytes that starts from the prepared midstates
+static inline uint64_t hmac_prepared_compressions(size_t len)
+{
+    return CVC_SHA256_BLOCKS(HMAC_BLOCK_SIZE + len) - 1 + CVC_SHA256_BLOCKS(HMAC_BLOCK_SIZE + CVC_HMAC_SHA256_SIZE) - 1;
+}
+
+// hmac_finish completes an HMAC whose inner state already absorbed the message
+static void hmac_finish(const cvc_hmac_prepared_t* prepared, hash256* inner, unsigned char* tag)
+{
+    hash256 outer;
+    char digest[CVC_HMAC_SHA256_SIZE];
+
+    HASH256_hash(inner, digest);
+    outer = prepared->outer;
+    absorb(&outer, (unsigned char*)digest, sizeof(digest));
+    HASH256_hash(&outer, (char*)tag);
+
+    memset(digest, 0, sizeof(digest));
+    memset(&outer, 0, sizeof(outer));
+}
+
+int cvc_hmac_prepare(cvc_hmac_prepared_t* prepared, const unsigned char* key, size_t key_len)
+{
+    unsigned char block[HMAC_BLOCK_SIZE];
+    hash256 h;
+    int i;
+
+    if (prepared == NULL || (key == NULL && key_len != 0))
+    {
+        return CVC_HMAC_ERROR_INVALID_PARAMS;
+    }
+
+    memset(block, 0, sizeof(block));
+    if (key_len > HMAC_BLOCK_SIZE)
+    {
+        HASH256_init(&h);
+        absorb(&h, key, key_len);
+        HASH256_hash(&h, (char*)block);
+        CVC_STATS_COUNT(CVC_STAT_HASH_COMPRESSION, CVC_SHA256_BLOCKS(key_len));
+    }
+    else if (key_len > 0)
+    {
+        memcpy(block, key, key_len);
+    }
+
+    HASH256_init(&prepared->inner);
+    HASH256_init(&prepared->outer);
+    for (i = 0; i < HMAC_BLOCK_SIZE; i++)
+    {
+        HASH256_process(&prepared->inner, block[i] ^ HMAC_IPAD);
+        HASH256_process(&prepared->outer, block[i] ^ HMAC_OPAD);
+    }
+    CVC_STATS_COUNT(CVC_STAT_HASH_COMPRESSION, 2);
+
+    memset(block, 0, sizeof(block));
+    memset(&h, 0, sizeof(h));
+    return CVC_HMAC_SUCCESS;
+}
+
+int cvc_hmac_prepared(const cvc_hmac_prepared_t* prepared, const unsigned char* message, size_t message_len, unsigned char* tag)
+{
+    hash256 inner;
+
+    if (prepared == NULL || tag == NULL || (message == NULL && message_len != 0))
+    {
+        return CVC_HMAC_ERROR_INVALID_PARAMS;
+    }
+
+    inner = prepared->inner;
+    absorb(&inner, message, message_len);
+    hmac_finish(prepared, &inner, tag);
+    CVC_STATS_COUNT(CVC_STAT_HASH_COMPRESSION, hmac_prepared_compressions(message_len));
+
+    memset(&inner, 0, sizeof(inner));
+    return CVC_HMAC_SUCCESS;
+}
+
+int cvc_hkdf_extract_prepared(const cvc_hmac_prepared_t* salt, const unsigned char* ikm, size_t ikm_len, cvc_hmac_prepared_t* prk)
+{
+    unsigned char prk_bytes[CVC_HMAC_SHA256_SIZE];
+    int result;
+
+    if (prk == NULL)
+    {
+        return CVC_HMAC_ERROR_INVALID_PARAMS;
+    }
+
+    result = cvc_hmac_prepared(salt, ikm, ikm_len, prk_bytes);
+    if (result == CVC_HMAC_SUCCESS)
+    {
+        result = cvc_hmac_prepare(prk, prk_bytes, sizeof(prk_bytes));
+    }
+
+    memset(prk_bytes, 0, sizeof(prk_bytes));
+    return result;
+}
+
+int cvc_hkdf_expand_prepared(const cvc_hmac_prepared_t* prk, const unsigned char* info, size_t info_len, unsigned char* out, size_t out_len)
+{
+    unsigned char t[CVC_HMAC_SHA256_SIZE];
+    hash256 inner;
+    size_t done, n;
+    int i;
+
+    if (prk == NULL || out == NULL || (info == NULL && info_len != 0) || out_len == 0)
+    {
+        return CVC_HMAC_ERROR_INVALID_PARAMS;
+    }
+    if (out_len > HKDF_MAX_BLOCKS * CVC_HMAC_SHA256_SIZE)
+    {
+        return CVC_HMAC_ERROR_INVALID_PARAMS;
+    }
+
+    // T(i) = HMAC(PRK, T(i-1) || info || i), with T(0) empty
+    for (i = 1, done = 0; done < out_len; i++, done += n)
+    {
+        inner = prk->inner;
+        if (i > 1)
+        {
+            absorb(&inner, t, sizeof(t));
+        }
+        absorb(&inner, info, info_len);
+        HASH256_process(&inner, i);
+        hmac_finish(prk, &inner, t);
+        CVC_STATS_COUNT(CVC_STAT_HASH_COMPRESSION, hmac_prepared_compressions((i > 1 ? sizeof(t) : 0) + info_len + 1));
+
+        n = out_len - done < sizeof(t) ? out_len - done : sizeof(t);
+        memcpy(out + done, t, n);
+    }
+
+    memset(t, 0, sizeof(t));
+    memset(&inner, 0, sizeof(inner));
+    return CVC_HMAC_SUCCESS;
+}
+
+int cvc_kdf2_prepare(cvc_kdf2_prepared_t* prepared, const unsigned char* z, size_t z_len)
+{
+    if (prepared == NULL || (z == NULL && z_len != 0))
+    {
+        return CVC_HMAC_ERROR_INVALID_PARAMS;
+    }
+
+    HASH256_init(&prepared->state);
+    absorb(&prepared->state, z, z_len);
+    prepared->z_len = z_len;
+    CVC_STATS_COUNT(CVC_STAT_HASH_COMPRESSION, z_len / HMAC_BLOCK_SIZE);
+    return CVC_HMAC_SUCCESS;
+}
+
+int cvc_kdf2_prepared(const cvc_kdf2_prepared_t* prepared, const unsigned char* param, size_t param_len, unsigned char* out, size_t out_len)
+{
+    unsigned char block[CVC_HMAC_SHA256_SIZE];
+    hash256 h;
+    size_t done, n;
+    unsigned int counter;
+
+    if (prepared == NULL || out == NULL || (param == NULL && param_len != 0) || out_len == 0)
+    {
+        return CVC_HMAC_ERROR_INVALID_PARAMS;
+    }
+
+    // full blocks of Z are already compressed into the prepared state; only its tail is hashed again
+    for (counter = 1, done = 0; done < out_len; counter++, done += n)
+    {
+        h = prepared->state;
+        HASH256_process(&h, (counter >> 24) & 0xff);
+        HASH256_process(&h, (counter >> 16) & 0xff);
+        HASH256_process(&h, (counter >> 8) & 0xff);
+        HASH256_process(&h, counter & 0xff);
+        absorb(&h, param, param_len);
+        HASH256_hash(&h, (char*)block);
+        CVC_STATS_COUNT(CVC_STAT_HASH_COMPRESSION, CVC_SHA256_BLOCKS(prepared->z_len + 4 + param_len) - prepared->z_len / HMAC_BLOCK_SIZE);
+
+        n = out_len - done < sizeof(block) ? out_len - done : sizeof(block);
+        memcpy(out + done, block, n);
+    }
+
+    memset(block, 0, sizeof(block));
+    memset(&h, 0, sizeof(h));
+    return CVC_HMAC_SUCCESS;
+}
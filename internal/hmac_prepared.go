@@ -0,0 +1,117 @@
+package internal
+
+/*
+#include "hmac_prepared.h"
+*/
+import "C"
+import "sync"
+
+// HMACSize size of an HMAC-SHA256 tag and of an HKDF-SHA256 PRK in bytes
+const HMACSize = C.CVC_HMAC_SHA256_SIZE
+
+// HMACKey is a prepared HMAC-SHA256 key schedule. Every use starts from the midstates after the
+// ipad and opad key blocks, which saves two SHA-256 compressions per HMAC. An HMACKey is safe for
+// concurrent use, except that Wipe must not run concurrently with other calls.
+type HMACKey struct {
+	prepared C.cvc_hmac_prepared_t
+}
+
+// NewHMACKey prepares the key schedule of key, which may be empty
+func NewHMACKey(key []byte) (*HMACKey, error) {
+	k := new(HMACKey)
+	result := C.cvc_hmac_prepare(&k.prepared, bytePtr(key), C.size_t(len(key)))
+	if result != 0 {
+		return nil, MapHMACError(CErrorCode(result))
+	}
+	return k, nil
+}
+
+// Sum writes the HMAC-SHA256 tag of message into tag, which must hold HMACSize bytes
+func (k *HMACKey) Sum(message, tag []byte) error {
+	if err := ValidateBufferSize(tag, HMACSize, "HMAC tag"); err != nil {
+		return err
+	}
+	result := C.cvc_hmac_prepared(&k.prepared, bytePtr(message), C.size_t(len(message)), bytePtr(tag))
+	if result != 0 {
+		return MapHMACError(CErrorCode(result))
+	}
+	return nil
+}
+
+// Extract runs HKDF-SHA256 extract with k as the salt and returns the key schedule of the PRK
+func (k *HMACKey) Extract(ikm []byte) (*HMACKey, error) {
+	prk := new(HMACKey)
+	result := C.cvc_hkdf_extract_prepared(&k.prepared, bytePtr(ikm), C.size_t(len(ikm)), &prk.prepared)
+	if result != 0 {
+		return nil, MapHMACError(CErrorCode(result))
+	}
+	return prk, nil
+}
+
+// Expand runs HKDF-SHA256 expand with k as the PRK and fills out, which may hold at most
+// 255 * HMACSize bytes
+func (k *HMACKey) Expand(info, out []byte) error {
+	if len(out) == 0 || len(out) > 255*HMACSize {
+		return WrapError(ErrInvalidParameters, "invalid HKDF output length")
+	}
+	result := C.cvc_hkdf_expand_prepared(&k.prepared, bytePtr(info), C.size_t(len(info)), bytePtr(out), C.size_t(len(out)))
+	if result != 0 {
+		return MapHMACError(CErrorCode(result))
+	}
+	return nil
+}
+
+// Wipe zeroes the key schedule
+func (k *HMACKey) Wipe() {
+	k.prepared = C.cvc_hmac_prepared_t{}
+}
+
+// KDF2Secret is a shared secret Z prepared for IEEE 1363 KDF2-SHA256, so that deriving several keys
+// from it does not hash Z again. A KDF2Secret is safe for concurrent use, except for Wipe.
+type KDF2Secret struct {
+	prepared C.cvc_kdf2_prepared_t
+}
+
+// NewKDF2Secret prepares the shared secret z
+func NewKDF2Secret(z []byte) (*KDF2Secret, error) {
+	s := new(KDF2Secret)
+	result := C.cvc_kdf2_prepare(&s.prepared, bytePtr(z), C.size_t(len(z)))
+	if result != 0 {
+		return nil, MapHMACError(CErrorCode(result))
+	}
+	return s, nil
+}
+
+// Derive fills out with KDF2-SHA256 of the secret and the key derivation parameter param
+func (s *KDF2Secret) Derive(param, out []byte) error {
+	if len(out) == 0 {
+		return WrapError(ErrInvalidParameters, "invalid KDF2 output length")
+	}
+	result := C.cvc_kdf2_prepared(&s.prepared, bytePtr(param), C.size_t(len(param)), bytePtr(out), C.size_t(len(out)))
+	if result != 0 {
+		return MapHMACError(CErrorCode(result))
+	}
+	return nil
+}
+
+// Wipe zeroes the prepared secret
+func (s *KDF2Secret) Wipe() {
+	s.prepared = C.cvc_kdf2_prepared_t{}
+}
+
+var (
+	hkdfZeroSalt     *HMACKey
+	hkdfZeroSaltOnce sync.Once
+)
+
+// hkdfNoSalt returns the schedule of the all-zero salt that HKDF uses when no salt is given. It is
+// public, so one schedule is shared by all callers.
+func hkdfNoSalt() (*HMACKey, error) {
+	hkdfZeroSaltOnce.Do(func() {
+		hkdfZeroSalt, _ = NewHMACKey(nil)
+	})
+	if hkdfZeroSalt == nil {
+		return nil, WrapError(ErrInternalError, "failed to prepare HKDF salt")
+	}
+	return hkdfZeroSalt, nil
+}
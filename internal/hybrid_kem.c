@@ -0,0 +1,125 @@
+#include <string.h>
+
+#include "core.h"
+
+// kyber.h uses the byte type without defining it
+typedef unsigned char byte;
+#include "kyber.h"
+
+#include "cvc_stats.h"
+#include "hybrid_kem.h"
+
+// Wrap a caller buffer in a MIRACL octet without copying
+static octet as_octet(const unsigned char* bytes, int len)
+{
+    octet o;
+    o.len = len;
+    o.max = len;
+    o.val = (char*)bytes;
+    return o;
+}
+
+int cvc_kyber768_keypair(const unsigned char* seed, int seed_len, unsigned char* secret_key, int secret_key_len, unsigned char* public_key, int public_key_len)
+{
+    byte r64[CVC_KYBER768_SEED_SIZE];
+    octet sk, pk;
+
+    if (seed == NULL || secret_key == NULL || public_key == NULL)
+    {
+        return CVC_KEM_ERROR_INVALID_PARAMS;
+    }
+    if (seed_len != CVC_KYBER768_SEED_SIZE)
+    {
+        return CVC_KEM_ERROR_INVALID_SEED;
+    }
+    if (secret_key_len < CVC_KYBER768_SECRET_KEY_SIZE || public_key_len < CVC_KYBER768_PUBLIC_KEY_SIZE)
+    {
+        return CVC_KEM_ERROR_INSUFFICIENT_BUFFER;
+    }
+
+    // KYBER768_keypair consumes the seed buffer, so work on a copy
+    memcpy(r64, seed, sizeof(r64));
+
+    sk = as_octet(secret_key, 0);
+    sk.max = CVC_KYBER768_SECRET_KEY_SIZE;
+    pk = as_octet(public_key, 0);
+    pk.max = CVC_KYBER768_PUBLIC_KEY_SIZE;
+
+    CVC_STATS_TIMER(start);
+    KYBER768_keypair(r64, &sk, &pk);
+    CVC_STATS_TIMED(CVC_STAT_KEM_KEYPAIR, start);
+    memset(r64, 0, sizeof(r64));
+
+    return CVC_KEM_SUCCESS;
+}
+
+int cvc_kyber768_encapsulate(const unsigned char* random, int random_len, const unsigned char* public_key, int public_key_len, unsigned char* shared_secret, int shared_secret_len, unsigned char* ciphertext, int ciphertext_len)
+{
+    byte r32[CVC_KYBER768_RANDOM_SIZE];
+    octet pk, ss, ct;
+
+    if (random == NULL || public_key == NULL || shared_secret == NULL || ciphertext == NULL)
+    {
+        return CVC_KEM_ERROR_INVALID_PARAMS;
+    }
+    if (random_len != CVC_KYBER768_RANDOM_SIZE)
+    {
+        return CVC_KEM_ERROR_INVALID_SEED;
+    }
+    if (public_key_len != CVC_KYBER768_PUBLIC_KEY_SIZE)
+    {
+        return CVC_KEM_ERROR_INVALID_PUBLIC_KEY;
+    }
+    if (shared_secret_len < CVC_KYBER768_SHARED_SECRET_SIZE || ciphertext_len < CVC_KYBER768_CIPHERTEXT_SIZE)
+    {
+        return CVC_KEM_ERROR_INSUFFICIENT_BUFFER;
+    }
+
+    memcpy(r32, random, sizeof(r32));
+
+    pk = as_octet(public_key, public_key_len);
+    ss = as_octet(shared_secret, 0);
+    ss.max = CVC_KYBER768_SHARED_SECRET_SIZE;
+    ct = as_octet(ciphertext, 0);
+    ct.max = CVC_KYBER768_CIPHERTEXT_SIZE;
+
+    CVC_STATS_TIMER(start);
+    KYBER768_encrypt(r32, &pk, &ss, &ct);
+    CVC_STATS_TIMED(CVC_STAT_KEM_ENCAPSULATE, start);
+    memset(r32, 0, sizeof(r32));
+
+    return CVC_KEM_SUCCESS;
+}
+
+int cvc_kyber768_decapsulate(const unsigned char* secret_key, int secret_key_len, const unsigned char* ciphertext, int ciphertext_len, unsigned char* shared_secret, int shared_secret_len)
+{
+    octet sk, ct, ss;
+
+    if (secret_key == NULL || ciphertext == NULL || shared_secret == NULL)
+    {
+        return CVC_KEM_ERROR_INVALID_PARAMS;
+    }
+    if (secret_key_len != CVC_KYBER768_SECRET_KEY_SIZE)
+    {
+        return CVC_KEM_ERROR_INVALID_SECRET_KEY;
+    }
+    if (ciphertext_len != CVC_KYBER768_CIPHERTEXT_SIZE)
+    {
+        return CVC_KEM_ERROR_INVALID_CIPHERTEXT;
+    }
+    if (shared_secret_len < CVC_KYBER768_SHARED_SECRET_SIZE)
+    {
+        return CVC_KEM_ERROR_INSUFFICIENT_BUFFER;
+    }
+
+    sk = as_octet(secret_key, secret_key_len);
+    ct = as_octet(ciphertext, ciphertext_len);
+    ss = as_octet(shared_secret, 0);
+    ss.max = CVC_KYBER768_SHARED_SECRET_SIZE;
+
+    CVC_STATS_TIMER(start);
+    KYBER768_decrypt(&sk, &ct, &ss);
+    CVC_STATS_TIMED(CVC_STAT_KEM_DECAPSULATE, start);
+
+    return CVC_KEM_SUCCESS;
+}
@@ -0,0 +1,144 @@
+package internal
+
+/*
+#include "hybrid_kem.h"
+*/
+import "C"
+import (
+	"unsafe"
+)
+
+const (
+	// KEMSeedSize seed size for deterministic ML-KEM-768 key pair generation
+	KEMSeedSize = C.CVC_KYBER768_SEED_SIZE
+	// KEMSecretKeySize ML-KEM-768 decapsulation key size in bytes
+	KEMSecretKeySize = C.CVC_KYBER768_SECRET_KEY_SIZE
+	// KEMPublicKeySize ML-KEM-768 encapsulation key size in bytes
+	KEMPublicKeySize = C.CVC_KYBER768_PUBLIC_KEY_SIZE
+	// KEMCiphertextSize ML-KEM-768 ciphertext size in bytes
+	KEMCiphertextSize = C.CVC_KYBER768_CIPHERTEXT_SIZE
+	// KEMSharedSecretSize ML-KEM-768 shared secret size in bytes
+	KEMSharedSecretSize = C.CVC_KYBER768_SHARED_SECRET_SIZE
+	// KEMRandomSize randomness consumed by a single encapsulation
+	KEMRandomSize = C.CVC_KYBER768_RANDOM_SIZE
+)
+
+// KEMKeyPair generates an ML-KEM-768 (Kyber768) key pair deterministically from a seed
+func KEMKeyPair(seed []byte) (secretKey, publicKey []byte, err error) {
+	if err := ValidateKeyLength(seed, KEMSeedSize, "KEM seed"); err != nil {
+		return nil, nil, err
+	}
+
+	secretKey = make([]byte, KEMSecretKeySize)
+	publicKey = make([]byte, KEMPublicKeySize)
+
+	result := C.cvc_kyber768_keypair(
+		(*C.uchar)(unsafe.Pointer(&seed[0])),
+		C.int(len(seed)),
+		(*C.uchar)(unsafe.Pointer(&secretKey[0])),
+		C.int(len(secretKey)),
+		(*C.uchar)(unsafe.Pointer(&publicKey[0])),
+		C.int(len(publicKey)),
+	)
+
+	if result != 0 {
+		return nil, nil, MapKEMError(CErrorCode(result))
+	}
+
+	return secretKey, publicKey, nil
+}
+
+// KEMEncapsulate encapsulates a fresh shared secret to an ML-KEM-768 public key using the given randomness
+func KEMEncapsulate(random, publicKey []byte) (sharedSecret, ciphertext []byte, err error) {
+	if err := ValidateKeyLength(random, KEMRandomSize, "KEM randomness"); err != nil {
+		return nil, nil, err
+	}
+
+	if err := ValidateKeyLength(publicKey, KEMPublicKeySize, "KEM public key"); err != nil {
+		return nil, nil, err
+	}
+
+	sharedSecret = make([]byte, KEMSharedSecretSize)
+	ciphertext = make([]byte, KEMCiphertextSize)
+
+	result := C.cvc_kyber768_encapsulate(
+		(*C.uchar)(unsafe.Pointer(&random[0])),
+		C.int(len(random)),
+		(*C.uchar)(unsafe.Pointer(&publicKey[0])),
+		C.int(len(publicKey)),
+		(*C.uchar)(unsafe.Pointer(&sharedSecret[0])),
+		C.int(len(sharedSecret)),
+		(*C.uchar)(unsafe.Pointer(&ciphertext[0])),
+		C.int(len(ciphertext)),
+	)
+
+	if result != 0 {
+		return nil, nil, MapKEMError(CErrorCode(result))
+	}
+
+	return sharedSecret, ciphertext, nil
+}
+
+// KEMDecapsulate recovers the shared secret from an ML-KEM-768 ciphertext
+func KEMDecapsulate(secretKey, ciphertext []byte) ([]byte, error) {
+	if err := ValidateKeyLength(secretKey, KEMSecretKeySize, "KEM secret key"); err != nil {
+		return nil, err
+	}
+
+	if err := ValidateKeyLength(ciphertext, KEMCiphertextSize, "KEM ciphertext"); err != nil {
+		return nil, err
+	}
+
+	sharedSecret := make([]byte, KEMSharedSecretSize)
+
+	result := C.cvc_kyber768_decapsulate(
+		(*C.uchar)(unsafe.Pointer(&secretKey[0])),
+		C.int(len(secretKey)),
+		(*C.uchar)(unsafe.Pointer(&ciphertext[0])),
+		C.int(len(ciphertext)),
+		(*C.uchar)(unsafe.Pointer(&sharedSecret[0])),
+		C.int(len(sharedSecret)),
+	)
+
+	if result != 0 {
+		return nil, MapKEMError(CErrorCode(result))
+	}
+
+	return sharedSecret, nil
+}
+
+// HKDF derives outLen bytes with HKDF-SHA256 from the input keying material, salt and info. Without a
+// salt the shared schedule of the all-zero salt is used, and the PRK is expanded from its prepared
+// schedule, so no key block is hashed more than once.
+func HKDF(salt, ikm, info []byte, outLen int) ([]byte, error) {
+	if err := ValidateNonEmpty(ikm, "input keying material"); err != nil {
+		return nil, err
+	}
+
+	if outLen <= 0 || outLen > 255*32 {
+		return nil, WrapError(ErrInvalidParameters, "invalid HKDF output length")
+	}
+
+	var saltKey *HMACKey
+	var err error
+	if len(salt) > 0 {
+		if saltKey, err = NewHMACKey(salt); err != nil {
+			return nil, err
+		}
+		defer saltKey.Wipe()
+	} else if saltKey, err = hkdfNoSalt(); err != nil {
+		return nil, err
+	}
+
+	prk, err := saltKey.Extract(ikm)
+	if err != nil {
+		return nil, err
+	}
+	defer prk.Wipe()
+
+	out := make([]byte, outLen)
+	if err := prk.Expand(info, out); err != nil {
+		return nil, err
+	}
+	return out, nil
+}
@@ -0,0 +1,238 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "derive_iov.h"
+#include "key_arena.h"
+
+// Zero memory through a volatile pointer so the stores are not optimized away
+static void wipe(void* p, size_t len)
+{
+    volatile unsigned char* v = (volatile unsigned char*)p;
+    while (len--)
+    {
+        *v++ = 0;
+    }
+}
+
+static size_t page_size(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (size_t)info.dwPageSize;
+#else
+    long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? (size_t)size : 4096;
+#endif
+}
+
+static void* map_pages(size_t len, int* locked)
+{
+    void* p;
+
+#ifdef _WIN32
+    p = VirtualAlloc(NULL, len, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (p == NULL)
+    {
+        return NULL;
+    }
+    *locked = VirtualLock(p, len) != 0;
+#else
+    p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (p == MAP_FAILED)
+    {
+        return NULL;
+    }
+#ifdef MADV_DONTDUMP
+    madvise(p, len, MADV_DONTDUMP);
+#endif
+    // locking fails when RLIMIT_MEMLOCK is too small; the arena is still usable
+    *locked = mlock(p, len) == 0;
+#endif
+
+    return p;
+}
+
+static void unmap_pages(void* p, size_t len, int locked)
+{
+#ifdef _WIN32
+    if (locked)
+    {
+        VirtualUnlock(p, len);
+    }
+    VirtualFree(p, 0, MEM_RELEASE);
+#else
+    if (locked)
+    {
+        munlock(p, len);
+    }
+    munmap(p, len);
+#endif
+}
+
+int cvc_key_arena_create(size_t capacity, cvc_key_arena_t** arena)
+{
+    cvc_key_arena_t* a;
+    size_t page, len;
+
+    if (arena == NULL || capacity == 0 || capacity > SIZE_MAX / sizeof(nist256_key_material_t))
+    {
+        return CVC_KEY_ARENA_ERROR_INVALID_PARAMS;
+    }
+    *arena = NULL;
+
+    page = page_size();
+    len = capacity * sizeof(nist256_key_material_t);
+    if (len > SIZE_MAX - page)
+    {
+        return CVC_KEY_ARENA_ERROR_INVALID_PARAMS;
+    }
+    len = (len + page - 1) / page * page;
+
+    a = (cvc_key_arena_t*)malloc(sizeof(*a));
+    if (a == NULL)
+    {
+        return CVC_KEY_ARENA_ERROR_ALLOCATION_FAILED;
+    }
+
+    a->slots = (nist256_key_material_t*)map_pages(len, &a->locked);
+    if (a->slots == NULL)
+    {
+        free(a);
+        return CVC_KEY_ARENA_ERROR_ALLOCATION_FAILED;
+    }
+    a->capacity = capacity;
+    a->mapped_len = len;
+    a->master = NULL;
+    a->master_len = 0;
+    a->master_mapped_len = 0;
+    a->master_locked = 0;
+
+    *arena = a;
+    return CVC_KEY_ARENA_SUCCESS;
+}
+
+int cvc_key_arena_is_locked(const cvc_key_arena_t* arena)
+{
+    return arena != NULL && arena->locked;
+}
+
+nist256_key_material_t* cvc_key_arena_slots(cvc_key_arena_t* arena)
+{
+    return arena == NULL ? NULL : arena->slots;
+}
+
+int cvc_key_arena_derive(cvc_key_arena_t* arena, size_t index, const unsigned char* master_key_bytes, size_t master_key_len, const unsigned char* context, size_t context_len, const unsigned char* dst, size_t dst_len)
+{
+    cvc_iovec_t segments[2];
+    int result;
+
+    if (arena == NULL || master_key_bytes == NULL || master_key_len == 0 || context == NULL || context_len == 0)
+    {
+        return CVC_KEY_ARENA_ERROR_INVALID_PARAMS;
+    }
+    if (index >= arena->capacity)
+    {
+        return CVC_KEY_ARENA_ERROR_INDEX_OUT_OF_RANGE;
+    }
+
+    segments[0].data = master_key_bytes;
+    segments[0].len = master_key_len;
+    segments[1].data = context;
+    segments[1].len = context_len;
+
+    result = cvc_derive_secret_key_nist256_iov(segments, 2, dst, dst_len, &arena->slots[index]);
+    if (result != CVC_DERIVE_KEY_SUCCESS)
+    {
+        wipe(&arena->slots[index], sizeof(nist256_key_material_t));
+    }
+    return result;
+}
+
+int cvc_key_arena_set_master(cvc_key_arena_t* arena, const unsigned char* master_key_bytes, size_t master_key_len)
+{
+    size_t page, len;
+
+    if (arena == NULL || master_key_bytes == NULL || master_key_len == 0)
+    {
+        return CVC_KEY_ARENA_ERROR_INVALID_PARAMS;
+    }
+    cvc_key_arena_clear_master(arena);
+
+    page = page_size();
+    if (master_key_len > SIZE_MAX - page)
+    {
+        return CVC_KEY_ARENA_ERROR_INVALID_PARAMS;
+    }
+    len = (master_key_len + page - 1) / page * page;
+
+    arena->master = (unsigned char*)map_pages(len, &arena->master_locked);
+    if (arena->master == NULL)
+    {
+        return CVC_KEY_ARENA_ERROR_ALLOCATION_FAILED;
+    }
+    memcpy(arena->master, master_key_bytes, master_key_len);
+    arena->master_len = master_key_len;
+    arena->master_mapped_len = len;
+    return CVC_KEY_ARENA_SUCCESS;
+}
+
+void cvc_key_arena_clear_master(cvc_key_arena_t* arena)
+{
+    if (arena == NULL || arena->master == NULL)
+    {
+        return;
+    }
+    wipe(arena->master, arena->master_mapped_len);
+    unmap_pages(arena->master, arena->master_mapped_len, arena->master_locked);
+    arena->master = NULL;
+    arena->master_len = 0;
+    arena->master_mapped_len = 0;
+    arena->master_locked = 0;
+}
+
+int cvc_key_arena_derive_from_master(cvc_key_arena_t* arena, size_t index, const unsigned char* context, size_t context_len, const unsigned char* dst, size_t dst_len)
+{
+    if (arena == NULL)
+    {
+        return CVC_KEY_ARENA_ERROR_INVALID_PARAMS;
+    }
+    if (arena->master == NULL)
+    {
+        return CVC_KEY_ARENA_ERROR_NO_MASTER;
+    }
+    return cvc_key_arena_derive(arena, index, arena->master, arena->master_len, context, context_len, dst, dst_len);
+}
+
+void cvc_key_arena_wipe(cvc_key_arena_t* arena, size_t count)
+{
+    if (arena == NULL)
+    {
+        return;
+    }
+    if (count > arena->capacity)
+    {
+        count = arena->capacity;
+    }
+    wipe(arena->slots, count * sizeof(nist256_key_material_t));
+}
+
+void cvc_key_arena_destroy(cvc_key_arena_t* arena)
+{
+    if (arena == NULL)
+    {
+        return;
+    }
+    cvc_key_arena_clear_master(arena);
+    wipe(arena->slots, arena->mapped_len);
+    unmap_pages(arena->slots, arena->mapped_len, arena->locked);
+    free(arena);
+}
@@ -0,0 +1,215 @@
+package internal
+
+/*
+#include "key_arena.h"
+*/
+import "C"
+import (
+	"runtime"
+	"unsafe"
+)
+
+// keyMaterialSize is the size of one arena slot: private key, public key X and public key Y
+const keyMaterialSize = 3 * KeySize
+
+// KeyArena holds derived key material in off-heap pages that are locked into RAM when possible and
+// wiped on Reset and Close. Slices returned by its accessors point into the arena and are only valid
+// until the next Reset or Close; they do not keep the arena reachable, so callers must hold it with
+// runtime.KeepAlive while they read them. A KeyArena is not safe for concurrent use.
+type KeyArena struct {
+	arena    *C.cvc_key_arena_t
+	slots    []byte
+	capacity int
+	n        int
+}
+
+// NewKeyArena maps an arena with room for capacity keys. A finalizer releases the arena if Close is
+// never called, but callers should not rely on it to wipe key material promptly.
+func NewKeyArena(capacity int) (*KeyArena, error) {
+	if capacity <= 0 {
+		return nil, WrapError(ErrInvalidParameters, "key arena capacity must be positive")
+	}
+
+	var arena *C.cvc_key_arena_t
+	result := C.cvc_key_arena_create(C.size_t(capacity), &arena)
+	if result != 0 {
+		return nil, MapKeyArenaError(CErrorCode(result))
+	}
+
+	a := &KeyArena{
+		arena:    arena,
+		slots:    unsafe.Slice((*byte)(unsafe.Pointer(C.cvc_key_arena_slots(arena))), capacity*keyMaterialSize),
+		capacity: capacity,
+	}
+	runtime.SetFinalizer(a, (*KeyArena).Close)
+	return a, nil
+}
+
+// Len returns the number of keys in the arena
+func (a *KeyArena) Len() int {
+	return a.n
+}
+
+// Cap returns the number of keys the arena can hold
+func (a *KeyArena) Cap() int {
+	return a.capacity
+}
+
+// Locked reports whether the arena pages are locked into RAM and therefore never written to swap
+func (a *KeyArena) Locked() bool {
+	if a.arena == nil {
+		return false
+	}
+	defer runtime.KeepAlive(a)
+	return C.cvc_key_arena_is_locked(a.arena) != 0
+}
+
+// Derive derives a secret key like DeriveSecretKey into the next free slot and returns its index.
+// Neither the inputs nor the result are copied to the Go heap.
+func (a *KeyArena) Derive(masterKeyBytes, context, dst []byte) (int, error) {
+	if err := ValidateNonEmpty(masterKeyBytes, "master key"); err != nil {
+		return 0, err
+	}
+	if err := a.checkDerive(context, dst); err != nil {
+		return 0, err
+	}
+
+	result := C.cvc_key_arena_derive(
+		a.arena,
+		C.size_t(a.n),
+		bytePtr(masterKeyBytes),
+		C.size_t(len(masterKeyBytes)),
+		bytePtr(context),
+		C.size_t(len(context)),
+		bytePtr(dst),
+		C.size_t(len(dst)),
+	)
+	runtime.KeepAlive(a)
+
+	if result != 0 {
+		return 0, MapKeyArenaError(CErrorCode(result))
+	}
+
+	a.n++
+	return a.n - 1, nil
+}
+
+// SetMaster copies the encoded master key into locked pages of the arena for DeriveFromMaster,
+// replacing any master set before. The caller can wipe masterKeyBytes as soon as SetMaster returns.
+func (a *KeyArena) SetMaster(masterKeyBytes []byte) error {
+	if a.arena == nil {
+		return WrapError(ErrInvalidParameters, "key arena is closed")
+	}
+	if err := ValidateNonEmpty(masterKeyBytes, "master key"); err != nil {
+		return err
+	}
+
+	result := C.cvc_key_arena_set_master(a.arena, bytePtr(masterKeyBytes), C.size_t(len(masterKeyBytes)))
+	runtime.KeepAlive(a)
+	if result != 0 {
+		return MapKeyArenaError(CErrorCode(result))
+	}
+	return nil
+}
+
+// ClearMaster wipes and releases the master set with SetMaster
+func (a *KeyArena) ClearMaster() {
+	if a.arena == nil {
+		return
+	}
+	C.cvc_key_arena_clear_master(a.arena)
+	runtime.KeepAlive(a)
+}
+
+// DeriveFromMaster is Derive with the master set by SetMaster
+func (a *KeyArena) DeriveFromMaster(context, dst []byte) (int, error) {
+	if err := a.checkDerive(context, dst); err != nil {
+		return 0, err
+	}
+
+	result := C.cvc_key_arena_derive_from_master(
+		a.arena,
+		C.size_t(a.n),
+		bytePtr(context),
+		C.size_t(len(context)),
+		bytePtr(dst),
+		C.size_t(len(dst)),
+	)
+	runtime.KeepAlive(a)
+
+	if result != 0 {
+		return 0, MapKeyArenaError(CErrorCode(result))
+	}
+
+	a.n++
+	return a.n - 1, nil
+}
+
+// checkDerive validates the arena state and the inputs shared by Derive and DeriveFromMaster
+func (a *KeyArena) checkDerive(context, dst []byte) error {
+	if a.arena == nil {
+		return WrapError(ErrInvalidParameters, "key arena is closed")
+	}
+	if a.n == a.capacity {
+		return WrapError(ErrInsufficientBuffer, "key arena is full")
+	}
+	if err := ValidateNonEmpty(context, "context"); err != nil {
+		return err
+	}
+	if err := ValidateNonEmpty(dst, "domain separation tag"); err != nil {
+		return err
+	}
+	return ValidateInputSize(dst, 256, "domain separation tag")
+}
+
+// slot returns the key material of the key at index i
+func (a *KeyArena) slot(i int) ([]byte, error) {
+	if a.arena == nil {
+		return nil, WrapError(ErrInvalidParameters, "key arena is closed")
+	}
+	if i < 0 || i >= a.n {
+		return nil, MapKeyArenaError(CErrorCode(C.CVC_KEY_ARENA_ERROR_INDEX_OUT_OF_RANGE))
+	}
+	return a.slots[i*keyMaterialSize : (i+1)*keyMaterialSize : (i+1)*keyMaterialSize], nil
+}
+
+// PrivateKey returns the 32-byte private key scalar of the key at index i
+func (a *KeyArena) PrivateKey(i int) ([]byte, error) {
+	s, err := a.slot(i)
+	if err != nil {
+		return nil, err
+	}
+	return s[:KeySize:KeySize], nil
+}
+
+// PublicKey returns the 32-byte X and Y coordinates of the public key of the key at index i
+func (a *KeyArena) PublicKey(i int) (x, y []byte, err error) {
+	s, err := a.slot(i)
+	if err != nil {
+		return nil, nil, err
+	}
+	return s[KeySize : 2*KeySize : 2*KeySize], s[2*KeySize:], nil
+}
+
+// Reset wipes all keys so the arena can be reused
+func (a *KeyArena) Reset() {
+	if a.arena == nil {
+		return
+	}
+	C.cvc_key_arena_wipe(a.arena, C.size_t(a.n))
+	runtime.KeepAlive(a)
+	a.n = 0
+}
+
+// Close wipes and releases the arena. Close is idempotent.
+func (a *KeyArena) Close() error {
+	if a.arena == nil {
+		return nil
+	}
+	C.cvc_key_arena_destroy(a.arena)
+	a.arena = nil
+	a.slots = nil
+	a.n = 0
+	runtime.SetFinalizer(a, nil)
+	return nil
+}
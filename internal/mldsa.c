@@ -0,0 +1,135 @@
+#include <string.h>
+
+#include "core.h"
+#include "dilithium.h"
+
+#include "cvc_stats.h"
+#include "mldsa.h"
+
+// Wrap a caller buffer in a MIRACL octet without copying
+static octet mldsa_octet(const unsigned char* bytes, int len)
+{
+    octet o;
+    o.len = len;
+    o.max = len;
+    o.val = (char*)bytes;
+    return o;
+}
+
+int cvc_mldsa65_keypair(const unsigned char* seed, int seed_len, unsigned char* secret_key, int secret_key_len, unsigned char* public_key, int public_key_len)
+{
+    byte tau[CVC_MLDSA65_SEED_SIZE];
+    octet sk, pk;
+
+    if (seed == NULL || secret_key == NULL || public_key == NULL)
+    {
+        return CVC_MLDSA_ERROR_INVALID_PARAMS;
+    }
+    if (seed_len != CVC_MLDSA65_SEED_SIZE)
+    {
+        return CVC_MLDSA_ERROR_INVALID_SEED;
+    }
+    if (secret_key_len < CVC_MLDSA65_SECRET_KEY_SIZE || public_key_len < CVC_MLDSA65_PUBLIC_KEY_SIZE)
+    {
+        return CVC_MLDSA_ERROR_INSUFFICIENT_BUFFER;
+    }
+
+    memcpy(tau, seed, sizeof(tau));
+
+    sk = mldsa_octet(secret_key, 0);
+    sk.max = CVC_MLDSA65_SECRET_KEY_SIZE;
+    pk = mldsa_octet(public_key, 0);
+    pk.max = CVC_MLDSA65_PUBLIC_KEY_SIZE;
+
+    DLTHM_keypair_3(tau, &sk, &pk);
+    memset(tau, 0, sizeof(tau));
+
+    return CVC_MLDSA_SUCCESS;
+}
+
+int cvc_mldsa65_sign(const unsigned char* secret_key, int secret_key_len, const unsigned char* context, int context_len, const unsigned char* message, int message_len, const unsigned char* random, int random_len, unsigned char* signature, int signature_len)
+{
+    byte rn[CVC_MLDSA65_RANDOM_SIZE];
+    octet sk, ctx, msg, sig;
+
+    if (secret_key == NULL || signature == NULL || (message == NULL && message_len != 0) || message_len < 0 ||
+        (context == NULL && context_len != 0) || context_len < 0)
+    {
+        return CVC_MLDSA_ERROR_INVALID_PARAMS;
+    }
+    if (secret_key_len != CVC_MLDSA65_SECRET_KEY_SIZE)
+    {
+        return CVC_MLDSA_ERROR_INVALID_SECRET_KEY;
+    }
+    if (context_len > CVC_MLDSA65_MAX_CONTEXT_SIZE)
+    {
+        return CVC_MLDSA_ERROR_CONTEXT_TOO_LARGE;
+    }
+    if (random != NULL && random_len != CVC_MLDSA65_RANDOM_SIZE)
+    {
+        return CVC_MLDSA_ERROR_INVALID_SEED;
+    }
+    if (signature_len < CVC_MLDSA65_SIGNATURE_SIZE)
+    {
+        return CVC_MLDSA_ERROR_INSUFFICIENT_BUFFER;
+    }
+
+    if (random != NULL)
+    {
+        memcpy(rn, random, sizeof(rn));
+    }
+
+    sk = mldsa_octet(secret_key, secret_key_len);
+    ctx = mldsa_octet(context, context_len);
+    msg = mldsa_octet(message, message_len);
+    sig = mldsa_octet(signature, 0);
+    sig.max = CVC_MLDSA65_SIGNATURE_SIZE;
+
+    // dilithium.h declares the context before the secret key for the level 3 functions, but the
+    // library takes them in the same order as DLTHM_signature_2
+    CVC_STATS_TIMER(start);
+    DLTHM_signature_3(false, random != NULL ? rn : NULL, &sk, context_len > 0 ? &ctx : NULL, &msg, &sig);
+    CVC_STATS_TIMED(CVC_STAT_SIGN, start);
+    memset(rn, 0, sizeof(rn));
+
+    return CVC_MLDSA_SUCCESS;
+}
+
+int cvc_mldsa65_verify(const unsigned char* public_key, int public_key_len, const unsigned char* context, int context_len, const unsigned char* message, int message_len, const unsigned char* signature, int signature_len)
+{
+    octet pk, ctx, msg, sig;
+    bool valid;
+
+    if (public_key == NULL || signature == NULL || (message == NULL && message_len != 0) || message_len < 0 ||
+        (context == NULL && context_len != 0) || context_len < 0)
+    {
+        return CVC_MLDSA_ERROR_INVALID_PARAMS;
+    }
+    if (public_key_len != CVC_MLDSA65_PUBLIC_KEY_SIZE)
+    {
+        return CVC_MLDSA_ERROR_INVALID_PUBLIC_KEY;
+    }
+    if (context_len > CVC_MLDSA65_MAX_CONTEXT_SIZE)
+    {
+        return CVC_MLDSA_ERROR_CONTEXT_TOO_LARGE;
+    }
+    if (signature_len != CVC_MLDSA65_SIGNATURE_SIZE)
+    {
+        return CVC_MLDSA_ERROR_INVALID_SIGNATURE;
+    }
+
+    pk = mldsa_octet(public_key, public_key_len);
+    ctx = mldsa_octet(context, context_len);
+    msg = mldsa_octet(message, message_len);
+    sig = mldsa_octet(signature, signature_len);
+
+    CVC_STATS_TIMER(start);
+    valid = DLTHM_verify_3(false, &pk, context_len > 0 ? &ctx : NULL, &msg, &sig);
+    CVC_STATS_TIMED(CVC_STAT_VERIFY, start);
+    if (!valid)
+    {
+        return CVC_MLDSA_ERROR_INVALID_SIGNATURE;
+    }
+
+    return CVC_MLDSA_SUCCESS;
+}
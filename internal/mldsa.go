@@ -0,0 +1,112 @@
+package internal
+
+/*
+#include "mldsa.h"
+*/
+import "C"
+import (
+	"unsafe"
+)
+
+const (
+	// MLDSASeedSize seed size for deterministic ML-DSA-65 key pair generation
+	MLDSASeedSize = C.CVC_MLDSA65_SEED_SIZE
+	// MLDSASecretKeySize ML-DSA-65 secret key size in bytes
+	MLDSASecretKeySize = C.CVC_MLDSA65_SECRET_KEY_SIZE
+	// MLDSAPublicKeySize ML-DSA-65 public key size in bytes
+	MLDSAPublicKeySize = C.CVC_MLDSA65_PUBLIC_KEY_SIZE
+	// MLDSASignatureSize ML-DSA-65 signature size in bytes
+	MLDSASignatureSize = C.CVC_MLDSA65_SIGNATURE_SIZE
+	// MLDSARandomSize randomness consumed by a hedged signature
+	MLDSARandomSize = C.CVC_MLDSA65_RANDOM_SIZE
+	// MLDSAMaxContextSize maximum length of the domain separation context
+	MLDSAMaxContextSize = C.CVC_MLDSA65_MAX_CONTEXT_SIZE
+)
+
+// bytePtr returns a C pointer to the first byte of b, or nil for an empty slice
+func bytePtr(b []byte) *C.uchar {
+	if len(b) == 0 {
+		return nil
+	}
+	return (*C.uchar)(unsafe.Pointer(&b[0]))
+}
+
+// MLDSAKeyPair generates an ML-DSA-65 (Dilithium3) key pair deterministically from a seed
+func MLDSAKeyPair(seed []byte) (secretKey, publicKey []byte, err error) {
+	if err := ValidateKeyLength(seed, MLDSASeedSize, "ML-DSA seed"); err != nil {
+		return nil, nil, err
+	}
+
+	secretKey = make([]byte, MLDSASecretKeySize)
+	publicKey = make([]byte, MLDSAPublicKeySize)
+
+	result := C.cvc_mldsa65_keypair(
+		bytePtr(seed),
+		C.int(len(seed)),
+		bytePtr(secretKey),
+		C.int(len(secretKey)),
+		bytePtr(publicKey),
+		C.int(len(publicKey)),
+	)
+
+	if result != 0 {
+		return nil, nil, MapSignatureError(CErrorCode(result))
+	}
+
+	return secretKey, publicKey, nil
+}
+
+// MLDSASign signs message into signature, which must hold MLDSASignatureSize bytes. A nil random
+// produces a deterministic signature.
+func MLDSASign(secretKey, context, message, random, signature []byte) error {
+	if err := ValidateKeyLength(secretKey, MLDSASecretKeySize, "ML-DSA secret key"); err != nil {
+		return err
+	}
+
+	if err := ValidateBufferSize(signature, MLDSASignatureSize, "signature"); err != nil {
+		return err
+	}
+
+	result := C.cvc_mldsa65_sign(
+		bytePtr(secretKey),
+		C.int(len(secretKey)),
+		bytePtr(context),
+		C.int(len(context)),
+		bytePtr(message),
+		C.int(len(message)),
+		bytePtr(random),
+		C.int(len(random)),
+		bytePtr(signature),
+		C.int(len(signature)),
+	)
+
+	if result != 0 {
+		return MapSignatureError(CErrorCode(result))
+	}
+
+	return nil
+}
+
+// MLDSAVerify verifies an ML-DSA-65 signature
+func MLDSAVerify(publicKey, context, message, signature []byte) error {
+	if err := ValidateKeyLength(publicKey, MLDSAPublicKeySize, "ML-DSA public key"); err != nil {
+		return err
+	}
+
+	result := C.cvc_mldsa65_verify(
+		bytePtr(publicKey),
+		C.int(len(publicKey)),
+		bytePtr(context),
+		C.int(len(context)),
+		bytePtr(message),
+		C.int(len(message)),
+		bytePtr(signature),
+		C.int(len(signature)),
+	)
+
+	if result != 0 {
+		return MapSignatureError(CErrorCode(result))
+	}
+
+	return nil
+}
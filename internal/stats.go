@@ -0,0 +1,64 @@
+package internal
+
+/*
+#include "cvc_stats.h"
+*/
+import "C"
+
+// Operations tracked by the C statistics counters
+const (
+	StatKeyDerivation   = int(C.CVC_STAT_KEY_DERIVATION)
+	StatScalarMul       = int(C.CVC_STAT_SCALAR_MUL)
+	StatPointAdd        = int(C.CVC_STAT_POINT_ADD)
+	StatHashCompression = int(C.CVC_STAT_HASH_COMPRESSION)
+	StatKEMKeyPair      = int(C.CVC_STAT_KEM_KEYPAIR)
+	StatKEMEncapsulate  = int(C.CVC_STAT_KEM_ENCAPSULATE)
+	StatKEMDecapsulate  = int(C.CVC_STAT_KEM_DECAPSULATE)
+	StatSign            = int(C.CVC_STAT_SIGN)
+	StatVerify          = int(C.CVC_STAT_VERIFY)
+	StatGCMBlock        = int(C.CVC_STAT_GCM_BLOCK)
+	// NumStatOps number of tracked operations
+	NumStatOps = int(C.CVC_STAT_COUNT)
+)
+
+// StatCounters holds the number of operations and elapsed ticks per operation
+type StatCounters struct {
+	Count [NumStatOps]uint64
+	Ticks [NumStatOps]uint64
+}
+
+// StatsEnabled reports whether the library was built with statistics (build tag cvcstats)
+func StatsEnabled() bool {
+	return statsEnabled
+}
+
+// StatsSnapshot sums the counters of all threads
+func StatsSnapshot() StatCounters {
+	var counters StatCounters
+	if !statsEnabled {
+		return counters
+	}
+
+	var stats C.cvc_stats_t
+	C.cvc_stats_snapshot(&stats)
+	for i := 0; i < NumStatOps; i++ {
+		counters.Count[i] = uint64(stats.count[i])
+		counters.Ticks[i] = uint64(stats.ticks[i])
+	}
+	return counters
+}
+
+// StatsReset zeroes the counters of all threads
+func StatsReset() {
+	if statsEnabled {
+		C.cvc_stats_reset()
+	}
+}
+
+// RecordGCMBlocks records the AES-GCM blocks needed for n bytes of plaintext. AES-GCM runs in Go,
+// so the envelope code reports it here.
+func RecordGCMBlocks(n int) {
+	if statsEnabled {
+		C.cvc_stats_record(C.CVC_STAT_GCM_BLOCK, C.uint64_t((n+15)/16), 0)
+	}
+}
@@ -0,0 +1,6 @@
+//go:build !cvcstats
+
+package internal
+
+// statsEnabled is false without the cvcstats build tag; the C counters and timers compile to nothing
+const statsEnabled = false
@@ -0,0 +1,9 @@
+//go:build cvcstats
+
+package internal
+
+// #cgo CFLAGS: -DCVC_STATS
+import "C"
+
+// statsEnabled is set by the cvcstats build tag, which also compiles the C counters and timers in
+const statsEnabled = true
@@ -0,0 +1,234 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "validate_points.h"
+
+// The curve check runs on a dedicated 4 x 64-bit Montgomery representation of the P-256 field instead of
+// the generic FP_NIST256 routines: p = 2^256 - 2^224 + 2^192 + 2^96 - 1 satisfies -p^-1 = 1 mod 2^64, which
+// turns every reduction step into a handful of multiply-adds. Only comparisons are needed, so coordinates
+// are never converted into Montgomery form; the constants are scaled instead.
+
+typedef unsigned __int128 uint128_t;
+
+#define COORDINATE_SIZE 32
+
+static const uint64_t P256_P[4] = {0xFFFFFFFFFFFFFFFFULL, 0x00000000FFFFFFFFULL, 0x0000000000000000ULL, 0xFFFFFFFF00000001ULL};
+static const uint64_t P256_B[4] = {0x3BCE3C3E27D2604BULL, 0x651D06B0CC53B0F6ULL, 0xB3EBBD55769886BCULL, 0x5AC635D8AA3A93E7ULL};
+
+// load_coordinate reads a big-endian coordinate into little-endian limbs
+static void load_coordinate(uint64_t x[4], const unsigned char* bytes)
+{
+    int i, j;
+
+    for (i = 0; i < 4; i++)
+    {
+        x[3 - i] = 0;
+        for (j = 0; j < 8; j++)
+        {
+            x[3 - i] = (x[3 - i] << 8) | bytes[8 * i + j];
+        }
+    }
+}
+
+// less_than_p reports whether x < p
+static int less_than_p(const uint64_t x[4])
+{
+    int i;
+
+    for (i = 3; i >= 0; i--)
+    {
+        if (x[i] != P256_P[i])
+        {
+            return x[i] < P256_P[i];
+        }
+    }
+    return 0;
+}
+
+// reduce_once computes r = t mod p for t < 2p, where carry is bit 256 of t
+static void reduce_once(uint64_t r[4], const uint64_t t[4], uint64_t carry)
+{
+    uint64_t d[4], borrow = 0;
+    uint128_t s;
+    int i;
+
+    for (i = 0; i < 4; i++)
+    {
+        s = (uint128_t)t[i] - P256_P[i] - borrow;
+        d[i] = (uint64_t)s;
+        borrow = (uint64_t)(s >> 64) & 1;
+    }
+    // keep t only if it was already below p
+    if (borrow > carry)
+    {
+        memcpy(r, t, sizeof(d));
+    }
+    else
+    {
+        memcpy(r, d, sizeof(d));
+    }
+}
+
+// mont_round folds the lowest limb of t into the higher ones: t = (t + m * p) / 2^64 with m = t[0]
+static void mont_round(uint64_t t[6])
+{
+    uint128_t c;
+    uint64_t m;
+
+    // m = t[0] * -p^-1 mod 2^64 = t[0]; m * p[0] + t[0] = m * 2^64 and p[2] = 0
+    m = t[0];
+    c = (uint128_t)m + ((uint128_t)m * P256_P[1] + t[1]);
+    t[0] = (uint64_t)c;
+    c = (c >> 64) + t[2];
+    t[1] = (uint64_t)c;
+    c = (c >> 64) + ((uint128_t)m * P256_P[3] + t[3]);
+    t[2] = (uint64_t)c;
+    c = (c >> 64) + t[4];
+    t[3] = (uint64_t)c;
+    t[4] = t[5] + (uint64_t)(c >> 64);
+    t[5] = 0;
+}
+
+// mont_mul computes r = a * b * 2^-256 mod p for a, b < p
+static void mont_mul(uint64_t r[4], const uint64_t a[4], const uint64_t b[4])
+{
+    uint64_t t[6] = {0};
+    uint128_t c;
+    int i, j;
+
+    for (i = 0; i < 4; i++)
+    {
+        c = 0;
+        for (j = 0; j < 4; j++)
+        {
+            c += (uint128_t)a[j] * b[i] + t[j];
+            t[j] = (uint64_t)c;
+            c >>= 64;
+        }
+        c += t[4];
+        t[4] = (uint64_t)c;
+        t[5] = (uint64_t)(c >> 64);
+
+        mont_round(t);
+    }
+
+    reduce_once(r, t, t[4]);
+}
+
+// mont_redc computes r = a * 2^-256 mod p for a < p, which is mont_mul by one without the products
+static void mont_redc(uint64_t r[4], const uint64_t a[4])
+{
+    uint64_t t[6] = {a[0], a[1], a[2], a[3], 0, 0};
+    int i;
+
+    for (i = 0; i < 4; i++)
+    {
+        mont_round(t);
+    }
+
+    reduce_once(r, t, t[4]);
+}
+
+// add_mod computes r = a + b mod p for a, b < p
+static void add_mod(uint64_t r[4], const uint64_t a[4], const uint64_t b[4])
+{
+    uint64_t t[4];
+    uint128_t c = 0;
+    int i;
+
+    for (i = 0; i < 4; i++)
+    {
+        c += (uint128_t)a[i] + b[i];
+        t[i] = (uint64_t)c;
+        c >>= 64;
+    }
+    reduce_once(r, t, (uint64_t)c);
+}
+
+// sub_mod computes r = a - b mod p for a, b < p
+static void sub_mod(uint64_t r[4], const uint64_t a[4], const uint64_t b[4])
+{
+    uint64_t borrow = 0, mask;
+    uint128_t s, c = 0;
+    int i;
+
+    for (i = 0; i < 4; i++)
+    {
+        s = (uint128_t)a[i] - b[i] - borrow;
+        r[i] = (uint64_t)s;
+        borrow = (uint64_t)(s >> 64) & 1;
+    }
+    // add p back on underflow
+    mask = (uint64_t)0 - borrow;
+    for (i = 0; i < 4; i++)
+    {
+        c += (uint128_t)r[i] + (P256_P[i] & mask);
+        r[i] = (uint64_t)c;
+        c >>= 64;
+    }
+}
+
+// curve constants scaled to match the unconverted coordinates
+typedef struct
+{
+    uint64_t three[4]; /* 3 * 2^-256 mod p */
+    uint64_t b[4];     /* b * 2^-512 mod p */
+} curve_constants_t;
+
+static void init_constants(curve_constants_t* k)
+{
+    const uint64_t three[4] = {3, 0, 0, 0};
+
+    mont_redc(k->three, three);
+    mont_redc(k->b, P256_B);
+    mont_redc(k->b, k->b);
+}
+
+// check_point tests y^2 = (x^2 - 3) * x + b, with both sides scaled by 2^-512
+static int check_point(const unsigned char* point, const curve_constants_t* k)
+{
+    uint64_t x[4], y[4], lhs[4], rhs[4];
+
+    if (point[0] != 0x04)
+    {
+        return 0;
+    }
+
+    load_coordinate(x, point + 1);
+    load_coordinate(y, point + 1 + COORDINATE_SIZE);
+    if (!less_than_p(x) || !less_than_p(y))
+    {
+        return 0;
+    }
+
+    mont_mul(lhs, y, y);
+    mont_redc(lhs, lhs);
+
+    mont_mul(rhs, x, x);
+    sub_mod(rhs, rhs, k->three);
+    mont_mul(rhs, rhs, x);
+    add_mod(rhs, rhs, k->b);
+
+    return memcmp(lhs, rhs, sizeof(lhs)) == 0;
+}
+
+int cvc_validate_nist256_public_keys(const unsigned char* points, int count, unsigned char* valid)
+{
+    curve_constants_t k;
+    int i, invalid = 0;
+
+    if (points == NULL || valid == NULL || count <= 0)
+    {
+        return CVC_VALIDATE_ERROR_INVALID_PARAMS;
+    }
+
+    init_constants(&k);
+
+    for (i = 0; i < count; i++)
+    {
+        valid[i] = (unsigned char)check_point(points + (size_t)i * CVC_NIST256_POINT_SIZE, &k);
+        invalid |= !valid[i];
+    }
+
+    return invalid ? CVC_VALIDATE_ERROR_INVALID_POINTS : CVC_VALIDATE_SUCCESS;
+}
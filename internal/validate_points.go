@@ -0,0 +1,51 @@
+package internal
+
+/*
+#include "validate_points.h"
+*/
+import "C"
+import (
+	"fmt"
+	"unsafe"
+)
+
+// ValidatePublicKeysBatch checks that every uncompressed P-256 point in points, given back to back as
+// UncompressedPublicKeySize byte blocks, lies on the curve. All points are validated in a single C call.
+// The returned slice reports the result per point; err wraps ErrKeyNotOnCurve and names the first
+// invalid point if there is one.
+func ValidatePublicKeysBatch(points []byte) ([]bool, error) {
+	if len(points) == 0 {
+		return nil, nil
+	}
+	if len(points)%UncompressedPublicKeySize != 0 {
+		return nil, fmt.Errorf("%w: batch length %d is not a multiple of %d",
+			ErrInvalidKeyLength, len(points), UncompressedPublicKeySize)
+	}
+	count := len(points) / UncompressedPublicKeySize
+
+	flags := make([]byte, count)
+	result := C.cvc_validate_nist256_public_keys(
+		(*C.uchar)(unsafe.Pointer(&points[0])),
+		C.int(count),
+		(*C.uchar)(unsafe.Pointer(&flags[0])),
+	)
+
+	valid := make([]bool, count)
+	for i, flag := range flags {
+		valid[i] = flag == 1
+	}
+
+	switch result {
+	case C.CVC_VALIDATE_SUCCESS:
+		return valid, nil
+	case C.CVC_VALIDATE_ERROR_INVALID_POINTS:
+		for i, ok := range valid {
+			if !ok {
+				return valid, fmt.Errorf("%w: public key %d is not a valid curve point", ErrKeyNotOnCurve, i)
+			}
+		}
+		return valid, ErrKeyNotOnCurve
+	default:
+		return nil, fmt.Errorf("%w: batch point validation failed", ErrInvalidParameters)
+	}
+}
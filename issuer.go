@@ -1,14 +1,18 @@
 package cvc
 
 import (
-	"bytes"
+	"context"
 	"crypto/rand"
 	"encoding/base64"
 	"encoding/json"
+	"errors"
 	"fmt"
 	"io"
 	"net/http"
 	"path"
+	"sync"
+	"sync/atomic"
+	"time"
 
 	"github.com/MyNextID/cvc-go/pkg"
 	"github.com/lestrrat-go/jwx/v2/jwk"
@@ -17,10 +21,74 @@ import (
 
 type IssuerConfig struct {
 	ProviderURL string
+
+	// HTTPClient is used for calls to the wallet provider. If nil, http.DefaultClient is used.
+	HTTPClient *http.Client
+
+	// RequestPolicy controls timeouts, retries and hedging of wallet provider calls.
+	// If nil, a shared policy created by NewRequestPolicy is used.
+	RequestPolicy *RequestPolicy
+
+	// latency holds the recent wallet provider latencies that hedge delays follow. It is created on
+	// first use (see latencyWindow) and shared by copies of the config made after that.
+	latency *latencyWindow
+
+	// PublicKeyCache optionally stores the salt, key ID and wallet provider public key issued for each
+	// recipient email. F0 reuses cached entries and only calls the wallet provider for cache misses.
+	PublicKeyCache PublicKeyCache
+
+	// PublicKeyCacheTTL limits how long a cached entry is reused. Zero means entries do not expire.
+	PublicKeyCacheTTL time.Duration
+
+	// AdditiveMasterKey enables provider-free issuance: when set, F0 derives wallet provider public keys
+	// locally with DeriveAdditivePublicKey instead of calling the wallet provider.
+	AdditiveMasterKey *AdditiveMasterKey
+
+	// HybridKEM makes PrepareMessagePack seal EncVC and EncVCSecKey in hybrid P-256 + Kyber768 envelopes
+	// (pkg.HybridFormatV1) instead of JWE. The wallet provider must run in hybrid mode, so this cannot be
+	// combined with AdditiveMasterKey.
+	HybridKEM bool
+
+	// CompactSecretKey makes PrepareMessagePack encrypt only the 32-byte VC secret key scalar
+	// (KeyFormatScalarV1) instead of its JWK JSON. Without HybridKEM the scalar is sealed in a compact binary
+	// envelope (pkg.CompactFormatV1) rather than a JWE.
+	CompactSecretKey bool
+
+	// BinaryEncVC makes PrepareMessagePack store the encrypted credential as a binary JWE (MessagePack.EncVCBinary)
+	// instead of a compact JWE in EncVC, which avoids base64url encoding the credential. It has no effect with
+	// HybridKEM, whose envelopes are already binary.
+	BinaryEncVC bool
+
+	// CompressionThreshold enables DEFLATE compression of signed credentials of at least this many bytes before
+	// they are encrypted: JWEs carry "zip":"DEF" and native envelopes set pkg.EnvelopeFlagDeflate. Zero disables
+	// compression.
+	CompressionThreshold int
 }
 
 // GetPublicKeysFromWalletProvider (F0) generates wallet provider public keys for a map of users
 func (c *IssuerConfig) GetPublicKeysFromWalletProvider(emailMap map[string]string) (map[string]*UserData, error) {
+	return c.StreamPublicKeysFromWalletProviderContext(context.Background(), emailMap, nil)
+}
+
+// GetPublicKeysFromWalletProviderContext is GetPublicKeysFromWalletProvider that aborts the wallet provider
+// requests and the local key work when ctx is done
+func (c *IssuerConfig) GetPublicKeysFromWalletProviderContext(ctx context.Context, emailMap map[string]string) (map[string]*UserData, error) {
+	return c.StreamPublicKeysFromWalletProviderContext(ctx, emailMap, nil)
+}
+
+// StreamPublicKeysFromWalletProvider (F0) generates wallet provider public keys for a map of users like
+// GetPublicKeysFromWalletProvider, but decodes the wallet provider response incrementally and calls handle for
+// each user as soon as their public key has been parsed, so that F1 can start while the rest of the response is
+// still being received. Calls to handle are serialized and happen at most once per user. They run on their own
+// goroutine, so a slow handler does not hold up reading the response. If handle returns an error, the remaining
+// response is discarded and the error is returned.
+func (c *IssuerConfig) StreamPublicKeysFromWalletProvider(emailMap map[string]string, handle func(uuid string, userData *UserData) error) (map[string]*UserData, error) {
+	return c.StreamPublicKeysFromWalletProviderContext(context.Background(), emailMap, handle)
+}
+
+// StreamPublicKeysFromWalletProviderContext is StreamPublicKeysFromWalletProvider that aborts the wallet
+// provider requests, local derivation and key validation when ctx is done, and then returns ctx.Err()
+func (c *IssuerConfig) StreamPublicKeysFromWalletProviderContext(ctx context.Context, emailMap map[string]string, handle func(uuid string, userData *UserData) error) (map[string]*UserData, error) {
 	// Input validation
 	if len(emailMap) == 0 {
 		return nil, fmt.Errorf("emailMap cannot be nil or empty")
@@ -35,12 +103,35 @@ func (c *IssuerConfig) GetPublicKeysFromWalletProvider(emailMap map[string]strin
 	// initialize slice for wp
 	var hashSlices []string
 
+	// users whose keys were found in the cache or derived locally
+	var readyUsers, cachedUsers []string
+
 	// Process each user
+	processed := 0
 	for uuid, email := range emailMap {
+		if processed%deriveChunkSize == 0 {
+			if err := ctx.Err(); err != nil {
+				return nil, err
+			}
+		}
+		processed++
+
 		if email == "" {
 			return nil, fmt.Errorf("email cannot be empty for uuid: %s", uuid)
 		}
 
+		// Reuse the key of a returning recipient if it is cached
+		cached, ok, err := c.lookupCachedPublicKey(email)
+		if err != nil {
+			return nil, err
+		}
+		if ok {
+			tempMap[uuid] = cached
+			readyUsers = append(readyUsers, uuid)
+			cachedUsers = append(cachedUsers, uuid)
+			continue
+		}
+
 		// Initialize UserData
 		tempMap[uuid] = &UserData{Email: email}
 
@@ -60,6 +151,24 @@ func (c *IssuerConfig) GetPublicKeysFromWalletProvider(emailMap map[string]strin
 		// convert to base64
 		base64Hash := base64.StdEncoding.EncodeToString(hashed)
 
+		// with additive derivation the wallet provider key is computed locally
+		if c.AdditiveMasterKey != nil {
+			if c.HybridKEM {
+				return nil, fmt.Errorf("additive derivation cannot be combined with HybridKEM")
+			}
+			keyID := NewAdditiveKeyID(c.AdditiveMasterKey.IssuerID)
+			keyContext := append([]byte(keyID), base64Hash...)
+			wpPubKey, err := DeriveAdditivePublicKey(c.AdditiveMasterKey, keyContext)
+			if err != nil {
+				return nil, fmt.Errorf("failed to derive wallet provider public key for user %s: %w", uuid, err)
+			}
+			tempMap[uuid].KeyID = keyID
+			tempMap[uuid].WpPubKey = wpPubKey
+			tempMap[uuid].wpPubKeyValidated = true
+			readyUsers = append(readyUsers, uuid)
+			continue
+		}
+
 		// add hash to slice for wp
 		hashSlices = append(hashSlices, base64Hash)
 
@@ -67,73 +176,353 @@ func (c *IssuerConfig) GetPublicKeysFromWalletProvider(emailMap map[string]strin
 		hashUuidMap[base64Hash] = uuid
 	}
 
-	// marshal the hashSlice to json for transport
-	hashBytes, err := json.Marshal(hashSlices)
-	if err != nil {
-		panic(err)
+	// cached keys may come from persisted storage, so they are validated like received ones; rejected
+	// ones are evicted so that the next issuance requests fresh keys
+	if err := validateWpPubKeys(ctx, tempMap, readyUsers); err != nil {
+		if ctx.Err() == nil {
+			if evictErr := c.evictInvalidCachedKeys(tempMap, cachedUsers); evictErr != nil {
+				return nil, errors.Join(err, evictErr)
+			}
+		}
+		return nil, err
 	}
 
-	// call api to get public keys for users
-	receivedMap, err := c.GeneratePublicKeys(hashBytes)
-	if err != nil {
-		return nil, fmt.Errorf("failed get public keys from wallet provider: %s", err)
+	// cached and locally derived users are complete before any network call is made
+	if handle != nil {
+		for _, uuid := range readyUsers {
+			if err := handle(uuid, tempMap[uuid]); err != nil {
+				return nil, err
+			}
+		}
+	}
+
+	// only cache misses go to the wallet provider
+	if len(hashSlices) == 0 {
+		return tempMap, nil
 	}
 
-	// loop through the map and fill out the return map
-	for hash, data := range receivedMap {
+	// a streaming caller's handler runs apart from the response reader, so that a slow handler cannot
+	// stall the read into the attempt timeout and make the wallet provider issue the keys again. The
+	// queue holds every user the wallet provider is asked for, so the reader never blocks on it.
+	var handled chan string
+	var handleErr error
+	var handlerDone sync.WaitGroup
+	if handle != nil {
+		var cancel context.CancelFunc
+		ctx, cancel = context.WithCancel(ctx)
+		defer cancel()
+		handled = make(chan string, len(hashSlices))
+		handlerDone.Add(1)
+		go func() {
+			defer handlerDone.Done()
+			for userId := range handled {
+				if handleErr != nil {
+					continue
+				}
+				if handleErr = handle(userId, tempMap[userId]); handleErr != nil {
+					cancel()
+				}
+			}
+		}()
+	}
+
+	// resolve each received entry to its user as it arrives; entries for unknown hashes and repeated
+	// entries (from retried or hedged requests) are skipped
+	var mu sync.Mutex
+	delivered := make(map[string]bool, len(hashSlices))
+	// received keys are only cached once they have been validated
+	var toCache map[string]KeyData
+	if handle == nil {
+		toCache = make(map[string]KeyData, len(hashSlices))
+	}
+	resolve := func(hash string, data KeyData) error {
 		// figure out to which user the data belongs
-		userId := hashUuidMap[hash]
-		// set values for user in return map
-		tempMap[userId].KeyID = data.KeyID
+		userId, ok := hashUuidMap[hash]
+		if !ok {
+			return nil
+		}
+		mu.Lock()
+		seen := delivered[hash]
+		mu.Unlock()
+		if seen {
+			return nil
+		}
+
 		// for the key we need to convert it to jwk.Key from json bytes
 		wpPubKey, err := pkg.KeyJsonToJWK(data.WpPubkey)
 		if err != nil {
-			return nil, fmt.Errorf("failed to convert json formatted key to jwk.Key: %s", err)
+			return fmt.Errorf("failed to convert json formatted key to jwk.Key: %s", err)
+		}
+
+		mu.Lock()
+		defer mu.Unlock()
+		if delivered[hash] {
+			return nil
 		}
+		delivered[hash] = true
+
+		// set values for user in return map
+		tempMap[userId].KeyID = data.KeyID
 		tempMap[userId].WpPubKey = wpPubKey
+		tempMap[userId].WpKemPubKey = data.WpKemPubkey
+
+		// a streaming caller uses the key right away; otherwise all keys are validated in one batch below
+		if handle == nil {
+			toCache[userId] = data
+			return nil
+		}
+		if err := validateWpPubKeys(ctx, tempMap, []string{userId}); err != nil {
+			return err
+		}
+		if err := c.storeCachedPublicKey(tempMap[userId].Email, tempMap[userId].Salt, data); err != nil {
+			return err
+		}
+		handled <- userId
+		return nil
+	}
+
+	// call api to get public keys for users
+	err := c.fetchPublicKeys(ctx, hashSlices, resolve)
+	if handle != nil {
+		close(handled)
+		handlerDone.Wait()
+		if handleErr != nil {
+			return nil, handleErr
+		}
+	}
+	if err != nil {
+		if ctxErr := ctx.Err(); ctxErr != nil {
+			return nil, ctxErr
+		}
+		return nil, fmt.Errorf("failed get public keys from wallet provider: %s", err)
+	}
+
+	received := make([]string, 0, len(hashSlices))
+	for _, hash := range hashSlices {
+		if !delivered[hash] {
+			return nil, fmt.Errorf("wallet provider response is missing key for user %s", hashUuidMap[hash])
+		}
+		received = append(received, hashUuidMap[hash])
+	}
+	if err := validateWpPubKeys(ctx, tempMap, received); err != nil {
+		return nil, err
+	}
+	for _, userId := range received {
+		if data, ok := toCache[userId]; ok {
+			if err := c.storeCachedPublicKey(tempMap[userId].Email, tempMap[userId].Salt, data); err != nil {
+				return nil, err
+			}
+		}
 	}
 
 	return tempMap, nil
 }
 
+// evictInvalidCachedKeys removes the cache entries of the given users whose wallet provider public key
+// does not pass validation
+func (c *IssuerConfig) evictInvalidCachedKeys(userMap map[string]*UserData, uuids []string) error {
+	var errs []error
+	for _, uuid := range uuids {
+		userData := userMap[uuid]
+		if userData.wpPubKeyValidated || ValidatePublicKeysBatch([]jwk.Key{userData.WpPubKey}) == nil {
+			continue
+		}
+		if err := c.InvalidateCachedPublicKey(userData.Email); err != nil {
+			errs = append(errs, fmt.Errorf("failed to remove invalid public key cache entry: %w", err))
+		}
+	}
+	return errors.Join(errs...)
+}
+
+// validateWpPubKeys checks the wallet provider public keys of the given users in a single batch and marks
+// them as validated. Users whose key has already been validated are skipped.
+func validateWpPubKeys(ctx context.Context, userMap map[string]*UserData, uuids []string) error {
+	pending := make([]string, 0, len(uuids))
+	keys := make([]jwk.Key, 0, len(uuids))
+	for _, uuid := range uuids {
+		if userMap[uuid].wpPubKeyValidated {
+			continue
+		}
+		pending = append(pending, uuid)
+		keys = append(keys, userMap[uuid].WpPubKey)
+	}
+	if len(keys) == 0 {
+		return nil
+	}
+
+	if err := ValidatePublicKeysBatchContext(ctx, keys); err != nil {
+		if ctxErr := ctx.Err(); ctxErr != nil {
+			return ctxErr
+		}
+		// name the offending user rather than its position in the batch
+		for _, uuid := range pending {
+			if err := ValidatePublicKeysBatch([]jwk.Key{userMap[uuid].WpPubKey}); err != nil {
+				return fmt.Errorf("invalid wallet provider public key for user %s: %w", uuid, err)
+			}
+		}
+		return fmt.Errorf("invalid wallet provider public key: %w", err)
+	}
+
+	for _, uuid := range pending {
+		userMap[uuid].wpPubKeyValidated = true
+	}
+	return nil
+}
+
+// fetchPublicKeys requests public keys for the given hashes, split into batches according to the
+// RequestPolicy, and passes every received entry to handle. Up to MaxConcurrentBatches batches run
+// concurrently; the first failing batch cancels the others.
+func (c *IssuerConfig) fetchPublicKeys(ctx context.Context, hashSlices []string, handle func(hash string, data KeyData) error) error {
+	if len(hashSlices) == 0 {
+		return nil
+	}
+	policy := c.requestPolicy()
+	batchSize := policy.BatchSize
+	if batchSize <= 0 || batchSize > len(hashSlices) {
+		batchSize = len(hashSlices)
+	}
+	batches := (len(hashSlices) + batchSize - 1) / batchSize
+	workers := policy.MaxConcurrentBatches
+	if workers < 1 {
+		workers = 1
+	}
+	if workers > batches {
+		workers = batches
+	}
+
+	ctx, cancel := context.WithCancel(ctx)
+	defer cancel()
+
+	var wg sync.WaitGroup
+	var errOnce sync.Once
+	var firstErr error
+	var next atomic.Int64
+	for w := 0; w < workers; w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for ctx.Err() == nil {
+				start := int(next.Add(1)-1) * batchSize
+				if start >= len(hashSlices) {
+					return
+				}
+				end := start + batchSize
+				if end > len(hashSlices) {
+					end = len(hashSlices)
+				}
+
+				// marshal the hashSlice to json for transport
+				hashBytes, err := json.Marshal(hashSlices[start:end])
+				if err == nil {
+					err = c.generatePublicKeysStream(ctx, hashBytes, handle)
+				}
+				if err != nil {
+					errOnce.Do(func() {
+						firstErr = err
+						cancel()
+					})
+				}
+			}
+		}()
+	}
+	wg.Wait()
+
+	if firstErr == nil {
+		// batches that were never started must not look like a complete result
+		firstErr = ctx.Err()
+	}
+	return firstErr
+}
+
+// GeneratePublicKeys calls the wallet provider to generate public keys for a JSON encoded list of
+// hashes. The call is retried and hedged according to the issuer's RequestPolicy.
 func (c *IssuerConfig) GeneratePublicKeys(hashBytes []byte) (map[string]KeyData, error) {
-	// Build the HTTP POST request with JSON body
-	url := c.ProviderURL + path.Join("/", "generate", "pub-key")
-	req, err := http.NewRequest("POST", url, bytes.NewBuffer(hashBytes))
+	return c.GeneratePublicKeysContext(context.Background(), hashBytes)
+}
+
+// GeneratePublicKeysContext is GeneratePublicKeys with the wallet provider requests bound to ctx
+func (c *IssuerConfig) GeneratePublicKeysContext(ctx context.Context, hashBytes []byte) (map[string]KeyData, error) {
+	receivedMap := make(map[string]KeyData)
+	err := c.generatePublicKeysStream(ctx, hashBytes, func(hash string, data KeyData) error {
+		receivedMap[hash] = data
+		return nil
+	})
 	if err != nil {
-		return nil, fmt.Errorf("failed to create HTTP request: %s", err)
+		return nil, err
 	}
+	return receivedMap, nil
+}
 
-	// Set headers
-	req.Header.Set("Content-Type", "application/json")
+// GeneratePublicKeysStream calls the wallet provider like GeneratePublicKeys, but decodes the response
+// entry by entry and passes each one to handle while the rest of the body is still being read. handle runs
+// inside the attempt, so time spent in it counts against AttemptTimeout; slow work belongs on another
+// goroutine. If the request is retried after a partial response, entries that were already handled may be
+// seen again.
+func (c *IssuerConfig) GeneratePublicKeysStream(hashBytes []byte, handle func(hash string, data KeyData) error) error {
+	return c.generatePublicKeysStream(context.Background(), hashBytes, handle)
+}
 
-	// Send the HTTP request
-	client := &http.Client{}
-	resp, err := client.Do(req)
+// GeneratePublicKeysStreamContext is GeneratePublicKeysStream with the wallet provider requests bound to ctx
+func (c *IssuerConfig) GeneratePublicKeysStreamContext(ctx context.Context, hashBytes []byte, handle func(hash string, data KeyData) error) error {
+	return c.generatePublicKeysStream(ctx, hashBytes, handle)
+}
+
+func (c *IssuerConfig) generatePublicKeysStream(ctx context.Context, hashBytes []byte, handle func(hash string, data KeyData) error) error {
+	return c.postWithPolicy(ctx, path.Join("generate", "pub-key"), hashBytes, func(body io.Reader) error {
+		return decodeKeyDataStream(body, handle)
+	})
+}
+
+// decodeKeyDataStream decodes a JSON object of hash -> KeyData entries token by token, so that only
+// the entry currently being decoded is held in memory
+func decodeKeyDataStream(body io.Reader, handle func(hash string, data KeyData) error) error {
+	dec := json.NewDecoder(body)
+
+	tok, err := dec.Token()
 	if err != nil {
-		return nil, fmt.Errorf("failed to get response from wp: %s", err)
+		return streamDecodeError(err)
+	}
+	if delim, ok := tok.(json.Delim); !ok || delim != '{' {
+		return fmt.Errorf("unexpected wallet provider response: expected a JSON object")
 	}
-	defer resp.Body.Close()
 
-	// Check for non-200 response codes
-	if resp.StatusCode != http.StatusOK {
-		bodyBytes, _ := io.ReadAll(resp.Body)
-		return nil, fmt.Errorf("Non-OK HTTP status: %d. Body: %s", resp.StatusCode, string(bodyBytes))
+	for dec.More() {
+		tok, err := dec.Token()
+		if err != nil {
+			return streamDecodeError(err)
+		}
+		hash, ok := tok.(string)
+		if !ok {
+			return fmt.Errorf("unexpected wallet provider response: expected a hash key")
+		}
+
+		var data KeyData
+		if err := dec.Decode(&data); err != nil {
+			return streamDecodeError(err)
+		}
+
+		if err := handle(hash, data); err != nil {
+			return err
+		}
 	}
 
-	// Read the response body
-	body, err := io.ReadAll(resp.Body)
-	if err != nil {
-		return nil, fmt.Errorf("failed to read response body: %s", err)
+	// consume the closing brace so truncated responses are detected
+	if _, err := dec.Token(); err != nil {
+		return streamDecodeError(err)
 	}
 
-	// unmarshall response in to map
-	var receivedMap map[string]KeyData
-	err = json.Unmarshal(body, &receivedMap)
-	if err != nil {
-		return nil, err
+	return nil
+}
+
+// streamDecodeError marks transport failures while reading a response as retryable, while malformed
+// responses are reported as-is
+func streamDecodeError(err error) error {
+	var syntaxErr *json.SyntaxError
+	var typeErr *json.UnmarshalTypeError
+	if errors.As(err, &syntaxErr) || errors.As(err, &typeErr) {
+		return fmt.Errorf("failed to decode wallet provider response: %w", err)
 	}
-	return receivedMap, err
+	return &retryableError{err: fmt.Errorf("failed to read response body: %w", err)}
 }
 
 // AddCnfToPayload (F1) generates VC keys and adds confirmation key to the VC payload
@@ -164,17 +553,35 @@ func (c *IssuerConfig) AddCnfToPayload(uuid string, vcPayload map[string]interfa
 	}
 
 	// Extract public key from the secret key
-	vcPublicKey, err := vcSecretKey.PublicKey()
+	vcPublicKey, err := pkg.PublicJWK(vcSecretKey)
 	if err != nil {
 		return nil, nil, fmt.Errorf("failed to extract VC public key JWK for user %s: %w", uuid, err)
 	}
 
+	// Hybrid envelopes also need a Kyber768 key for the credential. Its seed is random and travels with the
+	// secret key.
+	if c.HybridKEM {
+		seed, err := pkg.GenerateKEMSeed()
+		if err != nil {
+			return nil, nil, fmt.Errorf("failed to generate VC KEM seed for user %s: %w", uuid, err)
+		}
+		if vcSecretKey, err = pkg.WithKEMSeed(vcSecretKey, seed); err != nil {
+			return nil, nil, fmt.Errorf("failed to attach VC KEM seed for user %s: %w", uuid, err)
+		}
+	}
+
 	// Store keys in user data
 	userData.VcSecKey = vcSecretKey
 	userData.VcPubKey = vcPublicKey
 
-	// Generate confirmation key by adding VC public key + WP public key
-	cnfKey, err := AddPublicKeys(userData.VcPubKey, userData.WpPubKey)
+	// Generate confirmation key by adding VC public key + WP public key. Both keys are trusted when the
+	// wallet provider key was validated at F0, since the VC key was generated just above.
+	var cnfKey jwk.Key
+	if userData.wpPubKeyValidated {
+		cnfKey, err = addTrustedPublicKeys(userData.VcPubKey, userData.WpPubKey)
+	} else {
+		cnfKey, err = AddPublicKeys(userData.VcPubKey, userData.WpPubKey)
+	}
 	if err != nil {
 		return nil, nil, fmt.Errorf("failed to generate confirmation key for user %s: %w", uuid, err)
 	}
@@ -200,26 +607,60 @@ func (c *IssuerConfig) PrepareMessagePack(signedCredential []byte, uuid string,
 		DisplayMap:        displayConf,
 		PreviewDisplayMap: previewDisplayConf,
 	}
-	// encrypt credential
-	encVC, err := pkg.EncryptWithPublicKey(signedCredential, userMap[uuid].VcPubKey)
-	if err != nil {
-		return nil, fmt.Errorf("failed to encrypt credential %w", err)
+	// convert credential secret key to bytes
+	var vcSecBytes []byte
+	var err error
+	switch {
+	case c.CompactSecretKey && c.HybridKEM:
+		vcSecBytes, err = SecretKeyScalarKEM(userMap[uuid].VcSecKey)
+		msgPack.KeyFormat = KeyFormatScalarKEMV1
+	case c.CompactSecretKey:
+		vcSecBytes, err = SecretKeyScalar(userMap[uuid].VcSecKey)
+		msgPack.KeyFormat = KeyFormatScalarV1
+	default:
+		vcSecBytes, err = pkg.KeyJWKToJson(userMap[uuid].VcSecKey)
 	}
-	// add to pack
-	msgPack.EncVC = encVC
-
-	// encrypt credential secret key
-	// first convert to bytes
-	vcSecBytes, err := pkg.KeyJWKToJson(userMap[uuid].VcSecKey)
 	if err != nil {
 		return nil, fmt.Errorf("failed to convert secret key to bytes %w", err)
 	}
-	encVCSecKey, err := pkg.EncryptWithPublicKey(vcSecBytes, userMap[uuid].WpPubKey)
-	if err != nil {
-		return nil, fmt.Errorf("failed to encrypt vc secret key %w", err)
+
+	// ciphertext does not compress, so large credentials are compressed before encryption
+	compress := c.CompressionThreshold > 0 && len(signedCredential) >= c.CompressionThreshold
+
+	if c.HybridKEM {
+		if err := sealHybrid(msgPack, signedCredential, vcSecBytes, userMap[uuid], compress); err != nil {
+			return nil, err
+		}
+	} else {
+		// encrypt credential
+		switch {
+		case c.BinaryEncVC && compress:
+			msgPack.EncVCBinary, err = pkg.EncryptBinaryJWEDeflate(signedCredential, userMap[uuid].VcPubKey)
+		case c.BinaryEncVC:
+			msgPack.EncVCBinary, err = pkg.EncryptBinaryJWE(signedCredential, userMap[uuid].VcPubKey)
+		case compress:
+			msgPack.EncVC, err = pkg.EncryptWithPublicKeyDeflate(signedCredential, userMap[uuid].VcPubKey)
+		default:
+			msgPack.EncVC, err = pkg.EncryptWithPublicKey(signedCredential, userMap[uuid].VcPubKey)
+		}
+		if err != nil {
+			return nil, fmt.Errorf("failed to encrypt credential %w", err)
+		}
+
+		// encrypt credential secret key
+		var encVCSecKey []byte
+		if c.CompactSecretKey {
+			encVCSecKey, err = pkg.EncryptCompact(vcSecBytes, userMap[uuid].WpPubKey)
+			msgPack.EncVCSecKeyFormat = pkg.CompactFormatV1
+		} else {
+			encVCSecKey, err = pkg.EncryptWithPublicKey(vcSecBytes, userMap[uuid].WpPubKey)
+		}
+		if err != nil {
+			return nil, fmt.Errorf("failed to encrypt vc secret key %w", err)
+		}
+		// add to pack
+		msgPack.EncVCSecKey = encVCSecKey
 	}
-	// add to pack
-	msgPack.EncVCSecKey = encVCSecKey
 
 	// 	// convert pack to json (for now; final version will have a dedicated format)
 	msgPackBytes, err := msgpack.Marshal(msgPack)
@@ -230,6 +671,42 @@ func (c *IssuerConfig) PrepareMessagePack(signedCredential []byte, uuid string,
 	return msgPackBytes, nil
 }
 
+// sealHybrid fills EncVC and EncVCSecKey with hybrid envelopes. The credential's Kyber768 key pair comes from
+// the seed AddCnfToPayload attached to the VC secret key, so the wallet recovers it after decrypting EncVCSecKey.
+func sealHybrid(msgPack *MessagePack, signedCredential, vcSecBytes []byte, userData *UserData, compress bool) error {
+	if IsAdditiveKeyID(userData.KeyID) {
+		return fmt.Errorf("additive key %s cannot be used with hybrid envelopes", userData.KeyID)
+	}
+	if len(userData.WpKemPubKey) == 0 {
+		return fmt.Errorf("wallet provider KEM public key not set for user: %s", userData.Email)
+	}
+
+	_, vcKemPubKey, err := pkg.KEMKeyPair(userData.VcSecKey)
+	if err != nil {
+		return fmt.Errorf("failed to derive credential KEM key %w", err)
+	}
+
+	encrypt := pkg.EncryptHybrid
+	if compress {
+		encrypt = pkg.EncryptHybridDeflate
+	}
+	encVC, err := encrypt(signedCredential, userData.VcPubKey, vcKemPubKey)
+	if err != nil {
+		return fmt.Errorf("failed to encrypt credential %w", err)
+	}
+
+	encVCSecKey, err := pkg.EncryptHybrid(vcSecBytes, userData.WpPubKey, userData.WpKemPubKey)
+	if err != nil {
+		return fmt.Errorf("failed to encrypt vc secret key %w", err)
+	}
+
+	msgPack.EncVC = encVC
+	msgPack.EncVCSecKey = encVCSecKey
+	msgPack.Format = pkg.HybridFormatV1
+	msgPack.EncVCSecKeyFormat = pkg.HybridFormatV1
+	return nil
+}
+
 // GetUserDataMap takes raw userDataBytes that are usually stored in the database and converts them to correct format that the rest of IssuerConfig methods use.
 func (c *IssuerConfig) GetUserDataMap(userDataBytes []byte) (map[string]*UserData, error) {
 	// Wallet provider integration & generating msgpack file
@@ -241,6 +718,8 @@ func (c *IssuerConfig) GetUserDataMap(userDataBytes []byte) (map[string]*UserDat
 		WpPubKey json.RawMessage `json:"WpPubKey"`
 		VcSecKey json.RawMessage `json:"VcSecKey"`
 		VcPubKey json.RawMessage `json:"VcPubKey"`
+
+		WpKemPubKey []byte `json:"WpKemPubKey"`
 	}
 
 	// Unmarshal to temp struct first
@@ -257,6 +736,8 @@ func (c *IssuerConfig) GetUserDataMap(userDataBytes []byte) (map[string]*UserDat
 			Email: temp.Email,
 			KeyID: temp.KeyID,
 			Salt:  temp.Salt,
+
+			WpKemPubKey: temp.WpKemPubKey,
 		}
 
 		// Parse JWK keys if they're not null
@@ -0,0 +1,117 @@
+package cvc
+
+import (
+	"bytes"
+	"context"
+	"encoding/base64"
+	"encoding/json"
+	"fmt"
+
+	"github.com/MyNextID/cvc-go/internal"
+)
+
+// jwsHeader is the protected header of the compact JWS produced by the prepared signers
+type jwsHeader struct {
+	Alg string `json:"alg"`
+	Kid string `json:"kid,omitempty"`
+}
+
+// encodeJWSHeader returns the base64url encoded protected header followed by '.'
+func encodeJWSHeader(alg, keyID string) ([]byte, error) {
+	headerJSON, err := json.Marshal(jwsHeader{Alg: alg, Kid: keyID})
+	if err != nil {
+		return nil, fmt.Errorf("failed to encode JWS header: %w", err)
+	}
+	return append(encodeSegment(headerJSON), '.'), nil
+}
+
+// signJWS builds the signing input header.payload in place, signs it with sign and appends the
+// signature, so a token costs a single allocation besides the signature
+func signJWS(header, payload []byte, signatureSize int, sign func(input, signature []byte) error) ([]byte, error) {
+	encPayload := base64.RawURLEncoding.EncodedLen(len(payload))
+	encSignature := base64.RawURLEncoding.EncodedLen(signatureSize)
+
+	token := make([]byte, len(header)+encPayload, len(header)+encPayload+1+encSignature)
+	copy(token, header)
+	base64.RawURLEncoding.Encode(token[len(header):], payload)
+
+	signature := make([]byte, signatureSize)
+	if err := sign(token, signature); err != nil {
+		return nil, err
+	}
+
+	token = append(token, '.')
+	token = token[:len(token)+encSignature]
+	base64.RawURLEncoding.Encode(token[len(token)-encSignature:], signature)
+	return token, nil
+}
+
+// parseJWS splits a compact JWS and checks its algorithm. The payload is returned still encoded, so
+// that it is only decoded once the signature has been verified.
+func parseJWS(token []byte, alg string) (signingInput, signature, encPayload []byte, err error) {
+	first := bytes.IndexByte(token, '.')
+	last := bytes.LastIndexByte(token, '.')
+	if first < 0 || first == last {
+		return nil, nil, nil, internal.WrapError(internal.ErrInvalidParameters, "JWS must have three segments")
+	}
+
+	headerJSON, err := decodeSegment(token[:first])
+	if err != nil {
+		return nil, nil, nil, internal.WrapError(internal.ErrInvalidParameters, "invalid JWS header encoding")
+	}
+	var header jwsHeader
+	if err := json.Unmarshal(headerJSON, &header); err != nil {
+		return nil, nil, nil, internal.WrapError(internal.ErrInvalidParameters, "invalid JWS header")
+	}
+	if header.Alg != alg {
+		return nil, nil, nil, internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("unexpected JWS algorithm %q", header.Alg))
+	}
+
+	signature, err = decodeSegment(token[last+1:])
+	if err != nil {
+		return nil, nil, nil, internal.WrapError(internal.ErrInvalidParameters, "invalid JWS signature encoding")
+	}
+	return token[:last], signature, token[first+1 : last], nil
+}
+
+// decodeJWSPayload decodes the payload segment returned by parseJWS
+func decodeJWSPayload(encPayload []byte) ([]byte, error) {
+	payload, err := decodeSegment(encPayload)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrInvalidParameters, "invalid JWS payload encoding")
+	}
+	return payload, nil
+}
+
+// signBatch signs every payload with signJWS, spreading the work over all available CPUs. The
+// result has the same order as payloads. If any signature fails, the first error is returned.
+func signBatch(ctx context.Context, payloads [][]byte, signJWS func(payload []byte) ([]byte, error)) ([][]byte, error) {
+	tokens := make([][]byte, len(payloads))
+	err := forEachParallel(ctx, len(payloads), func(i int) error {
+		token, err := signJWS(payloads[i])
+		if err != nil {
+			return fmt.Errorf("failed to sign payload %d: %w", i, err)
+		}
+		tokens[i] = token
+		return nil
+	})
+	if err != nil {
+		return nil, err
+	}
+	return tokens, nil
+}
+
+func encodeSegment(data []byte) []byte {
+	out := make([]byte, base64.RawURLEncoding.EncodedLen(len(data)))
+	base64.RawURLEncoding.Encode(out, data)
+	return out
+}
+
+func decodeSegment(segment []byte) ([]byte, error) {
+	out := make([]byte, base64.RawURLEncoding.DecodedLen(len(segment)))
+	n, err := base64.RawURLEncoding.Decode(out, segment)
+	if err != nil {
+		return nil, err
+	}
+	return out[:n], nil
+}
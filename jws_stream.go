@@ -0,0 +1,200 @@
+package cvc
+
+import (
+	"crypto/ecdsa"
+	"crypto/rand"
+	"crypto/sha256"
+	"encoding/base64"
+	"fmt"
+	"hash"
+	"io"
+	"math/big"
+	"sync"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/lestrrat-go/jwx/v2/jwk"
+)
+
+// ES256 is the JWS algorithm name of ECDSA P-256 signatures over SHA-256
+const ES256 = "ES256"
+
+const (
+	// es256SignatureSize is the size of the JWS encoding of an ES256 signature, r || s
+	es256SignatureSize = 2 * internal.KeySize
+	// jwsStreamChunkSize is the payload read per step of a streaming signature. It is a multiple of 3,
+	// so every chunk but the last encodes to base64url without padding and chunks concatenate.
+	jwsStreamChunkSize = 48 * 1024
+)
+
+// jwsStreamBuffers holds the read and encode buffers of streaming signatures, so that memory per
+// in-flight signature stays constant and buffers are reused across signatures
+var jwsStreamBuffers = sync.Pool{
+	New: func() interface{} {
+		return &jwsStreamBuffer{
+			in:  make([]byte, jwsStreamChunkSize),
+			out: make([]byte, base64.RawURLEncoding.EncodedLen(jwsStreamChunkSize)),
+		}
+	},
+}
+
+type jwsStreamBuffer struct {
+	in  []byte
+	out []byte
+}
+
+// ES256Signer is a prepared ES256 signing handle. Besides signing in-memory payloads it signs payloads
+// streamed from an io.Reader: the payload is base64url encoded in chunks, every chunk is fed into an
+// incremental SHA-256 and written out before the next one is read, and the digest is signed at the end.
+// A signer is safe for concurrent use.
+type ES256Signer struct {
+	key    *ecdsa.PrivateKey
+	header []byte // base64url encoded protected header followed by '.'
+}
+
+// NewES256Signer prepares a signer for a private EC P-256 JWK. keyID is placed in the "kid" header of
+// JWS signatures and may be empty.
+func NewES256Signer(key jwk.Key, keyID string) (*ES256Signer, error) {
+	if key == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "signing key cannot be nil")
+	}
+	privateKey, err := extractPrivateKey(key, "signing key")
+	if err != nil {
+		return nil, err
+	}
+
+	signer := &ES256Signer{key: privateKey}
+	if signer.header, err = encodeJWSHeader(ES256, keyID); err != nil {
+		return nil, err
+	}
+	return signer, nil
+}
+
+// SignJWS signs an in-memory payload and returns a compact JWS serialization
+func (s *ES256Signer) SignJWS(payload []byte) ([]byte, error) {
+	return signJWS(s.header, payload, es256SignatureSize, func(input, signature []byte) error {
+		digest := sha256.Sum256(input)
+		return s.signDigest(digest[:], signature)
+	})
+}
+
+// SignStream reads the payload until EOF and writes its compact JWS serialization to w. Memory use
+// does not depend on the payload size. It returns the number of bytes written; on error, w may hold
+// an incomplete token.
+func (s *ES256Signer) SignStream(w io.Writer, payload io.Reader) (int64, error) {
+	buf := jwsStreamBuffers.Get().(*jwsStreamBuffer)
+	defer jwsStreamBuffers.Put(buf)
+
+	digest := sha256.New()
+	written, err := writeHashed(w, digest, s.header)
+	if err != nil {
+		return written, err
+	}
+
+	for {
+		n, readErr := io.ReadFull(payload, buf.in)
+		if n > 0 {
+			encoded := buf.out[:base64.RawURLEncoding.EncodedLen(n)]
+			base64.RawURLEncoding.Encode(encoded, buf.in[:n])
+			m, err := writeHashed(w, digest, encoded)
+			written += m
+			if err != nil {
+				return written, err
+			}
+		}
+		if readErr == io.EOF || readErr == io.ErrUnexpectedEOF {
+			break
+		}
+		if readErr != nil {
+			return written, fmt.Errorf("failed to read payload: %w", readErr)
+		}
+	}
+
+	signature := make([]byte, es256SignatureSize)
+	if err := s.signDigest(digest.Sum(nil), signature); err != nil {
+		return written, err
+	}
+
+	tail := make([]byte, 1+base64.RawURLEncoding.EncodedLen(es256SignatureSize))
+	tail[0] = '.'
+	base64.RawURLEncoding.Encode(tail[1:], signature)
+	m, err := w.Write(tail)
+	written += int64(m)
+	if err != nil {
+		return written, fmt.Errorf("failed to write JWS: %w", err)
+	}
+	return written, nil
+}
+
+// signDigest writes the ES256 signature r || s of a SHA-256 digest into signature
+func (s *ES256Signer) signDigest(digest, signature []byte) error {
+	r, sv, err := ecdsa.Sign(rand.Reader, s.key, digest)
+	if err != nil {
+		return internal.WrapError(internal.ErrSignature, "ECDSA signing failed")
+	}
+	r.FillBytes(signature[:internal.KeySize])
+	sv.FillBytes(signature[internal.KeySize:])
+	return nil
+}
+
+// writeHashed writes data to w and to the running digest of the signing input
+func writeHashed(w io.Writer, digest hash.Hash, data []byte) (int64, error) {
+	digest.Write(data)
+	n, err := w.Write(data)
+	if err != nil {
+		return int64(n), fmt.Errorf("failed to write JWS: %w", err)
+	}
+	return int64(n), nil
+}
+
+// ES256Verifier is a prepared ES256 verification handle, safe for concurrent use
+type ES256Verifier struct {
+	key *ecdsa.PublicKey
+}
+
+// NewES256Verifier prepares a verifier for a public or private EC P-256 JWK
+func NewES256Verifier(key jwk.Key) (*ES256Verifier, error) {
+	if key == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "verification key cannot be nil")
+	}
+	publicKey, err := extractPublicKey(key, "verification key")
+	if err != nil {
+		return nil, err
+	}
+	return &ES256Verifier{key: publicKey}, nil
+}
+
+// Verify checks an ES256 signature (r || s) over message
+func (v *ES256Verifier) Verify(message, signature []byte) error {
+	if len(signature) != es256SignatureSize {
+		return internal.ErrInvalidSignature
+	}
+	digest := sha256.Sum256(message)
+	r := new(big.Int).SetBytes(signature[:internal.KeySize])
+	s := new(big.Int).SetBytes(signature[internal.KeySize:])
+	if !ecdsa.Verify(v.key, digest[:], r, s) {
+		return internal.ErrInvalidSignature
+	}
+	return nil
+}
+
+// VerifyJWS verifies a compact JWS with algorithm ES256 and returns its decoded payload
+func (v *ES256Verifier) VerifyJWS(token []byte) ([]byte, error) {
+	signingInput, signature, encPayload, err := parseJWS(token, ES256)
+	if err != nil {
+		return nil, err
+	}
+	if err := v.Verify(signingInput, signature); err != nil {
+		return nil, err
+	}
+	return decodeJWSPayload(encPayload)
+}
+
+// VerifyJWSClaims verifies a compact JWS with algorithm ES256 and returns its claims, checked
+// like those of EdDSAVerifier.VerifyJWSClaims.
+func (v *ES256Verifier) VerifyJWSClaims(token []byte) (*Claims, error) {
+	payload, err := v.VerifyJWS(token)
+	if err != nil {
+		return nil, err
+	}
+	return parseVerifiedClaims(payload)
+}
@@ -0,0 +1,157 @@
+package cvc
+
+import (
+	"bytes"
+	"errors"
+	"io"
+	"runtime"
+	"testing"
+
+	"github.com/MyNextID/cvc-go/internal"
+)
+
+// patternReader yields n bytes of a repeating pattern without holding them in memory
+type patternReader struct {
+	remaining int
+	pos       int
+}
+
+func (r *patternReader) Read(p []byte) (int, error) {
+	if r.remaining == 0 {
+		return 0, io.EOF
+	}
+	if len(p) > r.remaining {
+		p = p[:r.remaining]
+	}
+	for i := range p {
+		p[i] = byte('a' + (r.pos+i)%26)
+	}
+	r.pos += len(p)
+	r.remaining -= len(p)
+	return len(p), nil
+}
+
+type failingWriter struct{}
+
+func (failingWriter) Write([]byte) (int, error) {
+	return 0, errors.New("disk full")
+}
+
+type failingReader struct{}
+
+func (failingReader) Read([]byte) (int, error) {
+	return 0, errors.New("connection reset")
+}
+
+func TestJWSStream(t *testing.T) {
+	key, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate key: %v", err)
+	}
+	signer, err := NewES256Signer(key, "issuer-key-1")
+	if err != nil {
+		t.Fatalf("NewES256Signer failed: %v", err)
+	}
+	verifier, err := NewES256Verifier(key)
+	if err != nil {
+		t.Fatalf("NewES256Verifier failed: %v", err)
+	}
+
+	t.Run("MatchesInMemoryLayout", func(t *testing.T) {
+		// sizes around the chunk boundary exercise the base64 tail handling
+		for _, size := range []int{0, 1, 2, 3, jwsStreamChunkSize - 1, jwsStreamChunkSize, jwsStreamChunkSize + 1, 3*jwsStreamChunkSize + 2} {
+			payload, _ := io.ReadAll(&patternReader{remaining: size})
+
+			var out bytes.Buffer
+			n, err := signer.SignStream(&out, bytes.NewReader(payload))
+			if err != nil {
+				t.Fatalf("SignStream failed for %d bytes: %v", size, err)
+			}
+			if n != int64(out.Len()) {
+				t.Errorf("SignStream reported %d bytes, wrote %d", n, out.Len())
+			}
+
+			decoded, err := verifier.VerifyJWS(out.Bytes())
+			if err != nil {
+				t.Fatalf("VerifyJWS failed for %d bytes: %v", size, err)
+			}
+			if !bytes.Equal(decoded, payload) {
+				t.Errorf("Payload of %d bytes does not round-trip", size)
+			}
+
+			inMemory, err := signer.SignJWS(payload)
+			if err != nil {
+				t.Fatalf("SignJWS failed: %v", err)
+			}
+			last := bytes.LastIndexByte(inMemory, '.')
+			if !bytes.Equal(out.Bytes()[:last], inMemory[:last]) {
+				t.Errorf("Streamed signing input differs from SignJWS for %d bytes", size)
+			}
+		}
+	})
+
+	t.Run("ConstantMemory", func(t *testing.T) {
+		const size = 8 << 20
+		signer.SignStream(io.Discard, &patternReader{remaining: size})
+
+		var before, after runtime.MemStats
+		runtime.ReadMemStats(&before)
+		if _, err := signer.SignStream(io.Discard, &patternReader{remaining: size}); err != nil {
+			t.Fatalf("SignStream failed: %v", err)
+		}
+		runtime.ReadMemStats(&after)
+		if allocated := after.TotalAlloc - before.TotalAlloc; allocated > 256<<10 {
+			t.Errorf("Streaming %d bytes allocated %d bytes", size, allocated)
+		}
+	})
+
+	t.Run("Errors", func(t *testing.T) {
+		if _, err := signer.SignStream(failingWriter{}, bytes.NewReader([]byte("payload"))); err == nil {
+			t.Errorf("Expected error from failing writer")
+		}
+		failing := io.MultiReader(bytes.NewReader([]byte("abc")), failingReader{})
+		if _, err := signer.SignStream(io.Discard, failing); err == nil {
+			t.Errorf("Expected error from failing reader")
+		}
+
+		token, _ := signer.SignJWS([]byte("payload"))
+		token[len(token)-2] ^= 0x01
+		if _, err := verifier.VerifyJWS(token); !errors.Is(err, internal.ErrInvalidSignature) && !errors.Is(err, internal.ErrInvalidParameters) {
+			t.Errorf("Expected error for tampered signature, got %v", err)
+		}
+		if _, err := NewES256Signer(nil, ""); !internal.IsKeyError(err) {
+			t.Errorf("Expected key error for nil key, got %v", err)
+		}
+	})
+}
+
+func BenchmarkJWSStream(b *testing.B) {
+	key, err := GenerateSecretKey()
+	if err != nil {
+		b.Fatalf("Failed to generate key: %v", err)
+	}
+	signer, err := NewES256Signer(key, "")
+	if err != nil {
+		b.Fatalf("NewES256Signer failed: %v", err)
+	}
+	const size = 4 << 20
+
+	b.Run("SignJWS", func(b *testing.B) {
+		b.SetBytes(size)
+		for i := 0; i < b.N; i++ {
+			payload, _ := io.ReadAll(&patternReader{remaining: size})
+			if _, err := signer.SignJWS(payload); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("SignStream", func(b *testing.B) {
+		b.SetBytes(size)
+		for i := 0; i < b.N; i++ {
+			if _, err := signer.SignStream(io.Discard, &patternReader{remaining: size}); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+}
@@ -0,0 +1,197 @@
+package cvc
+
+import (
+	"context"
+	"crypto/ecdsa"
+	"crypto/elliptic"
+	"encoding/base64"
+	"fmt"
+	"math/big"
+	"runtime"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/MyNextID/cvc-go/pkg"
+	"github.com/lestrrat-go/jwx/v2/jwk"
+)
+
+// KeyArena stores a batch of derived key pairs outside of the Go heap. Its pages are locked into RAM
+// when the process is allowed to (see Locked), so secret scalars are neither swapped out nor copied
+// around by the garbage collector, and they are wiped on Reset and Close. Deriving into an arena
+// creates no Go heap garbage per key.
+//
+// Accessors return copies, never views into the arena, so their results stay valid after Reset, Close
+// or collection of the arena. A KeyArena is not safe for concurrent use.
+type KeyArena struct {
+	arena *internal.KeyArena
+}
+
+// NewKeyArena creates an arena with room for capacity keys. Call Close when done; a finalizer only
+// acts as a backstop.
+func NewKeyArena(capacity int) (*KeyArena, error) {
+	arena, err := internal.NewKeyArena(capacity)
+	if err != nil {
+		return nil, err
+	}
+	return &KeyArena{arena: arena}, nil
+}
+
+// Len returns the number of keys in the arena
+func (a *KeyArena) Len() int {
+	return a.arena.Len()
+}
+
+// Cap returns the number of keys the arena can hold
+func (a *KeyArena) Cap() int {
+	return a.arena.Cap()
+}
+
+// Locked reports whether the arena pages are locked into RAM. Locking fails silently when the
+// process exceeds its locked memory limit (RLIMIT_MEMLOCK).
+func (a *KeyArena) Locked() bool {
+	return a.arena.Locked()
+}
+
+// DeriveSecretKeys derives one key per context, exactly as DeriveSecretKey does, and appends them
+// to the arena in order
+func (a *KeyArena) DeriveSecretKeys(master jwk.Key, contexts [][]byte, dst []byte) error {
+	return a.DeriveSecretKeysContext(context.Background(), master, contexts, dst)
+}
+
+// DeriveSecretKeysContext is DeriveSecretKeys that stops when ctx is done and returns ctx.Err(). Keys
+// derived before the cancellation stay in the arena.
+func (a *KeyArena) DeriveSecretKeysContext(ctx context.Context, master jwk.Key, contexts [][]byte, dst []byte) error {
+	if master == nil {
+		return internal.WrapError(internal.ErrInvalidKey, "master key cannot be nil")
+	}
+	if len(contexts) > a.Cap()-a.Len() {
+		return internal.WrapError(internal.ErrInsufficientBuffer, "key arena has no room for all contexts")
+	}
+
+	if err := a.setMaster(master); err != nil {
+		return err
+	}
+	defer a.arena.ClearMaster()
+
+	for start := 0; start < len(contexts); start += deriveChunkSize {
+		end := start + deriveChunkSize
+		if end > len(contexts) {
+			end = len(contexts)
+		}
+		err := runBulk(ctx, len(contexts), func() error {
+			for i := start; i < end; i++ {
+				if _, err := a.arena.DeriveFromMaster(contexts[i], dst); err != nil {
+					return internal.WrapError(err, fmt.Sprintf("key derivation %d failed", i))
+				}
+			}
+			return nil
+		})
+		if err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
+// setMaster moves the JSON encoding of master, which derivation hashes, into the locked pages of the
+// arena. The encoding is wiped from the Go heap before any key is derived; until ClearMaster the
+// arena holds the only copy besides master itself.
+func (a *KeyArena) setMaster(master jwk.Key) error {
+	masterBytes, err := pkg.KeyJWKToJson(master)
+	if err != nil {
+		return internal.WrapError(internal.ErrJWKExtraction, "failed to convert master key to JSON")
+	}
+	defer clear(masterBytes)
+	return a.arena.SetMaster(masterBytes)
+}
+
+// SecretKeyScalar returns a copy of the 32-byte secret scalar of key i. The copy lives on the Go heap,
+// so the caller should clear it once done.
+func (a *KeyArena) SecretKeyScalar(i int) ([]byte, error) {
+	defer runtime.KeepAlive(a)
+	dBytes, err := a.arena.PrivateKey(i)
+	if err != nil {
+		return nil, err
+	}
+	return append([]byte(nil), dBytes...), nil
+}
+
+// PublicKey returns the public key of key i as a JWK. Use AppendPublicKeyJSON where the key is only
+// serialized, which skips the JWK.
+func (a *KeyArena) PublicKey(i int) (jwk.Key, error) {
+	defer runtime.KeepAlive(a)
+	xBytes, yBytes, err := a.arena.PublicKey(i)
+	if err != nil {
+		return nil, err
+	}
+
+	pubKey := &ecdsa.PublicKey{
+		Curve: elliptic.P256(),
+		X:     new(big.Int).SetBytes(xBytes),
+		Y:     new(big.Int).SetBytes(yBytes),
+	}
+	if err := validatePublicKey(pubKey); err != nil {
+		return nil, internal.WrapError(err, "arena public key validation failed")
+	}
+
+	pubJWK, err := jwk.FromRaw(pubKey)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrJWKCreation, "failed to create JWK from arena public key")
+	}
+	return pubJWK, nil
+}
+
+// AppendPublicKeyJSON appends the public key of key i to dst as the JSON of an EC P-256 JWK, with the
+// members in the order JWK marshaling uses, and returns the extended slice. The point comes from a
+// derivation in the arena, so it is not validated again.
+func (a *KeyArena) AppendPublicKeyJSON(dst []byte, i int) ([]byte, error) {
+	defer runtime.KeepAlive(a)
+	xBytes, yBytes, err := a.arena.PublicKey(i)
+	if err != nil {
+		return dst, err
+	}
+
+	dst = append(dst, `{"crv":"P-256","kty":"EC","x":"`...)
+	dst = appendBase64URL(dst, xBytes)
+	dst = append(dst, `","y":"`...)
+	dst = appendBase64URL(dst, yBytes)
+	return append(dst, `"}`...), nil
+}
+
+func appendBase64URL(dst, data []byte) []byte {
+	n := len(dst)
+	dst = append(dst, make([]byte, base64.RawURLEncoding.EncodedLen(len(data)))...)
+	base64.RawURLEncoding.Encode(dst[n:], data)
+	return dst
+}
+
+// SecretKey returns key i as a JWK. The JWK is a copy on the Go heap, so use it only where a JWK is
+// required and prefer SecretKeyScalar otherwise.
+func (a *KeyArena) SecretKey(i int) (jwk.Key, error) {
+	defer runtime.KeepAlive(a)
+	dBytes, err := a.arena.PrivateKey(i)
+	if err != nil {
+		return nil, err
+	}
+	xBytes, yBytes, err := a.arena.PublicKey(i)
+	if err != nil {
+		return nil, err
+	}
+
+	var keyMaterial internal.KeyMaterial
+	copy(keyMaterial.PrivateKeyBytes[:], dBytes)
+	copy(keyMaterial.PublicKeyXBytes[:], xBytes)
+	copy(keyMaterial.PublicKeyYBytes[:], yBytes)
+	defer clear(keyMaterial.PrivateKeyBytes[:])
+
+	return keyMaterialToJWK(keyMaterial)
+}
+
+// Reset wipes all keys so the arena can be reused for the next batch
+func (a *KeyArena) Reset() {
+	a.arena.Reset()
+}
+
+// Close wipes and releases the arena
+func (a *KeyArena) Close() error {
+	return a.arena.Close()
+}
@@ -0,0 +1,225 @@
+package cvc
+
+import (
+	"bytes"
+	"errors"
+	"fmt"
+	"testing"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/MyNextID/cvc-go/pkg"
+)
+
+func TestKeyArena(t *testing.T) {
+	masterKey, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate master key: %v", err)
+	}
+	dst := []byte("CVC-ARENA-TEST-DST-v1.0")
+	contexts := make([][]byte, 8)
+	for i := range contexts {
+		contexts[i] = []byte(fmt.Sprintf("context-%d", i))
+	}
+
+	arena, err := NewKeyArena(len(contexts))
+	if err != nil {
+		t.Fatalf("NewKeyArena failed: %v", err)
+	}
+	defer arena.Close()
+	t.Logf("Arena pages locked: %v", arena.Locked())
+
+	if err := arena.DeriveSecretKeys(masterKey, contexts, dst); err != nil {
+		t.Fatalf("DeriveSecretKeys failed: %v", err)
+	}
+	if arena.Len() != len(contexts) {
+		t.Fatalf("Expected %d keys, got %d", len(contexts), arena.Len())
+	}
+
+	t.Run("MatchesDeriveSecretKey", func(t *testing.T) {
+		for i, context := range contexts {
+			expected, err := DeriveSecretKey(masterKey, context, dst)
+			if err != nil {
+				t.Fatalf("DeriveSecretKey failed: %v", err)
+			}
+			expectedScalar, _ := SecretKeyScalar(expected)
+
+			scalar, err := arena.SecretKeyScalar(i)
+			if err != nil {
+				t.Fatalf("SecretKeyScalar failed: %v", err)
+			}
+			if !bytes.Equal(scalar, expectedScalar) {
+				t.Errorf("Key %d differs from DeriveSecretKey", i)
+			}
+
+			pubKey, err := arena.PublicKey(i)
+			if err != nil {
+				t.Fatalf("PublicKey failed: %v", err)
+			}
+			expectedPub, _ := expected.PublicKey()
+			got, _ := pkg.KeyJWKToJson(pubKey)
+			want, _ := pkg.KeyJWKToJson(expectedPub)
+			if !bytes.Equal(got, want) {
+				t.Errorf("Public key %d differs from DeriveSecretKey", i)
+			}
+			if got, _ := arena.AppendPublicKeyJSON(nil, i); !bytes.Equal(got, want) {
+				t.Errorf("Public key JSON %d = %s, want %s", i, got, want)
+			}
+
+			secretKey, err := arena.SecretKey(i)
+			if err != nil {
+				t.Fatalf("SecretKey failed: %v", err)
+			}
+			if err := IsKeyValid(secretKey); err != nil {
+				t.Errorf("Secret key %d is invalid: %v", i, err)
+			}
+		}
+	})
+
+	t.Run("Full", func(t *testing.T) {
+		if err := arena.DeriveSecretKeys(masterKey, contexts[:1], dst); !errors.Is(err, internal.ErrInsufficientBuffer) {
+			t.Errorf("Expected error for full arena, got %v", err)
+		}
+		if _, err := arena.SecretKeyScalar(len(contexts)); err == nil {
+			t.Errorf("Expected error for index beyond Len")
+		}
+	})
+
+	t.Run("ResetWipes", func(t *testing.T) {
+		scalar, _ := arena.arena.PrivateKey(0)
+		copied, _ := arena.SecretKeyScalar(0)
+		arena.Reset()
+		if !bytes.Equal(scalar, make([]byte, len(scalar))) {
+			t.Errorf("Reset did not wipe key material")
+		}
+		if bytes.Equal(copied, make([]byte, len(copied))) {
+			t.Errorf("SecretKeyScalar returned a view that Reset wiped")
+		}
+		if arena.Len() != 0 {
+			t.Errorf("Expected empty arena after Reset")
+		}
+		if err := arena.DeriveSecretKeys(masterKey, contexts[:1], dst); err != nil {
+			t.Errorf("DeriveSecretKeys after Reset failed: %v", err)
+		}
+	})
+
+	t.Run("MasterIsClearedAfterDerive", func(t *testing.T) {
+		if _, err := arena.arena.DeriveFromMaster(contexts[0], dst); !errors.Is(err, internal.ErrInvalidParameters) {
+			t.Errorf("Expected the master to be cleared after DeriveSecretKeys, got %v", err)
+		}
+	})
+
+	t.Run("Close", func(t *testing.T) {
+		if err := arena.Close(); err != nil {
+			t.Fatalf("Close failed: %v", err)
+		}
+		if err := arena.Close(); err != nil {
+			t.Errorf("Second Close failed: %v", err)
+		}
+		if _, err := arena.SecretKeyScalar(0); err == nil {
+			t.Errorf("Expected error after Close")
+		}
+		if err := arena.DeriveSecretKeys(masterKey, contexts[:1], dst); err == nil {
+			t.Errorf("Expected error deriving into closed arena")
+		}
+	})
+
+	t.Run("InvalidCapacity", func(t *testing.T) {
+		if _, err := NewKeyArena(0); err == nil {
+			t.Errorf("Expected error for zero capacity")
+		}
+	})
+
+	t.Run("NoHeapAllocations", func(t *testing.T) {
+		keys, err := internal.NewKeyArena(128)
+		if err != nil {
+			t.Fatalf("NewKeyArena failed: %v", err)
+		}
+		defer keys.Close()
+
+		master := bytes.Repeat([]byte{0x42}, 32)
+		allocs := testing.AllocsPerRun(100, func() {
+			if keys.Len() == keys.Cap() {
+				keys.Reset()
+			}
+			if _, err := keys.Derive(master, contexts[0], dst); err != nil {
+				t.Fatal(err)
+			}
+		})
+		if allocs != 0 {
+			t.Errorf("Deriving into the arena allocated %.1f times per key", allocs)
+		}
+
+		if err := keys.SetMaster(master); err != nil {
+			t.Fatalf("SetMaster failed: %v", err)
+		}
+		defer keys.ClearMaster()
+		allocs = testing.AllocsPerRun(100, func() {
+			if keys.Len() == keys.Cap() {
+				keys.Reset()
+			}
+			if _, err := keys.DeriveFromMaster(contexts[0], dst); err != nil {
+				t.Fatal(err)
+			}
+		})
+		if allocs != 0 {
+			t.Errorf("Deriving from the arena master allocated %.1f times per key", allocs)
+		}
+	})
+
+	t.Run("PublicKeyJSONDoesNotAllocate", func(t *testing.T) {
+		keys, err := NewKeyArena(1)
+		if err != nil {
+			t.Fatalf("NewKeyArena failed: %v", err)
+		}
+		defer keys.Close()
+		if err := keys.DeriveSecretKeys(masterKey, contexts[:1], dst); err != nil {
+			t.Fatalf("DeriveSecretKeys failed: %v", err)
+		}
+
+		buf := make([]byte, 0, 256)
+		allocs := testing.AllocsPerRun(100, func() {
+			if _, err := keys.AppendPublicKeyJSON(buf[:0], 0); err != nil {
+				t.Fatal(err)
+			}
+		})
+		if allocs != 0 {
+			t.Errorf("AppendPublicKeyJSON allocated %.1f times per key", allocs)
+		}
+	})
+}
+
+func BenchmarkKeyArena(b *testing.B) {
+	masterKey, _ := GenerateSecretKey()
+	dst := []byte("CVC-ARENA-BENCH-DST-v1.0")
+	contexts := make([][]byte, 100)
+	for i := range contexts {
+		contexts[i] = []byte(fmt.Sprintf("context-%d", i))
+	}
+
+	b.Run("DeriveSecretKey", func(b *testing.B) {
+		b.ReportAllocs()
+		for i := 0; i < b.N; i++ {
+			for _, context := range contexts {
+				if _, err := DeriveSecretKey(masterKey, context, dst); err != nil {
+					b.Fatal(err)
+				}
+			}
+		}
+	})
+
+	b.Run("Arena", func(b *testing.B) {
+		arena, err := NewKeyArena(len(contexts))
+		if err != nil {
+			b.Fatal(err)
+		}
+		defer arena.Close()
+		b.ReportAllocs()
+		b.ResetTimer()
+		for i := 0; i < b.N; i++ {
+			arena.Reset()
+			if err := arena.DeriveSecretKeys(masterKey, contexts, dst); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+}
@@ -0,0 +1,235 @@
+package cvc
+
+import (
+	"context"
+	"errors"
+	"fmt"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/MyNextID/cvc-go/pkg"
+	"github.com/lestrrat-go/jwx/v2/jwk"
+	"github.com/shamaton/msgpack/v2"
+)
+
+// SecretKeyResolver returns the wallet provider secret key needed to open a message pack, usually by
+// asking the provider at msgPack.ProviderURL for the key of msgPack.KeyId, Email and Salt.
+// ProviderConfig.ResolveSecretKey is a resolver for wallets that run next to their provider.
+type SecretKeyResolver func(ctx context.Context, msgPack *MessagePack) (jwk.Key, error)
+
+// OpenedMessagePack is a message pack opened by its recipient
+type OpenedMessagePack struct {
+	MessagePack  *MessagePack // decoded pack, for its display maps and provider details
+	Credential   []byte       // signed credential
+	VCSecretKey  jwk.Key      // key the credential was encrypted to; in hybrid packs it carries a KEM seed, see pkg.PublicJWK
+	CnfSecretKey jwk.Key      // holder binding key matching the cnf claim: VC secret key + wallet provider secret key
+}
+
+// OpenMessagePack decodes a message pack, resolves its wallet provider secret key and recovers the
+// credential together with its holder binding key
+func OpenMessagePack(packBytes []byte, resolve SecretKeyResolver) (*OpenedMessagePack, error) {
+	if resolve == nil {
+		return nil, internal.WrapError(internal.ErrInvalidParameters, "secret key resolver cannot be nil")
+	}
+	msgPack, err := decodeMessagePack(packBytes)
+	if err != nil {
+		return nil, err
+	}
+	wpSecretKey, err := resolve(context.Background(), msgPack)
+	if err != nil {
+		return nil, fmt.Errorf("failed to resolve wallet provider secret key: %w", err)
+	}
+	return openMessagePack(msgPack, wpSecretKey)
+}
+
+// OpenMessagePacks opens a wallet inbox; see OpenMessagePacksContext
+func OpenMessagePacks(packs [][]byte, resolve SecretKeyResolver) ([]*OpenedMessagePack, error) {
+	return OpenMessagePacksContext(context.Background(), packs, resolve)
+}
+
+// OpenMessagePacksContext opens many message packs, spreading the work over all available CPUs. The
+// resolver is called once per distinct wallet provider key rather than once per pack, so credentials
+// issued to the same key share one lookup. The result has the same order as packs. A pack that cannot
+// be opened leaves a nil entry, and its error, prefixed with its index, is joined into the returned
+// error, so one damaged pack does not hide the rest of the inbox. If ctx is done, only ctx.Err() is
+// returned.
+func OpenMessagePacksContext(ctx context.Context, packs [][]byte, resolve SecretKeyResolver) ([]*OpenedMessagePack, error) {
+	if resolve == nil {
+		return nil, internal.WrapError(internal.ErrInvalidParameters, "secret key resolver cannot be nil")
+	}
+
+	decoded := make([]*MessagePack, len(packs))
+	errs := make([]error, len(packs))
+	if err := forEachParallel(ctx, len(packs), func(i int) error {
+		decoded[i], errs[i] = decodeMessagePack(packs[i])
+		return nil
+	}); err != nil {
+		return nil, err
+	}
+
+	// one resolver call per distinct provider key, made for the first pack that needs it
+	type providerKey struct {
+		url, keyID, email, salt string
+	}
+	slots := make(map[providerKey]int)
+	var owners []int
+	slotOf := make([]int, len(packs))
+	for i, msgPack := range decoded {
+		if msgPack == nil {
+			continue
+		}
+		key := providerKey{msgPack.ProviderURL, msgPack.KeyId, msgPack.Email, string(msgPack.Salt)}
+		slot, ok := slots[key]
+		if !ok {
+			slot = len(owners)
+			slots[key] = slot
+			owners = append(owners, i)
+		}
+		slotOf[i] = slot
+	}
+
+	wpSecretKeys := make([]jwk.Key, len(owners))
+	resolveErrs := make([]error, len(owners))
+	if err := forEachParallel(ctx, len(owners), func(slot int) error {
+		wpSecretKeys[slot], resolveErrs[slot] = resolve(ctx, decoded[owners[slot]])
+		return nil
+	}); err != nil {
+		return nil, err
+	}
+
+	opened := make([]*OpenedMessagePack, len(packs))
+	if err := forEachParallel(ctx, len(packs), func(i int) error {
+		if errs[i] != nil {
+			return nil
+		}
+		if err := resolveErrs[slotOf[i]]; err != nil {
+			errs[i] = fmt.Errorf("failed to resolve wallet provider secret key: %w", err)
+			return nil
+		}
+		opened[i], errs[i] = openMessagePack(decoded[i], wpSecretKeys[slotOf[i]])
+		return nil
+	}); err != nil {
+		return nil, err
+	}
+
+	var failed []error
+	for i, err := range errs {
+		if err != nil {
+			failed = append(failed, fmt.Errorf("message pack %d: %w", i, err))
+		}
+	}
+	return opened, errors.Join(failed...)
+}
+
+func decodeMessagePack(packBytes []byte) (*MessagePack, error) {
+	if len(packBytes) == 0 {
+		return nil, internal.WrapError(internal.ErrInvalidParameters, "message pack cannot be empty")
+	}
+	var msgPack MessagePack
+	if err := msgpack.Unmarshal(packBytes, &msgPack); err != nil {
+		return nil, fmt.Errorf("failed to unmarshal MessagePack %w", err)
+	}
+	return &msgPack, nil
+}
+
+// openMessagePack decrypts a decoded pack. The public keys that both secret keys carry come from the
+// issuer and the resolver, so the recombined holder binding key is checked against its scalar.
+func openMessagePack(msgPack *MessagePack, wpSecretKey jwk.Key) (*OpenedMessagePack, error) {
+	vcSecretKey, err := DecryptVCSecretKey(msgPack, wpSecretKey)
+	if err != nil {
+		return nil, err
+	}
+	credential, err := DecryptVC(msgPack, vcSecretKey)
+	if err != nil {
+		return nil, err
+	}
+	cnfSecretKey, err := AddSecretKeysWithPublic(vcSecretKey, wpSecretKey, true)
+	if err != nil {
+		return nil, fmt.Errorf("failed to recombine holder binding key: %w", err)
+	}
+	return &OpenedMessagePack{
+		MessagePack:  msgPack,
+		Credential:   credential,
+		VCSecretKey:  vcSecretKey,
+		CnfSecretKey: cnfSecretKey,
+	}, nil
+}
+
+// DecryptVCSecretKey recovers the VC secret key from a message pack with the wallet provider secret key,
+// following the pack's EncVCSecKeyFormat and KeyFormat
+func DecryptVCSecretKey(msgPack *MessagePack, wpSecretKey jwk.Key) (jwk.Key, error) {
+	if msgPack == nil {
+		return nil, internal.WrapError(internal.ErrInvalidParameters, "message pack cannot be nil")
+	}
+
+	// packs without EncVCSecKeyFormat seal both envelopes in the format named by Format
+	format := msgPack.EncVCSecKeyFormat
+	if format == "" {
+		format = msgPack.Format
+	}
+
+	var vcSecBytes []byte
+	var err error
+	switch format {
+	case "":
+		vcSecBytes, err = pkg.DecryptWithSecretKey(msgPack.EncVCSecKey, wpSecretKey)
+	case pkg.HybridFormatV1:
+		vcSecBytes, err = pkg.DecryptHybrid(msgPack.EncVCSecKey, wpSecretKey)
+	case pkg.CompactFormatV1:
+		vcSecBytes, err = pkg.DecryptCompact(msgPack.EncVCSecKey, wpSecretKey)
+	default:
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, fmt.Sprintf("unsupported secret key envelope format %q", format))
+	}
+	if err != nil {
+		return nil, fmt.Errorf("failed to decrypt vc secret key: %w", err)
+	}
+
+	switch msgPack.KeyFormat {
+	case "":
+		return pkg.KeyJsonToJWK(vcSecBytes)
+	case KeyFormatScalarV1:
+		return SecretKeyFromScalar(vcSecBytes)
+	case KeyFormatScalarKEMV1:
+		return SecretKeyFromScalarKEM(vcSecBytes)
+	default:
+		return nil, internal.WrapError(internal.ErrInvalidKeyFormat, fmt.Sprintf("unsupported key format %q", msgPack.KeyFormat))
+	}
+}
+
+// DecryptVC decrypts the credential of a message pack with the VC secret key, following the pack's Format
+func DecryptVC(msgPack *MessagePack, vcSecretKey jwk.Key) ([]byte, error) {
+	if msgPack == nil {
+		return nil, internal.WrapError(internal.ErrInvalidParameters, "message pack cannot be nil")
+	}
+
+	var credential []byte
+	var err error
+	switch {
+	case msgPack.Format == pkg.HybridFormatV1:
+		credential, err = pkg.DecryptHybrid(msgPack.EncVC, vcSecretKey)
+	case msgPack.EncVCBinary != nil:
+		credential, err = pkg.DecryptBinaryJWE(msgPack.EncVCBinary, vcSecretKey)
+	case msgPack.Format == "":
+		credential, err = pkg.DecryptWithSecretKey(msgPack.EncVC, vcSecretKey)
+	case msgPack.Format == pkg.CompactFormatV1 && msgPack.EncVCSecKeyFormat == "":
+		// older packs named the compact secret key envelope in Format; their credential is a JWE
+		credential, err = pkg.DecryptWithSecretKey(msgPack.EncVC, vcSecretKey)
+	default:
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, fmt.Sprintf("unsupported message pack format %q", msgPack.Format))
+	}
+	if err != nil {
+		return nil, fmt.Errorf("failed to decrypt credential: %w", err)
+	}
+	return credential, nil
+}
+
+// CompactEncVC returns the encrypted credential as a compact JWE, converting a binary envelope if needed, for
+// interoperability with other JOSE libraries
+func (m *MessagePack) CompactEncVC() ([]byte, error) {
+	if m.Format == pkg.HybridFormatV1 {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, "hybrid envelopes have no JWE representation")
+	}
+	if m.EncVCBinary != nil {
+		return m.EncVCBinary.Compact(), nil
+	}
+	return m.EncVC, nil
+}
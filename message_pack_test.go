@@ -0,0 +1,237 @@
+package cvc
+
+import (
+	"bytes"
+	"context"
+	"crypto/ecdsa"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"sync/atomic"
+	"testing"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/MyNextID/cvc-go/pkg"
+	"github.com/lestrrat-go/jwx/v2/jwk"
+)
+
+// testInbox issues one credential per user through an additive provider and returns the packs, the
+// credentials and the holder binding public keys the issuer put into the cnf claims
+func testInbox(t testing.TB, provider *ProviderConfig, issuer *IssuerConfig, users, perUser int) ([][]byte, [][]byte, []jwk.Key) {
+	t.Helper()
+
+	masterPub, err := provider.AdditiveMasterKey("issuer-a")
+	if err != nil {
+		t.Fatalf("AdditiveMasterKey failed: %v", err)
+	}
+	issuer.ProviderURL = "http://127.0.0.1:1"
+	issuer.AdditiveMasterKey = masterPub
+
+	userMap, err := issuer.GetPublicKeysFromWalletProvider(testEmailMap(users))
+	if err != nil {
+		t.Fatalf("GetPublicKeysFromWalletProvider failed: %v", err)
+	}
+
+	var packs, credentials [][]byte
+	var cnfKeys []jwk.Key
+	for i := 0; i < perUser; i++ {
+		for u := 0; u < users; u++ {
+			uuid := fmt.Sprintf("user-%d", u)
+			_, userData, err := issuer.AddCnfToPayload(uuid, map[string]interface{}{}, userMap)
+			if err != nil {
+				t.Fatalf("AddCnfToPayload failed: %v", err)
+			}
+			cnfKey, err := AddPublicKeys(userData.VcPubKey, userData.WpPubKey)
+			if err != nil {
+				t.Fatalf("AddPublicKeys failed: %v", err)
+			}
+			credential := []byte(fmt.Sprintf("signed-credential-%d-%d", u, i))
+			pack, err := issuer.PrepareMessagePack(credential, uuid, userMap, []byte("display"), nil)
+			if err != nil {
+				t.Fatalf("PrepareMessagePack failed: %v", err)
+			}
+			packs = append(packs, pack)
+			credentials = append(credentials, credential)
+			cnfKeys = append(cnfKeys, cnfKey)
+		}
+	}
+	return packs, credentials, cnfKeys
+}
+
+func TestOpenMessagePacks(t *testing.T) {
+	provider := newAdditiveProvider(t)
+
+	checkOpened := func(t *testing.T, opened *OpenedMessagePack, credential []byte, cnfKey jwk.Key) {
+		t.Helper()
+		if !bytes.Equal(opened.Credential, credential) {
+			t.Errorf("Credential = %q, want %q", opened.Credential, credential)
+		}
+		if string(opened.MessagePack.DisplayMap) != "display" {
+			t.Errorf("Display map was not carried over")
+		}
+		var got ecdsa.PrivateKey
+		var want ecdsa.PublicKey
+		if err := opened.CnfSecretKey.Raw(&got); err != nil {
+			t.Fatalf("Failed to extract cnf secret key: %v", err)
+		}
+		if err := cnfKey.Raw(&want); err != nil {
+			t.Fatalf("Failed to extract cnf public key: %v", err)
+		}
+		if !got.PublicKey.Equal(&want) {
+			t.Errorf("Holder binding key does not match the cnf claim")
+		}
+		if x, y := got.Curve.ScalarBaseMult(got.D.Bytes()); x.Cmp(want.X) != 0 || y.Cmp(want.Y) != 0 {
+			t.Errorf("Holder binding secret scalar does not match the cnf claim")
+		}
+	}
+
+	for _, tc := range []struct {
+		name   string
+		issuer *IssuerConfig
+	}{
+		{"JWE", &IssuerConfig{}},
+		{"CompactSecretKey", &IssuerConfig{CompactSecretKey: true}},
+		{"BinaryEncVC", &IssuerConfig{BinaryEncVC: true, CompressionThreshold: 1}},
+	} {
+		t.Run(tc.name, func(t *testing.T) {
+			packs, credentials, cnfKeys := testInbox(t, provider, tc.issuer, 3, 2)
+
+			opened, err := OpenMessagePack(packs[0], provider.ResolveSecretKey)
+			if err != nil {
+				t.Fatalf("OpenMessagePack failed: %v", err)
+			}
+			checkOpened(t, opened, credentials[0], cnfKeys[0])
+
+			all, err := OpenMessagePacks(packs, provider.ResolveSecretKey)
+			if err != nil {
+				t.Fatalf("OpenMessagePacks failed: %v", err)
+			}
+			for i := range packs {
+				checkOpened(t, all[i], credentials[i], cnfKeys[i])
+			}
+		})
+	}
+
+	t.Run("ResolvesEachProviderKeyOnce", func(t *testing.T) {
+		packs, _, _ := testInbox(t, provider, &IssuerConfig{}, 3, 4)
+
+		var calls atomic.Int64
+		resolve := func(ctx context.Context, msgPack *MessagePack) (jwk.Key, error) {
+			calls.Add(1)
+			return provider.ResolveSecretKey(ctx, msgPack)
+		}
+		if _, err := OpenMessagePacks(packs, resolve); err != nil {
+			t.Fatalf("OpenMessagePacks failed: %v", err)
+		}
+		if n := calls.Load(); n != 3 {
+			t.Errorf("Resolver called %d times for 3 distinct keys", n)
+		}
+	})
+
+	t.Run("DamagedPacksDoNotHideTheRest", func(t *testing.T) {
+		packs, credentials, cnfKeys := testInbox(t, provider, &IssuerConfig{}, 3, 1)
+		packs = append(packs, []byte("not a message pack"), nil)
+
+		opened, err := OpenMessagePacks(packs, provider.ResolveSecretKey)
+		if err == nil {
+			t.Fatal("OpenMessagePacks accepted damaged packs")
+		}
+		if !errors.Is(err, internal.ErrInvalidParameters) {
+			t.Errorf("Expected the empty pack error to be joined, got %v", err)
+		}
+		for i := range credentials {
+			checkOpened(t, opened[i], credentials[i], cnfKeys[i])
+		}
+		if opened[3] != nil || opened[4] != nil {
+			t.Errorf("Damaged packs produced results")
+		}
+	})
+
+	t.Run("ResolverErrors", func(t *testing.T) {
+		packs, _, _ := testInbox(t, provider, &IssuerConfig{}, 2, 1)
+		failure := errors.New("provider unavailable")
+		resolve := func(ctx context.Context, msgPack *MessagePack) (jwk.Key, error) {
+			if msgPack.Email == "user-1@example.com" {
+				return nil, failure
+			}
+			return provider.ResolveSecretKey(ctx, msgPack)
+		}
+
+		opened, err := OpenMessagePacks(packs, resolve)
+		if !errors.Is(err, failure) {
+			t.Fatalf("Expected resolver error, got %v", err)
+		}
+		if (opened[0] == nil) == (opened[1] == nil) {
+			t.Errorf("Expected exactly one pack to open")
+		}
+
+		if _, err := OpenMessagePacks(packs, nil); !errors.Is(err, internal.ErrInvalidParameters) {
+			t.Errorf("Expected error for nil resolver, got %v", err)
+		}
+	})
+
+	t.Run("InconsistentProviderKey", func(t *testing.T) {
+		packs, _, _ := testInbox(t, provider, &IssuerConfig{}, 1, 1)
+		other, err := GenerateSecretKey()
+		if err != nil {
+			t.Fatalf("GenerateSecretKey failed: %v", err)
+		}
+		// the resolver returns the right scalar with the public coordinates of another key
+		resolve := func(ctx context.Context, msgPack *MessagePack) (jwk.Key, error) {
+			wpSecretKey, err := provider.ResolveSecretKey(ctx, msgPack)
+			if err != nil {
+				return nil, err
+			}
+			var fields, otherFields map[string]interface{}
+			if err := json.Unmarshal(mustJSON(t, wpSecretKey), &fields); err != nil {
+				return nil, err
+			}
+			if err := json.Unmarshal(mustJSON(t, other), &otherFields); err != nil {
+				return nil, err
+			}
+			fields["x"], fields["y"] = otherFields["x"], otherFields["y"]
+			forged, err := json.Marshal(fields)
+			if err != nil {
+				return nil, err
+			}
+			return pkg.KeyJsonToJWK(forged)
+		}
+		if _, err := OpenMessagePack(packs[0], resolve); err == nil {
+			t.Error("OpenMessagePack accepted a provider key whose public part does not match its scalar")
+		}
+	})
+
+	t.Run("Cancelled", func(t *testing.T) {
+		packs, _, _ := testInbox(t, provider, &IssuerConfig{}, 2, 1)
+		ctx, cancel := context.WithCancel(context.Background())
+		cancel()
+		if _, err := OpenMessagePacksContext(ctx, packs, provider.ResolveSecretKey); !errors.Is(err, context.Canceled) {
+			t.Errorf("Expected context.Canceled, got %v", err)
+		}
+	})
+}
+
+func BenchmarkOpenMessagePacks(b *testing.B) {
+	masterKey, _ := GenerateSecretKey()
+	chainCode, _ := GenerateChainCode()
+	provider := &ProviderConfig{MasterSecretKey: masterKey, Dst: "CVC-TEST-DST-v1.0", ChainCode: chainCode, AdditiveIssuers: []string{"issuer-a"}}
+	packs, _, _ := testInbox(b, provider, &IssuerConfig{CompactSecretKey: true}, 16, 8)
+
+	b.Run("Sequential", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			for _, pack := range packs {
+				if _, err := OpenMessagePack(pack, provider.ResolveSecretKey); err != nil {
+					b.Fatal(err)
+				}
+			}
+		}
+	})
+
+	b.Run("Inbox", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			if _, err := OpenMessagePacks(packs, provider.ResolveSecretKey); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+}
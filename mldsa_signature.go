@@ -0,0 +1,143 @@
+package cvc
+
+import (
+	"context"
+	"crypto/rand"
+
+	"github.com/MyNextID/cvc-go/internal"
+)
+
+// MLDSA65 is the JWS algorithm name of ML-DSA-65 (Dilithium3) signatures
+const MLDSA65 = "ML-DSA-65"
+
+// mldsaSelfTestMessage is signed when a signer is prepared to check that its key pair matches
+var mldsaSelfTestMessage = []byte("cvc ml-dsa signer self test")
+
+// GenerateMLDSAKeyPair generates a new ML-DSA-65 key pair
+func GenerateMLDSAKeyPair() (secretKey, publicKey []byte, err error) {
+	seed := make([]byte, internal.MLDSASeedSize)
+	if _, err := rand.Read(seed); err != nil {
+		return nil, nil, internal.WrapError(internal.ErrKeyGeneration, "failed to generate ML-DSA seed")
+	}
+	defer clear(seed)
+
+	return internal.MLDSAKeyPair(seed)
+}
+
+// MLDSASigner is a prepared ML-DSA-65 signing handle. The key pair is validated and the JWS protected
+// header is encoded once, so per-signature cost is only the signature itself. A signer is safe for
+// concurrent use.
+type MLDSASigner struct {
+	secretKey []byte
+	publicKey []byte
+	header    []byte // base64url encoded protected header followed by '.'
+}
+
+// NewMLDSASigner prepares a signer for the given key pair. keyID is placed in the "kid" header of JWS
+// signatures and may be empty.
+func NewMLDSASigner(secretKey, publicKey []byte, keyID string) (*MLDSASigner, error) {
+	if err := internal.ValidateKeyLength(secretKey, internal.MLDSASecretKeySize, "ML-DSA secret key"); err != nil {
+		return nil, err
+	}
+	if err := internal.ValidateKeyLength(publicKey, internal.MLDSAPublicKeySize, "ML-DSA public key"); err != nil {
+		return nil, err
+	}
+
+	signer := &MLDSASigner{
+		secretKey: append([]byte{}, secretKey...),
+		publicKey: append([]byte{}, publicKey...),
+	}
+
+	// a mismatched key pair would only surface at the verifier, so catch it here
+	signature, err := signer.Sign(mldsaSelfTestMessage)
+	if err != nil {
+		return nil, err
+	}
+	if err := internal.MLDSAVerify(signer.publicKey, nil, mldsaSelfTestMessage, signature); err != nil {
+		return nil, internal.WrapError(internal.ErrKeyMismatch, "ML-DSA public key does not match secret key")
+	}
+
+	if signer.header, err = encodeJWSHeader(MLDSA65, keyID); err != nil {
+		return nil, err
+	}
+
+	return signer, nil
+}
+
+// PublicKey returns the signer's public key
+func (s *MLDSASigner) PublicKey() []byte {
+	return append([]byte{}, s.publicKey...)
+}
+
+// Sign returns a hedged ML-DSA-65 signature over message
+func (s *MLDSASigner) Sign(message []byte) ([]byte, error) {
+	signature := make([]byte, internal.MLDSASignatureSize)
+	if err := s.signInto(message, signature); err != nil {
+		return nil, err
+	}
+	return signature, nil
+}
+
+func (s *MLDSASigner) signInto(message, signature []byte) error {
+	random := make([]byte, internal.MLDSARandomSize)
+	if _, err := rand.Read(random); err != nil {
+		return internal.WrapError(internal.ErrInsufficientEntropy, "failed to generate signature randomness")
+	}
+	return internal.MLDSASign(s.secretKey, nil, message, random, signature)
+}
+
+// SignJWS signs payload and returns a compact JWS serialization (header.payload.signature)
+func (s *MLDSASigner) SignJWS(payload []byte) ([]byte, error) {
+	return signJWS(s.header, payload, internal.MLDSASignatureSize, s.signInto)
+}
+
+// SignBatch signs every payload as compact JWS, spreading the work over all available CPUs. The
+// result has the same order as payloads. If any signature fails, the first error is returned.
+func (s *MLDSASigner) SignBatch(payloads [][]byte) ([][]byte, error) {
+	return signBatch(context.Background(), payloads, s.SignJWS)
+}
+
+// SignBatchContext is SignBatch that stops starting new signatures once ctx is done and returns ctx.Err()
+func (s *MLDSASigner) SignBatchContext(ctx context.Context, payloads [][]byte) ([][]byte, error) {
+	return signBatch(ctx, payloads, s.SignJWS)
+}
+
+// MLDSAVerifier is a prepared ML-DSA-65 verification handle, safe for concurrent use
+type MLDSAVerifier struct {
+	publicKey []byte
+}
+
+// NewMLDSAVerifier prepares a verifier for the given public key
+func NewMLDSAVerifier(publicKey []byte) (*MLDSAVerifier, error) {
+	if err := internal.ValidateKeyLength(publicKey, internal.MLDSAPublicKeySize, "ML-DSA public key"); err != nil {
+		return nil, err
+	}
+	return &MLDSAVerifier{publicKey: append([]byte{}, publicKey...)}, nil
+}
+
+// Verify checks an ML-DSA-65 signature over message
+func (v *MLDSAVerifier) Verify(message, signature []byte) error {
+	return internal.MLDSAVerify(v.publicKey, nil, message, signature)
+}
+
+// VerifyJWS verifies a compact JWS produced by MLDSASigner.SignJWS and returns its decoded payload
+func (v *MLDSAVerifier) VerifyJWS(token []byte) ([]byte, error) {
+	signingInput, signature, encPayload, err := parseJWS(token, MLDSA65)
+	if err != nil {
+		return nil, err
+	}
+	if err := v.Verify(signingInput, signature); err != nil {
+		return nil, err
+	}
+	return decodeJWSPayload(encPayload)
+}
+
+// VerifyJWSClaims verifies a compact JWS produced by MLDSASigner.SignJWS and returns its claims, checked
+// like those of EdDSAVerifier.VerifyJWSClaims.
+func (v *MLDSAVerifier) VerifyJWSClaims(token []byte) (*Claims, error) {
+	payload, err := v.VerifyJWS(token)
+	if err != nil {
+		return nil, err
+	}
+	return parseVerifiedClaims(payload)
+}
@@ -0,0 +1,151 @@
+package cvc
+
+import (
+	"bytes"
+	"errors"
+	"fmt"
+	"testing"
+
+	"github.com/MyNextID/cvc-go/internal"
+)
+
+func TestMLDSASignature(t *testing.T) {
+	secretKey, publicKey, err := GenerateMLDSAKeyPair()
+	if err != nil {
+		t.Fatalf("GenerateMLDSAKeyPair failed: %v", err)
+	}
+	signer, err := NewMLDSASigner(secretKey, publicKey, "issuer-key-1")
+	if err != nil {
+		t.Fatalf("NewMLDSASigner failed: %v", err)
+	}
+	verifier, err := NewMLDSAVerifier(publicKey)
+	if err != nil {
+		t.Fatalf("NewMLDSAVerifier failed: %v", err)
+	}
+	payload := []byte(`{"iss":"https://issuer.example.com","vc":{"type":["VerifiableCredential"]}}`)
+
+	t.Run("SignVerify", func(t *testing.T) {
+		signature, err := signer.Sign(payload)
+		if err != nil {
+			t.Fatalf("Sign failed: %v", err)
+		}
+		if len(signature) != internal.MLDSASignatureSize {
+			t.Errorf("Expected signature of %d bytes, got %d", internal.MLDSASignatureSize, len(signature))
+		}
+		if err := verifier.Verify(payload, signature); err != nil {
+			t.Errorf("Verify failed: %v", err)
+		}
+		if err := verifier.Verify([]byte("other"), signature); !errors.Is(err, internal.ErrInvalidSignature) {
+			t.Errorf("Expected invalid signature for other message, got %v", err)
+		}
+	})
+
+	t.Run("JWS", func(t *testing.T) {
+		token, err := signer.SignJWS(payload)
+		if err != nil {
+			t.Fatalf("SignJWS failed: %v", err)
+		}
+		if bytes.Count(token, []byte(".")) != 2 {
+			t.Fatalf("Expected compact JWS with three segments")
+		}
+		decoded, err := verifier.VerifyJWS(token)
+		if err != nil {
+			t.Fatalf("VerifyJWS failed: %v", err)
+		}
+		if !bytes.Equal(decoded, payload) {
+			t.Errorf("Decoded payload does not match")
+		}
+
+		tampered := append([]byte{}, token...)
+		tampered[bytes.IndexByte(token, '.')+2] ^= 0x01
+		if _, err := verifier.VerifyJWS(tampered); err == nil {
+			t.Errorf("Expected error for tampered payload")
+		}
+		if _, err := verifier.VerifyJWS([]byte("a.b")); err == nil {
+			t.Errorf("Expected error for malformed JWS")
+		}
+	})
+
+	t.Run("BatchSign", func(t *testing.T) {
+		payloads := make([][]byte, 16)
+		for i := range payloads {
+			payloads[i] = []byte(fmt.Sprintf(`{"sub":"user-%d"}`, i))
+		}
+		tokens, err := signer.SignBatch(payloads)
+		if err != nil {
+			t.Fatalf("SignBatch failed: %v", err)
+		}
+		for i, token := range tokens {
+			decoded, err := verifier.VerifyJWS(token)
+			if err != nil {
+				t.Fatalf("VerifyJWS failed for token %d: %v", i, err)
+			}
+			if !bytes.Equal(decoded, payloads[i]) {
+				t.Errorf("Token %d carries the wrong payload", i)
+			}
+		}
+	})
+
+	t.Run("MismatchedKeyPair", func(t *testing.T) {
+		_, otherPublicKey, err := GenerateMLDSAKeyPair()
+		if err != nil {
+			t.Fatalf("GenerateMLDSAKeyPair failed: %v", err)
+		}
+		if _, err := NewMLDSASigner(secretKey, otherPublicKey, ""); !errors.Is(err, internal.ErrKeyMismatch) {
+			t.Errorf("Expected key mismatch error, got %v", err)
+		}
+	})
+
+	t.Run("InvalidKeys", func(t *testing.T) {
+		if _, err := NewMLDSASigner(secretKey[:10], publicKey, ""); !internal.IsKeyError(err) {
+			t.Errorf("Expected key error for short secret key, got %v", err)
+		}
+		if _, err := NewMLDSAVerifier(publicKey[:10]); !internal.IsKeyError(err) {
+			t.Errorf("Expected key error for short public key, got %v", err)
+		}
+	})
+}
+
+func BenchmarkMLDSASignature(b *testing.B) {
+	secretKey, publicKey, err := GenerateMLDSAKeyPair()
+	if err != nil {
+		b.Fatalf("GenerateMLDSAKeyPair failed: %v", err)
+	}
+	signer, err := NewMLDSASigner(secretKey, publicKey, "")
+	if err != nil {
+		b.Fatalf("NewMLDSASigner failed: %v", err)
+	}
+	verifier, _ := NewMLDSAVerifier(publicKey)
+	payload := bytes.Repeat([]byte("a"), 1024)
+
+	b.Run("SignJWS", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			if _, err := signer.SignJWS(payload); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("SignBatch", func(b *testing.B) {
+		payloads := make([][]byte, 64)
+		for i := range payloads {
+			payloads[i] = payload
+		}
+		b.ResetTimer()
+		for i := 0; i < b.N; i++ {
+			if _, err := signer.SignBatch(payloads); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("VerifyJWS", func(b *testing.B) {
+		token, _ := signer.SignJWS(payload)
+		b.ResetTimer()
+		for i := 0; i < b.N; i++ {
+			if _, err := verifier.VerifyJWS(token); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+}
@@ -0,0 +1,315 @@
+package pkg
+
+import (
+	"bytes"
+	"crypto/aes"
+	"crypto/cipher"
+	"crypto/ecdh"
+	"crypto/ecdsa"
+	"crypto/elliptic"
+	"crypto/rand"
+	"crypto/sha256"
+	"encoding/base64"
+	"encoding/binary"
+	"encoding/json"
+	"fmt"
+	"math/big"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/lestrrat-go/jwx/v2/jwk"
+)
+
+// BinaryJWE holds the parts of a compact JWE as raw bytes, so it can be stored in binary formats such as
+// MessagePack without a base64url layer. Converting to and from the compact serialization is lossless.
+type BinaryJWE struct {
+	Protected    []byte `json:"protected" msgpack:"protected"` // protected header JSON, not base64url encoded
+	EncryptedKey []byte `json:"encrypted_key,omitempty" msgpack:"encrypted_key"`
+	IV           []byte `json:"iv" msgpack:"iv"`
+	Ciphertext   []byte `json:"ciphertext" msgpack:"ciphertext"`
+	Tag          []byte `json:"tag" msgpack:"tag"`
+}
+
+type binaryJWEHeader struct {
+	Alg string          `json:"alg"`
+	Enc string          `json:"enc"`
+	Epk json.RawMessage `json:"epk"`
+	Apu string          `json:"apu,omitempty"`
+	Apv string          `json:"apv,omitempty"`
+	Zip string          `json:"zip,omitempty"`
+}
+
+// nativeAlgorithm reports whether the JWE can be decrypted by DecryptBinaryJWE
+func (h binaryJWEHeader) nativeAlgorithm() bool {
+	return h.Alg == "ECDH-ES" && h.Enc == "A256GCM"
+}
+
+type binaryJWEKey struct {
+	Kty string `json:"kty"`
+	Crv string `json:"crv"`
+	X   string `json:"x"`
+	Y   string `json:"y"`
+}
+
+// jweEncoding rejects non-canonical base64url, which would not survive a round trip through BinaryJWE
+var jweEncoding = base64.RawURLEncoding.Strict()
+
+// ParseCompactJWE splits a compact JWE into its binary parts
+func ParseCompactJWE(compact []byte) (*BinaryJWE, error) {
+	parts := bytes.Split(compact, []byte("."))
+	if len(parts) != 5 {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, "compact JWE must have five parts")
+	}
+
+	decoded := make([][]byte, len(parts))
+	for i, part := range parts {
+		out := make([]byte, jweEncoding.DecodedLen(len(part)))
+		n, err := jweEncoding.Decode(out, part)
+		if err != nil {
+			return nil, internal.WrapError(internal.ErrEnvelopeFormat, fmt.Sprintf("invalid base64url in JWE part %d", i))
+		}
+		decoded[i] = out[:n]
+	}
+
+	return &BinaryJWE{
+		Protected:    decoded[0],
+		EncryptedKey: decoded[1],
+		IV:           decoded[2],
+		Ciphertext:   decoded[3],
+		Tag:          decoded[4],
+	}, nil
+}
+
+// Compact returns the compact serialization of the JWE
+func (b *BinaryJWE) Compact() []byte {
+	parts := [][]byte{b.Protected, b.EncryptedKey, b.IV, b.Ciphertext, b.Tag}
+
+	size := len(parts) - 1
+	for _, part := range parts {
+		size += base64.RawURLEncoding.EncodedLen(len(part))
+	}
+
+	out := make([]byte, 0, size)
+	for i, part := range parts {
+		if i > 0 {
+			out = append(out, '.')
+		}
+		start := len(out)
+		out = out[:start+base64.RawURLEncoding.EncodedLen(len(part))]
+		base64.RawURLEncoding.Encode(out[start:], part)
+	}
+	return out
+}
+
+// EncryptBinaryJWE encrypts payload like EncryptWithPublicKey (ECDH-ES, A256GCM), but produces the binary form
+// directly, so the payload is never base64url encoded
+func EncryptBinaryJWE(payload []byte, pkJWK jwk.Key) (*BinaryJWE, error) {
+	return encryptBinaryJWE(payload, pkJWK, false)
+}
+
+// EncryptBinaryJWEDeflate encrypts like EncryptBinaryJWE, but compresses the payload first and marks the JWE
+// with "zip":"DEF"
+func EncryptBinaryJWEDeflate(payload []byte, pkJWK jwk.Key) (*BinaryJWE, error) {
+	return encryptBinaryJWE(payload, pkJWK, true)
+}
+
+func encryptBinaryJWE(payload []byte, pkJWK jwk.Key, compress bool) (*BinaryJWE, error) {
+	recipientKey, err := recipientECDHKey(pkJWK)
+	if err != nil {
+		return nil, err
+	}
+
+	ephemeral, err := ecdh.P256().GenerateKey(rand.Reader)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrKeyGeneration, "failed to generate ephemeral key")
+	}
+	shared, err := ephemeral.ECDH(recipientKey)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrKeyDerivation, "ECDH failed")
+	}
+
+	epk := ephemeral.PublicKey().Bytes()
+	epkJSON, err := json.Marshal(binaryJWEKey{
+		Kty: "EC",
+		Crv: "P-256",
+		X:   base64.RawURLEncoding.EncodeToString(epk[1:33]),
+		Y:   base64.RawURLEncoding.EncodeToString(epk[33:]),
+	})
+	if err != nil {
+		return nil, fmt.Errorf("failed to encode ephemeral key: %w", err)
+	}
+	header := binaryJWEHeader{Alg: "ECDH-ES", Enc: "A256GCM", Epk: epkJSON}
+	if compress {
+		header.Zip = "DEF"
+		if payload, err = Deflate(payload); err != nil {
+			return nil, err
+		}
+	}
+	protected, err := json.Marshal(header)
+	if err != nil {
+		return nil, fmt.Errorf("failed to encode JWE header: %w", err)
+	}
+
+	aead, err := newJWEAEAD(concatKDF(shared, "A256GCM", nil, nil, 32))
+	if err != nil {
+		return nil, err
+	}
+
+	iv := make([]byte, aead.NonceSize())
+	if _, err := rand.Read(iv); err != nil {
+		return nil, internal.WrapError(internal.ErrInsufficientEntropy, "failed to generate IV")
+	}
+
+	// a compressed payload is our own buffer and is sealed in place
+	var dst []byte
+	if compress {
+		dst = payload[:0]
+	}
+	internal.RecordGCMBlocks(len(payload))
+	sealed := aead.Seal(dst, iv, payload, jweAAD(protected))
+	tagStart := len(sealed) - aead.Overhead()
+
+	return &BinaryJWE{
+		Protected:  protected,
+		IV:         iv,
+		Ciphertext: sealed[:tagStart],
+		Tag:        sealed[tagStart:],
+	}, nil
+}
+
+// DecryptBinaryJWE decrypts a JWE in binary form with the recipient's P-256 secret key. ECDH-ES, A256GCM
+// envelopes are opened natively; other algorithms go through DecryptWithSecretKey on b.Compact().
+// Compressed payloads are limited to MaxDecompressedSize.
+func DecryptBinaryJWE(b *BinaryJWE, skJWK jwk.Key) ([]byte, error) {
+	return decryptBinaryJWE(b, skJWK, MaxDecompressedSize)
+}
+
+func decryptBinaryJWE(b *BinaryJWE, skJWK jwk.Key, maxSize int64) ([]byte, error) {
+	if b == nil {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, "JWE cannot be nil")
+	}
+
+	var header binaryJWEHeader
+	if err := json.Unmarshal(b.Protected, &header); err != nil {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, "invalid JWE protected header")
+	}
+	if !header.nativeAlgorithm() {
+		return DecryptWithSecretKeyLimit(b.Compact(), skJWK, maxSize)
+	}
+	if len(b.EncryptedKey) != 0 {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, fmt.Sprintf("unsupported JWE algorithm %s/%s", header.Alg, header.Enc))
+	}
+
+	epk, err := parseJWEKey(header.Epk)
+	if err != nil {
+		return nil, err
+	}
+	apu, err := base64.RawURLEncoding.DecodeString(header.Apu)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, "invalid apu")
+	}
+	apv, err := base64.RawURLEncoding.DecodeString(header.Apv)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, "invalid apv")
+	}
+
+	priv, err := hybridPrivateKey(skJWK)
+	if err != nil {
+		return nil, err
+	}
+	ecdhKey, err := priv.ECDH()
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "invalid recipient secret key")
+	}
+	shared, err := ecdhKey.ECDH(epk)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrDecryption, "ECDH failed")
+	}
+
+	aead, err := newJWEAEAD(concatKDF(shared, header.Enc, apu, apv, 32))
+	if err != nil {
+		return nil, err
+	}
+	if len(b.IV) != aead.NonceSize() || len(b.Tag) != aead.Overhead() {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, "invalid IV or tag length")
+	}
+
+	sealed := make([]byte, 0, len(b.Ciphertext)+len(b.Tag))
+	sealed = append(append(sealed, b.Ciphertext...), b.Tag...)
+	internal.RecordGCMBlocks(len(b.Ciphertext))
+	payload, err := aead.Open(sealed[:0], b.IV, sealed, jweAAD(b.Protected))
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrDecryption, "JWE authentication failed")
+	}
+
+	switch header.Zip {
+	case "":
+		return payload, nil
+	case "DEF":
+		return Inflate(payload, maxSize)
+	default:
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, fmt.Sprintf("unsupported JWE compression %q", header.Zip))
+	}
+}
+
+// concatKDF derives keyLen bytes with the Concat KDF of RFC 7518 section 4.6.2 for direct key agreement
+func concatKDF(z []byte, algID string, apu, apv []byte, keyLen int) []byte {
+	otherInfo := make([]byte, 0, 16+len(algID)+len(apu)+len(apv))
+	otherInfo = appendLengthPrefixed(otherInfo, []byte(algID))
+	otherInfo = appendLengthPrefixed(otherInfo, apu)
+	otherInfo = appendLengthPrefixed(otherInfo, apv)
+	otherInfo = binary.BigEndian.AppendUint32(otherInfo, uint32(keyLen*8))
+
+	out := make([]byte, 0, keyLen+sha256.Size)
+	for counter := uint32(1); len(out) < keyLen; counter++ {
+		h := sha256.New()
+		binary.Write(h, binary.BigEndian, counter)
+		h.Write(z)
+		h.Write(otherInfo)
+		out = h.Sum(out)
+	}
+	return out[:keyLen]
+}
+
+func appendLengthPrefixed(dst, data []byte) []byte {
+	dst = binary.BigEndian.AppendUint32(dst, uint32(len(data)))
+	return append(dst, data...)
+}
+
+// jweAAD returns the additional authenticated data of a JWE, the base64url encoded protected header
+func jweAAD(protected []byte) []byte {
+	aad := make([]byte, base64.RawURLEncoding.EncodedLen(len(protected)))
+	base64.RawURLEncoding.Encode(aad, protected)
+	return aad
+}
+
+func newJWEAEAD(key []byte) (cipher.AEAD, error) {
+	block, err := aes.NewCipher(key)
+	if err != nil {
+		return nil, fmt.Errorf("failed to create cipher: %w", err)
+	}
+	aead, err := cipher.NewGCM(block)
+	if err != nil {
+		return nil, fmt.Errorf("failed to create GCM: %w", err)
+	}
+	return aead, nil
+}
+
+// parseJWEKey parses the P-256 ephemeral public key of a JWE header
+func parseJWEKey(raw json.RawMessage) (*ecdh.PublicKey, error) {
+	var key binaryJWEKey
+	if err := json.Unmarshal(raw, &key); err != nil || key.Kty != "EC" || key.Crv != "P-256" {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, "invalid JWE ephemeral key")
+	}
+	x, errX := base64.RawURLEncoding.DecodeString(key.X)
+	y, errY := base64.RawURLEncoding.DecodeString(key.Y)
+	if errX != nil || errY != nil || len(x) != 32 || len(y) != 32 {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, "invalid JWE ephemeral key coordinates")
+	}
+
+	pub := &ecdsa.PublicKey{Curve: elliptic.P256(), X: new(big.Int).SetBytes(x), Y: new(big.Int).SetBytes(y)}
+	epk, err := pub.ECDH()
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, "JWE ephemeral key is not on the curve")
+	}
+	return epk, nil
+}
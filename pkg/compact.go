@@ -0,0 +1,118 @@
+package pkg
+
+import (
+	"crypto/ecdh"
+	"crypto/elliptic"
+	"crypto/rand"
+	"fmt"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/lestrrat-go/jwx/v2/jwk"
+)
+
+// Compact envelopes are a fixed binary alternative to JWE for small payloads such as a 32-byte secret key
+// scalar. The layout is
+//
+//	version (1) | ephemeral P-256 public key, compressed (33) | AES-256-GCM ciphertext + tag
+//
+// The AES key and nonce are derived with HKDF-SHA256 from the ECDH shared secret, bound to the header and the
+// recipient public key, and the header is authenticated as additional data. A 32-byte payload gives an 82 byte
+// envelope.
+
+const (
+	// CompactEnvelopeV1 is the version byte of compact envelopes
+	CompactEnvelopeV1 byte = 0x02
+	// CompactFormatV1 names the compact envelope format in message packs
+	CompactFormatV1 = "compact-v1"
+
+	compactInfo       = "cvc-compact-v1"
+	compactEPKSize    = 33
+	compactHeaderSize = 1 + compactEPKSize
+)
+
+// EncryptCompact seals payload into a compact envelope for the recipient's P-256 public key
+func EncryptCompact(payload []byte, pkJWK jwk.Key) ([]byte, error) {
+	recipientKey, err := recipientECDHKey(pkJWK)
+	if err != nil {
+		return nil, err
+	}
+
+	ephemeral, err := ecdh.P256().GenerateKey(rand.Reader)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrKeyGeneration, "failed to generate ephemeral key")
+	}
+	shared, err := ephemeral.ECDH(recipientKey)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrKeyDerivation, "ECDH failed")
+	}
+
+	envelope := make([]byte, compactHeaderSize, compactHeaderSize+len(payload)+hybridTagSize)
+	envelope[0] = CompactEnvelopeV1
+	copy(envelope[1:], compressPoint(ephemeral.PublicKey().Bytes()))
+
+	aead, nonce, err := envelopeAEAD(compactInfo, shared, envelope, compressPoint(recipientKey.Bytes()))
+	if err != nil {
+		return nil, err
+	}
+
+	internal.RecordGCMBlocks(len(payload))
+	return aead.Seal(envelope, nonce, payload, envelope), nil
+}
+
+// DecryptCompact opens a compact envelope with the recipient's P-256 secret key
+func DecryptCompact(envelope []byte, skJWK jwk.Key) ([]byte, error) {
+	if len(envelope) < compactHeaderSize+hybridTagSize {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, "envelope is too short")
+	}
+	if envelope[0] != CompactEnvelopeV1 {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, fmt.Sprintf("unsupported envelope version %d", envelope[0]))
+	}
+
+	priv, err := hybridPrivateKey(skJWK)
+	if err != nil {
+		return nil, err
+	}
+	ecdhKey, err := priv.ECDH()
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "invalid recipient secret key")
+	}
+
+	x, y := elliptic.UnmarshalCompressed(elliptic.P256(), envelope[1:compactHeaderSize])
+	if x == nil {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, "invalid ephemeral public key")
+	}
+	epk, err := ecdh.P256().NewPublicKey(elliptic.Marshal(elliptic.P256(), x, y))
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, "invalid ephemeral public key")
+	}
+	shared, err := ecdhKey.ECDH(epk)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrDecryption, "ECDH failed")
+	}
+
+	header := envelope[:compactHeaderSize]
+	aead, nonce, err := envelopeAEAD(compactInfo, shared, header, compressPoint(ecdhKey.PublicKey().Bytes()))
+	if err != nil {
+		return nil, err
+	}
+
+	internal.RecordGCMBlocks(len(envelope) - compactHeaderSize - hybridTagSize)
+	payload, err := aead.Open(nil, nonce, envelope[compactHeaderSize:], header)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrDecryption, "envelope authentication failed")
+	}
+	return payload, nil
+}
+
+// IsCompactEnvelope reports whether data starts like a compact envelope rather than a compact JWE
+func IsCompactEnvelope(data []byte) bool {
+	return len(data) >= compactHeaderSize+hybridTagSize && data[0] == CompactEnvelopeV1
+}
+
+// compressPoint converts an uncompressed P-256 point to its 33-byte compressed form
+func compressPoint(uncompressed []byte) []byte {
+	compressed := make([]byte, compactEPKSize)
+	compressed[0] = 0x02 | uncompressed[len(uncompressed)-1]&1
+	copy(compressed[1:], uncompressed[1:33])
+	return compressed
+}
@@ -0,0 +1,71 @@
+package pkg
+
+import (
+	"bytes"
+	"compress/flate"
+	"fmt"
+	"io"
+	"sync"
+
+	"github.com/MyNextID/cvc-go/internal"
+)
+
+// MaxDecompressedSize caps the size of a decompressed payload in the decrypt functions. Use
+// DecryptWithSecretKeyLimit to decrypt larger JWE payloads.
+const MaxDecompressedSize = 16 << 20
+
+// flateWriters reuses DEFLATE compressors, whose internal state is costly to allocate per payload
+var flateWriters = sync.Pool{
+	New: func() interface{} {
+		w, _ := flate.NewWriter(nil, flate.DefaultCompression)
+		return w
+	},
+}
+
+// Deflate compresses payload with raw DEFLATE (RFC 1951), as used by the JWE "zip":"DEF" header
+func Deflate(payload []byte) ([]byte, error) {
+	return DeflateTo(make([]byte, 0, len(payload)/3+64), payload)
+}
+
+// DeflateTo compresses payload like Deflate and appends the result to dst. The compressor writes straight
+// into dst, so envelopes can compress a payload into their own buffer behind the header.
+func DeflateTo(dst, payload []byte) ([]byte, error) {
+	out := appendWriter{buf: dst}
+
+	w := flateWriters.Get().(*flate.Writer)
+	defer flateWriters.Put(w)
+	w.Reset(&out)
+
+	if _, err := w.Write(payload); err != nil {
+		return nil, fmt.Errorf("failed to compress payload: %w", err)
+	}
+	if err := w.Close(); err != nil {
+		return nil, fmt.Errorf("failed to compress payload: %w", err)
+	}
+	return out.buf, nil
+}
+
+// appendWriter appends everything written to it to buf
+type appendWriter struct {
+	buf []byte
+}
+
+func (w *appendWriter) Write(p []byte) (int, error) {
+	w.buf = append(w.buf, p...)
+	return len(p), nil
+}
+
+// Inflate decompresses raw DEFLATE data, failing once the output would exceed maxSize bytes
+func Inflate(data []byte, maxSize int64) ([]byte, error) {
+	r := flate.NewReader(bytes.NewReader(data))
+	defer r.Close()
+
+	out, err := io.ReadAll(io.LimitReader(r, maxSize+1))
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrDecryption, "failed to decompress payload")
+	}
+	if int64(len(out)) > maxSize {
+		return nil, fmt.Errorf("%w: decompressed payload exceeds %d bytes", internal.ErrInputTooLarge, maxSize)
+	}
+	return out, nil
+}
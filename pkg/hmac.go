@@ -0,0 +1,103 @@
+package pkg
+
+import (
+	"crypto/subtle"
+
+	"github.com/MyNextID/cvc-go/internal"
+)
+
+// HMACKey is a prepared HMAC-SHA256 key. Keys that are used over and over, such as request
+// authentication keys or HKDF salts and PRKs, should be prepared once: every use then starts from the
+// hash states after the key blocks, which saves two SHA-256 compressions and makes HMACs of short
+// messages roughly twice as fast. An HMACKey is safe for concurrent use, except for Wipe.
+type HMACKey struct {
+	key *internal.HMACKey
+}
+
+// NewHMACKey prepares key for HMAC-SHA256. An empty key is allowed.
+func NewHMACKey(key []byte) (*HMACKey, error) {
+	prepared, err := internal.NewHMACKey(key)
+	if err != nil {
+		return nil, err
+	}
+	return &HMACKey{key: prepared}, nil
+}
+
+// Sum returns the HMAC-SHA256 tag of message
+func (k *HMACKey) Sum(message []byte) ([]byte, error) {
+	tag := make([]byte, internal.HMACSize)
+	if err := k.key.Sum(message, tag); err != nil {
+		return nil, err
+	}
+	return tag, nil
+}
+
+// Verify reports whether tag is the HMAC-SHA256 tag of message, in constant time
+func (k *HMACKey) Verify(message, tag []byte) bool {
+	var expected [internal.HMACSize]byte
+	if err := k.key.Sum(message, expected[:]); err != nil {
+		return false
+	}
+	return subtle.ConstantTimeCompare(expected[:], tag) == 1
+}
+
+// HKDF derives outLen bytes with HKDF-SHA256 (RFC 5869) from ikm and info, using k as the salt
+func (k *HMACKey) HKDF(ikm, info []byte, outLen int) ([]byte, error) {
+	prk, err := k.key.Extract(ikm)
+	if err != nil {
+		return nil, err
+	}
+	defer prk.Wipe()
+
+	out := make([]byte, outLen)
+	if err := prk.Expand(info, out); err != nil {
+		return nil, err
+	}
+	return out, nil
+}
+
+// Expand runs HKDF-SHA256 expand with k as the PRK, for key schedules that expand one PRK many times
+func (k *HMACKey) Expand(info []byte, outLen int) ([]byte, error) {
+	out := make([]byte, outLen)
+	if err := k.key.Expand(info, out); err != nil {
+		return nil, err
+	}
+	return out, nil
+}
+
+// Wipe zeroes the prepared key
+func (k *HMACKey) Wipe() {
+	k.key.Wipe()
+}
+
+// KDF2Secret is a shared secret prepared for IEEE 1363 KDF2-SHA256. Deriving several keys from one
+// secret hashes the secret only once. A KDF2Secret is safe for concurrent use, except for Wipe.
+type KDF2Secret struct {
+	secret *internal.KDF2Secret
+}
+
+// NewKDF2Secret prepares the shared secret z for KDF2
+func NewKDF2Secret(z []byte) (*KDF2Secret, error) {
+	prepared, err := internal.NewKDF2Secret(z)
+	if err != nil {
+		return nil, err
+	}
+	return &KDF2Secret{secret: prepared}, nil
+}
+
+// Derive returns outLen bytes of KDF2-SHA256 for the key derivation parameter param
+func (s *KDF2Secret) Derive(param []byte, outLen int) ([]byte, error) {
+	if outLen <= 0 {
+		return nil, internal.WrapError(internal.ErrInvalidParameters, "invalid KDF2 output length")
+	}
+	out := make([]byte, outLen)
+	if err := s.secret.Derive(param, out); err != nil {
+		return nil, err
+	}
+	return out, nil
+}
+
+// Wipe zeroes the prepared secret
+func (s *KDF2Secret) Wipe() {
+	s.secret.Wipe()
+}
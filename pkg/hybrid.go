@@ -0,0 +1,352 @@
+package pkg
+
+import (
+	"crypto/aes"
+	"crypto/cipher"
+	"crypto/ecdh"
+	"crypto/ecdsa"
+	"crypto/elliptic"
+	"crypto/rand"
+	"encoding/base64"
+	"fmt"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/lestrrat-go/jwx/v2/jwk"
+)
+
+// Hybrid envelopes combine P-256 ECDH with ML-KEM-768 (Kyber768) so that a payload stays confidential as long
+// as either of the two key agreements is unbroken. The binary layout is
+//
+//	version (1) | ephemeral P-256 public key, uncompressed (65) | Kyber768 ciphertext (1088) | AES-256-GCM ciphertext + tag
+//
+// The AES key and nonce are derived with HKDF-SHA256 from ss_ecdh || ss_kem, bound to the header and the
+// recipient public key. Every envelope uses a fresh ephemeral key and encapsulation, so the derived nonce is
+// never reused. The header is authenticated as additional data.
+//
+// The recipient's Kyber768 key pair is generated from its own seed, which is independent of the P-256 secret key:
+// breaking the P-256 key must not reveal the Kyber768 key as well. The seed travels with the P-256 secret key as
+// the private JWK member KEMSeedParam (see WithKEMSeed, PublicJWK and KEMKeyPair).
+
+const (
+	// HybridEnvelopeV1 is the version byte of hybrid envelopes
+	HybridEnvelopeV1 byte = 0x01
+	// HybridFormatV1 names the hybrid envelope format in message packs
+	HybridFormatV1 = "hybrid-v1"
+	// EnvelopeFlagDeflate is set in the version byte of envelopes whose payload was compressed with Deflate.
+	// The version byte is authenticated, so the flag cannot be altered.
+	EnvelopeFlagDeflate byte = 0x80
+
+	// KEMSeedParam is the private JWK member that carries the Kyber768 seed of a hybrid recipient, base64url
+	// encoded, next to its P-256 secret key
+	KEMSeedParam = "cvc_kem_seed"
+
+	hybridInfo       = "cvc-hybrid-v1"
+	hybridEPKSize    = internal.UncompressedPublicKeySize
+	hybridHeaderSize = 1 + hybridEPKSize + internal.KEMCiphertextSize
+	hybridKeySize    = 32
+	hybridNonceSize  = 12
+	hybridTagSize    = 16
+)
+
+// HybridRecipient is a prepared hybrid encryption target. Parsing and validating the recipient keys is done
+// once, so issuers sending many envelopes to the same recipient should keep the handle and call Encrypt.
+// A HybridRecipient is safe for concurrent use.
+type HybridRecipient struct {
+	ecdhKey  *ecdh.PublicKey
+	pubBytes []byte
+	kemPub   []byte
+}
+
+// NewHybridRecipient prepares a recipient from its P-256 public key and Kyber768 public key
+func NewHybridRecipient(pkJWK jwk.Key, kemPub []byte) (*HybridRecipient, error) {
+	if err := internal.ValidateKeyLength(kemPub, internal.KEMPublicKeySize, "KEM public key"); err != nil {
+		return nil, err
+	}
+
+	ecdhKey, err := recipientECDHKey(pkJWK)
+	if err != nil {
+		return nil, err
+	}
+
+	return &HybridRecipient{
+		ecdhKey:  ecdhKey,
+		pubBytes: ecdhKey.Bytes(),
+		kemPub:   append([]byte{}, kemPub...),
+	}, nil
+}
+
+// Encrypt seals payload into a hybrid envelope for the recipient
+func (r *HybridRecipient) Encrypt(payload []byte) ([]byte, error) {
+	return r.encrypt(payload, false)
+}
+
+// EncryptDeflate compresses payload and seals it into a hybrid envelope marked with EnvelopeFlagDeflate
+func (r *HybridRecipient) EncryptDeflate(payload []byte) ([]byte, error) {
+	return r.encrypt(payload, true)
+}
+
+func (r *HybridRecipient) encrypt(payload []byte, compress bool) ([]byte, error) {
+	version := HybridEnvelopeV1
+	if compress {
+		version |= EnvelopeFlagDeflate
+	}
+
+	ephemeral, err := ecdh.P256().GenerateKey(rand.Reader)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrKeyGeneration, "failed to generate ephemeral key")
+	}
+	ssECDH, err := ephemeral.ECDH(r.ecdhKey)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrKEM, "ECDH failed")
+	}
+
+	random := make([]byte, internal.KEMRandomSize)
+	if _, err := rand.Read(random); err != nil {
+		return nil, internal.WrapError(internal.ErrKeyGeneration, "failed to generate encapsulation randomness")
+	}
+	ssKEM, kemCt, err := internal.KEMEncapsulate(random, r.kemPub)
+	if err != nil {
+		return nil, err
+	}
+
+	envelope := make([]byte, hybridHeaderSize, hybridHeaderSize+len(payload)+hybridTagSize)
+	envelope[0] = version
+	copy(envelope[1:], ephemeral.PublicKey().Bytes())
+	copy(envelope[1+hybridEPKSize:], kemCt)
+
+	aead, nonce, err := envelopeAEAD(hybridInfo, append(ssECDH, ssKEM...), envelope, r.pubBytes)
+	if err != nil {
+		return nil, err
+	}
+
+	// a compressed payload is written straight behind the header and sealed in place
+	if compress {
+		if envelope, err = DeflateTo(envelope, payload); err != nil {
+			return nil, err
+		}
+		payload = envelope[hybridHeaderSize:]
+	}
+	header := envelope[:hybridHeaderSize]
+
+	internal.RecordGCMBlocks(len(payload))
+	return aead.Seal(header, nonce, payload, header), nil
+}
+
+// EncryptHybrid seals payload into a hybrid envelope for a single use. Use NewHybridRecipient when encrypting
+// repeatedly for the same recipient.
+func EncryptHybrid(payload []byte, pkJWK jwk.Key, kemPub []byte) ([]byte, error) {
+	recipient, err := NewHybridRecipient(pkJWK, kemPub)
+	if err != nil {
+		return nil, err
+	}
+	return recipient.Encrypt(payload)
+}
+
+// EncryptHybridDeflate is EncryptHybrid with the payload compressed first
+func EncryptHybridDeflate(payload []byte, pkJWK jwk.Key, kemPub []byte) ([]byte, error) {
+	recipient, err := NewHybridRecipient(pkJWK, kemPub)
+	if err != nil {
+		return nil, err
+	}
+	return recipient.EncryptDeflate(payload)
+}
+
+// DecryptHybrid opens a hybrid envelope with the recipient's P-256 secret key
+func DecryptHybrid(envelope []byte, skJWK jwk.Key) ([]byte, error) {
+	if len(envelope) < hybridHeaderSize+hybridTagSize {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, "envelope is too short")
+	}
+	if envelope[0]&^EnvelopeFlagDeflate != HybridEnvelopeV1 {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, fmt.Sprintf("unsupported envelope version %d", envelope[0]))
+	}
+
+	priv, err := hybridPrivateKey(skJWK)
+	if err != nil {
+		return nil, err
+	}
+	ecdhKey, err := priv.ECDH()
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "invalid recipient secret key")
+	}
+
+	epk, err := ecdh.P256().NewPublicKey(envelope[1 : 1+hybridEPKSize])
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrEnvelopeFormat, "invalid ephemeral public key")
+	}
+	ssECDH, err := ecdhKey.ECDH(epk)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrDecryption, "ECDH failed")
+	}
+	defer clear(ssECDH)
+
+	kemSecretKey, _, err := KEMKeyPair(skJWK)
+	if err != nil {
+		return nil, err
+	}
+	defer clear(kemSecretKey)
+	ssKEM, err := internal.KEMDecapsulate(kemSecretKey, envelope[1+hybridEPKSize:hybridHeaderSize])
+	if err != nil {
+		return nil, err
+	}
+	defer clear(ssKEM)
+
+	header := envelope[:hybridHeaderSize]
+	sharedSecret := append(ssECDH[:len(ssECDH):len(ssECDH)], ssKEM...)
+	defer clear(sharedSecret)
+	aead, nonce, err := envelopeAEAD(hybridInfo, sharedSecret, header, ecdhKey.PublicKey().Bytes())
+	if err != nil {
+		return nil, err
+	}
+
+	internal.RecordGCMBlocks(len(envelope) - hybridHeaderSize - hybridTagSize)
+	payload, err := aead.Open(nil, nonce, envelope[hybridHeaderSize:], header)
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrDecryption, "envelope authentication failed")
+	}
+	if envelope[0]&EnvelopeFlagDeflate != 0 {
+		return Inflate(payload, MaxDecompressedSize)
+	}
+	return payload, nil
+}
+
+// IsHybridEnvelope reports whether data starts like a hybrid envelope rather than a compact JWE
+func IsHybridEnvelope(data []byte) bool {
+	return len(data) >= hybridHeaderSize+hybridTagSize && data[0]&^EnvelopeFlagDeflate == HybridEnvelopeV1
+}
+
+// GenerateKEMSeed returns a fresh random seed for a Kyber768 key pair
+func GenerateKEMSeed() ([]byte, error) {
+	seed := make([]byte, internal.KEMSeedSize)
+	if _, err := rand.Read(seed); err != nil {
+		return nil, internal.WrapError(internal.ErrKeyGeneration, "failed to generate KEM seed")
+	}
+	return seed, nil
+}
+
+// WithKEMSeed stores a Kyber768 seed in the P-256 secret key skJWK as KEMSeedParam and returns skJWK. jwk
+// copies private members into public keys, so take the public key of skJWK with PublicJWK, never with its
+// PublicKey method.
+func WithKEMSeed(skJWK jwk.Key, seed []byte) (jwk.Key, error) {
+	if skJWK == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "secret key cannot be nil")
+	}
+	if err := internal.ValidateKeyLength(seed, internal.KEMSeedSize, "KEM seed"); err != nil {
+		return nil, err
+	}
+	if err := skJWK.Set(KEMSeedParam, base64.RawURLEncoding.EncodeToString(seed)); err != nil {
+		return nil, internal.WrapError(internal.ErrJWKCreation, "failed to attach KEM seed")
+	}
+	return skJWK, nil
+}
+
+// PublicJWK returns the public key of key without KEMSeedParam, which jwk's PublicKey copies from a secret
+// key like any other private member
+func PublicJWK(key jwk.Key) (jwk.Key, error) {
+	if key == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "key cannot be nil")
+	}
+	pubKey, err := key.PublicKey()
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrJWKExtraction, "failed to extract public key")
+	}
+	if err := pubKey.Remove(KEMSeedParam); err != nil {
+		return nil, internal.WrapError(internal.ErrJWKCreation, "failed to remove KEM seed from public key")
+	}
+	return pubKey, nil
+}
+
+// KEMSeed returns the Kyber768 seed a secret key carries as KEMSeedParam
+func KEMSeed(skJWK jwk.Key) ([]byte, error) {
+	if skJWK == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "secret key cannot be nil")
+	}
+	value, ok := skJWK.Get(KEMSeedParam)
+	if !ok {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "secret key carries no KEM seed")
+	}
+	encoded, ok := value.(string)
+	if !ok {
+		return nil, internal.WrapError(internal.ErrInvalidKeyFormat, "KEM seed is not a string")
+	}
+	seed, err := base64.RawURLEncoding.DecodeString(encoded)
+	if err != nil || len(seed) != internal.KEMSeedSize {
+		return nil, internal.WrapError(internal.ErrInvalidKeyFormat, "invalid KEM seed")
+	}
+	return seed, nil
+}
+
+// KEMKeyPair returns the Kyber768 key pair of a hybrid recipient from the seed its secret key carries.
+// Recipients publish the public key next to their P-256 public key.
+func KEMKeyPair(skJWK jwk.Key) (secretKey, publicKey []byte, err error) {
+	seed, err := KEMSeed(skJWK)
+	if err != nil {
+		return nil, nil, err
+	}
+	defer clear(seed)
+	return internal.KEMKeyPair(seed)
+}
+
+// KEMKeyPairFromSeed returns the Kyber768 key pair generated from seed
+func KEMKeyPairFromSeed(seed []byte) (secretKey, publicKey []byte, err error) {
+	return internal.KEMKeyPair(seed)
+}
+
+// envelopeAEAD derives the content encryption key and nonce from the shared secret(s) of an envelope
+func envelopeAEAD(label string, ikm, header, recipientPub []byte) (cipher.AEAD, []byte, error) {
+	info := make([]byte, 0, len(label)+len(header)+len(recipientPub))
+	info = append(append(append(info, label...), header...), recipientPub...)
+
+	okm, err := internal.HKDF(nil, ikm, info, hybridKeySize+hybridNonceSize)
+	if err != nil {
+		return nil, nil, err
+	}
+
+	block, err := aes.NewCipher(okm[:hybridKeySize])
+	if err != nil {
+		return nil, nil, fmt.Errorf("failed to create cipher: %w", err)
+	}
+	aead, err := cipher.NewGCM(block)
+	if err != nil {
+		return nil, nil, fmt.Errorf("failed to create GCM: %w", err)
+	}
+	return aead, okm[hybridKeySize:], nil
+}
+
+// recipientECDHKey extracts the P-256 public key of an envelope recipient
+func recipientECDHKey(pkJWK jwk.Key) (*ecdh.PublicKey, error) {
+	if pkJWK == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "recipient public key cannot be nil")
+	}
+
+	var pub ecdsa.PublicKey
+	if err := pkJWK.Raw(&pub); err != nil {
+		var priv ecdsa.PrivateKey
+		if err := pkJWK.Raw(&priv); err != nil {
+			return nil, internal.WrapError(internal.ErrJWKExtraction, "failed to extract recipient public key")
+		}
+		pub = priv.PublicKey
+	}
+	if pub.Curve != elliptic.P256() {
+		return nil, internal.WrapError(internal.ErrCurveUnsupported, "recipient public key is not on P-256 curve")
+	}
+
+	ecdhKey, err := pub.ECDH()
+	if err != nil {
+		return nil, internal.WrapError(internal.ErrKeyNotOnCurve, "invalid recipient public key")
+	}
+	return ecdhKey, nil
+}
+
+func hybridPrivateKey(skJWK jwk.Key) (*ecdsa.PrivateKey, error) {
+	if skJWK == nil {
+		return nil, internal.WrapError(internal.ErrInvalidKey, "secret key cannot be nil")
+	}
+	var priv ecdsa.PrivateKey
+	if err := skJWK.Raw(&priv); err != nil {
+		return nil, internal.WrapError(internal.ErrJWKExtraction, "failed to extract secret key")
+	}
+	if priv.Curve != elliptic.P256() {
+		return nil, internal.WrapError(internal.ErrCurveUnsupported, "secret key is not on P-256 curve")
+	}
+	return &priv, nil
+}
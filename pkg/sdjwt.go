@@ -0,0 +1,375 @@
+package pkg
+
+import (
+	"bytes"
+	"crypto/rand"
+	"crypto/sha256"
+	"encoding/base64"
+	"encoding/json"
+	"fmt"
+	"sort"
+	"strconv"
+	"strings"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/lestrrat-go/jwx/v2/jwk"
+)
+
+// Selective disclosure (SD-JWT) replaces every disclosable claim of a payload by the digest of a
+// disclosure, the base64url encoded JSON array [salt, name, value] for object properties or
+// [salt, value] for array elements. Object property digests are collected in an "_sd" array of the
+// parent object; array elements are replaced by {"...": digest}. The SD-JWT is the issuer-signed
+// JWS followed by its disclosures, each terminated by '~'.
+//
+// Disclosable claims are named by JSON Pointers (RFC 6901), the same way builder.Element.Value refers
+// to payload fields. Nested pointers are processed deepest first, so a disclosable object may itself
+// contain disclosable claims. All salts of a build are drawn from the random source in one read. The
+// disclosures of each nesting level are base64url encoded back to back into one buffer, and each is
+// then hashed with its own SHA-256 call.
+
+const (
+	// SDAlgSHA256 is the "_sd_alg" value of disclosures hashed with SHA-256
+	SDAlgSHA256 = "sha-256"
+	// DefaultSDSaltSize is the salt size used when none is configured
+	DefaultSDSaltSize = 16
+
+	sdDigestsKey      = "_sd"
+	sdAlgKey          = "_sd_alg"
+	sdArrayDigestKey  = "..."
+	sdSeparator       = '~'
+	sdMinSaltSize     = 16
+	sdMaxSaltSize     = 32
+	sdEncodedHashSize = 43 // base64url length of a SHA-256 digest
+)
+
+// JWSSigner produces a compact JWS over a payload. MLDSASigner, EdDSASigner and ES256Signer of the
+// cvc package implement it.
+type JWSSigner interface {
+	SignJWS(payload []byte) ([]byte, error)
+}
+
+// SDJWTBuilder turns credential payloads into SD-JWT payloads with a fixed set of disclosable claims.
+// A builder is safe for concurrent use.
+type SDJWTBuilder struct {
+	paths    [][]string // decoded JSON Pointer tokens, deepest first
+	saltSize int
+}
+
+// SDPayload is a credential payload whose disclosable claims have been replaced by digests, together
+// with the disclosures that reveal them
+type SDPayload struct {
+	Payload     map[string]interface{}
+	Disclosures []string
+}
+
+// NewSDJWTBuilder prepares a builder for the given JSON Pointers. saltSize is the salt length in bytes,
+// between 16 and 32; 0 selects DefaultSDSaltSize.
+func NewSDJWTBuilder(pointers []string, saltSize int) (*SDJWTBuilder, error) {
+	if saltSize == 0 {
+		saltSize = DefaultSDSaltSize
+	}
+	if saltSize < sdMinSaltSize || saltSize > sdMaxSaltSize {
+		return nil, internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("salt size must be between %d and %d bytes", sdMinSaltSize, sdMaxSaltSize))
+	}
+
+	seen := make(map[string]bool, len(pointers))
+	paths := make([][]string, 0, len(pointers))
+	for _, pointer := range pointers {
+		if seen[pointer] {
+			continue
+		}
+		seen[pointer] = true
+
+		tokens, err := parseJSONPointer(pointer)
+		if err != nil {
+			return nil, err
+		}
+		switch tokens[0] {
+		case "cnf", sdDigestsKey, sdAlgKey:
+			return nil, internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("claim %q cannot be selectively disclosable", pointer))
+		}
+		paths = append(paths, tokens)
+	}
+
+	sort.SliceStable(paths, func(i, j int) bool { return len(paths[i]) > len(paths[j]) })
+	return &SDJWTBuilder{paths: paths, saltSize: saltSize}, nil
+}
+
+// Build returns the SD payload of a credential payload with cnfKey embedded as holder key. The input
+// payload is not modified.
+func (b *SDJWTBuilder) Build(payload map[string]interface{}, cnfKey jwk.Key) (*SDPayload, error) {
+	results, err := b.BuildBatch([]map[string]interface{}{payload}, []jwk.Key{cnfKey})
+	if err != nil {
+		return nil, err
+	}
+	return results[0], nil
+}
+
+// BuildBatch builds the SD payloads of several credentials at once, one holder key per payload. Salts
+// for the whole batch come from a single random read and each nesting level is hashed in one pass.
+func (b *SDJWTBuilder) BuildBatch(payloads []map[string]interface{}, cnfKeys []jwk.Key) ([]*SDPayload, error) {
+	if len(payloads) != len(cnfKeys) {
+		return nil, internal.WrapError(internal.ErrInvalidParameters, "every payload needs a holder key")
+	}
+
+	results := make([]*SDPayload, len(payloads))
+	for i, payload := range payloads {
+		if payload == nil {
+			return nil, internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("payload %d is nil", i))
+		}
+		copied := deepCopyJSON(payload).(map[string]interface{})
+		if err := AddKeyToPayload(copied, cnfKeys[i]); err != nil {
+			return nil, fmt.Errorf("failed to embed holder key in payload %d: %w", i, err)
+		}
+		copied[sdAlgKey] = SDAlgSHA256
+		results[i] = &SDPayload{Payload: copied, Disclosures: make([]string, 0, len(b.paths))}
+	}
+
+	salts := make([]byte, len(payloads)*len(b.paths)*b.saltSize)
+	if _, err := rand.Read(salts); err != nil {
+		return nil, internal.WrapError(internal.ErrInsufficientEntropy, "failed to generate disclosure salts")
+	}
+	defer clear(salts)
+
+	level := &sdLevel{}
+	for start := 0; start < len(b.paths); {
+		end := start
+		for end < len(b.paths) && len(b.paths[end]) == len(b.paths[start]) {
+			end++
+		}
+
+		level.reset()
+		for i, result := range results {
+			for p := start; p < end; p++ {
+				salt := salts[(i*len(b.paths)+p)*b.saltSize:][:b.saltSize]
+				if err := level.add(result, b.paths[p], salt); err != nil {
+					return nil, err
+				}
+			}
+		}
+		level.hash()
+		level.place()
+
+		start = end
+	}
+
+	return results, nil
+}
+
+// Issue signs the SD payload and returns the SD-JWT: the JWS followed by every disclosure, each
+// terminated by '~'
+func (p *SDPayload) Issue(signer JWSSigner) ([]byte, error) {
+	if signer == nil {
+		return nil, internal.WrapError(internal.ErrInvalidParameters, "signer cannot be nil")
+	}
+
+	payloadJSON, err := json.Marshal(p.Payload)
+	if err != nil {
+		return nil, fmt.Errorf("failed to encode SD-JWT payload: %w", err)
+	}
+	token, err := signer.SignJWS(payloadJSON)
+	if err != nil {
+		return nil, err
+	}
+
+	size := len(token) + 1
+	for _, disclosure := range p.Disclosures {
+		size += len(disclosure) + 1
+	}
+	sdJWT := make([]byte, 0, size)
+	sdJWT = append(append(sdJWT, token...), sdSeparator)
+	for _, disclosure := range p.Disclosures {
+		sdJWT = append(append(sdJWT, disclosure...), sdSeparator)
+	}
+	return sdJWT, nil
+}
+
+// sdLevel collects the disclosures of one nesting level. Their base64url encodings share one buffer,
+// which is reused together with the JSON encoder for every level of a build. The encoded salt, the
+// disclosure array, the disclosure string and the digest string are still allocated per claim.
+type sdLevel struct {
+	encoded []byte
+	pending []sdPending
+	raw     bytes.Buffer
+	encoder *json.Encoder
+}
+
+type sdPending struct {
+	result *SDPayload
+	start  int
+	end    int
+	digest string
+
+	// the claim is an object property when parent is set, an array element otherwise
+	parent map[string]interface{}
+	array  []interface{}
+	index  int
+}
+
+func (l *sdLevel) reset() {
+	l.encoded = l.encoded[:0]
+	l.pending = l.pending[:0]
+}
+
+// add removes the claim at path from the payload and encodes its disclosure
+func (l *sdLevel) add(result *SDPayload, path []string, salt []byte) error {
+	container, err := resolveParent(result.Payload, path)
+	if err != nil {
+		return err
+	}
+
+	encSalt := make([]byte, base64.RawURLEncoding.EncodedLen(len(salt)))
+	base64.RawURLEncoding.Encode(encSalt, salt)
+
+	pending := sdPending{result: result}
+	var disclosure []interface{}
+	name := path[len(path)-1]
+	switch parent := container.(type) {
+	case map[string]interface{}:
+		value, ok := parent[name]
+		if !ok {
+			return internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("claim %s not found in payload", formatJSONPointer(path)))
+		}
+		delete(parent, name)
+		pending.parent = parent
+		disclosure = []interface{}{string(encSalt), name, value}
+	case []interface{}:
+		index, err := arrayIndex(name, len(parent))
+		if err != nil {
+			return internal.WrapError(err, fmt.Sprintf("invalid array index in %s", formatJSONPointer(path)))
+		}
+		pending.array = parent
+		pending.index = index
+		disclosure = []interface{}{string(encSalt), parent[index]}
+	default:
+		return internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("parent of %s is not an object or array", formatJSONPointer(path)))
+	}
+
+	if l.encoder == nil {
+		l.encoder = json.NewEncoder(&l.raw)
+		l.encoder.SetEscapeHTML(false)
+	}
+	l.raw.Reset()
+	if err := l.encoder.Encode(disclosure); err != nil {
+		return fmt.Errorf("failed to encode disclosure for %s: %w", formatJSONPointer(path), err)
+	}
+	raw := bytes.TrimSuffix(l.raw.Bytes(), []byte{'\n'})
+
+	pending.start = len(l.encoded)
+	l.encoded = append(l.encoded, make([]byte, base64.RawURLEncoding.EncodedLen(len(raw)))...)
+	base64.RawURLEncoding.Encode(l.encoded[pending.start:], raw)
+	pending.end = len(l.encoded)
+
+	l.pending = append(l.pending, pending)
+	return nil
+}
+
+// hash computes the digest of each disclosure of the level with one SHA-256 call per disclosure
+func (l *sdLevel) hash() {
+	var encoded [sdEncodedHashSize]byte
+	for i := range l.pending {
+		pending := &l.pending[i]
+		sum := sha256.Sum256(l.encoded[pending.start:pending.end])
+		base64.RawURLEncoding.Encode(encoded[:], sum[:])
+		pending.digest = string(encoded[:])
+	}
+}
+
+// place records the disclosures and puts their digests where the claims were. The "_sd" arrays are
+// sorted before the next level encodes the objects holding them, so that the order of the digests does
+// not reveal the order of the claims.
+func (l *sdLevel) place() {
+	var touched []map[string]interface{}
+	for _, pending := range l.pending {
+		pending.result.Disclosures = append(pending.result.Disclosures, string(l.encoded[pending.start:pending.end]))
+		if pending.parent == nil {
+			pending.array[pending.index] = map[string]interface{}{sdArrayDigestKey: pending.digest}
+			continue
+		}
+
+		digests, ok := pending.parent[sdDigestsKey].([]interface{})
+		if !ok {
+			touched = append(touched, pending.parent)
+		}
+		pending.parent[sdDigestsKey] = append(digests, pending.digest)
+	}
+
+	for _, object := range touched {
+		digests := object[sdDigestsKey].([]interface{})
+		sort.Slice(digests, func(i, j int) bool { return digests[i].(string) < digests[j].(string) })
+	}
+}
+
+// resolveParent returns the object or array that holds the claim at path
+func resolveParent(payload map[string]interface{}, path []string) (interface{}, error) {
+	var current interface{} = payload
+	for depth, token := range path[:len(path)-1] {
+		switch node := current.(type) {
+		case map[string]interface{}:
+			next, ok := node[token]
+			if !ok {
+				return nil, internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("claim %s not found in payload", formatJSONPointer(path[:depth+1])))
+			}
+			current = next
+		case []interface{}:
+			index, err := arrayIndex(token, len(node))
+			if err != nil {
+				return nil, internal.WrapError(err, fmt.Sprintf("invalid array index in %s", formatJSONPointer(path[:depth+1])))
+			}
+			current = node[index]
+		default:
+			return nil, internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("claim %s is not an object or array", formatJSONPointer(path[:depth])))
+		}
+	}
+	return current, nil
+}
+
+func arrayIndex(token string, length int) (int, error) {
+	index, err := strconv.Atoi(token)
+	if err != nil || index < 0 || index >= length || (len(token) > 1 && token[0] == '0') {
+		return 0, internal.ErrInvalidParameters
+	}
+	return index, nil
+}
+
+// parseJSONPointer splits an RFC 6901 JSON Pointer into its unescaped reference tokens
+func parseJSONPointer(pointer string) ([]string, error) {
+	if len(pointer) < 2 || pointer[0] != '/' {
+		return nil, internal.WrapError(internal.ErrInvalidParameters, fmt.Sprintf("invalid JSON Pointer %q", pointer))
+	}
+	tokens := strings.Split(pointer[1:], "/")
+	for i, token := range tokens {
+		tokens[i] = strings.ReplaceAll(strings.ReplaceAll(token, "~1", "/"), "~0", "~")
+	}
+	return tokens, nil
+}
+
+func formatJSONPointer(tokens []string) string {
+	var sb strings.Builder
+	for _, token := range tokens {
+		sb.WriteByte('/')
+		sb.WriteString(strings.ReplaceAll(strings.ReplaceAll(token, "~", "~0"), "/", "~1"))
+	}
+	return sb.String()
+}
+
+// deepCopyJSON copies the objects and arrays of a decoded JSON value, so that disclosing claims does
+// not modify the caller's payload
+func deepCopyJSON(value interface{}) interface{} {
+	switch v := value.(type) {
+	case map[string]interface{}:
+		copied := make(map[string]interface{}, len(v))
+		for key, item := range v {
+			copied[key] = deepCopyJSON(item)
+		}
+		return copied
+	case []interface{}:
+		copied := make([]interface{}, len(v))
+		for i, item := range v {
+			copied[i] = deepCopyJSON(item)
+		}
+		return copied
+	default:
+		return v
+	}
+}
@@ -77,8 +77,16 @@ func ValidatePublicKey(curve elliptic.Curve, xBig, yBig *big.Int) error {
 		return fmt.Errorf("unsupported curve for ecdh validation")
 	}
 
-	// Marshal the point to uncompressed format
-	pointBytes := elliptic.Marshal(curve, xBig, yBig)
+	// Encode the point in uncompressed format. elliptic.Marshal panics for points that are not on the
+	// curve, so the encoding is done by hand and the check is left to ecdh.
+	byteLen := (curve.Params().BitSize + 7) / 8
+	if xBig.Sign() < 0 || yBig.Sign() < 0 || xBig.BitLen() > 8*byteLen || yBig.BitLen() > 8*byteLen {
+		return fmt.Errorf("invalid public key point: coordinates out of range")
+	}
+	pointBytes := make([]byte, 1+2*byteLen)
+	pointBytes[0] = 4
+	xBig.FillBytes(pointBytes[1 : 1+byteLen])
+	yBig.FillBytes(pointBytes[1+byteLen:])
 
 	// Try to create an ecdh.PublicKey - this performs all necessary validation
 	_, err := ecdhCurve.NewPublicKey(pointBytes)
@@ -104,11 +112,35 @@ func EncryptWithPublicKey(payload []byte, pkJWK jwk.Key) ([]byte, error) {
 	return encrypted, nil
 }
 
+// EncryptWithPublicKeyDeflate encrypts like EncryptWithPublicKey, but compresses the payload first and marks
+// the JWE with "zip":"DEF"
+func EncryptWithPublicKeyDeflate(payload []byte, pkJWK jwk.Key) ([]byte, error) {
+	encrypted, err := jwe.Encrypt(
+		payload,
+		jwe.WithKey(jwa.ECDH_ES, pkJWK),
+		jwe.WithContentEncryption(jwa.A256GCM),
+		jwe.WithCompress(jwa.Deflate),
+	)
+
+	if err != nil {
+		return nil, fmt.Errorf("failed to encrypt with JWE: %w", err)
+	}
+
+	return encrypted, nil
+}
+
 func DecryptWithSecretKey(payload []byte, skJWK jwk.Key) ([]byte, error) {
+	return DecryptWithSecretKeyLimit(payload, skJWK, MaxDecompressedSize)
+}
+
+// DecryptWithSecretKeyLimit decrypts a JWE like DecryptWithSecretKey, failing when a compressed payload
+// inflates to more than maxSize bytes
+func DecryptWithSecretKeyLimit(payload []byte, skJWK jwk.Key, maxSize int64) ([]byte, error) {
 	// perform JWE decryption with ECDH-ES
 	decrypted, err := jwe.Decrypt(
 		payload,
 		jwe.WithKey(jwa.ECDH_ES, skJWK),
+		jwe.WithMaxDecompressBufferSize(maxSize),
 	)
 	if err != nil {
 		return nil, fmt.Errorf("failed to encrypt with JWE: %w", err)
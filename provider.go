@@ -1,10 +1,13 @@
 package cvc
 
 import (
+	"context"
+	"crypto/rand"
 	"encoding/base64"
 	"encoding/json"
 	"fmt"
 
+	"github.com/MyNextID/cvc-go/internal"
 	"github.com/MyNextID/cvc-go/pkg"
 	"github.com/lestrrat-go/jwx/v2/jwk"
 )
@@ -12,9 +15,71 @@ import (
 type ProviderConfig struct {
 	MasterSecretKey jwk.Key
 	Dst             string
+
+	// ChainCode enables additive derivation (see AdditiveMasterKey) for the issuers listed in
+	// AdditiveIssuers. Keys whose ID carries the AdditiveKeyIDPrefix are derived as issuer master + tweak
+	// instead of with DeriveSecretKey; additive key IDs of other issuers are rejected.
+	ChainCode       []byte
+	AdditiveIssuers []string
+
+	// HybridKEM makes GeneratePublicKeys and GenerateSinglePublicKey also return the Kyber768 public key
+	// belonging to each derived key, so issuers can use hybrid envelopes (see pkg.EncryptHybrid), and makes
+	// GenerateSecretKey attach the matching seed (pkg.KEMSeedParam). It cannot be combined with additive
+	// derivation, whose issuers compute keys without asking for a KEM public key.
+	HybridKEM bool
+
+	// KEMMasterSeed is the secret the Kyber768 keys are derived from in hybrid mode. It must be independent
+	// of MasterSecretKey, so that breaking the P-256 keys does not reveal the Kyber768 keys.
+	KEMMasterSeed []byte
+}
+
+// kemSeedInfo separates the Kyber768 seeds of derived keys from other uses of the KEM master seed
+const kemSeedInfo = "cvc-hybrid-v1 kem seed"
+
+// GenerateKEMMasterSeed generates a random KEMMasterSeed
+func GenerateKEMMasterSeed() ([]byte, error) {
+	seed := make([]byte, internal.KeySize)
+	if _, err := rand.Read(seed); err != nil {
+		return nil, internal.WrapError(internal.ErrKeyGeneration, "failed to generate KEM master seed")
+	}
+	return seed, nil
+}
+
+// kemSeed derives the Kyber768 seed of the key with the given key context from KEMMasterSeed
+func (c *ProviderConfig) kemSeed(keyContext []byte) ([]byte, error) {
+	if len(c.KEMMasterSeed) < internal.KeySize {
+		return nil, internal.WrapError(internal.ErrInvalidParameters, "KEM master seed not set")
+	}
+	info := append([]byte(kemSeedInfo), keyContext...)
+	return internal.HKDF(nil, c.KEMMasterSeed, info, internal.KEMSeedSize)
+}
+
+// kemPublicKey returns the Kyber768 public key for the key with the given key context, or nil if HybridKEM
+// is disabled
+func (c *ProviderConfig) kemPublicKey(keyContext []byte) ([]byte, error) {
+	if !c.HybridKEM {
+		return nil, nil
+	}
+	seed, err := c.kemSeed(keyContext)
+	if err != nil {
+		return nil, err
+	}
+	defer clear(seed)
+	_, kemPubKey, err := pkg.KEMKeyPairFromSeed(seed)
+	if err != nil {
+		return nil, fmt.Errorf("failed to derive KEM public key %w", err)
+	}
+	return kemPubKey, nil
 }
 
 func (c *ProviderConfig) GeneratePublicKeys(requestJson []byte) ([]byte, error) {
+	return c.GeneratePublicKeysContext(context.Background(), requestJson)
+}
+
+// GeneratePublicKeysContext is GeneratePublicKeys that stops deriving when ctx is done and returns
+// ctx.Err(). Wallet provider handlers should pass the request context, so that keys are not derived for
+// clients that have gone away.
+func (c *ProviderConfig) GeneratePublicKeysContext(ctx context.Context, requestJson []byte) ([]byte, error) {
 	// unmarshal request
 	var hashSlices []string
 	err := json.Unmarshal(requestJson, &hashSlices)
@@ -24,36 +89,68 @@ func (c *ProviderConfig) GeneratePublicKeys(requestJson []byte) ([]byte, error)
 
 	// prepare return item
 	keyMap := make(map[string]KeyData)
+	if len(hashSlices) == 0 {
+		return json.Marshal(keyMap)
+	}
 
-	// Loop through the slice and fill the map
-	for _, hash := range hashSlices {
-		// generate key id
-		keyID := pkg.GenerateUUID()
+	if c.MasterSecretKey == nil {
+		return nil, internal.ErrMasterKeyNotSet
+	}
 
-		// combine with hash
-		context := append([]byte(keyID), hash...)
+	// the master encoding and the derived secret keys only live in the arena, which is wiped on return
+	arena, err := NewKeyArena(len(hashSlices))
+	if err != nil {
+		return nil, fmt.Errorf("failed to create key arena %w", err)
+	}
+	defer arena.Close()
+	if err := arena.setMaster(c.MasterSecretKey); err != nil {
+		return nil, fmt.Errorf("failed to marshal master key %w", err)
+	}
 
-		dstByte := []byte(c.Dst)
+	dstByte := []byte(c.Dst)
+	var keyContext []byte
+	keyIDs := make([]string, len(hashSlices))
 
-		// derive public key
-		derivedSecretKey, err := DeriveSecretKey(c.MasterSecretKey, context, dstByte)
-		if err != nil {
-			return nil, fmt.Errorf("failed to derive secret key %s", err)
+	// Derive the keys chunk by chunk and fill the map
+	for start := 0; start < len(hashSlices); start += deriveChunkSize {
+		end := start + deriveChunkSize
+		if end > len(hashSlices) {
+			end = len(hashSlices)
 		}
 
-		derivedPublicKey, err := derivedSecretKey.PublicKey()
-		if err != nil {
-			return nil, fmt.Errorf("failed to get public key %s", err)
-		}
+		// large requests derive on the bulk executor, so they do not hold up interactive callers
+		err := runBulk(ctx, len(hashSlices), func() error {
+			for i := start; i < end; i++ {
+				// generate key id and combine with hash
+				keyIDs[i] = pkg.GenerateUUID()
+				keyContext = append(append(keyContext[:0], keyIDs[i]...), hashSlices[i]...)
 
-		// convert to json bytes
-		pubKeyBytes, err := pkg.KeyJWKToJson(derivedPublicKey)
+				// derive public key
+				if _, err := arena.arena.DeriveFromMaster(keyContext, dstByte); err != nil {
+					return fmt.Errorf("failed to derive secret key %s", err)
+				}
+			}
+			return nil
+		})
 		if err != nil {
-			return nil, fmt.Errorf("failed to marshal jwk to json bytes %w", err)
+			return nil, err
 		}
 
-		// make entry into map
-		keyMap[hash] = KeyData{KeyID: keyID, WpPubkey: pubKeyBytes}
+		for i := start; i < end; i++ {
+			// the public JWK is written as JSON straight from the arena
+			pubKeyBytes, err := arena.AppendPublicKeyJSON(nil, i)
+			if err != nil {
+				return nil, fmt.Errorf("failed to get public key %s", err)
+			}
+
+			kemPubKey, err := c.kemPublicKey(append([]byte(keyIDs[i]), hashSlices[i]...))
+			if err != nil {
+				return nil, err
+			}
+
+			// make entry into map
+			keyMap[hashSlices[i]] = KeyData{KeyID: keyIDs[i], WpPubkey: pubKeyBytes, WpKemPubkey: kemPubKey}
+		}
 	}
 
 	// marshal for transport over http
@@ -90,7 +187,7 @@ func (c *ProviderConfig) GenerateSinglePublicKey(requestJson []byte) ([]byte, er
 		return nil, fmt.Errorf("failed to derive secret key %s", err)
 	}
 
-	derivedPublicKey, err := derivedSecretKey.PublicKey()
+	derivedPublicKey, err := pkg.PublicJWK(derivedSecretKey)
 	if err != nil {
 		return nil, fmt.Errorf("failed to get public key %s", err)
 	}
@@ -101,8 +198,13 @@ func (c *ProviderConfig) GenerateSinglePublicKey(requestJson []byte) ([]byte, er
 		return nil, fmt.Errorf("failed to marshal jwk to json bytes %w", err)
 	}
 
+	kemPubKey, err := c.kemPublicKey(context)
+	if err != nil {
+		return nil, err
+	}
+
 	// make entry into map
-	keyMap[hash] = KeyData{KeyID: keyID, WpPubkey: pubKeyBytes}
+	keyMap[hash] = KeyData{KeyID: keyID, WpPubkey: pubKeyBytes, WpKemPubkey: kemPubKey}
 
 	// marshal for transport over http
 	keyMapBytes, err := json.Marshal(keyMap)
@@ -121,13 +223,38 @@ func (c *ProviderConfig) GenerateSecretKey(requestJson []byte, dst string) ([]by
 		return nil, fmt.Errorf("failed to unmarshal request %s", err)
 	}
 
+	derivedSecretKey, err := c.deriveWalletSecretKey(&keyData, dst)
+	if err != nil {
+		return nil, err
+	}
+
+	// convert to json bytes
+	secKeyBytes, err := pkg.KeyJWKToJson(derivedSecretKey)
+	if err != nil {
+		return nil, fmt.Errorf("failed to marshal jwk to json bytes %w", err)
+	}
+
+	return secKeyBytes, nil
+}
+
+// ResolveSecretKey derives the wallet provider secret key of a message pack. It is a SecretKeyResolver
+// for wallets that run next to their provider, and skips the JSON encoding of GenerateSecretKey.
+func (c *ProviderConfig) ResolveSecretKey(ctx context.Context, msgPack *MessagePack) (jwk.Key, error) {
+	if err := ctx.Err(); err != nil {
+		return nil, err
+	}
+	return c.deriveWalletSecretKey(&SecretKeyData{KeyId: msgPack.KeyId, Salt: msgPack.Salt, Email: msgPack.Email}, "")
+}
+
+// deriveWalletSecretKey derives the secret key belonging to a key ID, email and salt
+func (c *ProviderConfig) deriveWalletSecretKey(keyData *SecretKeyData, dst string) (jwk.Key, error) {
 	// generate hash part of the key (in the same way as the issuer does)
 	data := append([]byte(keyData.Email), keyData.Salt...)
 	hashed := pkg.Hash(data)
 	base64Hash := base64.StdEncoding.EncodeToString(hashed)
 
 	// combine hash with keyId
-	context := append([]byte(keyData.KeyId), base64Hash...)
+	keyContext := append([]byte(keyData.KeyId), base64Hash...)
 
 	// get domain separation tag from config if empty
 	if dst == "" {
@@ -136,16 +263,31 @@ func (c *ProviderConfig) GenerateSecretKey(requestJson []byte, dst string) ([]by
 	dstByte := []byte(dst)
 
 	// derive the secret key
-	derivedSecretKey, err := DeriveSecretKey(c.MasterSecretKey, context, dstByte)
-	if err != nil {
-		return nil, fmt.Errorf("failed to derive secret key %s", err)
+	var derivedSecretKey jwk.Key
+	var err error
+	if IsAdditiveKeyID(keyData.KeyId) {
+		// the issuer computed the public key locally from its additive master key
+		derivedSecretKey, err = c.DeriveAdditiveSecretKey(keyData.KeyId, keyContext, dst)
+		if err != nil {
+			return nil, fmt.Errorf("failed to derive secret key %w", err)
+		}
+	} else {
+		derivedSecretKey, err = DeriveSecretKey(c.MasterSecretKey, keyContext, dstByte)
+		if err != nil {
+			return nil, fmt.Errorf("failed to derive secret key %s", err)
+		}
 	}
 
-	// convert to json bytes
-	secKeyBytes, err := pkg.KeyJWKToJson(derivedSecretKey)
-	if err != nil {
-		return nil, fmt.Errorf("failed to marshal jwk to json bytes %w", err)
+	// hybrid recipients also need the seed of their Kyber768 key
+	if c.HybridKEM {
+		seed, err := c.kemSeed(keyContext)
+		if err != nil {
+			return nil, err
+		}
+		if _, err := pkg.WithKEMSeed(derivedSecretKey, seed); err != nil {
+			return nil, err
+		}
 	}
 
-	return secKeyBytes, nil
+	return derivedSecretKey, nil
 }
@@ -0,0 +1,350 @@
+package cvc
+
+import (
+	"bytes"
+	"context"
+	"errors"
+	"fmt"
+	"io"
+	"math/rand"
+	"net/http"
+	"path"
+	"sort"
+	"sync"
+	"time"
+)
+
+const (
+	// latencyWindowSize is the number of recent successful attempt latencies kept for hedge delay estimation
+	latencyWindowSize = 128
+	// latencyMinSamples is the number of samples required before the observed quantile replaces HedgeDelay
+	latencyMinSamples = 16
+)
+
+// RequestPolicy controls timeouts, retries and hedging of calls to the wallet provider.
+//
+// /generate/pub-key is not idempotent: every request derives and issues new keys, so each repeated or
+// duplicated request costs the wallet provider a full batch of derivations. Hedging and per-attempt
+// timeouts are therefore opt-in.
+type RequestPolicy struct {
+	// AttemptTimeout bounds a single HTTP attempt, including reading the response body. It must leave
+	// room for the largest batch (see BatchSize). Zero means no per-attempt timeout; the context passed
+	// to the call still bounds the whole request.
+	AttemptTimeout time.Duration
+
+	// MaxAttempts is the number of attempts (including the first one) made before giving up.
+	// Values below 1 are treated as 1.
+	MaxAttempts int
+
+	// BaseBackoff and MaxBackoff bound the jittered exponential backoff between attempts.
+	BaseBackoff time.Duration
+	MaxBackoff  time.Duration
+
+	// MaxHedges is the number of duplicate requests that may be started while an attempt is still
+	// in flight. Zero disables hedging. Each hedge makes the wallet provider derive the batch again.
+	MaxHedges int
+
+	// HedgeDelay is the delay before a hedged duplicate is sent until enough latency samples have
+	// been observed. Afterwards the delay follows the HedgeQuantile of the issuer's recent attempt
+	// latencies.
+	HedgeDelay time.Duration
+
+	// HedgeQuantile is the latency quantile used as hedge delay (for example 0.95 for p95).
+	HedgeQuantile float64
+
+	// BatchSize splits large key requests into batches of at most this many hashes, each of which is
+	// retried and hedged independently. Zero sends all hashes in a single request.
+	BatchSize int
+
+	// MaxConcurrentBatches limits how many batches are in flight at once. Values below 1 are treated as 1.
+	MaxConcurrentBatches int
+}
+
+// NewRequestPolicy returns a RequestPolicy with defaults suitable for most wallet provider deployments:
+// failed requests are retried, but requests are neither hedged nor bounded by a per-attempt timeout
+func NewRequestPolicy() *RequestPolicy {
+	return &RequestPolicy{
+		AttemptTimeout:       0,
+		MaxAttempts:          3,
+		BaseBackoff:          100 * time.Millisecond,
+		MaxBackoff:           2 * time.Second,
+		MaxHedges:            0,
+		HedgeDelay:           500 * time.Millisecond,
+		HedgeQuantile:        0.95,
+		BatchSize:            0,
+		MaxConcurrentBatches: 4,
+	}
+}
+
+// defaultRequestPolicy is used by issuers that do not configure a RequestPolicy
+var defaultRequestPolicy = NewRequestPolicy()
+
+// retryableError marks failures that may succeed when the request is repeated
+type retryableError struct {
+	err error
+}
+
+func (e *retryableError) Error() string { return e.err.Error() }
+func (e *retryableError) Unwrap() error { return e.err }
+
+func isRetryable(err error) bool {
+	var re *retryableError
+	return errors.As(err, &re)
+}
+
+// latencyWindow keeps a ring of recent successful attempt latencies. Every IssuerConfig has its own, so
+// issuers talking to different wallet providers do not share hedge delays.
+type latencyWindow struct {
+	mu      sync.Mutex
+	samples [latencyWindowSize]time.Duration
+	next    int
+	count   int
+}
+
+// latencyInit guards the lazy creation of the latency window of every IssuerConfig. A per-config
+// sync.Once would make IssuerConfig unsafe to copy.
+var latencyInit sync.Mutex
+
+// latencyWindow returns the latency window of the issuer, creating it on first use
+func (c *IssuerConfig) latencyWindow() *latencyWindow {
+	latencyInit.Lock()
+	defer latencyInit.Unlock()
+	if c.latency == nil {
+		c.latency = new(latencyWindow)
+	}
+	return c.latency
+}
+
+func (w *latencyWindow) observe(d time.Duration) {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	w.samples[w.next] = d
+	w.next = (w.next + 1) % latencyWindowSize
+	if w.count < latencyWindowSize {
+		w.count++
+	}
+}
+
+// quantile returns the q-quantile of the observed latencies, or false if there are too few samples
+func (w *latencyWindow) quantile(q float64) (time.Duration, bool) {
+	w.mu.Lock()
+	if w.count < latencyMinSamples {
+		w.mu.Unlock()
+		return 0, false
+	}
+	sorted := make([]time.Duration, w.count)
+	copy(sorted, w.samples[:w.count])
+	w.mu.Unlock()
+
+	sort.Slice(sorted, func(i, j int) bool { return sorted[i] < sorted[j] })
+	idx := int(q * float64(len(sorted)-1))
+	if idx < 0 {
+		idx = 0
+	}
+	if idx >= len(sorted) {
+		idx = len(sorted) - 1
+	}
+	return sorted[idx], true
+}
+
+// hedgeDelay returns the delay after which a hedged duplicate request is started
+func (p *RequestPolicy) hedgeDelay(latency *latencyWindow) time.Duration {
+	if d, ok := latency.quantile(p.HedgeQuantile); ok {
+		return d
+	}
+	return p.HedgeDelay
+}
+
+// backoff returns the full-jitter backoff before the given retry (1-based)
+func (p *RequestPolicy) backoff(retry int) time.Duration {
+	if p.BaseBackoff <= 0 {
+		return 0
+	}
+	shift := retry - 1
+	if shift > 30 {
+		shift = 30
+	}
+	ceiling := p.BaseBackoff << uint(shift)
+	if ceiling <= 0 || (p.MaxBackoff > 0 && ceiling > p.MaxBackoff) {
+		ceiling = p.MaxBackoff
+	}
+	return time.Duration(rand.Int63n(int64(ceiling) + 1))
+}
+
+func (c *IssuerConfig) requestPolicy() *RequestPolicy {
+	if c.RequestPolicy != nil {
+		return c.RequestPolicy
+	}
+	return defaultRequestPolicy
+}
+
+func (c *IssuerConfig) httpClient() *http.Client {
+	if c.HTTPClient != nil {
+		return c.HTTPClient
+	}
+	return http.DefaultClient
+}
+
+// postWithPolicy sends body to the given wallet provider endpoint, retrying and hedging according to
+// the issuer's RequestPolicy, and passes the body of the first successful response to consume.
+// Errors returned by consume are retried only if they are marked retryable, so consume must tolerate
+// seeing the beginning of a response again after a retry.
+func (c *IssuerConfig) postWithPolicy(ctx context.Context, endpoint string, body []byte, consume func(io.Reader) error) error {
+	policy := c.requestPolicy()
+	url := c.ProviderURL + path.Join("/", endpoint)
+
+	attempts := policy.MaxAttempts
+	if attempts < 1 {
+		attempts = 1
+	}
+
+	var lastErr error
+	for attempt := 1; attempt <= attempts; attempt++ {
+		if attempt > 1 {
+			timer := time.NewTimer(policy.backoff(attempt - 1))
+			select {
+			case <-ctx.Done():
+				timer.Stop()
+				return ctx.Err()
+			case <-timer.C:
+			}
+		}
+
+		err := c.hedgedPost(ctx, policy, url, body, consume)
+		if err == nil {
+			return nil
+		}
+		lastErr = err
+		if !isRetryable(err) || ctx.Err() != nil {
+			break
+		}
+	}
+
+	return lastErr
+}
+
+// attemptResult is the outcome of a single HTTP exchange that has received its response headers
+type attemptResult struct {
+	index  int
+	resp   *http.Response
+	cancel context.CancelFunc
+	err    error
+}
+
+// hedgedPost runs one attempt, starting up to MaxHedges duplicate requests while it is outstanding.
+// The first response with status 200 wins, the remaining requests are cancelled, and the winning
+// body is passed to consume.
+func (c *IssuerConfig) hedgedPost(ctx context.Context, policy *RequestPolicy, url string, body []byte, consume func(io.Reader) error) error {
+	results := make(chan attemptResult, policy.MaxHedges+1)
+	var cancels []context.CancelFunc
+	launch := func() {
+		attemptCtx, cancel := context.WithCancel(ctx)
+		index := len(cancels)
+		cancels = append(cancels, cancel)
+		go func() {
+			res := c.startAttempt(attemptCtx, policy, url, body)
+			res.index = index
+			results <- res
+		}()
+	}
+
+	latency := c.latencyWindow()
+	launch()
+	launched, received := 1, 0
+
+	var hedgeTimer <-chan time.Time
+	if policy.MaxHedges > 0 {
+		timer := time.NewTimer(policy.hedgeDelay(latency))
+		defer timer.Stop()
+		hedgeTimer = timer.C
+	}
+
+	var winner *attemptResult
+	var lastErr error
+	for received < launched && winner == nil {
+		select {
+		case res := <-results:
+			received++
+			if res.err == nil {
+				winner = &res
+				break
+			}
+			lastErr = res.err
+		case <-hedgeTimer:
+			hedgeTimer = nil
+			if launched <= policy.MaxHedges {
+				launch()
+				launched++
+				if launched <= policy.MaxHedges {
+					timer := time.NewTimer(policy.hedgeDelay(latency))
+					defer timer.Stop()
+					hedgeTimer = timer.C
+				}
+			}
+		}
+		if lastErr != nil && !isRetryable(lastErr) {
+			break
+		}
+	}
+
+	// Cancel the losing attempts, then wait for every one still outstanding and release its response,
+	// so that no connection is left open behind the returned result
+	for i, cancel := range cancels {
+		if winner == nil || i != winner.index {
+			cancel()
+		}
+	}
+	for ; received < launched; received++ {
+		if res := <-results; res.resp != nil {
+			res.resp.Body.Close()
+			res.cancel()
+		}
+	}
+
+	if winner == nil {
+		return lastErr
+	}
+
+	defer cancels[winner.index]()
+	defer winner.cancel()
+	defer winner.resp.Body.Close()
+	return consume(winner.resp.Body)
+}
+
+// startAttempt sends a single HTTP POST and waits for its response headers. A successful result
+// holds the open response, which stays bounded by the policy's AttemptTimeout until its cancel
+// function is called.
+func (c *IssuerConfig) startAttempt(ctx context.Context, policy *RequestPolicy, url string, body []byte) attemptResult {
+	cancel := context.CancelFunc(func() {})
+	if policy.AttemptTimeout > 0 {
+		ctx, cancel = context.WithTimeout(ctx, policy.AttemptTimeout)
+	}
+
+	req, err := http.NewRequestWithContext(ctx, http.MethodPost, url, bytes.NewReader(body))
+	if err != nil {
+		cancel()
+		return attemptResult{err: fmt.Errorf("failed to create HTTP request: %w", err)}
+	}
+	req.Header.Set("Content-Type", "application/json")
+
+	start := time.Now()
+	resp, err := c.httpClient().Do(req)
+	if err != nil {
+		cancel()
+		return attemptResult{err: &retryableError{err: fmt.Errorf("failed to get response from wp: %w", err)}}
+	}
+
+	if resp.StatusCode != http.StatusOK {
+		bodyBytes, _ := io.ReadAll(io.LimitReader(resp.Body, 4096))
+		resp.Body.Close()
+		cancel()
+		err := fmt.Errorf("non-OK HTTP status: %d. Body: %s", resp.StatusCode, string(bodyBytes))
+		if resp.StatusCode == http.StatusTooManyRequests || resp.StatusCode >= 500 {
+			return attemptResult{err: &retryableError{err: err}}
+		}
+		return attemptResult{err: err}
+	}
+
+	c.latencyWindow().observe(time.Since(start))
+	return attemptResult{resp: resp, cancel: cancel}
+}
@@ -0,0 +1,400 @@
+package cvc
+
+import (
+	"encoding/json"
+	"fmt"
+	"io"
+	"net/http"
+	"net/http/httptest"
+	"strings"
+	"sync/atomic"
+	"testing"
+	"time"
+)
+
+// newTestProvider starts an httptest wallet provider backed by ProviderConfig.GeneratePublicKeys.
+// The handler hook is called with the 1-based request number before the response is produced and
+// can delay or fail the request by returning a non-zero status code.
+func newTestProvider(t *testing.T, hook func(n int64) int) (*httptest.Server, *int64) {
+	t.Helper()
+
+	masterKey, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate master key: %v", err)
+	}
+	provider := &ProviderConfig{MasterSecretKey: masterKey, Dst: "CVC-TEST-DST-v1.0"}
+
+	var requests int64
+	server := httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+		n := atomic.AddInt64(&requests, 1)
+		if hook != nil {
+			if status := hook(n); status != 0 {
+				w.WriteHeader(status)
+				return
+			}
+		}
+		body, err := io.ReadAll(r.Body)
+		if err != nil {
+			w.WriteHeader(http.StatusBadRequest)
+			return
+		}
+		resp, err := provider.GeneratePublicKeys(body)
+		if err != nil {
+			w.WriteHeader(http.StatusInternalServerError)
+			return
+		}
+		w.Header().Set("Content-Type", "application/json")
+		w.Write(resp)
+	}))
+	t.Cleanup(server.Close)
+
+	return server, &requests
+}
+
+func testEmailMap(n int) map[string]string {
+	emails := make(map[string]string, n)
+	for i := 0; i < n; i++ {
+		emails[fmt.Sprintf("user-%d", i)] = fmt.Sprintf("user-%d@example.com", i)
+	}
+	return emails
+}
+
+func TestProviderRequestPolicy(t *testing.T) {
+	t.Run("RetriesServerErrors", func(t *testing.T) {
+		server, requests := newTestProvider(t, func(n int64) int {
+			if n < 3 {
+				return http.StatusServiceUnavailable
+			}
+			return 0
+		})
+
+		policy := NewRequestPolicy()
+		policy.MaxHedges = 0
+		policy.BaseBackoff = time.Millisecond
+		issuer := &IssuerConfig{ProviderURL: server.URL, RequestPolicy: policy}
+
+		userMap, err := issuer.GetPublicKeysFromWalletProvider(testEmailMap(3))
+		if err != nil {
+			t.Fatalf("GetPublicKeysFromWalletProvider failed: %v", err)
+		}
+		for uuid, userData := range userMap {
+			if userData.WpPubKey == nil || userData.KeyID == "" {
+				t.Errorf("Missing key data for user %s", uuid)
+			}
+		}
+		if got := atomic.LoadInt64(requests); got != 3 {
+			t.Errorf("Expected 3 requests, got %d", got)
+		}
+	})
+
+	t.Run("DoesNotRetryClientErrors", func(t *testing.T) {
+		server, requests := newTestProvider(t, func(n int64) int {
+			return http.StatusBadRequest
+		})
+
+		policy := NewRequestPolicy()
+		policy.BaseBackoff = time.Millisecond
+		issuer := &IssuerConfig{ProviderURL: server.URL, RequestPolicy: policy}
+
+		if _, err := issuer.GetPublicKeysFromWalletProvider(testEmailMap(1)); err == nil {
+			t.Fatalf("Expected error for client error response")
+		}
+		if got := atomic.LoadInt64(requests); got != 1 {
+			t.Errorf("Expected 1 request, got %d", got)
+		}
+	})
+
+	t.Run("AttemptTimeout", func(t *testing.T) {
+		server, _ := newTestProvider(t, func(n int64) int {
+			if n == 1 {
+				time.Sleep(500 * time.Millisecond)
+			}
+			return 0
+		})
+
+		policy := NewRequestPolicy()
+		policy.MaxHedges = 0
+		policy.AttemptTimeout = 50 * time.Millisecond
+		policy.BaseBackoff = time.Millisecond
+		issuer := &IssuerConfig{ProviderURL: server.URL, RequestPolicy: policy}
+
+		start := time.Now()
+		if _, err := issuer.GetPublicKeysFromWalletProvider(testEmailMap(2)); err != nil {
+			t.Fatalf("GetPublicKeysFromWalletProvider failed: %v", err)
+		}
+		if elapsed := time.Since(start); elapsed >= 500*time.Millisecond {
+			t.Errorf("Timed out attempt was not abandoned, took %v", elapsed)
+		}
+	})
+
+	t.Run("HedgesStragglers", func(t *testing.T) {
+		server, requests := newTestProvider(t, func(n int64) int {
+			if n == 1 {
+				time.Sleep(time.Second)
+			}
+			return 0
+		})
+
+		policy := NewRequestPolicy()
+		policy.MaxHedges = 1
+		policy.HedgeDelay = 20 * time.Millisecond
+		issuer := &IssuerConfig{ProviderURL: server.URL, RequestPolicy: policy}
+
+		start := time.Now()
+		if _, err := issuer.GetPublicKeysFromWalletProvider(testEmailMap(2)); err != nil {
+			t.Fatalf("GetPublicKeysFromWalletProvider failed: %v", err)
+		}
+		if elapsed := time.Since(start); elapsed >= time.Second {
+			t.Errorf("Hedged request did not win over straggler, took %v", elapsed)
+		}
+		if got := atomic.LoadInt64(requests); got != 2 {
+			t.Errorf("Expected 2 requests, got %d", got)
+		}
+	})
+
+	t.Run("DefaultsDoNotDuplicateSlowRequests", func(t *testing.T) {
+		server, requests := newTestProvider(t, func(n int64) int {
+			time.Sleep(700 * time.Millisecond)
+			return 0
+		})
+
+		issuer := &IssuerConfig{ProviderURL: server.URL}
+		if _, err := issuer.GetPublicKeysFromWalletProvider(testEmailMap(2)); err != nil {
+			t.Fatalf("GetPublicKeysFromWalletProvider failed: %v", err)
+		}
+		if got := atomic.LoadInt64(requests); got != 1 {
+			t.Errorf("Expected a single request for a slow provider, got %d", got)
+		}
+	})
+
+	t.Run("ClosesHedgesAfterClientError", func(t *testing.T) {
+		// the first attempt fails with a client error while its hedge is still outstanding
+		var closed atomic.Bool
+		var calls atomic.Int64
+		client := &http.Client{Transport: roundTripFunc(func(r *http.Request) (*http.Response, error) {
+			if calls.Add(1) == 1 {
+				time.Sleep(40 * time.Millisecond)
+				return &http.Response{StatusCode: http.StatusBadRequest, Body: io.NopCloser(strings.NewReader("bad request"))}, nil
+			}
+			time.Sleep(80 * time.Millisecond)
+			return &http.Response{StatusCode: http.StatusOK, Body: &closeRecorder{Reader: strings.NewReader("{}"), closed: &closed}}, nil
+		})}
+
+		policy := NewRequestPolicy()
+		policy.MaxHedges = 1
+		policy.HedgeDelay = 10 * time.Millisecond
+		issuer := &IssuerConfig{ProviderURL: "http://wallet-provider.test", HTTPClient: client, RequestPolicy: policy}
+
+		if _, err := issuer.GetPublicKeysFromWalletProvider(testEmailMap(2)); err == nil {
+			t.Fatal("Expected the client error to be returned")
+		}
+		if calls.Load() != 2 {
+			t.Fatalf("Expected a hedged request, got %d requests", calls.Load())
+		}
+		if !closed.Load() {
+			t.Errorf("Response of the outstanding hedge was not closed")
+		}
+	})
+
+	t.Run("CopiesDoNotShareALock", func(t *testing.T) {
+		base := IssuerConfig{RequestPolicy: NewRequestPolicy()}
+		copied := base
+		for i := 0; i < latencyMinSamples; i++ {
+			copied.latencyWindow().observe(time.Millisecond)
+		}
+		if base.latency != nil {
+			t.Errorf("Latency observed on a copy reached the original")
+		}
+	})
+
+	t.Run("LatencyIsPerIssuer", func(t *testing.T) {
+		policy := NewRequestPolicy()
+		fast := &IssuerConfig{RequestPolicy: policy}
+		slow := &IssuerConfig{RequestPolicy: policy}
+		for i := 0; i < latencyMinSamples; i++ {
+			fast.latencyWindow().observe(time.Millisecond)
+		}
+		if d := policy.hedgeDelay(fast.latencyWindow()); d != time.Millisecond {
+			t.Errorf("Expected observed hedge delay, got %v", d)
+		}
+		if d := policy.hedgeDelay(slow.latencyWindow()); d != policy.HedgeDelay {
+			t.Errorf("Latency of another issuer leaked into the hedge delay: %v", d)
+		}
+	})
+
+	t.Run("BoundsConcurrentBatches", func(t *testing.T) {
+		var inFlight, peak atomic.Int64
+		server, requests := newTestProvider(t, func(n int64) int {
+			current := inFlight.Add(1)
+			defer inFlight.Add(-1)
+			for {
+				old := peak.Load()
+				if current <= old || peak.CompareAndSwap(old, current) {
+					break
+				}
+			}
+			time.Sleep(20 * time.Millisecond)
+			return 0
+		})
+
+		policy := NewRequestPolicy()
+		policy.BatchSize = 1
+		policy.MaxConcurrentBatches = 2
+		issuer := &IssuerConfig{ProviderURL: server.URL, RequestPolicy: policy}
+		userMap, err := issuer.GetPublicKeysFromWalletProvider(testEmailMap(8))
+		if err != nil {
+			t.Fatalf("GetPublicKeysFromWalletProvider failed: %v", err)
+		}
+		if len(userMap) != 8 || atomic.LoadInt64(requests) != 8 {
+			t.Fatalf("Expected 8 users in 8 batches, got %d users in %d requests", len(userMap), atomic.LoadInt64(requests))
+		}
+		if got := peak.Load(); got > 2 {
+			t.Errorf("Expected at most 2 concurrent batches, got %d", got)
+		}
+	})
+
+	t.Run("BatchesAreMerged", func(t *testing.T) {
+		server, requests := newTestProvider(t, nil)
+
+		policy := NewRequestPolicy()
+		policy.BatchSize = 4
+		issuer := &IssuerConfig{ProviderURL: server.URL, RequestPolicy: policy}
+
+		userMap, err := issuer.GetPublicKeysFromWalletProvider(testEmailMap(10))
+		if err != nil {
+			t.Fatalf("GetPublicKeysFromWalletProvider failed: %v", err)
+		}
+		if len(userMap) != 10 {
+			t.Fatalf("Expected 10 users, got %d", len(userMap))
+		}
+		for uuid, userData := range userMap {
+			if userData.WpPubKey == nil {
+				t.Errorf("Missing public key for user %s", uuid)
+			}
+		}
+		if got := atomic.LoadInt64(requests); got != 3 {
+			t.Errorf("Expected 3 batch requests, got %d", got)
+		}
+	})
+
+	t.Run("UnrequestedAndMissingHashes", func(t *testing.T) {
+		server := httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+			json.NewEncoder(w).Encode(map[string]KeyData{"not-requested": {KeyID: "x"}})
+		}))
+		defer server.Close()
+
+		issuer := &IssuerConfig{ProviderURL: server.URL}
+		if _, err := issuer.GetPublicKeysFromWalletProvider(testEmailMap(1)); err == nil {
+			t.Fatalf("Expected error for response without requested hashes")
+		}
+	})
+}
+
+func TestStreamPublicKeysFromWalletProvider(t *testing.T) {
+	masterKey, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate master key: %v", err)
+	}
+	provider := &ProviderConfig{MasterSecretKey: masterKey, Dst: "CVC-TEST-DST-v1.0"}
+
+	// firstHandled is closed by the handler; the server only sends the second half of the
+	// response once that has happened (or after a timeout)
+	firstHandled := make(chan struct{})
+	server := httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+		body, _ := io.ReadAll(r.Body)
+		resp, err := provider.GeneratePublicKeys(body)
+		if err != nil {
+			w.WriteHeader(http.StatusInternalServerError)
+			return
+		}
+		half := len(resp) / 2
+		w.Write(resp[:half])
+		w.(http.Flusher).Flush()
+		select {
+		case <-firstHandled:
+		case <-time.After(2 * time.Second):
+		}
+		w.Write(resp[half:])
+	}))
+	defer server.Close()
+
+	issuer := &IssuerConfig{ProviderURL: server.URL}
+
+	t.Run("HandlesUsersBeforeResponseCompletes", func(t *testing.T) {
+		handled := map[string]bool{}
+		start := time.Now()
+		var firstAt time.Duration
+		userMap, err := issuer.StreamPublicKeysFromWalletProvider(testEmailMap(4), func(uuid string, userData *UserData) error {
+			if handled[uuid] {
+				t.Errorf("User %s handled twice", uuid)
+			}
+			if userData.WpPubKey == nil || userData.KeyID == "" {
+				t.Errorf("Incomplete key data for user %s", uuid)
+			}
+			if len(handled) == 0 {
+				firstAt = time.Since(start)
+				close(firstHandled)
+			}
+			handled[uuid] = true
+			return nil
+		})
+		if err != nil {
+			t.Fatalf("StreamPublicKeysFromWalletProvider failed: %v", err)
+		}
+		if len(handled) != 4 || len(userMap) != 4 {
+			t.Fatalf("Expected 4 handled users, got %d (map %d)", len(handled), len(userMap))
+		}
+		if firstAt >= 2*time.Second {
+			t.Errorf("First user was only handled after the full response, at %v", firstAt)
+		}
+	})
+
+	t.Run("SlowHandlerDoesNotTimeOutAttempt", func(t *testing.T) {
+		fast, requests := newTestProvider(t, nil)
+		policy := NewRequestPolicy()
+		policy.AttemptTimeout = 50 * time.Millisecond
+		policy.BaseBackoff = time.Millisecond
+		issuer := &IssuerConfig{ProviderURL: fast.URL, RequestPolicy: policy}
+
+		// the response is larger than the read buffers, so reading it has to outlast the handler calls
+		handled := 0
+		_, err := issuer.StreamPublicKeysFromWalletProvider(testEmailMap(64), func(uuid string, userData *UserData) error {
+			time.Sleep(5 * time.Millisecond)
+			handled++
+			return nil
+		})
+		if err != nil {
+			t.Fatalf("StreamPublicKeysFromWalletProvider failed: %v", err)
+		}
+		if handled != 64 {
+			t.Errorf("Expected 64 handled users, got %d", handled)
+		}
+		if got := atomic.LoadInt64(requests); got != 1 {
+			t.Errorf("Slow handler made the keys be requested %d times", got)
+		}
+	})
+
+	t.Run("HandlerErrorAborts", func(t *testing.T) {
+		_, err := issuer.StreamPublicKeysFromWalletProvider(testEmailMap(2), func(uuid string, userData *UserData) error {
+			return fmt.Errorf("stop")
+		})
+		if err == nil {
+			t.Fatalf("Expected handler error to be returned")
+		}
+	})
+}
+
+type roundTripFunc func(*http.Request) (*http.Response, error)
+
+func (f roundTripFunc) RoundTrip(r *http.Request) (*http.Response, error) { return f(r) }
+
+// closeRecorder is a response body that records whether it was closed
+type closeRecorder struct {
+	io.Reader
+	closed *atomic.Bool
+}
+
+func (b *closeRecorder) Close() error {
+	b.closed.Store(true)
+	return nil
+}
@@ -0,0 +1,180 @@
+package cvc
+
+import (
+	"encoding/json"
+	"errors"
+	"fmt"
+	"sync"
+	"time"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/MyNextID/cvc-go/pkg"
+)
+
+// PublicKeyCache interface allows issuers to persist wallet provider public keys of returning recipients.
+// Implementations must be safe for concurrent use.
+type PublicKeyCache interface {
+	// Get returns the cached entry for email, or false if there is none
+	Get(email string) (CachedPublicKey, bool, error)
+	// Put stores the entry for email, replacing any previous one
+	Put(email string, entry CachedPublicKey) error
+	// Delete removes the entry for email, if any
+	Delete(email string) error
+}
+
+// CachedPublicKey holds the wallet provider key material issued for a recipient email
+type CachedPublicKey struct {
+	Salt      []byte    `json:"salt"`
+	KeyID     string    `json:"key_id"`
+	WpPubKey  []byte    `json:"wp_pubkey"`  // JSON encoded JWK, as received from the wallet provider
+	ExpiresAt time.Time `json:"expires_at"` // zero means the entry does not expire
+
+	WpKemPubKey []byte `json:"wp_kem_pubkey,omitempty"` // Kyber768 public key, only in hybrid mode
+}
+
+// expired reports whether the entry can no longer be used at the given time
+func (e CachedPublicKey) expired(now time.Time) bool {
+	return !e.ExpiresAt.IsZero() && !now.Before(e.ExpiresAt)
+}
+
+// lookupCachedPublicKey returns user data for email from the issuer's cache. Expired entries are
+// removed and reported as a miss. Entries whose public key cannot be parsed are removed and reported
+// as an error, so the corruption is seen while the next issuance still requests a fresh key.
+func (c *IssuerConfig) lookupCachedPublicKey(email string) (*UserData, bool, error) {
+	if c.PublicKeyCache == nil {
+		return nil, false, nil
+	}
+
+	entry, ok, err := c.PublicKeyCache.Get(email)
+	if err != nil {
+		return nil, false, fmt.Errorf("failed to read public key cache: %w", err)
+	}
+	if !ok {
+		return nil, false, nil
+	}
+	if entry.expired(time.Now()) {
+		if err := c.PublicKeyCache.Delete(email); err != nil {
+			return nil, false, fmt.Errorf("failed to remove expired public key cache entry: %w", err)
+		}
+		return nil, false, nil
+	}
+
+	wpPubKey, err := pkg.KeyJsonToJWK(entry.WpPubKey)
+	if err != nil {
+		parseErr := fmt.Errorf("%w: removed unparseable public key cache entry: %v", internal.ErrInvalidKeyFormat, err)
+		if err := c.PublicKeyCache.Delete(email); err != nil {
+			return nil, false, errors.Join(parseErr, fmt.Errorf("failed to remove public key cache entry: %w", err))
+		}
+		return nil, false, parseErr
+	}
+
+	return &UserData{
+		Email:    email,
+		KeyID:    entry.KeyID,
+		Salt:     entry.Salt,
+		WpPubKey: wpPubKey,
+
+		WpKemPubKey: entry.WpKemPubKey,
+	}, true, nil
+}
+
+// storeCachedPublicKey records the key material received for a recipient in the issuer's cache
+func (c *IssuerConfig) storeCachedPublicKey(email string, salt []byte, data KeyData) error {
+	if c.PublicKeyCache == nil {
+		return nil
+	}
+
+	entry := CachedPublicKey{
+		Salt:     salt,
+		KeyID:    data.KeyID,
+		WpPubKey: data.WpPubkey,
+
+		WpKemPubKey: data.WpKemPubkey,
+	}
+	if c.PublicKeyCacheTTL > 0 {
+		entry.ExpiresAt = time.Now().Add(c.PublicKeyCacheTTL)
+	}
+
+	if err := c.PublicKeyCache.Put(email, entry); err != nil {
+		return fmt.Errorf("failed to write public key cache: %w", err)
+	}
+	return nil
+}
+
+// InvalidateCachedPublicKey removes the cached wallet provider key of a recipient, so that the next
+// issuance for that email requests a fresh key from the wallet provider
+func (c *IssuerConfig) InvalidateCachedPublicKey(email string) error {
+	if c.PublicKeyCache == nil {
+		return nil
+	}
+	return c.PublicKeyCache.Delete(email)
+}
+
+// MemoryPublicKeyCache is an in-memory PublicKeyCache. Its contents can be persisted with json.Marshal
+// and restored with json.Unmarshal.
+type MemoryPublicKeyCache struct {
+	mu      sync.RWMutex
+	entries map[string]CachedPublicKey
+}
+
+// NewMemoryPublicKeyCache returns an empty MemoryPublicKeyCache
+func NewMemoryPublicKeyCache() *MemoryPublicKeyCache {
+	return &MemoryPublicKeyCache{entries: make(map[string]CachedPublicKey)}
+}
+
+func (m *MemoryPublicKeyCache) Get(email string) (CachedPublicKey, bool, error) {
+	m.mu.RLock()
+	defer m.mu.RUnlock()
+	entry, ok := m.entries[email]
+	return entry, ok, nil
+}
+
+func (m *MemoryPublicKeyCache) Put(email string, entry CachedPublicKey) error {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+	if m.entries == nil {
+		m.entries = make(map[string]CachedPublicKey)
+	}
+	m.entries[email] = entry
+	return nil
+}
+
+func (m *MemoryPublicKeyCache) Delete(email string) error {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+	delete(m.entries, email)
+	return nil
+}
+
+// Prune removes all entries that have expired at the given time and returns how many were removed
+func (m *MemoryPublicKeyCache) Prune(now time.Time) int {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+	removed := 0
+	for email, entry := range m.entries {
+		if entry.expired(now) {
+			delete(m.entries, email)
+			removed++
+		}
+	}
+	return removed
+}
+
+// MarshalJSON encodes all cache entries keyed by email
+func (m *MemoryPublicKeyCache) MarshalJSON() ([]byte, error) {
+	m.mu.RLock()
+	defer m.mu.RUnlock()
+	return json.Marshal(m.entries)
+}
+
+// UnmarshalJSON replaces the cache contents with previously marshaled entries
+func (m *MemoryPublicKeyCache) UnmarshalJSON(data []byte) error {
+	entries := make(map[string]CachedPublicKey)
+	if err := json.Unmarshal(data, &entries); err != nil {
+		return err
+	}
+	m.mu.Lock()
+	defer m.mu.Unlock()
+	m.entries = entries
+	return nil
+}
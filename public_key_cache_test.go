@@ -0,0 +1,191 @@
+package cvc
+
+import (
+	"encoding/base64"
+	"encoding/json"
+	"errors"
+	"net/http"
+	"net/http/httptest"
+	"sync/atomic"
+	"testing"
+	"time"
+
+	"github.com/MyNextID/cvc-go/internal"
+)
+
+func TestPublicKeyCache(t *testing.T) {
+	t.Run("ReturningRecipientsSkipProvider", func(t *testing.T) {
+		server, requests := newTestProvider(t, nil)
+		cache := NewMemoryPublicKeyCache()
+		issuer := &IssuerConfig{ProviderURL: server.URL, PublicKeyCache: cache}
+
+		first, err := issuer.GetPublicKeysFromWalletProvider(map[string]string{"u1": "alice@example.com"})
+		if err != nil {
+			t.Fatalf("First issuance failed: %v", err)
+		}
+
+		second, err := issuer.GetPublicKeysFromWalletProvider(map[string]string{"u2": "alice@example.com"})
+		if err != nil {
+			t.Fatalf("Second issuance failed: %v", err)
+		}
+		if got := atomic.LoadInt64(requests); got != 1 {
+			t.Errorf("Expected 1 provider request, got %d", got)
+		}
+		if first["u1"].KeyID != second["u2"].KeyID || string(first["u1"].Salt) != string(second["u2"].Salt) {
+			t.Errorf("Cached key material was not reused")
+		}
+
+		// a mixed batch only requests the miss
+		mixed, err := issuer.GetPublicKeysFromWalletProvider(map[string]string{"u3": "alice@example.com", "u4": "bob@example.com"})
+		if err != nil {
+			t.Fatalf("Mixed issuance failed: %v", err)
+		}
+		if mixed["u4"].WpPubKey == nil {
+			t.Errorf("Missing key for cache miss")
+		}
+		if got := atomic.LoadInt64(requests); got != 2 {
+			t.Errorf("Expected 2 provider requests, got %d", got)
+		}
+	})
+
+	t.Run("ExpiryAndInvalidation", func(t *testing.T) {
+		server, requests := newTestProvider(t, nil)
+		cache := NewMemoryPublicKeyCache()
+		issuer := &IssuerConfig{ProviderURL: server.URL, PublicKeyCache: cache, PublicKeyCacheTTL: time.Hour}
+		emails := map[string]string{"u1": "carol@example.com"}
+
+		if _, err := issuer.GetPublicKeysFromWalletProvider(emails); err != nil {
+			t.Fatalf("Issuance failed: %v", err)
+		}
+		if err := issuer.InvalidateCachedPublicKey("carol@example.com"); err != nil {
+			t.Fatalf("InvalidateCachedPublicKey failed: %v", err)
+		}
+		if _, err := issuer.GetPublicKeysFromWalletProvider(emails); err != nil {
+			t.Fatalf("Issuance failed: %v", err)
+		}
+		if got := atomic.LoadInt64(requests); got != 2 {
+			t.Errorf("Expected invalidated entry to be refetched, got %d requests", got)
+		}
+
+		// force the entry to expire
+		entry, _, _ := cache.Get("carol@example.com")
+		entry.ExpiresAt = time.Now().Add(-time.Second)
+		cache.Put("carol@example.com", entry)
+		if _, err := issuer.GetPublicKeysFromWalletProvider(emails); err != nil {
+			t.Fatalf("Issuance failed: %v", err)
+		}
+		if got := atomic.LoadInt64(requests); got != 3 {
+			t.Errorf("Expected expired entry to be refetched, got %d requests", got)
+		}
+	})
+
+	t.Run("UnparseableEntryIsEvicted", func(t *testing.T) {
+		server, requests := newTestProvider(t, nil)
+		cache := NewMemoryPublicKeyCache()
+		issuer := &IssuerConfig{ProviderURL: server.URL, PublicKeyCache: cache}
+		emails := map[string]string{"u1": "frank@example.com"}
+		cache.Put("frank@example.com", CachedPublicKey{Salt: []byte("salt"), KeyID: "kid", WpPubKey: []byte("not a jwk")})
+
+		if _, err := issuer.GetPublicKeysFromWalletProvider(emails); !errors.Is(err, internal.ErrInvalidKeyFormat) {
+			t.Fatalf("Expected an error for the unparseable entry, got %v", err)
+		}
+		if _, ok, _ := cache.Get("frank@example.com"); ok {
+			t.Errorf("Unparseable entry was not removed")
+		}
+
+		userMap, err := issuer.GetPublicKeysFromWalletProvider(emails)
+		if err != nil {
+			t.Fatalf("Issuance after eviction failed: %v", err)
+		}
+		if userMap["u1"].WpPubKey == nil || atomic.LoadInt64(requests) != 1 {
+			t.Errorf("Expected a fresh key from the provider after eviction")
+		}
+	})
+
+	t.Run("OffCurveEntryIsEvicted", func(t *testing.T) {
+		server, requests := newTestProvider(t, nil)
+		cache := NewMemoryPublicKeyCache()
+		issuer := &IssuerConfig{ProviderURL: server.URL, PublicKeyCache: cache}
+		emails := map[string]string{"u1": "grace@example.com", "u2": "heidi@example.com"}
+		if _, err := issuer.GetPublicKeysFromWalletProvider(map[string]string{"u2": "heidi@example.com"}); err != nil {
+			t.Fatalf("Issuance failed: %v", err)
+		}
+		cache.Put("grace@example.com", CachedPublicKey{Salt: []byte("salt"), KeyID: "kid", WpPubKey: offCurveJWK()})
+
+		if _, err := issuer.GetPublicKeysFromWalletProvider(emails); !errors.Is(err, internal.ErrKeyNotOnCurve) {
+			t.Fatalf("Expected ErrKeyNotOnCurve for the cached key, got %v", err)
+		}
+		if _, ok, _ := cache.Get("grace@example.com"); ok {
+			t.Errorf("Off-curve entry was not removed")
+		}
+		if _, ok, _ := cache.Get("heidi@example.com"); !ok {
+			t.Errorf("Valid entry was removed")
+		}
+
+		if _, err := issuer.GetPublicKeysFromWalletProvider(emails); err != nil {
+			t.Fatalf("Issuance after eviction failed: %v", err)
+		}
+		if got := atomic.LoadInt64(requests); got != 2 {
+			t.Errorf("Expected the evicted key to be refetched, got %d requests", got)
+		}
+	})
+
+	t.Run("InvalidProviderKeyIsNotCached", func(t *testing.T) {
+		invalidJWK := offCurveJWK()
+		server := httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+			var hashes []string
+			json.NewDecoder(r.Body).Decode(&hashes)
+			keyMap := make(map[string]KeyData, len(hashes))
+			for _, hash := range hashes {
+				keyMap[hash] = KeyData{KeyID: "kid", WpPubkey: invalidJWK}
+			}
+			w.Header().Set("Content-Type", "application/json")
+			json.NewEncoder(w).Encode(keyMap)
+		}))
+		defer server.Close()
+		cache := NewMemoryPublicKeyCache()
+		issuer := &IssuerConfig{ProviderURL: server.URL, PublicKeyCache: cache, RequestPolicy: &RequestPolicy{MaxAttempts: 1}}
+
+		if _, err := issuer.GetPublicKeysFromWalletProvider(map[string]string{"u1": "ivan@example.com"}); !errors.Is(err, internal.ErrKeyNotOnCurve) {
+			t.Fatalf("Expected ErrKeyNotOnCurve, got %v", err)
+		}
+		if _, ok, _ := cache.Get("ivan@example.com"); ok {
+			t.Errorf("Invalid provider key was cached")
+		}
+	})
+
+	t.Run("Persistence", func(t *testing.T) {
+		cache := NewMemoryPublicKeyCache()
+		cache.Put("dave@example.com", CachedPublicKey{Salt: []byte("salt"), KeyID: "kid", WpPubKey: []byte("{}")})
+		cache.Put("erin@example.com", CachedPublicKey{KeyID: "old", ExpiresAt: time.Now().Add(-time.Minute)})
+
+		if removed := cache.Prune(time.Now()); removed != 1 {
+			t.Errorf("Expected 1 pruned entry, got %d", removed)
+		}
+
+		data, err := json.Marshal(cache)
+		if err != nil {
+			t.Fatalf("Failed to marshal cache: %v", err)
+		}
+		restored := NewMemoryPublicKeyCache()
+		if err := json.Unmarshal(data, restored); err != nil {
+			t.Fatalf("Failed to unmarshal cache: %v", err)
+		}
+		entry, ok, _ := restored.Get("dave@example.com")
+		if !ok || entry.KeyID != "kid" || string(entry.Salt) != "salt" {
+			t.Errorf("Restored entry does not match: %+v", entry)
+		}
+	})
+}
+
+// offCurveJWK returns a P-256 public JWK that parses but whose point is not on the curve
+func offCurveJWK() []byte {
+	x, y := offCurvePoint()
+	key, _ := json.Marshal(map[string]string{
+		"kty": "EC",
+		"crv": "P-256",
+		"x":   base64.RawURLEncoding.EncodeToString(x.FillBytes(make([]byte, 32))),
+		"y":   base64.RawURLEncoding.EncodeToString(y.FillBytes(make([]byte, 32))),
+	})
+	return key
+}
@@ -0,0 +1,273 @@
+package cvc
+
+import (
+	"bytes"
+	"encoding/base64"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"reflect"
+	"testing"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/MyNextID/cvc-go/pkg"
+	"github.com/lestrrat-go/jwx/v2/jwk"
+)
+
+func sdTestPayload() map[string]interface{} {
+	var payload map[string]interface{}
+	json.Unmarshal([]byte(`{
+		"iss": "https://issuer.example.com",
+		"credentialSubject": {
+			"given_name": "Erika",
+			"family_name": "Mustermann",
+			"address": {"street": "Heidestraße 17", "locality": "Köln"},
+			"nationalities": ["DE", "FR"]
+		}
+	}`), &payload)
+	return payload
+}
+
+// revealAll replaces every digest in an SD payload by the claim of its disclosure, as a holder that
+// presents all disclosures would
+func revealAll(t *testing.T, value interface{}, disclosures map[string][]interface{}) interface{} {
+	switch v := value.(type) {
+	case map[string]interface{}:
+		out := make(map[string]interface{})
+		for key, item := range v {
+			if key == "_sd" || key == "_sd_alg" {
+				continue
+			}
+			out[key] = revealAll(t, item, disclosures)
+		}
+		sd, _ := v["_sd"].([]interface{})
+		for _, digest := range sd {
+			disclosure, ok := disclosures[digest.(string)]
+			if !ok || len(disclosure) != 3 {
+				t.Fatalf("No object disclosure for digest %v", digest)
+			}
+			out[disclosure[1].(string)] = revealAll(t, disclosure[2], disclosures)
+		}
+		return out
+	case []interface{}:
+		out := make([]interface{}, len(v))
+		for i, item := range v {
+			if element, ok := item.(map[string]interface{}); ok && len(element) == 1 && element["..."] != nil {
+				disclosure, ok := disclosures[element["..."].(string)]
+				if !ok || len(disclosure) != 2 {
+					t.Fatalf("No array disclosure for digest %v", element["..."])
+				}
+				item = disclosure[1]
+			}
+			out[i] = revealAll(t, item, disclosures)
+		}
+		return out
+	default:
+		return v
+	}
+}
+
+func decodeDisclosures(t *testing.T, encoded []string) map[string][]interface{} {
+	disclosures := make(map[string][]interface{})
+	for _, disclosure := range encoded {
+		raw, err := base64.RawURLEncoding.DecodeString(disclosure)
+		if err != nil {
+			t.Fatalf("Disclosure is not base64url: %v", err)
+		}
+		var decoded []interface{}
+		if err := json.Unmarshal(raw, &decoded); err != nil {
+			t.Fatalf("Disclosure is not a JSON array: %v", err)
+		}
+		digest := pkg.Hash([]byte(disclosure))
+		disclosures[base64.RawURLEncoding.EncodeToString(digest)] = decoded
+	}
+	return disclosures
+}
+
+// normalizeJSON round-trips a value through JSON so that it compares equal to decoded payloads
+func normalizeJSON(t *testing.T, value interface{}) interface{} {
+	data, err := json.Marshal(value)
+	if err != nil {
+		t.Fatalf("Failed to encode: %v", err)
+	}
+	var out interface{}
+	json.Unmarshal(data, &out)
+	return out
+}
+
+func TestSDJWT(t *testing.T) {
+	holderKey, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate key: %v", err)
+	}
+	holderPub, _ := holderKey.PublicKey()
+
+	pointers := []string{
+		"/credentialSubject/given_name",
+		"/credentialSubject/address",
+		"/credentialSubject/address/street",
+		"/credentialSubject/nationalities/1",
+	}
+	builder, err := pkg.NewSDJWTBuilder(pointers, 0)
+	if err != nil {
+		t.Fatalf("NewSDJWTBuilder failed: %v", err)
+	}
+
+	t.Run("RevealAllRestoresPayload", func(t *testing.T) {
+		payload := sdTestPayload()
+		sd, err := builder.Build(payload, holderPub)
+		if err != nil {
+			t.Fatalf("Build failed: %v", err)
+		}
+		if len(sd.Disclosures) != len(pointers) {
+			t.Fatalf("Expected %d disclosures, got %d", len(pointers), len(sd.Disclosures))
+		}
+		if !reflect.DeepEqual(payload, sdTestPayload()) {
+			t.Errorf("Build modified the input payload")
+		}
+
+		subject := sd.Payload["credentialSubject"].(map[string]interface{})
+		if _, ok := subject["given_name"]; ok {
+			t.Errorf("Disclosable claim is still in the payload")
+		}
+		if _, ok := subject["address"]; ok {
+			t.Errorf("Disclosable object is still in the payload")
+		}
+		if subject["family_name"] != "Mustermann" {
+			t.Errorf("Claim that is not disclosable was changed")
+		}
+		if sd.Payload["_sd_alg"] != pkg.SDAlgSHA256 {
+			t.Errorf("Expected _sd_alg %q", pkg.SDAlgSHA256)
+		}
+		if _, ok := sd.Payload["cnf"]; !ok {
+			t.Errorf("Holder key is not embedded")
+		}
+
+		expected := sdTestPayload()
+		if err := pkg.AddKeyToPayload(expected, holderPub); err != nil {
+			t.Fatalf("AddKeyToPayload failed: %v", err)
+		}
+		revealed := revealAll(t, normalizeJSON(t, sd.Payload), decodeDisclosures(t, sd.Disclosures))
+		if !reflect.DeepEqual(revealed, normalizeJSON(t, expected)) {
+			t.Errorf("Revealed payload does not match the original")
+		}
+	})
+
+	t.Run("Issue", func(t *testing.T) {
+		issuerKey, err := GenerateCurveSecretKey(CurveEd25519)
+		if err != nil {
+			t.Fatalf("GenerateCurveSecretKey failed: %v", err)
+		}
+		signer, _ := NewEdDSASigner(issuerKey, "issuer-key-1")
+		issuerPub, _ := signer.PublicKey()
+		verifier, _ := NewEdDSAVerifier(issuerPub)
+
+		sd, err := builder.Build(sdTestPayload(), holderPub)
+		if err != nil {
+			t.Fatalf("Build failed: %v", err)
+		}
+		sdJWT, err := sd.Issue(signer)
+		if err != nil {
+			t.Fatalf("Issue failed: %v", err)
+		}
+		if !bytes.HasSuffix(sdJWT, []byte("~")) {
+			t.Errorf("SD-JWT must end with '~'")
+		}
+
+		parts := bytes.Split(sdJWT[:len(sdJWT)-1], []byte("~"))
+		if len(parts) != 1+len(pointers) {
+			t.Fatalf("Expected JWS and %d disclosures, got %d parts", len(pointers), len(parts))
+		}
+		signed, err := verifier.VerifyJWS(parts[0])
+		if err != nil {
+			t.Fatalf("VerifyJWS failed: %v", err)
+		}
+		var signedPayload map[string]interface{}
+		json.Unmarshal(signed, &signedPayload)
+		if !reflect.DeepEqual(signedPayload, normalizeJSON(t, sd.Payload)) {
+			t.Errorf("Signed payload does not match the SD payload")
+		}
+	})
+
+	t.Run("BatchUsesFreshSalts", func(t *testing.T) {
+		payloads := make([]map[string]interface{}, 8)
+		keys := make([]jwk.Key, len(payloads))
+		for i := range payloads {
+			payloads[i] = sdTestPayload()
+			keys[i] = holderPub
+		}
+		results, err := builder.BuildBatch(payloads, keys)
+		if err != nil {
+			t.Fatalf("BuildBatch failed: %v", err)
+		}
+		seen := make(map[string]bool)
+		for _, result := range results {
+			for _, disclosure := range result.Disclosures {
+				if seen[disclosure] {
+					t.Fatalf("Disclosure repeated across credentials")
+				}
+				seen[disclosure] = true
+			}
+		}
+	})
+
+	t.Run("InvalidInput", func(t *testing.T) {
+		for _, pointer := range []string{"", "/", "given_name", "/cnf", "/cnf/jwk", "/_sd"} {
+			if _, err := pkg.NewSDJWTBuilder([]string{pointer}, 0); !errors.Is(err, internal.ErrInvalidParameters) {
+				t.Errorf("Expected error for pointer %q, got %v", pointer, err)
+			}
+		}
+		if _, err := pkg.NewSDJWTBuilder(pointers, 8); !errors.Is(err, internal.ErrInvalidParameters) {
+			t.Errorf("Expected error for short salt")
+		}
+		for _, pointer := range []string{"/credentialSubject/birthdate", "/credentialSubject/nationalities/2", "/credentialSubject/nationalities/01", "/iss/x"} {
+			b, err := pkg.NewSDJWTBuilder([]string{pointer}, 0)
+			if err != nil {
+				t.Fatalf("NewSDJWTBuilder failed: %v", err)
+			}
+			if _, err := b.Build(sdTestPayload(), holderPub); !errors.Is(err, internal.ErrInvalidParameters) {
+				t.Errorf("Expected error for pointer %q, got %v", pointer, err)
+			}
+		}
+	})
+}
+
+func BenchmarkSDJWT(b *testing.B) {
+	holderKey, _ := GenerateSecretKey()
+	holderPub, _ := holderKey.PublicKey()
+
+	subject := make(map[string]interface{})
+	pointers := make([]string, 0, 20)
+	for i := 0; i < 20; i++ {
+		subject[fmt.Sprintf("claim%d", i)] = fmt.Sprintf("value of claim %d", i)
+		pointers = append(pointers, fmt.Sprintf("/credentialSubject/claim%d", i))
+	}
+	builder, err := pkg.NewSDJWTBuilder(pointers, 0)
+	if err != nil {
+		b.Fatalf("NewSDJWTBuilder failed: %v", err)
+	}
+	payload := map[string]interface{}{"iss": "https://issuer.example.com", "credentialSubject": subject}
+
+	b.Run("Build", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			if _, err := builder.Build(payload, holderPub); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("BuildBatch100", func(b *testing.B) {
+		payloads := make([]map[string]interface{}, 100)
+		keys := make([]jwk.Key, len(payloads))
+		for i := range payloads {
+			payloads[i] = payload
+			keys[i] = holderPub
+		}
+		b.ResetTimer()
+		for i := 0; i < b.N; i++ {
+			if _, err := builder.BuildBatch(payloads, keys); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+}
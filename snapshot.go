@@ -0,0 +1,233 @@
+package cvc
+
+import (
+	"bytes"
+	"crypto/sha256"
+	"encoding/binary"
+	"fmt"
+	"os"
+	"path/filepath"
+	"runtime"
+	"runtime/debug"
+
+	"github.com/MyNextID/cvc-go/internal"
+)
+
+// A precomputation snapshot stores state that every process would otherwise compute at startup, so
+// that replicas reach full speed immediately. Snapshots only hold public, curve-dependent tables; no
+// key material is ever written to them, so one file can be shared by every process on a host. The
+// file is memory-mapped read-only while it is verified, and Install copies the tables it uses into
+// process memory, so rewriting or truncating the file later cannot affect a running process.
+//
+// The layout is little-endian:
+//
+//	magic "CVCSNAP\x00" (8) | version (4) | section count (4) | GOARCH, zero padded (16)
+//	section table: count x (id (4) | reserved (4) | offset (8) | length (8))
+//	section data, each section aligned to snapshotAlign
+//	SHA-256 of everything before it (32)
+//
+// Sections are stored in the memory layout of the platform, which the GOARCH field pins down.
+// Readers skip sections with unknown ids.
+
+const (
+	// SnapshotVersion is the version of the snapshot layout written by WriteSnapshot
+	SnapshotVersion = 1
+
+	snapshotMagic      = "CVCSNAP\x00"
+	snapshotHeaderSize = 32
+	snapshotEntrySize  = 24
+	snapshotAlign      = 64
+
+	// snapshotSectionEd25519BaseTable holds the fixed-base table used by EdDSA signing
+	snapshotSectionEd25519BaseTable = 1
+)
+
+type snapshotSection struct {
+	id   uint32
+	data []byte
+}
+
+// Snapshot is an opened and verified precomputation snapshot
+type Snapshot struct {
+	data      []byte
+	release   func() error
+	sections  map[uint32][]byte
+	installed bool
+}
+
+// WriteSnapshot builds all precomputed state of this process and writes it to path. The file is
+// written to a temporary name first and renamed, so readers never see a partial snapshot.
+func WriteSnapshot(path string) error {
+	table, err := internal.Ed25519BaseTableBytes()
+	if err != nil {
+		return err
+	}
+	data := encodeSnapshot([]snapshotSection{{id: snapshotSectionEd25519BaseTable, data: table}})
+
+	tmp, err := os.CreateTemp(filepath.Dir(path), filepath.Base(path)+".tmp*")
+	if err != nil {
+		return fmt.Errorf("failed to create snapshot: %w", err)
+	}
+	defer os.Remove(tmp.Name())
+
+	if _, err := tmp.Write(data); err != nil {
+		tmp.Close()
+		return fmt.Errorf("failed to write snapshot: %w", err)
+	}
+	if err := tmp.Chmod(0o644); err != nil {
+		tmp.Close()
+		return fmt.Errorf("failed to write snapshot: %w", err)
+	}
+	if err := tmp.Close(); err != nil {
+		return fmt.Errorf("failed to write snapshot: %w", err)
+	}
+	if err := os.Rename(tmp.Name(), path); err != nil {
+		return fmt.Errorf("failed to write snapshot: %w", err)
+	}
+	return nil
+}
+
+// encodeSnapshot lays out the sections and appends the checksum
+func encodeSnapshot(sections []snapshotSection) []byte {
+	offset := alignSnapshot(snapshotHeaderSize + len(sections)*snapshotEntrySize)
+	offsets := make([]int, len(sections))
+	for i, section := range sections {
+		offsets[i] = offset
+		offset = alignSnapshot(offset + len(section.data))
+	}
+
+	data := make([]byte, offset, offset+sha256.Size)
+	copy(data, snapshotMagic)
+	binary.LittleEndian.PutUint32(data[8:], SnapshotVersion)
+	binary.LittleEndian.PutUint32(data[12:], uint32(len(sections)))
+	copy(data[16:32], runtime.GOARCH)
+	for i, section := range sections {
+		entry := data[snapshotHeaderSize+i*snapshotEntrySize:]
+		binary.LittleEndian.PutUint32(entry, section.id)
+		binary.LittleEndian.PutUint64(entry[8:], uint64(offsets[i]))
+		binary.LittleEndian.PutUint64(entry[16:], uint64(len(section.data)))
+		copy(data[offsets[i]:], section.data)
+	}
+
+	sum := sha256.Sum256(data)
+	return append(data, sum[:]...)
+}
+
+func alignSnapshot(n int) int {
+	return (n + snapshotAlign - 1) &^ (snapshotAlign - 1)
+}
+
+// OpenSnapshot maps a snapshot written by WriteSnapshot and verifies its checksum, version and
+// platform. The tables are only put to use by Install.
+func OpenSnapshot(path string) (*Snapshot, error) {
+	data, release, err := mapSnapshot(path)
+	if err != nil {
+		return nil, fmt.Errorf("failed to open snapshot: %w", err)
+	}
+
+	var sections map[uint32][]byte
+	err = readMapped(func() (err error) {
+		sections, err = parseSnapshot(data)
+		return err
+	})
+	if err != nil {
+		release()
+		return nil, err
+	}
+	return &Snapshot{data: data, release: release, sections: sections}, nil
+}
+
+// parseSnapshot verifies a snapshot and returns its sections as views into data
+func parseSnapshot(data []byte) (map[uint32][]byte, error) {
+	if len(data) < snapshotHeaderSize+sha256.Size || string(data[:8]) != snapshotMagic {
+		return nil, internal.WrapError(internal.ErrSnapshotFormat, "not a snapshot file")
+	}
+	body := data[:len(data)-sha256.Size]
+	if sum := sha256.Sum256(body); !bytes.Equal(sum[:], data[len(body):]) {
+		return nil, internal.WrapError(internal.ErrSnapshotFormat, "checksum mismatch")
+	}
+	if version := binary.LittleEndian.Uint32(data[8:]); version != SnapshotVersion {
+		return nil, internal.WrapError(internal.ErrSnapshotFormat, fmt.Sprintf("unsupported snapshot version %d", version))
+	}
+	if arch := string(bytes.TrimRight(data[16:32], "\x00")); arch != runtime.GOARCH {
+		return nil, internal.WrapError(internal.ErrSnapshotFormat, fmt.Sprintf("snapshot was written on %s", arch))
+	}
+
+	count := int(binary.LittleEndian.Uint32(data[12:]))
+	if count > (len(body)-snapshotHeaderSize)/snapshotEntrySize {
+		return nil, internal.WrapError(internal.ErrSnapshotFormat, "section table is truncated")
+	}
+	sections := make(map[uint32][]byte, count)
+	for i := 0; i < count; i++ {
+		entry := data[snapshotHeaderSize+i*snapshotEntrySize:]
+		id := binary.LittleEndian.Uint32(entry)
+		offset := binary.LittleEndian.Uint64(entry[8:])
+		length := binary.LittleEndian.Uint64(entry[16:])
+		if offset%snapshotAlign != 0 || offset > uint64(len(body)) || length > uint64(len(body))-offset {
+			return nil, internal.WrapError(internal.ErrSnapshotFormat, fmt.Sprintf("section %d is out of bounds", id))
+		}
+		sections[id] = body[offset : offset+length : offset+length]
+	}
+	return sections, nil
+}
+
+// readMapped runs fn, which reads the mapped snapshot, and reports a fault of the mapping as a
+// malformed snapshot. Reading a mapping faults when the file is truncated underneath it.
+func readMapped(fn func() error) (err error) {
+	defer debug.SetPanicOnFault(debug.SetPanicOnFault(true))
+	defer func() {
+		if r := recover(); r != nil {
+			if _, fault := r.(interface{ Addr() uintptr }); !fault {
+				panic(r)
+			}
+			err = internal.WrapError(internal.ErrSnapshotFormat, "snapshot file changed while it was read")
+		}
+	}()
+	return fn()
+}
+
+// Install copies the tables of the snapshot into process memory, checks the copies and puts them to use
+// for the rest of the process lifetime, then unmaps the snapshot. It must be called before the first
+// operation that uses them, typically at startup; afterwards the process has already built its own
+// tables and Install fails.
+func (s *Snapshot) Install() error {
+	if s.installed {
+		return nil
+	}
+	table, ok := s.sections[snapshotSectionEd25519BaseTable]
+	if !ok {
+		return internal.WrapError(internal.ErrSnapshotFormat, "snapshot has no Ed25519 fixed-base table")
+	}
+	if err := readMapped(func() error { return internal.UseEd25519BaseTable(table) }); err != nil {
+		return err
+	}
+	s.installed = true
+	return s.unmap()
+}
+
+// Close unmaps a snapshot. Installed tables are copies, so they stay in use.
+func (s *Snapshot) Close() error {
+	return s.unmap()
+}
+
+func (s *Snapshot) unmap() error {
+	if s.release == nil {
+		return nil
+	}
+	err := s.release()
+	s.data, s.sections, s.release = nil, nil, nil
+	return err
+}
+
+// LoadSnapshot opens and installs a snapshot in one step
+func LoadSnapshot(path string) error {
+	snapshot, err := OpenSnapshot(path)
+	if err != nil {
+		return err
+	}
+	if err := snapshot.Install(); err != nil {
+		snapshot.Close()
+		return err
+	}
+	return nil
+}
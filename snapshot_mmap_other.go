@@ -0,0 +1,14 @@
+//go:build !unix
+
+package cvc
+
+import "os"
+
+// mapSnapshot reads a snapshot file into memory on platforms without mmap support in syscall
+func mapSnapshot(path string) ([]byte, func() error, error) {
+	data, err := os.ReadFile(path)
+	if err != nil {
+		return nil, nil, err
+	}
+	return data, func() error { return nil }, nil
+}
@@ -0,0 +1,36 @@
+//go:build unix
+
+package cvc
+
+import (
+	"os"
+	"syscall"
+)
+
+// mapSnapshot maps a snapshot file read-only. The mapping is shared with the page cache, so it is only
+// read while the snapshot is verified and installed.
+func mapSnapshot(path string) ([]byte, func() error, error) {
+	file, err := os.Open(path)
+	if err != nil {
+		return nil, nil, err
+	}
+	defer file.Close()
+
+	info, err := file.Stat()
+	if err != nil {
+		return nil, nil, err
+	}
+	if info.Size() == 0 {
+		// an empty file cannot be mapped; the caller reports it as malformed
+		return nil, func() error { return nil }, nil
+	}
+	if int64(int(info.Size())) != info.Size() {
+		return nil, nil, syscall.EFBIG
+	}
+
+	data, err := syscall.Mmap(int(file.Fd()), 0, int(info.Size()), syscall.PROT_READ, syscall.MAP_SHARED)
+	if err != nil {
+		return nil, nil, err
+	}
+	return data, func() error { return syscall.Munmap(data) }, nil
+}
@@ -0,0 +1,202 @@
+package cvc
+
+import (
+	"bytes"
+	"crypto/ed25519"
+	"crypto/sha256"
+	"encoding/binary"
+	"errors"
+	"os"
+	"os/exec"
+	"path/filepath"
+	"testing"
+
+	"github.com/MyNextID/cvc-go/internal"
+)
+
+// snapshotHelperEnv makes the test binary act as a fresh process that loads a snapshot
+const snapshotHelperEnv = "CVC_SNAPSHOT_HELPER"
+
+func writeTestSnapshot(t testing.TB) string {
+	t.Helper()
+	path := filepath.Join(t.TempDir(), "cvc.snapshot")
+	if err := WriteSnapshot(path); err != nil {
+		t.Fatalf("WriteSnapshot failed: %v", err)
+	}
+	return path
+}
+
+func TestSnapshot(t *testing.T) {
+	path := writeTestSnapshot(t)
+	data, err := os.ReadFile(path)
+	if err != nil {
+		t.Fatalf("Failed to read snapshot: %v", err)
+	}
+
+	rewrite := func(t *testing.T, data []byte) string {
+		t.Helper()
+		tampered := filepath.Join(t.TempDir(), "tampered.snapshot")
+		if err := os.WriteFile(tampered, data, 0o644); err != nil {
+			t.Fatalf("Failed to write snapshot: %v", err)
+		}
+		return tampered
+	}
+
+	t.Run("OpenVerifiesTable", func(t *testing.T) {
+		snapshot, err := OpenSnapshot(path)
+		if err != nil {
+			t.Fatalf("OpenSnapshot failed: %v", err)
+		}
+		defer snapshot.Close()
+
+		table := snapshot.sections[snapshotSectionEd25519BaseTable]
+		if len(table) != internal.Ed25519BaseTableSize {
+			t.Fatalf("Expected a %d byte table, got %d", internal.Ed25519BaseTableSize, len(table))
+		}
+		// this process has built its own table for WriteSnapshot, so the valid table is refused as late
+		if err := snapshot.Install(); !errors.Is(err, internal.ErrInvalidParameters) {
+			t.Errorf("Expected table already in use, got %v", err)
+		}
+	})
+
+	t.Run("Tampered", func(t *testing.T) {
+		tampered := append([]byte{}, data...)
+		tampered[len(tampered)/2] ^= 1
+		if _, err := OpenSnapshot(rewrite(t, tampered)); !errors.Is(err, internal.ErrSnapshotFormat) {
+			t.Errorf("Expected snapshot format error, got %v", err)
+		}
+	})
+
+	t.Run("CorruptTableWithValidChecksum", func(t *testing.T) {
+		table, err := internal.Ed25519BaseTableBytes()
+		if err != nil {
+			t.Fatalf("Ed25519BaseTableBytes failed: %v", err)
+		}
+		corrupt := append([]byte{}, table...)
+		corrupt[1000] ^= 1
+
+		snapshot, err := OpenSnapshot(rewrite(t, encodeSnapshot([]snapshotSection{{id: snapshotSectionEd25519BaseTable, data: corrupt}})))
+		if err != nil {
+			t.Fatalf("OpenSnapshot failed: %v", err)
+		}
+		defer snapshot.Close()
+		if err := snapshot.Install(); !errors.Is(err, internal.ErrSnapshotFormat) {
+			t.Errorf("Expected snapshot format error, got %v", err)
+		}
+	})
+
+	t.Run("Malformed", func(t *testing.T) {
+		reseal := func(data []byte) []byte {
+			body := data[:len(data)-32]
+			return encodeSnapshotChecksum(body)
+		}
+		otherVersion := append([]byte{}, data...)
+		binary.LittleEndian.PutUint32(otherVersion[8:], SnapshotVersion+1)
+		otherArch := append([]byte{}, data...)
+		copy(otherArch[16:32], bytes.Repeat([]byte{0}, 16))
+		copy(otherArch[16:], "otherarch")
+		outOfBounds := append([]byte{}, data...)
+		binary.LittleEndian.PutUint64(outOfBounds[snapshotHeaderSize+16:], uint64(len(data)))
+
+		cases := map[string][]byte{
+			"Empty":        {},
+			"Truncated":    data[:len(data)/2],
+			"NotSnapshot":  bytes.Repeat([]byte("x"), 128),
+			"OtherVersion": reseal(otherVersion),
+			"OtherArch":    reseal(otherArch),
+			"OutOfBounds":  reseal(outOfBounds),
+		}
+		for name, malformed := range cases {
+			t.Run(name, func(t *testing.T) {
+				if _, err := OpenSnapshot(rewrite(t, malformed)); !errors.Is(err, internal.ErrSnapshotFormat) {
+					t.Errorf("Expected snapshot format error, got %v", err)
+				}
+			})
+		}
+	})
+
+	t.Run("MissingFile", func(t *testing.T) {
+		if _, err := OpenSnapshot(filepath.Join(t.TempDir(), "missing")); !errors.Is(err, os.ErrNotExist) {
+			t.Errorf("Expected file not found, got %v", err)
+		}
+	})
+
+	t.Run("InstallInFreshProcess", func(t *testing.T) {
+		cmd := exec.Command(os.Args[0], "-test.run=^TestSnapshotHelper$")
+		cmd.Env = append(os.Environ(), snapshotHelperEnv+"="+path)
+		if output, err := cmd.CombinedOutput(); err != nil {
+			t.Fatalf("Helper process failed: %v\n%s", err, output)
+		}
+	})
+}
+
+// encodeSnapshotChecksum appends a fresh checksum to a modified snapshot body
+func encodeSnapshotChecksum(body []byte) []byte {
+	sum := sha256.Sum256(body)
+	return append(append([]byte{}, body...), sum[:]...)
+}
+
+// TestSnapshotHelper runs in a child process started by TestSnapshot. It installs the snapshot before
+// anything builds a table, rewrites the file in place and checks that signatures made with the installed
+// table still match crypto/ed25519.
+func TestSnapshotHelper(t *testing.T) {
+	path := os.Getenv(snapshotHelperEnv)
+	if path == "" {
+		t.Skip("only runs as a helper process")
+	}
+	if err := LoadSnapshot(path); err != nil {
+		t.Fatalf("LoadSnapshot failed: %v", err)
+	}
+	// the installed table is a private copy, so neither rewriting nor truncating the file reaches it
+	if err := os.WriteFile(path, bytes.Repeat([]byte{0xff}, 4096), 0o644); err != nil {
+		t.Fatalf("Failed to rewrite snapshot: %v", err)
+	}
+	if err := os.Truncate(path, 0); err != nil {
+		t.Fatalf("Failed to truncate snapshot: %v", err)
+	}
+
+	privateKey := ed25519.NewKeyFromSeed(bytes.Repeat([]byte{7}, ed25519.SeedSize))
+	privateJWK, err := jwkFromRaw(privateKey)
+	if err != nil {
+		t.Fatalf("Failed to create JWK: %v", err)
+	}
+	key, err := CurveSecretKeyFromJWK(privateJWK)
+	if err != nil {
+		t.Fatalf("CurveSecretKeyFromJWK failed: %v", err)
+	}
+	signer, err := NewEdDSASigner(key, "")
+	if err != nil {
+		t.Fatalf("NewEdDSASigner failed: %v", err)
+	}
+
+	message := []byte("signed with a snapshot table")
+	signature, err := signer.Sign(message)
+	if err != nil {
+		t.Fatalf("Sign failed: %v", err)
+	}
+	if !bytes.Equal(signature, ed25519.Sign(privateKey, message)) {
+		t.Error("Signature with the snapshot table differs from crypto/ed25519")
+	}
+}
+
+func BenchmarkSnapshot(b *testing.B) {
+	path := writeTestSnapshot(b)
+
+	b.Run("Write", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			if err := WriteSnapshot(path); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+
+	b.Run("Open", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			snapshot, err := OpenSnapshot(path)
+			if err != nil {
+				b.Fatal(err)
+			}
+			snapshot.Close()
+		}
+	})
+}
@@ -0,0 +1,96 @@
+package cvc
+
+import (
+	"fmt"
+
+	"github.com/MyNextID/cvc-go/internal"
+)
+
+// StatOp identifies an operation tracked by the library statistics
+type StatOp int
+
+// Operations tracked by the library statistics
+const (
+	StatKeyDerivation   StatOp = StatOp(internal.StatKeyDerivation)   // secret key derivations
+	StatScalarMul       StatOp = StatOp(internal.StatScalarMul)       // P-256 scalar multiplications
+	StatPointAdd        StatOp = StatOp(internal.StatPointAdd)        // P-256 point additions
+	StatHashCompression StatOp = StatOp(internal.StatHashCompression) // SHA-256 compressions in derivation and HKDF
+	StatKEMKeyPair      StatOp = StatOp(internal.StatKEMKeyPair)      // Kyber768 key pair generations
+	StatKEMEncapsulate  StatOp = StatOp(internal.StatKEMEncapsulate)  // Kyber768 encapsulations
+	StatKEMDecapsulate  StatOp = StatOp(internal.StatKEMDecapsulate)  // Kyber768 decapsulations
+	StatSign            StatOp = StatOp(internal.StatSign)            // ML-DSA-65 signatures
+	StatVerify          StatOp = StatOp(internal.StatVerify)          // ML-DSA-65 verifications
+	StatGCMBlock        StatOp = StatOp(internal.StatGCMBlock)        // AES-GCM blocks of envelopes and binary JWEs
+
+	// NumStatOps is the number of tracked operations
+	NumStatOps = internal.NumStatOps
+)
+
+var statOpNames = [NumStatOps]string{
+	StatKeyDerivation:   "key_derivation",
+	StatScalarMul:       "scalar_mul",
+	StatPointAdd:        "point_add",
+	StatHashCompression: "hash_compression",
+	StatKEMKeyPair:      "kem_keypair",
+	StatKEMEncapsulate:  "kem_encapsulate",
+	StatKEMDecapsulate:  "kem_decapsulate",
+	StatSign:            "sign",
+	StatVerify:          "verify",
+	StatGCMBlock:        "gcm_block",
+}
+
+func (op StatOp) String() string {
+	if op < 0 || int(op) >= NumStatOps {
+		return fmt.Sprintf("StatOp(%d)", int(op))
+	}
+	return statOpNames[op]
+}
+
+// OpStats holds the statistics of one operation. Ticks are TSC cycles on x86-64, generic timer ticks on
+// arm64 and nanoseconds elsewhere; operations that are only counted report zero ticks.
+type OpStats struct {
+	Count uint64
+	Ticks uint64
+}
+
+// TicksPerOp returns the average ticks per timed operation, or 0 if the operation was not timed
+func (s OpStats) TicksPerOp() float64 {
+	if s.Count == 0 || s.Ticks == 0 {
+		return 0
+	}
+	return float64(s.Ticks) / float64(s.Count)
+}
+
+// Stats is a snapshot of the library statistics, indexed by StatOp
+type Stats [NumStatOps]OpStats
+
+// Sub returns the operations performed between the earlier snapshot prev and s
+func (s Stats) Sub(prev Stats) Stats {
+	var diff Stats
+	for i := range s {
+		diff[i] = OpStats{Count: s[i].Count - prev[i].Count, Ticks: s[i].Ticks - prev[i].Ticks}
+	}
+	return diff
+}
+
+// StatsEnabled reports whether statistics are collected. They are compiled in with the cvcstats build
+// tag (go build -tags cvcstats); without it the counters and timers cost nothing and snapshots are zero.
+func StatsEnabled() bool {
+	return internal.StatsEnabled()
+}
+
+// StatsSnapshot returns the statistics summed over all threads since the last ResetStats
+func StatsSnapshot() Stats {
+	var stats Stats
+	counters := internal.StatsSnapshot()
+	for i := range stats {
+		stats[i] = OpStats{Count: counters.Count[i], Ticks: counters.Ticks[i]}
+	}
+	return stats
+}
+
+// ResetStats zeroes the statistics. Operations running concurrently with the reset may still be
+// counted afterwards.
+func ResetStats() {
+	internal.StatsReset()
+}
@@ -0,0 +1,61 @@
+package cvc
+
+import (
+	"testing"
+
+	"github.com/MyNextID/cvc-go/pkg"
+)
+
+func TestStats(t *testing.T) {
+	if !StatsEnabled() {
+		if StatsSnapshot() != (Stats{}) {
+			t.Errorf("Expected empty snapshot with statistics disabled")
+		}
+		t.Skip("statistics not compiled in, run with -tags cvcstats")
+	}
+
+	masterKey, err := GenerateSecretKey()
+	if err != nil {
+		t.Fatalf("Failed to generate master key: %v", err)
+	}
+
+	before := StatsSnapshot()
+	derivedKey, err := DeriveSecretKey(masterKey, []byte("stats-context"), []byte("CVC-STATS-TEST-DST-v1.0"))
+	if err != nil {
+		t.Fatalf("DeriveSecretKey failed: %v", err)
+	}
+	publicKey, _ := derivedKey.PublicKey()
+	envelope, err := pkg.EncryptCompact(make([]byte, 32), publicKey)
+	if err != nil {
+		t.Fatalf("EncryptCompact failed: %v", err)
+	}
+	if _, err := pkg.DecryptCompact(envelope, derivedKey); err != nil {
+		t.Fatalf("DecryptCompact failed: %v", err)
+	}
+	diff := StatsSnapshot().Sub(before)
+
+	if got := diff[StatKeyDerivation].Count; got != 1 {
+		t.Errorf("Expected 1 key derivation, got %d", got)
+	}
+	if got := diff[StatScalarMul].Count; got != 1 {
+		t.Errorf("Expected 1 scalar multiplication, got %d", got)
+	}
+	// b_0 over Z_pad || msg || trailer and two b_i of one block each
+	if got := diff[StatHashCompression].Count; got < 4 {
+		t.Errorf("Expected at least 4 hash compressions, got %d", got)
+	}
+	if got := diff[StatGCMBlock].Count; got != 4 {
+		t.Errorf("Expected 4 GCM blocks, got %d", got)
+	}
+	if diff[StatKeyDerivation].TicksPerOp() == 0 {
+		t.Errorf("Key derivation was not timed")
+	}
+
+	ResetStats()
+	if got := StatsSnapshot()[StatKeyDerivation].Count; got != 0 {
+		t.Errorf("Expected no key derivations after reset, got %d", got)
+	}
+	if StatKeyDerivation.String() != "key_derivation" {
+		t.Errorf("Unexpected operation name %q", StatKeyDerivation.String())
+	}
+}
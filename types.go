@@ -1,6 +1,9 @@
 package cvc
 
-import "github.com/lestrrat-go/jwx/v2/jwk"
+import (
+	"github.com/MyNextID/cvc-go/pkg"
+	"github.com/lestrrat-go/jwx/v2/jwk"
+)
 
 // MasterKeyStore interface allows users to implement their own key storage
 type MasterKeyStore interface {
@@ -15,11 +18,18 @@ type UserData struct {
 	WpPubKey jwk.Key
 	VcSecKey jwk.Key
 	VcPubKey jwk.Key
+
+	// WpKemPubKey is the wallet provider's Kyber768 public key, set when the provider runs in hybrid mode
+	WpKemPubKey []byte
+
+	// wpPubKeyValidated is set once WpPubKey has passed point validation at F0, so F1 can skip it
+	wpPubKeyValidated bool
 }
 
 type KeyData struct {
-	KeyID    string `json:"key_id"`
-	WpPubkey []byte `json:"wp_pubkey"`
+	KeyID       string `json:"key_id"`
+	WpPubkey    []byte `json:"wp_pubkey"`
+	WpKemPubkey []byte `json:"wp_kem_pubkey,omitempty"` // Kyber768 public key, only in hybrid mode
 }
 
 // MessagePack defines values that are stored in the message pack binary format
@@ -32,6 +42,15 @@ type MessagePack struct {
 	Email             string `json:"email" msgpack:"email"`                               // who gets the VC
 	DisplayMap        []byte `json:"display_map" msgpack:"display_map"`                   // how VC looks in wallet
 	PreviewDisplayMap []byte `json:"preview_display_map" msgpack:"preview_display_map"`   // preview of VC before he adds it to the wallet
+	Format            string `json:"format" msgpack:"format"`                             // envelope format of EncVC; empty for JWE
+	KeyFormat         string `json:"key_format" msgpack:"key_format"`                     // encoding of the VC secret key; empty for JWK JSON
+
+	// EncVCSecKeyFormat is the envelope format of EncVCSecKey. Packs without it seal EncVCSecKey in the
+	// format named by Format.
+	EncVCSecKeyFormat string `json:"encrypted_vc_sec_key_format,omitempty" msgpack:"encrypted_vc_sec_key_format"`
+
+	// EncVCBinary replaces EncVC when the issuer uses binary envelopes; see MessagePack.CompactEncVC
+	EncVCBinary *pkg.BinaryJWE `json:"encrypted_vc_binary,omitempty" msgpack:"encrypted_vc_binary"`
 }
 
 type CnfData struct {
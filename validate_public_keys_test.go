@@ -0,0 +1,157 @@
+package cvc
+
+import (
+	"crypto/ecdsa"
+	"crypto/elliptic"
+	"encoding/base64"
+	"encoding/json"
+	"errors"
+	"io"
+	"math/big"
+	"net/http"
+	"net/http/httptest"
+	"strings"
+	"testing"
+
+	"github.com/MyNextID/cvc-go/internal"
+	"github.com/lestrrat-go/jwx/v2/jwk"
+)
+
+func testPublicKeys(t testing.TB, n int) []jwk.Key {
+	t.Helper()
+	keys := make([]jwk.Key, n)
+	for i := range keys {
+		secretKey, err := GenerateSecretKey()
+		if err != nil {
+			t.Fatalf("Failed to generate key: %v", err)
+		}
+		if keys[i], err = secretKey.PublicKey(); err != nil {
+			t.Fatalf("Failed to get public key: %v", err)
+		}
+	}
+	return keys
+}
+
+// offCurvePoint returns the P-256 generator with y incremented by one
+func offCurvePoint() (*big.Int, *big.Int) {
+	params := elliptic.P256().Params()
+	return new(big.Int).Set(params.Gx), new(big.Int).Add(params.Gy, big.NewInt(1))
+}
+
+func TestValidatePublicKeysBatch(t *testing.T) {
+	keys := testPublicKeys(t, 32)
+
+	t.Run("ValidKeys", func(t *testing.T) {
+		if err := ValidatePublicKeysBatch(keys); err != nil {
+			t.Fatalf("ValidatePublicKeysBatch failed: %v", err)
+		}
+		if err := ValidatePublicKeysBatch(nil); err != nil {
+			t.Errorf("Expected empty batch to be valid, got %v", err)
+		}
+	})
+
+	t.Run("OffCurveKey", func(t *testing.T) {
+		x, y := offCurvePoint()
+		invalid, err := jwk.FromRaw(&ecdsa.PublicKey{Curve: elliptic.P256(), X: x, Y: y})
+		if err != nil {
+			t.Fatalf("Failed to create JWK: %v", err)
+		}
+		batch := append(append([]jwk.Key{}, keys[:3]...), invalid)
+		batch = append(batch, keys[3:]...)
+
+		err = ValidatePublicKeysBatch(batch)
+		if !errors.Is(err, internal.ErrKeyNotOnCurve) {
+			t.Fatalf("Expected ErrKeyNotOnCurve, got %v", err)
+		}
+		if !strings.Contains(err.Error(), "public key 3") {
+			t.Errorf("Expected error to name the invalid key, got %v", err)
+		}
+		// the per-key path rejects the same key
+		if _, err := AddPublicKeys(invalid, keys[0]); err == nil {
+			t.Errorf("Expected AddPublicKeys to reject the off-curve key")
+		}
+	})
+
+	t.Run("CoordinateOutOfRange", func(t *testing.T) {
+		params := elliptic.P256().Params()
+		invalid, err := jwk.FromRaw(&ecdsa.PublicKey{Curve: elliptic.P256(), X: params.P, Y: params.Gy})
+		if err != nil {
+			t.Fatalf("Failed to create JWK: %v", err)
+		}
+		if err := ValidatePublicKeysBatch([]jwk.Key{invalid}); !errors.Is(err, internal.ErrKeyNotOnCurve) {
+			t.Errorf("Expected ErrKeyNotOnCurve, got %v", err)
+		}
+	})
+
+	t.Run("NilKey", func(t *testing.T) {
+		if err := ValidatePublicKeysBatch([]jwk.Key{keys[0], nil}); !errors.Is(err, internal.ErrInvalidKey) {
+			t.Errorf("Expected ErrInvalidKey, got %v", err)
+		}
+	})
+
+	t.Run("RejectedAtIngestion", func(t *testing.T) {
+		x, y := offCurvePoint()
+		invalidJWK, _ := json.Marshal(map[string]string{
+			"kty": "EC",
+			"crv": "P-256",
+			"x":   base64.RawURLEncoding.EncodeToString(x.FillBytes(make([]byte, 32))),
+			"y":   base64.RawURLEncoding.EncodeToString(y.FillBytes(make([]byte, 32))),
+		})
+		server := httptest.NewServer(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+			body, _ := io.ReadAll(r.Body)
+			var hashes []string
+			json.Unmarshal(body, &hashes)
+			keyMap := make(map[string]KeyData, len(hashes))
+			for _, hash := range hashes {
+				keyMap[hash] = KeyData{KeyID: "kid", WpPubkey: invalidJWK}
+			}
+			w.Header().Set("Content-Type", "application/json")
+			json.NewEncoder(w).Encode(keyMap)
+		}))
+		defer server.Close()
+
+		issuer := &IssuerConfig{ProviderURL: server.URL, RequestPolicy: &RequestPolicy{MaxAttempts: 1}}
+		if _, err := issuer.GetPublicKeysFromWalletProvider(testEmailMap(4)); !errors.Is(err, internal.ErrKeyNotOnCurve) {
+			t.Errorf("Expected ErrKeyNotOnCurve from F0, got %v", err)
+		}
+	})
+
+	t.Run("ValidatedAtIngestion", func(t *testing.T) {
+		server, _ := newTestProvider(t, nil)
+		issuer := &IssuerConfig{ProviderURL: server.URL}
+		userMap, err := issuer.GetPublicKeysFromWalletProvider(testEmailMap(8))
+		if err != nil {
+			t.Fatalf("GetPublicKeysFromWalletProvider failed: %v", err)
+		}
+		for uuid, userData := range userMap {
+			if !userData.wpPubKeyValidated {
+				t.Errorf("Key of %s not marked as validated", uuid)
+			}
+			if _, _, err := issuer.AddCnfToPayload(uuid, map[string]interface{}{}, userMap); err != nil {
+				t.Errorf("AddCnfToPayload failed: %v", err)
+			}
+		}
+	})
+}
+
+func BenchmarkValidatePublicKeys(b *testing.B) {
+	keys := testPublicKeys(b, 100)
+
+	b.Run("PerKey", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			for _, key := range keys {
+				if _, err := extractPublicKey(key, "key"); err != nil {
+					b.Fatal(err)
+				}
+			}
+		}
+	})
+
+	b.Run("Batch", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			if err := ValidatePublicKeysBatch(keys); err != nil {
+				b.Fatal(err)
+			}
+		}
+	})
+}